@@ -5,6 +5,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "../include/cursor.h"
+#include "../include/colorspace.h"
+#include "../include/codec.h"
+#include "../include/roi.h"
+
 // Inclusions pour les API Windows
 #ifdef _WIN32
 #include <winsock2.h>
@@ -20,6 +25,29 @@ typedef enum {
     CAPTURE_METHOD_AUTO       // Sélection automatique de la meilleure méthode
 } CaptureMethod;
 
+/**
+ * @brief Couche d'une image transmise, chacune avec son canevas et ses acquittements
+ * @details Quand le visualiseur zoome sur une région, elle est envoyée à part à la résolution affichée,
+ *          la zone entière seulement en aperçu réduit (voir ViewerViewport).
+ */
+typedef enum {
+    CAPTURE_LAYER_FULL,       // Zone capturée entière (aperçu réduit si une région est demandée)
+    CAPTURE_LAYER_DETAIL,     // Région affichée par le visualiseur
+    CAPTURE_LAYER_COUNT
+} CaptureLayer;
+
+/**
+ * @brief Affichage d'un visualiseur, annoncé à l'émetteur (voir SetViewerViewport)
+ */
+typedef struct {
+    int width;                // Zone d'affichage en pixels (0 : pas de limite)
+    int height;
+    int regionX;              // Région affichée, en pixels de la zone capturée par l'émetteur
+    int regionY;
+    int regionWidth;          // 0 : zone capturée entière, pas de couche de détail
+    int regionHeight;
+} ViewerViewport;
+
 /**
  * @brief Information sur un moniteur
  */
@@ -36,7 +64,7 @@ typedef struct {
 /**
  * @brief Configuration du système de capture
  */
-typedef struct {
+typedef struct CaptureConfig {
     CaptureMethod method;           // Méthode de capture
     int quality;                    // Qualité de compression (0-100)
     int captureInterval;            // Intervalle entre captures en ms
@@ -44,26 +72,58 @@ typedef struct {
     int changeThreshold;            // Seuil pour considérer qu'un changement a eu lieu (0-100)
     bool autoAdjustQuality;         // Ajuster automatiquement la qualité
     int targetMonitor;              // Index du moniteur cible (-1 pour tous)
+    bool detectScroll;              // Envoyer les défilements comme copies de rectangles
+    bool useTileCache;              // Référencer les tuiles déjà présentes dans le cache des visualiseurs
+    bool tileCodecs;                // Coder sans perte les tuiles de texte et d'interface (JPEG pour le reste)
+    bool lossless;                  // Aucune perte (CAO, code) : toutes les tuiles en QOI, plus de JPEG
+    bool yuvOutput;                 // Produire aussi l'image en NV12 (yuv) pour les codecs vidéo
+    CodecId codec;                  // Codec demandé (CODEC_ID_VIDEO pour les vidéos et jeux), si les visualiseurs le décodent
+    int videoGop;                   // Images au plus entre deux images I du codec vidéo (0 = à la demande)
+    int videoSlices;                // Tranches par image du codec vidéo, décodables indépendamment
+    bool scaleToViewer;             // Réduire l'image à la taille d'affichage du visualiseur (voir ScaleCaptureData)
+    int maxBitrateKbps;             // Débit visé en kbit/s : au-delà, la résolution envoyée baisse (0 = pas de limite)
+    bool roiQuality;                // Qualité concentrée autour du curseur, de la fenêtre active et des zones qui changent (voir roi.h)
+    bool refineTiles;               // Renvoyer sans perte les tuiles figées parties en JPEG, dans la marge de débit
 } CaptureConfig;
 
 /**
  * @brief Structure contenant les données d'une capture d'écran
  */
-typedef struct {
+typedef struct CaptureData {
     Image image;                 // Image brute capturée
+    YuvImage yuv;                // Même image en NV12 si CaptureConfig.yuvOutput ou codec CODEC_CAP_YUV (plans vides sinon)
     Texture2D texture;           // Texture pour l'affichage
+    const void* textureDecoder;  // Décodeur dont l'image remplit la texture (visualiseur, NULL sinon)
     unsigned char* compressedData; // Données compressées pour la transmission
     int compressedSize;          // Taille des données compressées
-    uint8_t* encryptedData;      // Données chiffrées
-    int encryptedSize;           // Taille des données chiffrées
     int width;                   // Largeur de l'image
     int height;                  // Hauteur de l'image
+    int sourceWidth;             // Largeur de la zone représentée, avant réduction (0 = width)
+    int sourceHeight;            // Hauteur de la zone représentée, avant réduction (0 = height)
+    int sourceX;                 // Position de cette zone dans la zone capturée (couche de détail)
+    int sourceY;
+    CaptureLayer layer;          // Couche de l'image
     bool isCompressed;           // Indique si les données sont compressées
-    bool isEncrypted;            // Indique si les données sont chiffrées
+    CodecId codec;               // Codec de compressedData (choisi avant CompressCaptureData, voir CodecSelect)
+    const RoiMap* roi;           // Zones d'intérêt de l'image, renseignées par CompressCaptureData (NULL : qualité uniforme)
+    uint32_t refineBudget;       // Octets accordés par CompressCaptureData au renvoi sans perte des tuiles figées
     unsigned char* previousFrame; // Image précédente pour la détection de changements
     bool hasChanged;             // Indique si l'image a changé depuis la dernière capture
+    int changedPixels;           // Pixels différents de l'image précédente (DetectChanges), même sous le seuil de hasChanged
     int monitorIndex;            // Index du moniteur capturé (-1 si combiné)
-    uint64_t timestamp;          // Timestamp de la capture
+    uint32_t frameId;            // Identifiant croissant de la capture
+    uint32_t canvasId;           // Canevas de tuiles de l'émetteur (voir tiles.h) ou flux vidéo, selon le codec
+    uint32_t baseFrameId;        // Image déjà reçue par les visualiseurs, seules les tuiles modifiées depuis sont envoyées (0 = image complète)
+    uint64_t appliedFrames;      // Bit i : image baseFrameId - i appliquée par tous les visualiseurs (voir GetAppliedFrames)
+    int tileCount;               // Tuiles contenues dans compressedData
+    int sourcePeerId;            // Pair émetteur d'une image reçue (0 pour une capture locale)
+    uint64_t timestamp;          // Horodatage monotone de la capture en ns (ClockNowNs)
+    uint64_t encodeStartNs;      // Début de la compression (ns)
+    uint64_t encodeEndNs;        // Fin de la compression (ns)
+    uint64_t sendNs;             // Envoi par l'émetteur (ns)
+    uint64_t receiveNs;          // Réception par le visualiseur (ns)
+    uint64_t decodeNs;           // Fin de la décompression par le visualiseur (ns)
+    uint64_t presentNs;          // Affichage par le visualiseur (ns)
 } CaptureData;
 
 /**
@@ -112,8 +172,38 @@ CaptureData CaptureScreenRegion(Rectangle region);
  */
 void UnloadCaptureData(CaptureData* capture);
 
+/**
+ * @brief Extrait une région d'une capture, pour la couche de détail
+ * @details La région est bornée à l'image. Le reste de la capture (identifiant, horodatage, codec)
+ *          est repris ; canevas et image de référence sont ceux de la couche de détail.
+ * @param capture Capture entière, avant réduction
+ * @param region Région en pixels de la capture
+ * @param detail Capture produite (à libérer avec UnloadCaptureData)
+ * @return true si la région est non vide et a été copiée, false sinon
+ */
+bool ExtractCaptureRegion(const CaptureData* capture, Rectangle region, CaptureData* detail);
+
+/**
+ * @brief Réduit la résolution de l'image avant sa compression
+ * @details La cible est la taille d'affichage du visualiseur (sans jamais agrandir), réduite encore
+ *          par le contrôle de débit si CaptureConfig.maxBitrateKbps est dépassé. Les rapports proches
+ *          de 1/2 et 1/4 sont arrondis pour les moyennes de blocs de scale.h ; une cible proche de la
+ *          précédente est conservée, pour ne pas repartir d'une image complète à chaque redimensionnement
+ *          de la fenêtre (une cible par couche). width et height deviennent ceux de l'image réduite,
+ *          sourceWidth et sourceHeight gardent ceux de la zone représentée : le visualiseur agrandit
+ *          l'image à l'affichage.
+ * @param capture Capture à réduire (image RGBA, avant CompressCaptureData)
+ * @param viewerWidth Largeur d'affichage du visualiseur (0 si inconnue, voir GetPeerViewport)
+ * @param viewerHeight Hauteur d'affichage du visualiseur (0 si inconnue)
+ * @return true si l'image est prête à compresser (réduite ou non), false en cas d'erreur
+ */
+bool ScaleCaptureData(CaptureData* capture, int viewerWidth, int viewerHeight);
+
 /**
  * @brief Compresse les données de l'image pour la transmission
+ * @details Avec le codec capture->codec (voir codec.h). En tuiles, seules celles modifiées depuis
+ *          capture->baseFrameId sont compressées ; en vidéo, l'image est prédite depuis baseFrameId.
+ *          Une image décodable seule est produite si baseFrameId vaut 0 ou si les dimensions ont changé.
  * @param capture Pointeur vers la structure CaptureData à compresser
  * @param quality Niveau de qualité (0-100, 100 étant la meilleure qualité)
  * @return true si la compression réussit, false sinon
@@ -122,12 +212,57 @@ bool CompressCaptureData(CaptureData* capture, int quality);
 
 /**
  * @brief Détecte si l'image a changé significativement depuis la dernière capture
+ * @details Compare l'image à capture->previousFrame, de mêmes dimensions (transmis d'une capture à
+ *          la suivante par l'appelant), puis l'y recopie. Sans image précédente, l'image est changée.
  * @param capture Pointeur vers la structure CaptureData actuelle
  * @param threshold Seuil de changement (0-100, 0 = tout changement, 100 = aucun changement)
  * @return true si l'image a changé, false sinon
  */
 bool DetectChanges(CaptureData* capture, int threshold);
 
+/**
+ * @brief Identifiant du canevas de tuiles ou du flux vidéo courant d'un codec
+ * @details Change avec les dimensions capturées ; les acquittements d'un autre canevas ne valent plus.
+ * @param layer Couche des prochaines images
+ * @param codec Codec des prochaines images
+ * @return Identifiant du canevas, 0 avant la première compression avec ce codec
+ */
+uint32_t GetCaptureCanvasId(CaptureLayer layer, CodecId codec);
+
+/**
+ * @brief Carte des zones d'intérêt de la dernière image compressée d'une couche
+ * @details Cellules de ROI_CELL_SIZE pixels de l'image envoyée (après ScaleCaptureData), pour le
+ *          panneau de débogage. Mise à jour seulement si CaptureConfig.roiQuality est activé.
+ * @param layer Couche de l'image
+ * @return Carte, NULL si aucune n'a encore été calculée
+ */
+const RoiMap* GetCaptureRoiMap(CaptureLayer layer);
+
+/**
+ * @brief Capture la position et la forme du curseur, séparément de l'image
+ * @details Le curseur n'est pas inclus dans les captures : le visualiseur le dessine lui-même,
+ *          ce qui évite de recompresser des tuiles à chaque mouvement de la souris. La position
+ *          est relative à la zone de la dernière capture. Disponible avec la capture GDI uniquement.
+ * @param state Position et forme courantes (invisible si le curseur est masqué ou hors de la zone)
+ * @param shapeChanged Mis à true si la forme diffère de la précédente (peut être NULL)
+ * @return true si l'état du curseur a pu être lu, false sinon
+ */
+bool CaptureCursor(CursorState* state, bool* shapeChanged);
+
+/**
+ * @brief Forme courante du curseur capturé
+ * @return Forme (valide jusqu'au prochain CaptureCursor), NULL si aucune forme n'a été capturée
+ */
+const CursorShape* GetCaptureCursorShape(void);
+
+/**
+ * @brief Heure de la dernière saisie de l'utilisateur (clavier ou souris), toutes fenêtres confondues
+ * @details Réveille la cadence de capture avant que le changement d'écran ne soit visible.
+ * @param inputNs Heure de la saisie (ClockNowNs)
+ * @return true si le système la fournit (Windows), false sinon
+ */
+bool GetLastInputTime(uint64_t* inputNs);
+
 /**
  * @brief Met à jour la configuration de capture
  * @param config Nouvelle configuration
@@ -141,4 +276,17 @@ bool UpdateCaptureConfig(CaptureConfig config);
  */
 CaptureConfig GetCaptureConfig(void);
 
+/**
+ * @brief Mesure la compression des captures sur un bureau synthétique, sans écran ni réseau
+ * @details Compare le JPEG seul, le choix du codec par tuile, le mode sans perte et sa différence
+ *          avec l'image acquittée : débits d'encodage et de décodage (Mo/s d'image RGBA) et taux
+ *          de compression, dans le journal. Compare aussi les tuiles et le codec vidéo sur une vidéo
+ *          synthétique (taille par image et PSNR), le décodage parallèle des tuiles et des tranches vidéo
+ *          selon le nombre de threads, et mesure la conversion des couleurs vers et depuis NV12 ainsi
+ *          que la réduction de résolution.
+ * @param frames Images compressées par mode
+ * @return true si toutes les images ont été compressées et décodées, et restituées exactement sans perte
+ */
+bool RunCaptureBenchmark(int frames);
+
 #endif // CAPTURE_H
\ No newline at end of file
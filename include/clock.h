@@ -0,0 +1,69 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Nombre d'échantillons conservés par l'estimateur de décalage d'horloge
+ */
+#define CLOCK_OFFSET_SAMPLES 8
+
+/**
+ * @brief Estimateur du décalage entre l'horloge locale et celle d'un pair
+ * @details Échanges ping/pong à la NTP : chaque échantillon fournit un décalage et un RTT,
+ * l'estimation retenue est celle de l'échantillon au plus petit RTT sur la fenêtre récente
+ * (le moins perturbé par les files d'attente).
+ */
+typedef struct {
+    int64_t offsetNs[CLOCK_OFFSET_SAMPLES];  // Décalages mesurés (distant - local)
+    uint64_t rttNs[CLOCK_OFFSET_SAMPLES];    // RTT associés
+    int count;                               // Nombre d'échantillons valides
+    int next;                                // Prochain emplacement à écrire
+    int64_t bestOffsetNs;                    // Décalage retenu
+    uint64_t bestRttNs;                      // RTT de l'échantillon retenu
+    bool isValid;                            // Au moins un échantillon disponible
+} ClockOffsetEstimator;
+
+/**
+ * @brief Retourne l'heure monotone courante
+ * @return Temps en nanosecondes depuis une origine arbitraire, jamais décroissant
+ */
+uint64_t ClockNowNs(void);
+
+/**
+ * @brief Retourne l'heure monotone courante en microsecondes (résolution du protocole)
+ */
+static inline uint64_t ClockNowUs(void) {
+    return ClockNowNs() / 1000;
+}
+
+/**
+ * @brief Convertit une durée en nanosecondes en millisecondes
+ */
+static inline double ClockNsToMs(int64_t ns) {
+    return (double)ns / 1000000.0;
+}
+
+/**
+ * @brief Réinitialise un estimateur de décalage
+ */
+void ClockOffsetReset(ClockOffsetEstimator* estimator);
+
+/**
+ * @brief Ajoute un échantillon ping/pong
+ * @param estimator Estimateur à mettre à jour
+ * @param t0 Envoi du ping (horloge locale)
+ * @param t1 Réception du ping (horloge distante)
+ * @param t2 Envoi du pong (horloge distante)
+ * @param t3 Réception du pong (horloge locale)
+ */
+void ClockOffsetAddSample(ClockOffsetEstimator* estimator, uint64_t t0, uint64_t t1, uint64_t t2, uint64_t t3);
+
+/**
+ * @brief Convertit un horodatage de l'horloge distante vers l'horloge locale
+ * @return L'horodatage local équivalent (inchangé si aucune estimation n'est disponible)
+ */
+uint64_t ClockRemoteToLocalNs(const ClockOffsetEstimator* estimator, uint64_t remoteNs);
+
+#endif // CLOCK_H
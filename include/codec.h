@@ -0,0 +1,97 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../include/tiles.h"
+
+// Déclarés dans capture.h, qui inclut ce fichier
+struct CaptureData;
+struct CaptureConfig;
+
+/**
+ * @brief Codec d'une image transmise (octet `codec` de WireCaptureMetadata)
+ * @details Dans l'ordre de préférence à capacités égales : du plus rapide au plus lent à coder.
+ */
+typedef enum {
+    CODEC_ID_TILES = 0,         // Tuiles modifiées depuis l'image acquittée (JPEG, palette, sans perte) : bureau, texte
+    CODEC_ID_VIDEO = 1,         // Images I/P à macroblocs (voir video.h) : vidéos, jeux
+    CODEC_ID_COUNT
+} CodecId;
+
+// Bit d'un codec dans les masques annoncés par le handshake
+#define CODEC_SUPPORT_BIT(codec) (1u << (codec))
+
+// Capacités d'un codec (Codec.capabilities)
+#define CODEC_CAP_LOSSLESS 0x01     // Sait restituer l'image exacte (CaptureConfig.lossless)
+#define CODEC_CAP_INTER 0x02        // Prédit depuis la dernière image acquittée (baseFrameId)
+#define CODEC_CAP_YUV 0x04          // Code depuis le NV12 produit à la capture (CaptureData.yuv)
+#define CODEC_CAP_SLICES 0x08       // Image découpée en parties décodables indépendamment
+
+/**
+ * @brief En-tête d'une image reçue, lu par le codec qui l'a produite
+ */
+typedef struct {
+    uint32_t streamId;          // Canevas de tuiles ou flux vidéo de l'émetteur
+    uint32_t baseFrameId;       // Image de référence (0 = image décodable seule)
+    int tileCount;              // Tuiles transmises (0 pour un codec sans tuiles)
+} CodecFrameInfo;
+
+/**
+ * @brief Table de fonctions d'un codec d'image
+ * @details L'état de l'émetteur et celui du visualiseur sont opaques, créés à la première image.
+ *          Un codec ajouté au registre (codec.c) est utilisable par la capture, le réseau, l'affichage
+ *          et le banc d'essai sans autre changement.
+ */
+typedef struct {
+    CodecId id;
+    const char* name;
+    uint32_t capabilities;      // CODEC_CAP_*
+    
+    // Émetteur
+    void* (*createEncoder)(void);
+    // Remplit compressedData, compressedSize, canvasId, baseFrameId (référence réellement utilisée) et tileCount
+    bool (*encode)(void* encoder, struct CaptureData* capture, const struct CaptureConfig* config, int quality);
+    uint32_t (*encoderStreamId)(const void* encoder);
+    // Oublie les références : la prochaine image ouvre un nouveau flux, décodable seule
+    void (*flushEncoder)(void* encoder);
+    void (*destroyEncoder)(void* encoder);
+    
+    // Visualiseur
+    bool (*parseFrame)(const uint8_t* data, uint32_t size, CodecFrameInfo* info);
+    void* (*createDecoder)(void);
+    TileApplyResult (*decode)(void* decoder, const uint8_t* data, uint32_t size, uint32_t frameId,
+                              int width, int height);
+    uint32_t (*decoderStreamId)(const void* decoder);
+    const Image* (*decodedImage)(const void* decoder);
+    // Zones de decodedImage modifiées par la dernière image décodée, à envoyer à la texture
+    int (*dirtyRects)(const void* decoder, const DirtyRect** rects);
+    void (*destroyDecoder)(void* decoder);
+} Codec;
+
+/**
+ * @brief Codec du registre
+ * @param id Identifiant (éventuellement reçu d'un pair)
+ * @return Codec, NULL si l'identifiant est inconnu
+ */
+const Codec* CodecGet(uint32_t id);
+
+/**
+ * @brief Codecs que ce programme sait coder et décoder
+ * @return Masque de CODEC_SUPPORT_BIT, annoncé dans le handshake
+ */
+uint32_t CodecSupportedCodecs(void);
+
+/**
+ * @brief Choisit le codec d'un flux d'après les capacités du ou des visualiseurs
+ * @details Le codec demandé s'il est commun, sinon le plus rapide des codecs communs. Les tuiles
+ *          restent le dernier recours : tout pair sait les décoder, même sans l'annoncer.
+ * @param preferred Codec demandé par la configuration
+ * @param remoteSupport Masque annoncé par le visualiseur (GetPeerCodecSupport)
+ * @return Codec à utiliser
+ */
+CodecId CodecSelect(CodecId preferred, uint32_t remoteSupport);
+
+#endif // CODEC_H
@@ -0,0 +1,72 @@
+#ifndef COLORSPACE_H
+#define COLORSPACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Image en YUV 4:2:0 au format NV12 (BT.601, plage limitée 16-235)
+ * @details Plan de luminance plein, suivi d'un plan de chrominance à demi-résolution où U et V
+ *          sont entrelacés : 1,5 octet par pixel au lieu de 4 en RGBA. C'est l'entrée attendue
+ *          par les codecs vidéo matériels et logiciels.
+ */
+typedef struct {
+    int width;                  // Largeur en pixels
+    int height;                 // Hauteur en pixels
+    uint8_t* y;                 // Luminance, yStride octets par ligne
+    uint8_t* uv;                // Chrominance UVUV..., (height + 1) / 2 lignes de uvStride octets
+    int yStride;                // Octets par ligne de luminance
+    int uvStride;               // Octets par ligne de chrominance (2 par bloc de 2x2 pixels)
+} YuvImage;
+
+/**
+ * @brief Alloue les plans d'une image NV12 (conservés s'ils ont déjà ces dimensions)
+ * @param image Image à (ré)allouer
+ * @param width Largeur en pixels
+ * @param height Hauteur en pixels
+ * @return true si les plans sont prêts, false en cas d'échec d'allocation
+ */
+bool YuvImageAlloc(YuvImage* image, int width, int height);
+
+/**
+ * @brief Libère les plans d'une image NV12
+ * @param image Image à libérer (remise à zéro)
+ */
+void YuvImageFree(YuvImage* image);
+
+/**
+ * @brief Convertit une capture BGRA (GDI) en RGBA opaque et/ou en NV12, en une seule lecture
+ * @details Chaque bloc de 2x2 pixels n'est lu qu'une fois pour les deux sorties : la conversion
+ *          remplace la copie BGRA vers RGBA de la capture sans relire l'image. La chrominance est
+ *          la moyenne du bloc. SSE2 quand il est disponible, résultat identique sans.
+ * @param bgra Pixels BGRA (alpha ignoré)
+ * @param stride Octets par ligne de bgra
+ * @param width Largeur en pixels
+ * @param height Hauteur en pixels
+ * @param rgba Destination RGBA, alpha à 255 (NULL pour ne produire que le NV12)
+ * @param rgbaStride Octets par ligne de rgba
+ * @param yuv Destination NV12 déjà allouée aux mêmes dimensions (NULL pour ne produire que le RGBA)
+ */
+void ColorConvertBgra(const uint8_t* bgra, size_t stride, int width, int height,
+                      uint8_t* rgba, size_t rgbaStride, YuvImage* yuv);
+
+/**
+ * @brief Convertit une image RGBA en NV12
+ * @param rgba Pixels RGBA (alpha ignoré)
+ * @param stride Octets par ligne
+ * @param width Largeur en pixels
+ * @param height Hauteur en pixels
+ * @param yuv Destination NV12 déjà allouée aux mêmes dimensions
+ */
+void ColorConvertRgbaToNv12(const uint8_t* rgba, size_t stride, int width, int height, YuvImage* yuv);
+
+/**
+ * @brief Reconstitue une image RGBA opaque depuis le NV12, côté visualiseur
+ * @param yuv Image NV12
+ * @param rgba Destination de yuv->width x yuv->height pixels
+ * @param stride Octets par ligne de rgba
+ */
+void ColorConvertNv12ToRgba(const YuvImage* yuv, uint8_t* rgba, size_t stride);
+
+#endif // COLORSPACE_H
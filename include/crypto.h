@@ -0,0 +1,135 @@
+#ifndef CRYPTO_H
+#define CRYPTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Tailles communes aux deux algorithmes AEAD
+#define AEAD_KEY_SIZE 32
+#define AEAD_NONCE_SIZE 12
+#define AEAD_TAG_SIZE 16
+
+/**
+ * @brief Algorithmes de chiffrement authentifié disponibles
+ * @details Les valeurs sont transmises sur le réseau (voir protocol.h), ne pas les renuméroter.
+ */
+typedef enum {
+    AEAD_ALGORITHM_NONE = 0,
+    AEAD_ALGORITHM_CHACHA20_POLY1305 = 1,   // Portable, vectorisé SSE2 si disponible
+    AEAD_ALGORITHM_AES_256_GCM = 2          // Nécessite AES-NI et PCLMULQDQ
+} AeadAlgorithm;
+
+// Masque des algorithmes supportés (bit = 1 << AeadAlgorithm)
+#define AEAD_SUPPORT_BIT(algorithm) (1u << (algorithm))
+
+/**
+ * @brief Contexte de chiffrement pour une clé donnée
+ * @details Les sous-clés (tours AES, H pour GHASH) sont précalculées une seule fois.
+ */
+typedef struct {
+    AeadAlgorithm algorithm;
+    uint8_t key[AEAD_KEY_SIZE];
+    uint8_t aesRoundKeys[15 * 16];  // 14 tours + clé initiale (AES-256)
+    uint8_t ghashKey[16];           // H = AES_K(0^128), ordre des octets inversé
+} AeadContext;
+
+/**
+ * @brief Détecte les extensions du processeur utilisables
+ * @return Masque des algorithmes supportés par cette machine
+ */
+uint32_t AeadSupportedAlgorithms(void);
+
+/**
+ * @brief Choisit l'algorithme le plus rapide commun aux deux masques
+ * @param localSupport Masque local (AeadSupportedAlgorithms)
+ * @param remoteSupport Masque annoncé par le pair
+ * @return AES-256-GCM si les deux machines l'accélèrent, ChaCha20-Poly1305 sinon
+ */
+AeadAlgorithm AeadSelectAlgorithm(uint32_t localSupport, uint32_t remoteSupport);
+
+/**
+ * @brief Nom lisible d'un algorithme
+ */
+const char* AeadAlgorithmName(AeadAlgorithm algorithm);
+
+/**
+ * @brief Prépare un contexte de chiffrement
+ * @param ctx Contexte à initialiser
+ * @param algorithm Algorithme à utiliser
+ * @param key Clé de 32 octets
+ * @return false si l'algorithme n'est pas supporté par cette machine
+ */
+bool AeadInit(AeadContext* ctx, AeadAlgorithm algorithm, const uint8_t key[AEAD_KEY_SIZE]);
+
+/**
+ * @brief Chiffre et authentifie des données en place
+ * @param ctx Contexte initialisé
+ * @param nonce Nonce de 12 octets, à ne jamais réutiliser avec la même clé
+ * @param aad Données associées authentifiées mais non chiffrées (peut être NULL)
+ * @param aadSize Taille des données associées
+ * @param data Données à chiffrer, remplacées par le texte chiffré
+ * @param size Taille des données
+ * @param tag Tag d'authentification produit (16 octets)
+ */
+void AeadSeal(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+              const uint8_t* aad, size_t aadSize,
+              uint8_t* data, size_t size, uint8_t tag[AEAD_TAG_SIZE]);
+
+/**
+ * @brief Chiffre et authentifie des données vers un autre buffer
+ * @details Le texte clair reste intact : un même paquet est chiffré pour chaque destinataire sans
+ *          être recopié ni déchiffré entre deux envois.
+ * @param plaintext Données à chiffrer (inchangées, sauf si cipher == plaintext)
+ * @param cipher Texte chiffré produit (size octets, identique à plaintext ou sans recouvrement)
+ */
+void AeadSealTo(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+                const uint8_t* aad, size_t aadSize,
+                const uint8_t* plaintext, uint8_t* cipher, size_t size, uint8_t tag[AEAD_TAG_SIZE]);
+
+/**
+ * @brief Vérifie et déchiffre des données en place
+ * @details Le tag est vérifié en temps constant avant tout déchiffrement ;
+ *          en cas d'échec les données restent inchangées.
+ * @return true si le tag est valide, false sinon
+ */
+bool AeadOpen(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+              const uint8_t* aad, size_t aadSize,
+              uint8_t* data, size_t size, const uint8_t tag[AEAD_TAG_SIZE]);
+
+/**
+ * @brief Efface un contexte (clé comprise)
+ */
+void AeadWipe(AeadContext* ctx);
+
+/**
+ * @brief Efface une zone mémoire sans que le compilateur puisse l'éliminer
+ */
+void CryptoWipe(void* data, size_t size);
+
+/**
+ * @brief Remplit un buffer avec des octets aléatoires du système
+ * @return true si la source d'aléa du système a répondu, false sinon
+ */
+bool CryptoRandomBytes(void* data, size_t size);
+
+/**
+ * @brief Vérifie les algorithmes supportés sur des vecteurs de référence
+ * @details RFC 8439 §2.8.2 pour ChaCha20-Poly1305, cas de test GCM 16 pour AES-256-GCM, puis des
+ *          messages longs (tags produits par OpenSSL) qui traversent les chemins SSE2 et AES-NI et
+ *          leurs restes. Chaque vecteur est scellé en place et vers un autre buffer, puis ouvert ;
+ *          un tag altéré doit être refusé. Les échecs sont dans le journal.
+ * @return true si tous les vecteurs sont validés
+ */
+bool AeadSelfTest(void);
+
+/**
+ * @brief Mesure le scellement et l'ouverture des algorithmes supportés sur des tailles d'image 4K
+ * @details Différence de 64 Ko, image clé JPEG de 1 Mo et RGBA brut 3840x2160 : débits en Mo/s et
+ *          part d'un cœur consommée à 30 images/s, dans le journal. Lance AeadSelfTest avant la mesure.
+ * @param frames Images scellées puis ouvertes par taille et par algorithme
+ * @return true si les vecteurs sont validés et que chaque image est restituée à l'identique
+ */
+bool RunCryptoBenchmark(int frames);
+
+#endif // CRYPTO_H
@@ -0,0 +1,64 @@
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Côté maximal d'une forme de curseur transmise (les curseurs système font 32 à 64 pixels)
+#define CURSOR_MAX_SIZE 128
+
+// Formes conservées par le visualiseur, les moins récemment utilisées sont remplacées
+#define CURSOR_CACHE_SIZE 16
+
+/**
+ * @brief Forme d'un curseur
+ * @details Identifiée par une empreinte de son contenu : deux curseurs identiques ont le même
+ *          identifiant, ce qui permet au visualiseur de ne demander qu'une fois chaque forme.
+ */
+typedef struct {
+    uint32_t shapeId;           // Empreinte du contenu (jamais 0)
+    int width;                  // Dimensions en pixels
+    int height;
+    int hotspotX;               // Point actif, relatif au coin haut gauche de la forme
+    int hotspotY;
+    uint8_t* pixels;            // Pixels RGBA, alpha non prémultiplié
+} CursorShape;
+
+/**
+ * @brief Position et forme courantes du curseur
+ */
+typedef struct {
+    bool visible;               // Curseur affiché et dans la zone capturée
+    int x;                      // Position du point actif, relative à la zone capturée
+    int y;
+    uint32_t shapeId;           // Forme affichée (CursorShape.shapeId)
+} CursorState;
+
+/**
+ * @brief Calcule l'empreinte d'une forme de curseur (FNV-1a sur les dimensions, le point actif et les pixels)
+ * @param shape Forme dont les champs autres que shapeId sont renseignés
+ * @return Empreinte non nulle
+ */
+uint32_t CursorShapeHash(const CursorShape* shape);
+
+/**
+ * @brief Ajoute une forme reçue au cache du visualiseur
+ * @details Les pixels sont copiés ; une forme déjà présente est seulement marquée comme utilisée.
+ * @param shape Forme à conserver
+ * @return true si la forme est dans le cache, false en cas d'échec d'allocation
+ */
+bool CursorCacheStore(const CursorShape* shape);
+
+/**
+ * @brief Cherche une forme dans le cache du visualiseur
+ * @param shapeId Empreinte de la forme
+ * @return Forme en cache (valide jusqu'au prochain CursorCacheStore), NULL si absente
+ */
+const CursorShape* CursorCacheFind(uint32_t shapeId);
+
+/**
+ * @brief Vide le cache des formes
+ */
+void CursorCacheClear(void);
+
+#endif // CURSOR_H
@@ -0,0 +1,146 @@
+#ifndef HANDSHAKE_H
+#define HANDSHAKE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../include/crypto.h"
+#include "../include/keys.h"
+
+#define HANDSHAKE_PSK_SIZE 32
+#define HANDSHAKE_SHARE_SIZE 32
+#define HANDSHAKE_SESSION_ID_SIZE 16
+#define HANDSHAKE_MAC_SIZE 16
+#define HANDSHAKE_NONCE_PREFIX_SIZE 4
+
+// Coût de PBKDF2 (~0,2 s) payé une seule fois par mot de passe, jamais par connexion ni par image
+#define HANDSHAKE_PBKDF2_ITERATIONS 200000
+
+// Cache des sessions pour la reprise rapide après une reconnexion
+#define HANDSHAKE_SESSION_CACHE_SIZE 16
+#define HANDSHAKE_SESSION_LIFETIME_NS (10ULL * 60 * 1000000000ULL)
+
+/**
+ * @brief Mode d'une part d'échange de clés (octet `mode` de WireKeyShare)
+ */
+typedef enum {
+    HANDSHAKE_MODE_NONE = 0,    // Aucune part envoyée
+    HANDSHAKE_MODE_FULL = 1,    // X25519 éphémère
+    HANDSHAKE_MODE_RESUME = 2   // Reprise d'une session en cache, sans X25519
+} HandshakeMode;
+
+/**
+ * @brief Résultat du traitement d'une part d'échange de clés reçue
+ */
+typedef enum {
+    HANDSHAKE_RESULT_ERROR,         // MAC invalide (mot de passe différent) ou part inutilisable
+    HANDSHAKE_RESULT_WAITING,       // Modes différents : on attend la part du pair dans notre mode
+    HANDSHAKE_RESULT_ESTABLISHED    // Clés de session disponibles
+} HandshakeResult;
+
+/**
+ * @brief Clés de session d'un pair, une par sens
+ */
+typedef struct {
+    bool isEstablished;
+    bool isResumed;                                 // Session issue d'une reprise
+    AeadAlgorithm algorithm;
+    AeadContext txContext;                          // Nos paquets vers le pair
+    AeadContext rxContext;                          // Paquets du pair vers nous
+    uint8_t txNoncePrefix[HANDSHAKE_NONCE_PREFIX_SIZE];
+    uint64_t txNonceCounter;                        // Paquets chiffrés avec txContext (jamais réutilisé)
+} SessionKeys;
+
+/**
+ * @brief État de l'échange de clés avec un pair
+ */
+typedef struct {
+    HandshakeMode mode;                             // Mode de notre part courante
+    uint8_t privateKey[X25519_KEY_SIZE];            // Clé éphémère (mode complet)
+    uint8_t localShare[HANDSHAKE_SHARE_SIZE];       // Notre part courante
+    bool localShareUsed;                            // Notre part a déjà produit des clés
+    uint8_t peerShare[HANDSHAKE_SHARE_SIZE];        // Dernière part reçue du pair (renvoyée en écho)
+    bool hasPeerShare;
+    uint8_t usedPeerShare[HANDSHAKE_SHARE_SIZE];    // Part du pair ayant produit les clés actuelles
+    uint8_t sessionId[HANDSHAKE_SESSION_ID_SIZE];   // Session reprise (mode reprise)
+    uint8_t resumeSecret[SHA256_DIGEST_SIZE];       // Secret de la session reprise
+    uint8_t ticketId[HANDSHAKE_SESSION_ID_SIZE];    // Entrée du cache issue des clés actuelles
+    SessionKeys keys;
+} HandshakeState;
+
+/**
+ * @brief Dérive la clé pré-partagée d'un mot de passe (PBKDF2-HMAC-SHA256)
+ * @details Le résultat est gardé en mémoire : réactiver le chiffrement avec le même mot de passe est immédiat.
+ * @param password Mot de passe
+ * @param psk Clé produite
+ */
+void HandshakeDerivePsk(const char* password, uint8_t psk[HANDSHAKE_PSK_SIZE]);
+
+/**
+ * @brief Prépare une nouvelle part pour un pair
+ * @details Reprend la session en cache pour cette adresse si elle existe, sinon tire une clé X25519 éphémère.
+ *          Les clés établies précédemment sont effacées.
+ * @param state État du pair
+ * @param peerAddress Adresse du pair
+ * @param peerPort Port du pair
+ * @return false si la source d'aléa du système est indisponible
+ */
+bool HandshakeBegin(HandshakeState* state, const char* peerAddress, int peerPort);
+
+/**
+ * @brief Écrit notre part et son MAC à la suite d'un handshake
+ * @param state État du pair (HandshakeBegin déjà appelé)
+ * @param psk Clé pré-partagée
+ * @param message Handshake complet : WireHandshake puis WIRE_KEY_SHARE_SIZE octets à remplir
+ */
+void HandshakeWriteKeyShare(const HandshakeState* state, const uint8_t psk[HANDSHAKE_PSK_SIZE], uint8_t* message);
+
+/**
+ * @brief Traite la part d'échange de clés d'un handshake reçu
+ * @details Vérifie le MAC, aligne notre mode sur celui du pair si besoin, puis dérive les clés
+ *          de chaque sens par HKDF (sel = clé pré-partagée). Une part locale ne produit des clés
+ *          qu'une seule fois : un nouvel échange du pair entraîne une nouvelle part, jamais une
+ *          réutilisation de nonce.
+ * @param state État du pair
+ * @param psk Clé pré-partagée
+ * @param message Handshake complet reçu (WireHandshake puis WireKeyShare)
+ * @param algorithm Algorithme négocié avec ce pair
+ * @param peerAddress Adresse du pair (cache de sessions)
+ * @param peerPort Port du pair (cache de sessions)
+ * @param replyNeeded Mis à true si le pair n'a pas encore reçu notre part courante
+ * @return Résultat du traitement
+ */
+HandshakeResult HandshakeProcessKeyShare(HandshakeState* state, const uint8_t psk[HANDSHAKE_PSK_SIZE],
+                                         const uint8_t* message, AeadAlgorithm algorithm,
+                                         const char* peerAddress, int peerPort, bool* replyNeeded);
+
+/**
+ * @brief Mémorise dans le ticket de la session la dernière image acquittée par le pair
+ * @details Une reprise de cette session restaure cet état : l'émetteur n'envoie alors que
+ *          les tuiles modifiées depuis cette image, sans repasser par une image complète.
+ * @param state État du pair (clés établies)
+ * @param canvasId Canevas de tuiles acquitté (0 pour oublier l'état)
+ * @param frameId Dernière image acquittée sur ce canevas
+ */
+void HandshakeSetFrameState(const HandshakeState* state, uint32_t canvasId, uint32_t frameId);
+
+/**
+ * @brief Récupère l'état des images enregistré dans le ticket de la session
+ * @param state État du pair (clés établies)
+ * @param canvasId Canevas de tuiles acquitté
+ * @param frameId Dernière image acquittée sur ce canevas
+ * @return false si la session n'a aucune image acquittée
+ */
+bool HandshakeGetFrameState(const HandshakeState* state, uint32_t* canvasId, uint32_t* frameId);
+
+/**
+ * @brief Efface l'état d'un pair (clés comprises)
+ */
+void HandshakeReset(HandshakeState* state);
+
+/**
+ * @brief Oublie la clé pré-partagée et les sessions en cache
+ */
+void HandshakeForgetAll(void);
+
+#endif // HANDSHAKE_H
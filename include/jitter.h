@@ -0,0 +1,74 @@
+#ifndef JITTER_H
+#define JITTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../include/capture.h"
+
+// Images reçues en attente d'affichage au plus, par couche
+#define JITTER_CAPACITY 8
+
+// Retard de lecture visé en mode fluide : multiple de la gigue mesurée, borné
+#define JITTER_DELAY_FACTOR 3
+#define JITTER_MAX_DELAY_MS 150
+
+/**
+ * @brief Politique de présentation des images reçues
+ */
+typedef enum {
+    PLAYOUT_POLICY_LATENCY,     // Latence minimale : l'image complète la plus récente, aussitôt
+    PLAYOUT_POLICY_SMOOTH,      // Fluidité : retard de lecture adapté à la gigue du réseau
+    PLAYOUT_POLICY_COUNT
+} PlayoutPolicy;
+
+/**
+ * @brief Tampon de gigue d'une couche, côté visualiseur
+ * @details Les images restent dans leur ordre d'arrivée, qui est celui de la capture. En mode
+ *          fluide, une image sort à l'heure de sa capture (CaptureData.timestamp, dans l'horloge
+ *          locale) augmentée du transit moyen et du retard de lecture : des écarts de transit
+ *          inférieurs à ce retard n'atteignent plus l'affichage. La gigue est estimée comme en RTP
+ *          (RFC 3550) sur les écarts de transit d'une image à la suivante. Une image dont l'heure
+ *          est passée rend obsolètes celles qui la précèdent : elles sont écartées sans être décodées.
+ */
+typedef struct {
+    CaptureData frames[JITTER_CAPACITY]; // Images en attente, de la plus ancienne à la plus récente
+    int count;
+    bool hasTransit;            // Au moins une image horodatée reçue
+    int64_t lastTransitNs;      // Transit (réception - capture) de la dernière image horodatée
+    int64_t meanTransitNs;      // Transit moyen (moyenne glissante sur 16 images)
+    uint64_t jitterNs;          // Gigue estimée
+} JitterBuffer;
+
+/**
+ * @brief Ajoute une image reçue
+ * @details En mode latence minimale, la plus récente l'emporte : les images en attente sont écartées
+ *          dès son arrivée, sans attendre JitterPop. Tampon plein : la plus ancienne image est écartée.
+ * @param buffer Tampon de la couche
+ * @param frame Image reçue ; le tampon prend possession de compressedData
+ * @param policy Politique de présentation
+ */
+void JitterPush(JitterBuffer* buffer, const CaptureData* frame, PlayoutPolicy policy);
+
+/**
+ * @brief Retire l'image à afficher maintenant, s'il y en a une
+ * @param buffer Tampon de la couche
+ * @param policy Politique de présentation
+ * @param now Heure courante (ClockNowNs)
+ * @param frame Image rendue (compressedData à libérer par l'appelant)
+ * @return true si une image est à afficher, false sinon
+ */
+bool JitterPop(JitterBuffer* buffer, PlayoutPolicy policy, uint64_t now, CaptureData* frame);
+
+/**
+ * @brief Retard de lecture visé en mode fluide (au-delà du transit moyen)
+ * @return Retard en ns, 0 tant qu'aucune image horodatée n'a été reçue
+ */
+uint64_t JitterPlayoutDelayNs(const JitterBuffer* buffer);
+
+/**
+ * @brief Écarte les images en attente et oublie les mesures de transit
+ */
+void JitterReset(JitterBuffer* buffer);
+
+#endif // JITTER_H
@@ -0,0 +1,101 @@
+#ifndef KEYS_H
+#define KEYS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SHA256_BLOCK_SIZE 64
+#define SHA256_DIGEST_SIZE 32
+#define X25519_KEY_SIZE 32
+
+/**
+ * @brief État d'un calcul SHA-256 incrémental
+ */
+typedef struct {
+    uint32_t state[8];
+    uint64_t totalSize;                 // Octets déjà absorbés
+    uint8_t buffer[SHA256_BLOCK_SIZE];  // Bloc partiel en attente
+    size_t bufferSize;
+} Sha256Context;
+
+/**
+ * @brief État d'un calcul HMAC-SHA256 incrémental
+ */
+typedef struct {
+    Sha256Context inner;
+    Sha256Context outer;                // Déjà initialisé avec la clé ^ opad
+} HmacSha256Context;
+
+void Sha256Init(Sha256Context* ctx);
+void Sha256Update(Sha256Context* ctx, const void* data, size_t size);
+void Sha256Final(Sha256Context* ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Calcule le SHA-256 d'un buffer en une fois
+ */
+void Sha256(const void* data, size_t size, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+void HmacSha256Init(HmacSha256Context* ctx, const uint8_t* key, size_t keySize);
+void HmacSha256Update(HmacSha256Context* ctx, const void* data, size_t size);
+void HmacSha256Final(HmacSha256Context* ctx, uint8_t mac[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Calcule un HMAC-SHA256 en une fois (RFC 2104)
+ */
+void HmacSha256(const uint8_t* key, size_t keySize, const void* data, size_t size,
+                uint8_t mac[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Dérive une clé d'un mot de passe (PBKDF2-HMAC-SHA256, RFC 8018)
+ * @details Volontairement coûteux : à appeler une seule fois par mot de passe, jamais par paquet.
+ * @param password Mot de passe
+ * @param passwordSize Longueur du mot de passe
+ * @param salt Sel
+ * @param saltSize Longueur du sel
+ * @param iterations Nombre d'itérations
+ * @param out Clé dérivée
+ * @param outSize Taille de la clé dérivée
+ */
+void Pbkdf2Sha256(const uint8_t* password, size_t passwordSize,
+                  const uint8_t* salt, size_t saltSize,
+                  uint32_t iterations, uint8_t* out, size_t outSize);
+
+/**
+ * @brief Étape d'extraction HKDF-SHA256 (RFC 5869)
+ * @param salt Sel (NULL pour une chaîne de zéros)
+ * @param ikm Matériau de clé d'entrée
+ * @param prk Clé pseudo-aléatoire produite
+ */
+void HkdfSha256Extract(const uint8_t* salt, size_t saltSize,
+                       const uint8_t* ikm, size_t ikmSize,
+                       uint8_t prk[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Étape d'expansion HKDF-SHA256 (RFC 5869)
+ * @param prk Clé pseudo-aléatoire issue de HkdfSha256Extract
+ * @param info Contexte lié à la clé (étiquette, transcription du handshake)
+ * @param out Matériau de clé produit
+ * @param outSize Taille demandée (au plus 255 * 32 octets)
+ * @return false si outSize est trop grand
+ */
+bool HkdfSha256Expand(const uint8_t prk[SHA256_DIGEST_SIZE],
+                      const uint8_t* info, size_t infoSize,
+                      uint8_t* out, size_t outSize);
+
+/**
+ * @brief Produit de Diffie-Hellman X25519 (RFC 7748)
+ * @param shared Secret partagé produit
+ * @param scalar Clé privée (32 octets aléatoires, bornée en interne)
+ * @param point Clé publique du pair
+ * @return false si le résultat est nul (point de petit ordre fourni par le pair)
+ */
+bool X25519(uint8_t shared[X25519_KEY_SIZE], const uint8_t scalar[X25519_KEY_SIZE],
+            const uint8_t point[X25519_KEY_SIZE]);
+
+/**
+ * @brief Calcule la clé publique X25519 associée à une clé privée
+ */
+void X25519PublicKey(uint8_t publicKey[X25519_KEY_SIZE], const uint8_t privateKey[X25519_KEY_SIZE]);
+
+#endif // KEYS_H
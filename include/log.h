@@ -0,0 +1,100 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/**
+ * @brief Niveaux de journalisation, du plus bavard au plus grave
+ */
+typedef enum {
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_NONE          // Désactive complètement un module
+} LogLevel;
+
+/**
+ * @brief Modules filtrables indépendamment
+ */
+typedef enum {
+    LOG_MODULE_APP,         // Application et interface (main.c)
+    LOG_MODULE_CAPTURE,     // Capture et compression
+    LOG_MODULE_NETWORK,     // Réseau et protocole
+    LOG_MODULE_STATS,       // Instrumentation et traces
+    LOG_MODULE_COUNT
+} LogModule;
+
+// Limitation de débit par appel : au plus LOG_RATE_LIMIT_BURST messages par fenêtre
+#define LOG_RATE_LIMIT_BURST 5
+#define LOG_RATE_LIMIT_WINDOW_NS 1000000000ULL
+
+/**
+ * @brief État de limitation de débit propre à un point d'appel (voir LOG_AT)
+ */
+typedef struct {
+    _Atomic uint64_t windowStartNs;     // Début de la fenêtre courante
+    _Atomic uint32_t count;             // Messages émis dans la fenêtre
+    _Atomic uint32_t suppressed;        // Messages écartés depuis le dernier émis
+} LogRateLimit;
+
+/**
+ * @brief Démarre le thread d'écriture des journaux
+ * @details Avant LogInit et après LogShutdown, les messages sont écrits directement (synchrone).
+ * @param filePath Fichier de journal supplémentaire (NULL pour la console uniquement)
+ * @return true si le thread d'écriture a démarré, false sinon
+ */
+bool LogInit(const char* filePath);
+
+/**
+ * @brief Vide la file, arrête le thread d'écriture et ferme le fichier de journal
+ */
+void LogShutdown(void);
+
+/**
+ * @brief Définit le niveau minimal d'un module
+ */
+void LogSetLevel(LogModule module, LogLevel level);
+
+/**
+ * @brief Définit le niveau minimal de tous les modules
+ */
+void LogSetAllLevels(LogLevel level);
+
+/**
+ * @brief Applique une règle de filtrage textuelle
+ * @param spec "niveau" pour tous les modules, ou "module=niveau" (ex: "network=debug")
+ * @return true si la règle est valide, false sinon
+ */
+bool LogConfigure(const char* spec);
+
+/**
+ * @brief Indique si un message de ce niveau serait émis pour ce module
+ */
+bool LogIsEnabled(LogModule module, LogLevel level);
+
+/**
+ * @brief Formate un message et le place dans la file (sans verrou, sans E/S)
+ * @details Utiliser les macros LOG_* qui fournissent l'état de limitation du point d'appel.
+ *          Si la file est pleine, le message est perdu et compté plutôt que de bloquer.
+ */
+void LogWrite(LogLevel level, LogModule module, LogRateLimit* site, const char* format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+// Chaque point d'appel possède son propre état de limitation de débit
+#define LOG_AT(level, module, ...)                                  \
+    do {                                                            \
+        static LogRateLimit logSite;                                \
+        if (LogIsEnabled(module, level)) {                          \
+            LogWrite(level, module, &logSite, __VA_ARGS__);         \
+        }                                                           \
+    } while (0)
+
+#define LOG_DEBUG(module, ...)   LOG_AT(LOG_LEVEL_DEBUG, module, __VA_ARGS__)
+#define LOG_INFO(module, ...)    LOG_AT(LOG_LEVEL_INFO, module, __VA_ARGS__)
+#define LOG_WARNING(module, ...) LOG_AT(LOG_LEVEL_WARNING, module, __VA_ARGS__)
+#define LOG_ERROR(module, ...)   LOG_AT(LOG_LEVEL_ERROR, module, __VA_ARGS__)
+
+#endif // LOG_H
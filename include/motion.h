@@ -0,0 +1,46 @@
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Rectangles de copie au plus par image
+#define MOTION_MAX_RECTS 16
+
+// Hauteur (ou largeur) minimale d'une bande copiée : en dessous, renvoyer les tuiles coûte moins cher
+#define MOTION_MIN_RUN 16
+
+// Lignes concordantes minimales pour retenir un décalage (évite les coïncidences sur du texte répété)
+#define MOTION_MIN_VOTES 8
+
+/**
+ * @brief Rectangle de pixels, ou copie d'un rectangle d'une position à une autre
+ */
+typedef struct {
+    int srcX;                   // Coin haut gauche de la source
+    int srcY;
+    int dstX;                   // Coin haut gauche de la destination
+    int dstY;
+    int width;
+    int height;
+} MotionRect;
+
+/**
+ * @brief Cherche un défilement entre l'image de référence et l'image courante
+ * @details Les lignes (puis les colonnes si aucun défilement vertical n'est trouvé) de la zone
+ *          sont réduites à une empreinte ; chaque ligne courante retrouvée dans la référence vote
+ *          pour un décalage. Avec le décalage majoritaire, les bandes de lignes identiques
+ *          (vérifiées octet par octet) deviennent des copies de rectangles.
+ * @param reference Image précédente (RGBA, width * height pixels)
+ * @param current Image courante (RGBA, mêmes dimensions)
+ * @param width Largeur des images
+ * @param height Hauteur des images
+ * @param area Zone à analyser (srcX, srcY, width, height ; les champs dst sont ignorés)
+ * @param rects Copies trouvées : la destination dans l'image courante égale la source dans la référence
+ * @param maxRects Taille du tableau rects
+ * @return Nombre de copies trouvées (0 si aucun défilement)
+ */
+int MotionDetect(const uint8_t* reference, const uint8_t* current, int width, int height,
+                 MotionRect area, MotionRect* rects, int maxRects);
+
+#endif // MOTION_H
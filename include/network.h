@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include "../include/capture.h"
+#include "../include/jitter.h"
 
 /**
  * @brief Structure contenant les informations d'un pair connecté
@@ -15,15 +16,15 @@ typedef struct {
     char address[64];           // Adresse IP du pair
     int port;                   // Port du pair
     bool isConnected;           // État de la connexion
-    uint64_t lastPacketTime;    // Horodatage du dernier paquet reçu
+    uint64_t lastPacketTime;    // Horodatage monotone du dernier paquet reçu (ns)
 } Peer;
 
 /**
  * @brief Structure contenant les informations de session pour le chiffrement
+ * @details Les clés de chaque sens sont propres à chaque pair et établies au handshake (voir handshake.h).
  */
 typedef struct {
-    uint8_t key[32];            // Clé de chiffrement
-    uint8_t iv[16];             // Vecteur d'initialisation
+    uint8_t psk[32];            // Clé dérivée du mot de passe (PBKDF2), authentifie l'échange de clés
     bool isEncryptionEnabled;   // Indique si le chiffrement est activé
 } EncryptionSession;
 
@@ -61,6 +62,133 @@ void DisconnectFromPeer(int peerId);
  */
 bool SendCaptureData(int peerId, const CaptureData* captureData);
 
+/**
+ * @brief Récupère la prochaine image reçue d'un pair à afficher
+ * @details Les images de chaque couche passent par un tampon de gigue (jitter.h) : selon la politique
+ * de présentation (SetPlayoutPolicy), la plus récente sort aussitôt ou à l'heure de lecture prévue, les
+ * précédentes sont écartées. Une image plus ancienne que la dernière reçue de la même couche est écartée
+ * dès sa réception. À appeler jusqu'à false, la zone entière est rendue avant la région détaillée
+ * (CaptureData.layer). Les horodatages sont convertis dans l'horloge locale ; timestamp vaut 0 tant que
+ * l'horloge de l'émetteur n'est pas synchronisée.
+ * @param captureData Structure remplie avec les données compressées (à libérer avec UnloadCaptureData)
+ * @return true si une nouvelle image est à afficher, false sinon
+ */
+bool ReceiveCaptureData(CaptureData* captureData);
+
+/**
+ * @brief Choisit la politique de présentation des images reçues, modifiable à tout moment
+ * @param policy Latence minimale ou fluidité
+ */
+void SetPlayoutPolicy(PlayoutPolicy policy);
+
+/**
+ * @brief Politique de présentation courante
+ */
+PlayoutPolicy GetPlayoutPolicy(void);
+
+/**
+ * @brief Retard de lecture visé en mode fluide pour la zone entière
+ * @param jitterNs Gigue estimée (peut être NULL)
+ * @return Retard ajouté au transit moyen (ns), 0 tant qu'aucune image horodatée n'a été reçue
+ */
+uint64_t GetPlayoutDelayNs(uint64_t* jitterNs);
+
+/**
+ * @brief Dernière image acquittée par les visualiseurs sur un canevas de tuiles
+ * @details Sert d'image de référence (CaptureData.baseFrameId) : seules les tuiles modifiées
+ *          depuis sont envoyées. Après une reprise de session, l'acquittement enregistré dans
+ *          le ticket est restauré sans attendre le visualiseur.
+ * @param peerId ID du pair destinataire (-1 pour tous les pairs connectés : le plus en retard)
+ * @param canvasId Canevas de tuiles courant (GetCaptureCanvasId)
+ * @return Image acquittée, 0 si un destinataire n'a rien acquitté sur ce canevas (image complète)
+ */
+uint32_t GetAcknowledgedFrame(int peerId, uint32_t canvasId);
+
+/**
+ * @brief Images appliquées par tous les visualiseurs, en remontant depuis l'image de référence
+ * @details Construit à partir de chaque acquittement reçu : une image dont l'acquittement est
+ *          perdu paraît simplement non appliquée. Sert à confirmer les tuiles mises en cache.
+ * @param peerId ID du pair destinataire (-1 pour tous les pairs connectés)
+ * @param canvasId Canevas de tuiles courant (GetCaptureCanvasId)
+ * @param baseFrameId Image de référence (GetAcknowledgedFrame)
+ * @return Bit i : image baseFrameId - i appliquée par tous les destinataires (0 si inconnu)
+ */
+uint64_t GetAppliedFrames(int peerId, uint32_t canvasId, uint32_t baseFrameId);
+
+/**
+ * @brief Codecs que le ou les visualiseurs savent décoder, annoncés dans leur handshake
+ * @param peerId ID du pair destinataire (-1 pour tous les pairs connectés : codecs communs)
+ * @return Masque de CODEC_SUPPORT_BIT, 0 si inconnu (voir CodecSelect)
+ */
+uint32_t GetPeerCodecSupport(int peerId);
+
+/**
+ * @brief Affichage du ou des visualiseurs, pour ne pas envoyer plus de pixels qu'ils n'en affichent
+ * @details Plusieurs destinataires : la plus grande fenêtre et l'union des régions zoomées, la zone
+ *          entière (regionWidth à 0) dès que l'un d'eux ne zoome pas.
+ * @param peerId ID du pair destinataire (-1 pour tous les pairs connectés)
+ * @param viewport Taille d'affichage et région visible
+ * @return true si tous les destinataires l'ont annoncé, false sinon (aucune réduction)
+ */
+bool GetPeerViewport(int peerId, ViewerViewport* viewport);
+
+/**
+ * @brief Annonce l'affichage de ce visualiseur aux émetteurs (voir ScaleCaptureData, ExtractCaptureRegion)
+ * @details Envoyé aux pairs connectés s'il change, puis à chaque nouvelle connexion.
+ * @param viewport Taille de la zone d'affichage (0 : pas de limite) et région visible en pixels
+ *                 de la capture (regionWidth à 0 : capture entière)
+ * @return true si tous les pairs prêts l'ont reçu, false sinon
+ */
+bool SetViewerViewport(const ViewerViewport* viewport);
+
+/**
+ * @brief Acquitte une image appliquée par le visualiseur
+ * @details Le dernier acquittement est renvoyé à chaque nouvelle connexion : un visualiseur qui se
+ *          reconnecte ne reçoit que les tuiles modifiées depuis, même sans reprise de session.
+ * @param peerId ID du pair émetteur de l'image
+ * @param layer Couche de l'image (seule la zone entière est renvoyée à la reconnexion)
+ * @param canvasId Canevas reproduit (0 pour demander une image complète)
+ * @param frameId Image appliquée sur ce canevas
+ * @return true si l'acquittement a été envoyé, false sinon
+ */
+bool AcknowledgeCaptureFrame(int peerId, CaptureLayer layer, uint32_t canvasId, uint32_t frameId);
+
+/**
+ * @brief Envoie la position du curseur
+ * @details Flux dédié et sans garantie, à appeler à chaque mouvement indépendamment des captures.
+ * @param peerId ID du pair destinataire (-1 pour tous les pairs)
+ * @param state Position et forme courantes
+ * @return true si l'envoi réussit, false sinon
+ */
+bool SendCursorState(int peerId, const CursorState* state);
+
+/**
+ * @brief Envoie une forme de curseur
+ * @details À appeler quand la forme change ; un visualiseur qui ne la connaît pas la redemande.
+ * @param peerId ID du pair destinataire (-1 pour tous les pairs)
+ * @param shape Forme à envoyer
+ * @return true si l'envoi réussit, false sinon
+ */
+bool SendCursorShape(int peerId, const CursorShape* shape);
+
+/**
+ * @brief Récupère la dernière position du curseur reçue
+ * @details La forme correspondante est cherchée avec CursorCacheFind ; elle est demandée
+ *          automatiquement à l'émetteur si elle manque.
+ * @param state Position et forme reçues
+ * @return true si une nouvelle position est disponible, false sinon
+ */
+bool ReceiveCursorState(CursorState* state);
+
+/**
+ * @brief Obtient l'estimation du décalage d'horloge avec un pair
+ * @param peerId ID du pair
+ * @param offsetNs Décalage horloge distante - horloge locale en ns (peut être NULL)
+ * @param rttNs Temps d'aller-retour de la meilleure mesure en ns (peut être NULL)
+ * @return true si une estimation est disponible, false sinon
+ */
+bool GetPeerClockOffset(int peerId, int64_t* offsetNs, uint64_t* rttNs);
+
 /**
  * @brief Reçoit et traite les paquets entrants
  * @return Nombre de paquets traités
@@ -69,7 +197,9 @@ int ProcessNetworkEvents(void);
 
 /**
  * @brief Active le chiffrement pour la session
- * @param password Mot de passe utilisé pour générer la clé de chiffrement
+ * @details Lance un échange de clés X25519 authentifié par le mot de passe avec chaque pair connecté ;
+ *          les pairs suivants l'effectuent à la connexion.
+ * @param password Mot de passe partagé par les pairs
  * @return true si l'activation réussit, false sinon
  */
 bool EnableEncryption(const char* password);
@@ -80,17 +210,25 @@ bool EnableEncryption(const char* password);
 void DisableEncryption(void);
 
 /**
- * @brief Chiffre les données d'une capture
- * @param captureData Pointeur vers la structure CaptureData à chiffrer
- * @return true si le chiffrement réussit, false sinon
+ * @brief Nom de l'algorithme de chiffrement utilisé vers un pair
+ * @details Les paquets sont chiffrés en place à l'envoi dans SendCaptureData (vers un second buffer
+ *          tant que d'autres pairs attendent la même image en clair) et déchiffrés en place dans le
+ *          paquet ENet reçu par ProcessNetworkEvents.
+ * @param peerId ID du pair
+ * @return Nom de l'algorithme, "aucun" si aucune clé de session n'est établie avec ce pair
  */
-bool EncryptCaptureData(CaptureData* captureData);
+const char* GetPeerCipherName(int peerId);
 
 /**
- * @brief Déchiffre les données d'une capture
- * @param captureData Pointeur vers la structure CaptureData à déchiffrer
- * @return true si le déchiffrement réussit, false sinon
+ * @brief Soumet des paquets valides puis altérés et tronqués à tous les analyseurs du format réseau
+ * @details Sans réseau ni fenêtre : WireParsePacket, puis chaque vue (métadonnées de capture, images
+ *          en tuiles et vidéo, contrôle, curseur, handshake) et l'analyse d'image de chaque codec.
+ *          Les paquets sont alloués à leur taille exacte, à compiler avec -fsanitize=address pour
+ *          détecter toute lecture hors limites. Le bilan est dans le journal.
+ * @param iterations Paquets altérés à soumettre
+ * @return true si tous les paquets valides sont acceptés et qu'aucun paquet accepté n'annonce plus de
+ *         données qu'il n'en contient
  */
-bool DecryptCaptureData(CaptureData* captureData);
+bool RunNetworkSelfTest(int iterations);
 
 #endif // NETWORK_H
\ No newline at end of file
@@ -0,0 +1,753 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @brief Format des paquets sur le réseau
+ * @details Toutes les structures sont empaquetées (aucun remplissage), tous les entiers
+ * sont en little-endian. Les structures ci-dessous ne servent qu'à documenter la disposition
+ * et à calculer les offsets : la lecture se fait directement dans le buffer reçu via les
+ * accesseurs Wire*, sans copie ni problème d'alignement.
+ * La version est incrémentée à chaque changement de disposition d'un message : un pair d'une
+ * autre version est refusé dès l'en-tête (WIRE_ERROR_VERSION) au lieu de lire des champs décalés.
+ * Version 2 : couche et zone source dans les métadonnées de capture (40 octets), couche dans
+ * l'acquittement d'image (10 octets), région agrandie dans la taille d'affichage (13 octets).
+ */
+#define PROTOCOL_VERSION 2
+
+// Types de paquet (octet `type` de l'en-tête)
+#define PACKET_TYPE_CAPTURE   1
+#define PACKET_TYPE_CONTROL   2
+#define PACKET_TYPE_HANDSHAKE 3
+#define PACKET_TYPE_CURSOR    4
+
+// Flux logiques : chaque flux possède son propre numéro de séquence 32 bits par pair
+typedef enum {
+    PACKET_STREAM_CAPTURE = 0,  // Images capturées
+    PACKET_STREAM_CONTROL,      // Messages de contrôle
+    PACKET_STREAM_HANDSHAKE,    // Établissement de session
+    PACKET_STREAM_CURSOR,       // Position du curseur (seule la plus récente compte)
+    PACKET_STREAM_COUNT
+} PacketStream;
+
+#pragma pack(push, 1)
+
+/**
+ * @brief En-tête commun à tous les paquets (20 octets)
+ */
+typedef struct {
+    uint8_t version;        // Version du protocole (PROTOCOL_VERSION)
+    uint8_t type;           // Type de paquet (PACKET_TYPE_*)
+    uint8_t flags;          // Drapeaux spécifiques au type de paquet
+    uint8_t stream;         // Flux logique (PacketStream)
+    uint32_t sequence;      // Numéro de séquence propre au flux
+    uint64_t timestampUs;   // Horodatage d'envoi en microsecondes
+    uint32_t dataSize;      // Taille des données qui suivent l'en-tête
+} WirePacketHeader;
+
+/**
+ * @brief Métadonnées d'une capture, en tête des données d'un paquet PACKET_TYPE_CAPTURE (40 octets)
+ * @details width x height est l'image transmise ; sourceWidth x sourceHeight, la zone qu'elle représente,
+ * placée en (sourceX, sourceY) dans la zone capturée. Le visualiseur agrandit l'image à la taille source
+ * si l'émetteur l'a réduite (voir scale.h). Une couche de détail (voir CaptureLayer) ne couvre que la
+ * région affichée par le visualiseur, sur son propre canevas, par-dessus l'aperçu de la zone entière.
+ */
+typedef struct {
+    uint32_t frameId;       // Identifiant croissant de l'image
+    uint16_t width;         // Largeur de l'image
+    uint16_t height;        // Hauteur de l'image
+    uint16_t sourceWidth;   // Largeur de la zone capturée, avant réduction
+    uint16_t sourceHeight;  // Hauteur de la zone capturée, avant réduction
+    uint16_t sourceX;       // Position de cette zone dans la zone capturée (0 pour la couche entière)
+    uint16_t sourceY;
+    uint32_t dataSize;      // Taille des données compressées qui suivent
+    uint8_t flags;          // WIRE_CAPTURE_FLAG_*
+    int8_t monitorIndex;    // Index du moniteur capturé (-1 si combiné)
+    uint8_t codec;          // Codec des données (CodecId) : format de ce qui suit
+    uint8_t layer;          // Couche de l'image (CaptureLayer) : un canevas par couche
+    uint64_t captureUs;     // Horodatage de la capture en microsecondes (horloge monotone de l'émetteur)
+    uint32_t encodeStartUs; // Début de l'encodage, relatif à captureUs
+    uint32_t encodeEndUs;   // Fin de l'encodage, relatif à captureUs
+} WireCaptureMetadata;
+
+/**
+ * @brief Image découpée en tuiles, données d'un paquet de capture du codec CODEC_ID_TILES (20 octets)
+ * @details Si copyCount > 0, suivie de l'image source des copies (uint32) et de copyCount WireCopyRect,
+ * appliquées avant les tuiles. Puis cachedCount WireCachedTile, tuiles reprises du cache du visualiseur ;
+ * tileCount indices de tuiles transmises (uint16) ; pour chacune, l'emplacement du cache où la conserver
+ * (uint16, TILE_CACHE_NO_SLOT sinon). Les codedCount premières sont codées sans perte : leur codec (uint8,
+ * TileCodec), leur taille (uint16) puis leurs données. Les autres sont regroupées dans une seule image
+ * JPEG de atlasColumns tuiles de large.
+ */
+typedef struct {
+    uint32_t canvasId;      // Canevas de l'émetteur (change avec les dimensions capturées)
+    uint32_t baseFrameId;   // Image que le visualiseur doit déjà avoir (0 = image complète)
+    uint16_t tileSize;      // Côté d'une tuile en pixels
+    uint16_t tileCount;     // Nombre de tuiles transmises
+    uint16_t atlasColumns;  // Tuiles par ligne dans l'image JPEG
+    uint16_t copyCount;     // Rectangles copiés dans le canevas (défilement)
+    uint16_t cachedCount;   // Tuiles reprises du cache du visualiseur
+    uint16_t codedCount;    // Tuiles transmises codées sans perte, hors de l'image JPEG
+} WireTileFrame;
+
+/**
+ * @brief Image vidéo, données d'un paquet de capture du codec CODEC_ID_VIDEO (12 octets)
+ * @details Suivie de sliceCount tailles (uint32) puis des tranches : lignes de macroblocs de 16x16 pixels
+ * codées chacune sans dépendre des autres (voir video.h). Une image P se décode à partir de la reconstruction
+ * de referenceFrameId, que le visualiseur a acquittée.
+ */
+typedef struct {
+    uint32_t streamId;          // Flux vidéo de l'émetteur (change avec les dimensions capturées)
+    uint32_t referenceFrameId;  // Image de référence d'une image P (0 = image I, décodable seule)
+    uint8_t qp;                 // Quantificateur (0-51, le pas double tous les 6)
+    uint8_t sliceCount;         // Tranches de l'image
+    uint16_t reserved;          // Réservé (0)
+} WireVideoFrame;
+
+/**
+ * @brief Copie d'un rectangle du canevas, pour un défilement (12 octets)
+ * @details Les sources désignent le canevas tel qu'il était à l'image source des copies,
+ * avant toute copie de la même image.
+ */
+typedef struct {
+    uint16_t srcX;          // Coin haut gauche de la source
+    uint16_t srcY;
+    uint16_t dstX;          // Coin haut gauche de la destination
+    uint16_t dstY;
+    uint16_t width;         // Dimensions du rectangle
+    uint16_t height;
+} WireCopyRect;
+
+/**
+ * @brief Tuile reprise du cache du visualiseur (4 octets)
+ * @details Appliquée avant les tuiles transmises, qui peuvent réattribuer l'emplacement.
+ */
+typedef struct {
+    uint16_t tile;          // Indice de la tuile dans le canevas
+    uint16_t slot;          // Emplacement du cache qui la contient
+} WireCachedTile;
+
+/**
+ * @brief Acquittement d'une image par le visualiseur (10 octets)
+ * @details canvasId = 0 demande une image complète de la couche (référence perdue).
+ */
+typedef struct {
+    uint8_t controlType;    // CONTROL_TYPE_FRAME_ACK
+    uint8_t layer;          // Couche acquittée (CaptureLayer)
+    uint32_t canvasId;      // Canevas reproduit par le visualiseur
+    uint32_t frameId;       // Dernière image appliquée sur ce canevas
+} WireFrameAck;
+
+/**
+ * @brief Position du curseur, données d'un paquet PACKET_TYPE_CURSOR (10 octets)
+ * @details Envoyée sans garantie à chaque mouvement : un paquet perdu est remplacé par le suivant.
+ */
+typedef struct {
+    uint8_t flags;          // WIRE_CURSOR_FLAG_*
+    uint8_t reserved;       // Réservé (0)
+    int16_t x;              // Point actif, relatif à la zone capturée
+    int16_t y;
+    uint32_t shapeId;       // Forme affichée (empreinte du contenu)
+} WireCursorPosition;
+
+/**
+ * @brief Forme du curseur, message de contrôle envoyé quand elle change (13 octets)
+ * @details Suivie de width * height pixels RGBA.
+ */
+typedef struct {
+    uint8_t controlType;    // CONTROL_TYPE_CURSOR_SHAPE
+    uint32_t shapeId;       // Empreinte du contenu
+    uint16_t width;         // Dimensions en pixels
+    uint16_t height;
+    uint16_t hotspotX;      // Point actif
+    uint16_t hotspotY;
+} WireCursorShape;
+
+/**
+ * @brief Demande d'une forme de curseur absente du cache du visualiseur (5 octets)
+ */
+typedef struct {
+    uint8_t controlType;    // CONTROL_TYPE_CURSOR_REQUEST
+    uint32_t shapeId;       // Forme demandée
+} WireCursorRequest;
+
+/**
+ * @brief Affichage du visualiseur, envoyé quand sa fenêtre ou son zoom change (13 octets)
+ * @details L'émetteur n'envoie pas plus de pixels que la fenêtre n'en affiche. 0 x 0 : pas de limite.
+ * Une région non vide (zoom) est envoyée à part à cette résolution, le reste en aperçu réduit.
+ */
+typedef struct {
+    uint8_t controlType;    // CONTROL_TYPE_VIEWPORT
+    uint16_t width;         // Zone d'affichage en pixels
+    uint16_t height;
+    uint16_t regionX;       // Région affichée, en pixels de la zone capturée par l'émetteur
+    uint16_t regionY;
+    uint16_t regionWidth;   // 0 : zone capturée entière
+    uint16_t regionHeight;
+} WireViewport;
+
+/**
+ * @brief Message de contrôle ping/pong pour l'estimation du décalage d'horloge (25 octets)
+ * @details Un ping ne renseigne que t0 ; le pong renvoie t0 et ajoute t1/t2 de l'horloge du répondeur.
+ */
+typedef struct {
+    uint8_t controlType;    // CONTROL_TYPE_PING ou CONTROL_TYPE_PONG
+    uint64_t t0Us;          // Envoi du ping (horloge de l'initiateur)
+    uint64_t t1Us;          // Réception du ping (horloge du répondeur)
+    uint64_t t2Us;          // Envoi du pong (horloge du répondeur)
+} WireClockSync;
+
+/**
+ * @brief Début d'un paquet PACKET_TYPE_HANDSHAKE, toujours en clair (26 octets)
+ */
+typedef struct {
+    char magic[24];         // WIRE_HANDSHAKE_MAGIC, zéro final compris
+    uint8_t aeadSupport;    // Masque des algorithmes AEAD supportés (AEAD_SUPPORT_BIT)
+    uint8_t codecSupport;   // Masque des codecs que l'on sait décoder (CODEC_SUPPORT_BIT)
+} WireHandshake;
+
+/**
+ * @brief Part d'échange de clés, après WireHandshake si le chiffrement est activé chez l'émetteur (97 octets)
+ * @details Le MAC couvre tout le handshake qui le précède (algorithmes annoncés compris).
+ */
+typedef struct {
+    uint8_t mode;           // HANDSHAKE_MODE_FULL ou HANDSHAKE_MODE_RESUME
+    uint8_t share[32];      // Clé publique X25519 éphémère (complet) ou aléa (reprise)
+    uint8_t echo[32];       // Dernière part reçue du pair (zéros si aucune)
+    uint8_t sessionId[16];  // Session à reprendre (zéros en mode complet)
+    uint8_t mac[16];        // HMAC-SHA256(clé du mot de passe, handshake jusqu'ici), tronqué
+} WireKeyShare;
+
+#pragma pack(pop)
+
+_Static_assert(sizeof(WirePacketHeader) == 20, "WirePacketHeader doit faire 20 octets");
+_Static_assert(sizeof(WireCaptureMetadata) == 40, "WireCaptureMetadata doit faire 40 octets");
+_Static_assert(sizeof(WireTileFrame) == 20, "WireTileFrame doit faire 20 octets");
+_Static_assert(sizeof(WireVideoFrame) == 12, "WireVideoFrame doit faire 12 octets");
+_Static_assert(sizeof(WireCopyRect) == 12, "WireCopyRect doit faire 12 octets");
+_Static_assert(sizeof(WireCachedTile) == 4, "WireCachedTile doit faire 4 octets");
+_Static_assert(sizeof(WireFrameAck) == 10, "WireFrameAck doit faire 10 octets");
+_Static_assert(sizeof(WireCursorPosition) == 10, "WireCursorPosition doit faire 10 octets");
+_Static_assert(sizeof(WireCursorShape) == 13, "WireCursorShape doit faire 13 octets");
+_Static_assert(sizeof(WireCursorRequest) == 5, "WireCursorRequest doit faire 5 octets");
+_Static_assert(sizeof(WireViewport) == 13, "WireViewport doit faire 13 octets");
+_Static_assert(sizeof(WireClockSync) == 25, "WireClockSync doit faire 25 octets");
+_Static_assert(sizeof(WireHandshake) == 26, "WireHandshake doit faire 26 octets");
+_Static_assert(sizeof(WireKeyShare) == 97, "WireKeyShare doit faire 97 octets");
+
+#define WIRE_HEADER_SIZE ((uint32_t)sizeof(WirePacketHeader))
+#define WIRE_CAPTURE_METADATA_SIZE ((uint32_t)sizeof(WireCaptureMetadata))
+#define WIRE_TILE_FRAME_SIZE ((uint32_t)sizeof(WireTileFrame))
+#define WIRE_VIDEO_FRAME_SIZE ((uint32_t)sizeof(WireVideoFrame))
+#define WIRE_COPY_RECT_SIZE ((uint32_t)sizeof(WireCopyRect))
+#define WIRE_CACHED_TILE_SIZE ((uint32_t)sizeof(WireCachedTile))
+#define WIRE_FRAME_ACK_SIZE ((uint32_t)sizeof(WireFrameAck))
+#define WIRE_CURSOR_POSITION_SIZE ((uint32_t)sizeof(WireCursorPosition))
+#define WIRE_CURSOR_SHAPE_SIZE ((uint32_t)sizeof(WireCursorShape))
+#define WIRE_CURSOR_REQUEST_SIZE ((uint32_t)sizeof(WireCursorRequest))
+#define WIRE_VIEWPORT_SIZE ((uint32_t)sizeof(WireViewport))
+#define WIRE_CLOCK_SYNC_SIZE ((uint32_t)sizeof(WireClockSync))
+#define WIRE_HANDSHAKE_SIZE ((uint32_t)sizeof(WireHandshake))
+#define WIRE_KEY_SHARE_SIZE ((uint32_t)sizeof(WireKeyShare))
+
+#define WIRE_HANDSHAKE_MAGIC "C_Screenshare Handshake"
+
+// Drapeaux de l'en-tête de paquet
+#define WIRE_FLAG_ENCRYPTED 0x01    // Charge utile = nonce | données chiffrées | tag
+#define WIRE_FLAG_AEAD_SHIFT 1      // Bits 1-2 : algorithme AEAD utilisé (AeadAlgorithm)
+#define WIRE_FLAG_AEAD_MASK 0x06
+
+// Surcoût d'une charge utile chiffrée
+#define WIRE_AEAD_NONCE_SIZE 12
+#define WIRE_AEAD_TAG_SIZE 16
+#define WIRE_AEAD_OVERHEAD (WIRE_AEAD_NONCE_SIZE + WIRE_AEAD_TAG_SIZE)
+
+// Drapeaux des métadonnées de capture
+#define WIRE_CAPTURE_FLAG_CHANGED 0x01
+
+// Drapeaux de la position du curseur
+#define WIRE_CURSOR_FLAG_VISIBLE 0x01
+
+// Sous-types des paquets de contrôle (premier octet des données)
+#define CONTROL_TYPE_PING 1
+#define CONTROL_TYPE_PONG 2
+#define CONTROL_TYPE_FRAME_ACK 3
+#define CONTROL_TYPE_CURSOR_SHAPE 4
+#define CONTROL_TYPE_CURSOR_REQUEST 5
+#define CONTROL_TYPE_VIEWPORT 6
+
+/**
+ * @brief Résultat de la validation d'un paquet reçu
+ */
+typedef enum {
+    WIRE_OK = 0,
+    WIRE_ERROR_TOO_SHORT,       // Buffer plus petit que l'en-tête
+    WIRE_ERROR_VERSION,         // Version de protocole inconnue
+    WIRE_ERROR_STREAM,          // Flux hors limites
+    WIRE_ERROR_SIZE             // dataSize incohérent avec la taille reçue
+} WireResult;
+
+/**
+ * @brief Vue sur un paquet reçu (pointe dans le buffer d'origine, aucune copie)
+ */
+typedef struct {
+    const uint8_t* header;      // Début de l'en-tête
+    const uint8_t* payload;     // Début des données
+    uint32_t payloadSize;       // Taille des données (dataSize de l'en-tête)
+} WirePacketView;
+
+// Lecture/écriture little-endian octet par octet : indépendant de l'alignement et de l'endianness de l'hôte
+static inline uint16_t WireReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t WireReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t WireReadU64(const uint8_t* p) {
+    return (uint64_t)WireReadU32(p) | ((uint64_t)WireReadU32(p + 4) << 32);
+}
+
+static inline void WireWriteU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void WireWriteU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void WireWriteU64(uint8_t* p, uint64_t v) {
+    WireWriteU32(p, (uint32_t)v);
+    WireWriteU32(p + 4, (uint32_t)(v >> 32));
+}
+
+#define WIRE_FIELD(type, field) ((size_t)offsetof(type, field))
+
+// Accesseurs de l'en-tête de paquet (h pointe sur un buffer d'au moins WIRE_HEADER_SIZE octets)
+static inline uint8_t WireHeaderVersion(const uint8_t* h) { return h[WIRE_FIELD(WirePacketHeader, version)]; }
+static inline uint8_t WireHeaderType(const uint8_t* h) { return h[WIRE_FIELD(WirePacketHeader, type)]; }
+static inline uint8_t WireHeaderFlags(const uint8_t* h) { return h[WIRE_FIELD(WirePacketHeader, flags)]; }
+static inline uint8_t WireHeaderStream(const uint8_t* h) { return h[WIRE_FIELD(WirePacketHeader, stream)]; }
+static inline uint32_t WireHeaderSequence(const uint8_t* h) { return WireReadU32(h + WIRE_FIELD(WirePacketHeader, sequence)); }
+static inline uint64_t WireHeaderTimestampUs(const uint8_t* h) { return WireReadU64(h + WIRE_FIELD(WirePacketHeader, timestampUs)); }
+static inline uint32_t WireHeaderDataSize(const uint8_t* h) { return WireReadU32(h + WIRE_FIELD(WirePacketHeader, dataSize)); }
+
+/**
+ * @brief Écrit un en-tête de paquet au début d'un buffer
+ */
+static inline void WireWriteHeader(uint8_t* h, uint8_t type, uint8_t flags, uint8_t stream,
+                                   uint32_t sequence, uint64_t timestampUs, uint32_t dataSize) {
+    h[WIRE_FIELD(WirePacketHeader, version)] = PROTOCOL_VERSION;
+    h[WIRE_FIELD(WirePacketHeader, type)] = type;
+    h[WIRE_FIELD(WirePacketHeader, flags)] = flags;
+    h[WIRE_FIELD(WirePacketHeader, stream)] = stream;
+    WireWriteU32(h + WIRE_FIELD(WirePacketHeader, sequence), sequence);
+    WireWriteU64(h + WIRE_FIELD(WirePacketHeader, timestampUs), timestampUs);
+    WireWriteU32(h + WIRE_FIELD(WirePacketHeader, dataSize), dataSize);
+}
+
+/**
+ * @brief Valide un paquet reçu et construit une vue dessus
+ * @param data Buffer reçu
+ * @param size Taille du buffer
+ * @param view Vue remplie en cas de succès
+ * @return WIRE_OK si le paquet est exploitable, un code d'erreur sinon
+ */
+static inline WireResult WireParsePacket(const uint8_t* data, size_t size, WirePacketView* view) {
+    if (!data || size < WIRE_HEADER_SIZE) return WIRE_ERROR_TOO_SHORT;
+    if (WireHeaderVersion(data) != PROTOCOL_VERSION) return WIRE_ERROR_VERSION;
+    if (WireHeaderStream(data) >= PACKET_STREAM_COUNT) return WIRE_ERROR_STREAM;
+    
+    uint32_t dataSize = WireHeaderDataSize(data);
+    if (dataSize > size - WIRE_HEADER_SIZE) return WIRE_ERROR_SIZE;
+    
+    view->header = data;
+    view->payload = data + WIRE_HEADER_SIZE;
+    view->payloadSize = dataSize;
+    return WIRE_OK;
+}
+
+// Accesseurs des métadonnées de capture (m pointe sur au moins WIRE_CAPTURE_METADATA_SIZE octets)
+static inline uint32_t WireCaptureFrameId(const uint8_t* m) { return WireReadU32(m + WIRE_FIELD(WireCaptureMetadata, frameId)); }
+static inline uint16_t WireCaptureWidth(const uint8_t* m) { return WireReadU16(m + WIRE_FIELD(WireCaptureMetadata, width)); }
+static inline uint16_t WireCaptureHeight(const uint8_t* m) { return WireReadU16(m + WIRE_FIELD(WireCaptureMetadata, height)); }
+static inline uint16_t WireCaptureSourceWidth(const uint8_t* m) { return WireReadU16(m + WIRE_FIELD(WireCaptureMetadata, sourceWidth)); }
+static inline uint16_t WireCaptureSourceHeight(const uint8_t* m) { return WireReadU16(m + WIRE_FIELD(WireCaptureMetadata, sourceHeight)); }
+static inline uint16_t WireCaptureSourceX(const uint8_t* m) { return WireReadU16(m + WIRE_FIELD(WireCaptureMetadata, sourceX)); }
+static inline uint16_t WireCaptureSourceY(const uint8_t* m) { return WireReadU16(m + WIRE_FIELD(WireCaptureMetadata, sourceY)); }
+static inline uint32_t WireCaptureDataSize(const uint8_t* m) { return WireReadU32(m + WIRE_FIELD(WireCaptureMetadata, dataSize)); }
+static inline uint8_t WireCaptureFlags(const uint8_t* m) { return m[WIRE_FIELD(WireCaptureMetadata, flags)]; }
+static inline int8_t WireCaptureMonitorIndex(const uint8_t* m) { return (int8_t)m[WIRE_FIELD(WireCaptureMetadata, monitorIndex)]; }
+static inline uint8_t WireCaptureCodec(const uint8_t* m) { return m[WIRE_FIELD(WireCaptureMetadata, codec)]; }
+static inline uint8_t WireCaptureLayer(const uint8_t* m) { return m[WIRE_FIELD(WireCaptureMetadata, layer)]; }
+static inline uint64_t WireCaptureTimestampUs(const uint8_t* m) { return WireReadU64(m + WIRE_FIELD(WireCaptureMetadata, captureUs)); }
+static inline uint32_t WireCaptureEncodeStartUs(const uint8_t* m) { return WireReadU32(m + WIRE_FIELD(WireCaptureMetadata, encodeStartUs)); }
+static inline uint32_t WireCaptureEncodeEndUs(const uint8_t* m) { return WireReadU32(m + WIRE_FIELD(WireCaptureMetadata, encodeEndUs)); }
+
+/**
+ * @brief Écrit les métadonnées de capture au début d'un buffer
+ */
+static inline void WireWriteCaptureMetadata(uint8_t* m, uint32_t frameId, uint16_t width, uint16_t height,
+                                            uint16_t sourceWidth, uint16_t sourceHeight, uint16_t sourceX, uint16_t sourceY,
+                                            uint32_t dataSize, uint8_t flags, int8_t monitorIndex, uint8_t codec, uint8_t layer,
+                                            uint64_t captureUs, uint32_t encodeStartUs, uint32_t encodeEndUs) {
+    WireWriteU32(m + WIRE_FIELD(WireCaptureMetadata, frameId), frameId);
+    WireWriteU16(m + WIRE_FIELD(WireCaptureMetadata, width), width);
+    WireWriteU16(m + WIRE_FIELD(WireCaptureMetadata, height), height);
+    WireWriteU16(m + WIRE_FIELD(WireCaptureMetadata, sourceWidth), sourceWidth);
+    WireWriteU16(m + WIRE_FIELD(WireCaptureMetadata, sourceHeight), sourceHeight);
+    WireWriteU16(m + WIRE_FIELD(WireCaptureMetadata, sourceX), sourceX);
+    WireWriteU16(m + WIRE_FIELD(WireCaptureMetadata, sourceY), sourceY);
+    WireWriteU32(m + WIRE_FIELD(WireCaptureMetadata, dataSize), dataSize);
+    m[WIRE_FIELD(WireCaptureMetadata, flags)] = flags;
+    m[WIRE_FIELD(WireCaptureMetadata, monitorIndex)] = (uint8_t)monitorIndex;
+    m[WIRE_FIELD(WireCaptureMetadata, codec)] = codec;
+    m[WIRE_FIELD(WireCaptureMetadata, layer)] = layer;
+    WireWriteU64(m + WIRE_FIELD(WireCaptureMetadata, captureUs), captureUs);
+    WireWriteU32(m + WIRE_FIELD(WireCaptureMetadata, encodeStartUs), encodeStartUs);
+    WireWriteU32(m + WIRE_FIELD(WireCaptureMetadata, encodeEndUs), encodeEndUs);
+}
+
+/**
+ * @brief Vérifie que des données de capture contiennent des métadonnées et les données annoncées
+ */
+static inline bool WireCaptureValidate(const uint8_t* payload, uint32_t size) {
+    if (!payload || size < WIRE_CAPTURE_METADATA_SIZE) return false;
+    if (WireCaptureWidth(payload) == 0 || WireCaptureHeight(payload) == 0) return false;
+    if (WireCaptureSourceWidth(payload) < WireCaptureWidth(payload) ||
+        WireCaptureSourceHeight(payload) < WireCaptureHeight(payload)) return false;
+    return WireCaptureDataSize(payload) <= size - WIRE_CAPTURE_METADATA_SIZE;
+}
+
+// Accesseurs de l'image en tuiles (t pointe sur au moins WIRE_TILE_FRAME_SIZE octets)
+static inline uint32_t WireTileFrameCanvasId(const uint8_t* t) { return WireReadU32(t + WIRE_FIELD(WireTileFrame, canvasId)); }
+static inline uint32_t WireTileFrameBaseFrameId(const uint8_t* t) { return WireReadU32(t + WIRE_FIELD(WireTileFrame, baseFrameId)); }
+static inline uint16_t WireTileFrameTileSize(const uint8_t* t) { return WireReadU16(t + WIRE_FIELD(WireTileFrame, tileSize)); }
+static inline uint16_t WireTileFrameTileCount(const uint8_t* t) { return WireReadU16(t + WIRE_FIELD(WireTileFrame, tileCount)); }
+static inline uint16_t WireTileFrameAtlasColumns(const uint8_t* t) { return WireReadU16(t + WIRE_FIELD(WireTileFrame, atlasColumns)); }
+static inline uint16_t WireTileFrameCopyCount(const uint8_t* t) { return WireReadU16(t + WIRE_FIELD(WireTileFrame, copyCount)); }
+static inline uint16_t WireTileFrameCachedCount(const uint8_t* t) { return WireReadU16(t + WIRE_FIELD(WireTileFrame, cachedCount)); }
+static inline uint16_t WireTileFrameCodedCount(const uint8_t* t) { return WireReadU16(t + WIRE_FIELD(WireTileFrame, codedCount)); }
+
+// Taille de la liste des copies (image source comprise), 0 sans copie
+static inline uint32_t WireTileFrameCopiesSize(uint32_t copyCount) {
+    return copyCount > 0 ? 4 + copyCount * WIRE_COPY_RECT_SIZE : 0;
+}
+
+// Taille de l'en-tête et de toutes les listes : les données des tuiles codées sans perte commencent juste après
+static inline uint32_t WireTileFrameHeaderSize(uint32_t copyCount, uint32_t cachedCount, uint32_t tileCount,
+                                               uint32_t codedCount) {
+    return WIRE_TILE_FRAME_SIZE + WireTileFrameCopiesSize(copyCount) + cachedCount * WIRE_CACHED_TILE_SIZE +
+           4 * tileCount + 3 * codedCount;
+}
+
+// Offset de la liste des tuiles en cache, suivie des indices puis des emplacements des tuiles transmises
+static inline uint32_t WireTileFrameCachedOffset(uint32_t copyCount) {
+    return WIRE_TILE_FRAME_SIZE + WireTileFrameCopiesSize(copyCount);
+}
+
+static inline uint32_t WireTileFrameIndicesOffset(uint32_t copyCount, uint32_t cachedCount) {
+    return WireTileFrameCachedOffset(copyCount) + cachedCount * WIRE_CACHED_TILE_SIZE;
+}
+
+// Offset des codecs des tuiles codées sans perte, suivis de leurs tailles
+static inline uint32_t WireTileFrameCodecsOffset(uint32_t copyCount, uint32_t cachedCount, uint32_t tileCount) {
+    return WireTileFrameIndicesOffset(copyCount, cachedCount) + 4 * tileCount;
+}
+
+static inline uint32_t WireTileFrameCopySourceFrameId(const uint8_t* t) { return WireReadU32(t + WIRE_TILE_FRAME_SIZE); }
+static inline const uint8_t* WireTileFrameCopyRect(const uint8_t* t, uint32_t i) { return t + WIRE_TILE_FRAME_SIZE + 4 + i * WIRE_COPY_RECT_SIZE; }
+static inline const uint8_t* WireTileFrameCachedTile(const uint8_t* t, uint32_t i) {
+    return t + WireTileFrameCachedOffset(WireTileFrameCopyCount(t)) + i * WIRE_CACHED_TILE_SIZE;
+}
+static inline uint16_t WireTileFrameIndex(const uint8_t* t, uint32_t i) {
+    return WireReadU16(t + WireTileFrameIndicesOffset(WireTileFrameCopyCount(t), WireTileFrameCachedCount(t)) + 2 * i);
+}
+static inline uint16_t WireTileFrameSlot(const uint8_t* t, uint32_t i) {
+    return WireReadU16(t + WireTileFrameIndicesOffset(WireTileFrameCopyCount(t), WireTileFrameCachedCount(t)) +
+                       2 * (uint32_t)WireTileFrameTileCount(t) + 2 * i);
+}
+static inline uint8_t WireTileFrameCodec(const uint8_t* t, uint32_t i) {
+    return t[WireTileFrameCodecsOffset(WireTileFrameCopyCount(t), WireTileFrameCachedCount(t), WireTileFrameTileCount(t)) + i];
+}
+static inline uint16_t WireTileFrameCodedSize(const uint8_t* t, uint32_t i) {
+    return WireReadU16(t + WireTileFrameCodecsOffset(WireTileFrameCopyCount(t), WireTileFrameCachedCount(t), WireTileFrameTileCount(t)) +
+                       WireTileFrameCodedCount(t) + 2 * i);
+}
+
+/**
+ * @brief Écrit l'en-tête d'une image en tuiles (les listes qui suivent sont écrites par l'appelant)
+ */
+static inline void WireWriteTileFrame(uint8_t* t, uint32_t canvasId, uint32_t baseFrameId,
+                                      uint16_t tileSize, uint16_t tileCount, uint16_t atlasColumns,
+                                      uint16_t copyCount, uint16_t cachedCount, uint16_t codedCount) {
+    WireWriteU32(t + WIRE_FIELD(WireTileFrame, canvasId), canvasId);
+    WireWriteU32(t + WIRE_FIELD(WireTileFrame, baseFrameId), baseFrameId);
+    WireWriteU16(t + WIRE_FIELD(WireTileFrame, tileSize), tileSize);
+    WireWriteU16(t + WIRE_FIELD(WireTileFrame, tileCount), tileCount);
+    WireWriteU16(t + WIRE_FIELD(WireTileFrame, atlasColumns), atlasColumns);
+    WireWriteU16(t + WIRE_FIELD(WireTileFrame, copyCount), copyCount);
+    WireWriteU16(t + WIRE_FIELD(WireTileFrame, cachedCount), cachedCount);
+    WireWriteU16(t + WIRE_FIELD(WireTileFrame, codedCount), codedCount);
+}
+
+// Accesseurs d'une copie de rectangle (c pointe sur au moins WIRE_COPY_RECT_SIZE octets)
+static inline uint16_t WireCopyRectSrcX(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCopyRect, srcX)); }
+static inline uint16_t WireCopyRectSrcY(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCopyRect, srcY)); }
+static inline uint16_t WireCopyRectDstX(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCopyRect, dstX)); }
+static inline uint16_t WireCopyRectDstY(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCopyRect, dstY)); }
+static inline uint16_t WireCopyRectWidth(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCopyRect, width)); }
+static inline uint16_t WireCopyRectHeight(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCopyRect, height)); }
+
+/**
+ * @brief Écrit une copie de rectangle
+ */
+static inline void WireWriteCopyRect(uint8_t* c, uint16_t srcX, uint16_t srcY, uint16_t dstX, uint16_t dstY,
+                                     uint16_t width, uint16_t height) {
+    WireWriteU16(c + WIRE_FIELD(WireCopyRect, srcX), srcX);
+    WireWriteU16(c + WIRE_FIELD(WireCopyRect, srcY), srcY);
+    WireWriteU16(c + WIRE_FIELD(WireCopyRect, dstX), dstX);
+    WireWriteU16(c + WIRE_FIELD(WireCopyRect, dstY), dstY);
+    WireWriteU16(c + WIRE_FIELD(WireCopyRect, width), width);
+    WireWriteU16(c + WIRE_FIELD(WireCopyRect, height), height);
+}
+
+// Accesseurs d'une tuile en cache (c pointe sur au moins WIRE_CACHED_TILE_SIZE octets)
+static inline uint16_t WireCachedTileIndex(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCachedTile, tile)); }
+static inline uint16_t WireCachedTileSlot(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCachedTile, slot)); }
+
+/**
+ * @brief Écrit une tuile reprise du cache
+ */
+static inline void WireWriteCachedTile(uint8_t* c, uint16_t tile, uint16_t slot) {
+    WireWriteU16(c + WIRE_FIELD(WireCachedTile, tile), tile);
+    WireWriteU16(c + WIRE_FIELD(WireCachedTile, slot), slot);
+}
+
+/**
+ * @brief Vérifie qu'une image en tuiles contient son en-tête et toutes ses listes
+ * @details Les codecs et les données des tuiles codées sans perte sont vérifiés à l'application.
+ */
+static inline bool WireTileFrameValidate(const uint8_t* t, uint32_t size) {
+    if (!t || size < WIRE_TILE_FRAME_SIZE) return false;
+    if (WireTileFrameCanvasId(t) == 0 || WireTileFrameTileSize(t) == 0) return false;
+    uint32_t tileCount = WireTileFrameTileCount(t);
+    uint32_t codedCount = WireTileFrameCodedCount(t);
+    if (codedCount > tileCount) return false;
+    if (tileCount > codedCount && WireTileFrameAtlasColumns(t) == 0) return false;
+    return WireTileFrameHeaderSize(WireTileFrameCopyCount(t), WireTileFrameCachedCount(t), tileCount, codedCount) <= size;
+}
+
+// Accesseurs de l'image vidéo (v pointe sur au moins WIRE_VIDEO_FRAME_SIZE octets)
+static inline uint32_t WireVideoFrameStreamId(const uint8_t* v) { return WireReadU32(v + WIRE_FIELD(WireVideoFrame, streamId)); }
+static inline uint32_t WireVideoFrameReferenceFrameId(const uint8_t* v) { return WireReadU32(v + WIRE_FIELD(WireVideoFrame, referenceFrameId)); }
+static inline uint8_t WireVideoFrameQp(const uint8_t* v) { return v[WIRE_FIELD(WireVideoFrame, qp)]; }
+static inline uint8_t WireVideoFrameSliceCount(const uint8_t* v) { return v[WIRE_FIELD(WireVideoFrame, sliceCount)]; }
+static inline uint32_t WireVideoFrameSliceSize(const uint8_t* v, uint32_t i) { return WireReadU32(v + WIRE_VIDEO_FRAME_SIZE + 4 * i); }
+
+// Taille de l'en-tête et de la liste des tailles : la première tranche commence juste après
+static inline uint32_t WireVideoFrameHeaderSize(uint32_t sliceCount) {
+    return WIRE_VIDEO_FRAME_SIZE + 4 * sliceCount;
+}
+
+/**
+ * @brief Écrit l'en-tête d'une image vidéo (les tailles des tranches sont écrites par l'appelant)
+ */
+static inline void WireWriteVideoFrame(uint8_t* v, uint32_t streamId, uint32_t referenceFrameId,
+                                       uint8_t qp, uint8_t sliceCount) {
+    WireWriteU32(v + WIRE_FIELD(WireVideoFrame, streamId), streamId);
+    WireWriteU32(v + WIRE_FIELD(WireVideoFrame, referenceFrameId), referenceFrameId);
+    v[WIRE_FIELD(WireVideoFrame, qp)] = qp;
+    v[WIRE_FIELD(WireVideoFrame, sliceCount)] = sliceCount;
+    WireWriteU16(v + WIRE_FIELD(WireVideoFrame, reserved), 0);
+}
+
+/**
+ * @brief Vérifie qu'une image vidéo contient son en-tête et toutes les tranches annoncées
+ */
+static inline bool WireVideoFrameValidate(const uint8_t* v, uint32_t size) {
+    if (!v || size < WIRE_VIDEO_FRAME_SIZE) return false;
+    uint32_t sliceCount = WireVideoFrameSliceCount(v);
+    if (WireVideoFrameStreamId(v) == 0 || sliceCount == 0 || WireVideoFrameQp(v) > 51) return false;
+    if (WireVideoFrameHeaderSize(sliceCount) > size) return false;
+    uint32_t remaining = size - WireVideoFrameHeaderSize(sliceCount);
+    for (uint32_t i = 0; i < sliceCount; i++) {
+        uint32_t sliceSize = WireVideoFrameSliceSize(v, i);
+        if (sliceSize > remaining) return false;
+        remaining -= sliceSize;
+    }
+    return true;
+}
+
+// Accesseurs de l'acquittement d'image (a pointe sur au moins WIRE_FRAME_ACK_SIZE octets)
+static inline uint8_t WireFrameAckLayer(const uint8_t* a) { return a[WIRE_FIELD(WireFrameAck, layer)]; }
+static inline uint32_t WireFrameAckCanvasId(const uint8_t* a) { return WireReadU32(a + WIRE_FIELD(WireFrameAck, canvasId)); }
+static inline uint32_t WireFrameAckFrameId(const uint8_t* a) { return WireReadU32(a + WIRE_FIELD(WireFrameAck, frameId)); }
+
+/**
+ * @brief Écrit un acquittement d'image
+ */
+static inline void WireWriteFrameAck(uint8_t* a, uint8_t layer, uint32_t canvasId, uint32_t frameId) {
+    a[WIRE_FIELD(WireFrameAck, controlType)] = CONTROL_TYPE_FRAME_ACK;
+    a[WIRE_FIELD(WireFrameAck, layer)] = layer;
+    WireWriteU32(a + WIRE_FIELD(WireFrameAck, canvasId), canvasId);
+    WireWriteU32(a + WIRE_FIELD(WireFrameAck, frameId), frameId);
+}
+
+// Accesseurs de la position du curseur (c pointe sur au moins WIRE_CURSOR_POSITION_SIZE octets)
+static inline uint8_t WireCursorPositionFlags(const uint8_t* c) { return c[WIRE_FIELD(WireCursorPosition, flags)]; }
+static inline int16_t WireCursorPositionX(const uint8_t* c) { return (int16_t)WireReadU16(c + WIRE_FIELD(WireCursorPosition, x)); }
+static inline int16_t WireCursorPositionY(const uint8_t* c) { return (int16_t)WireReadU16(c + WIRE_FIELD(WireCursorPosition, y)); }
+static inline uint32_t WireCursorPositionShapeId(const uint8_t* c) { return WireReadU32(c + WIRE_FIELD(WireCursorPosition, shapeId)); }
+
+/**
+ * @brief Écrit une position du curseur
+ */
+static inline void WireWriteCursorPosition(uint8_t* c, uint8_t flags, int16_t x, int16_t y, uint32_t shapeId) {
+    c[WIRE_FIELD(WireCursorPosition, flags)] = flags;
+    c[WIRE_FIELD(WireCursorPosition, reserved)] = 0;
+    WireWriteU16(c + WIRE_FIELD(WireCursorPosition, x), (uint16_t)x);
+    WireWriteU16(c + WIRE_FIELD(WireCursorPosition, y), (uint16_t)y);
+    WireWriteU32(c + WIRE_FIELD(WireCursorPosition, shapeId), shapeId);
+}
+
+// Accesseurs de la forme du curseur (c pointe sur au moins WIRE_CURSOR_SHAPE_SIZE octets)
+static inline uint32_t WireCursorShapeId(const uint8_t* c) { return WireReadU32(c + WIRE_FIELD(WireCursorShape, shapeId)); }
+static inline uint16_t WireCursorShapeWidth(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCursorShape, width)); }
+static inline uint16_t WireCursorShapeHeight(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCursorShape, height)); }
+static inline uint16_t WireCursorShapeHotspotX(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCursorShape, hotspotX)); }
+static inline uint16_t WireCursorShapeHotspotY(const uint8_t* c) { return WireReadU16(c + WIRE_FIELD(WireCursorShape, hotspotY)); }
+
+/**
+ * @brief Écrit l'en-tête d'une forme de curseur (les pixels sont écrits par l'appelant)
+ */
+static inline void WireWriteCursorShape(uint8_t* c, uint32_t shapeId, uint16_t width, uint16_t height,
+                                        uint16_t hotspotX, uint16_t hotspotY) {
+    c[WIRE_FIELD(WireCursorShape, controlType)] = CONTROL_TYPE_CURSOR_SHAPE;
+    WireWriteU32(c + WIRE_FIELD(WireCursorShape, shapeId), shapeId);
+    WireWriteU16(c + WIRE_FIELD(WireCursorShape, width), width);
+    WireWriteU16(c + WIRE_FIELD(WireCursorShape, height), height);
+    WireWriteU16(c + WIRE_FIELD(WireCursorShape, hotspotX), hotspotX);
+    WireWriteU16(c + WIRE_FIELD(WireCursorShape, hotspotY), hotspotY);
+}
+
+/**
+ * @brief Vérifie qu'une forme de curseur contient tous ses pixels et un point actif dans la forme
+ */
+static inline bool WireCursorShapeValidate(const uint8_t* c, uint32_t size) {
+    if (!c || size < WIRE_CURSOR_SHAPE_SIZE || WireCursorShapeId(c) == 0) return false;
+    uint32_t width = WireCursorShapeWidth(c);
+    uint32_t height = WireCursorShapeHeight(c);
+    if (width == 0 || height == 0 || WireCursorShapeHotspotX(c) >= width || WireCursorShapeHotspotY(c) >= height) return false;
+    return (uint64_t)width * height * 4 <= size - WIRE_CURSOR_SHAPE_SIZE;
+}
+
+static inline uint32_t WireCursorRequestShapeId(const uint8_t* c) { return WireReadU32(c + WIRE_FIELD(WireCursorRequest, shapeId)); }
+
+/**
+ * @brief Écrit une demande de forme de curseur
+ */
+static inline void WireWriteCursorRequest(uint8_t* c, uint32_t shapeId) {
+    c[WIRE_FIELD(WireCursorRequest, controlType)] = CONTROL_TYPE_CURSOR_REQUEST;
+    WireWriteU32(c + WIRE_FIELD(WireCursorRequest, shapeId), shapeId);
+}
+
+// Accesseurs de la taille d'affichage (v pointe sur au moins WIRE_VIEWPORT_SIZE octets)
+static inline uint16_t WireViewportWidth(const uint8_t* v) { return WireReadU16(v + WIRE_FIELD(WireViewport, width)); }
+static inline uint16_t WireViewportHeight(const uint8_t* v) { return WireReadU16(v + WIRE_FIELD(WireViewport, height)); }
+static inline uint16_t WireViewportRegionX(const uint8_t* v) { return WireReadU16(v + WIRE_FIELD(WireViewport, regionX)); }
+static inline uint16_t WireViewportRegionY(const uint8_t* v) { return WireReadU16(v + WIRE_FIELD(WireViewport, regionY)); }
+static inline uint16_t WireViewportRegionWidth(const uint8_t* v) { return WireReadU16(v + WIRE_FIELD(WireViewport, regionWidth)); }
+static inline uint16_t WireViewportRegionHeight(const uint8_t* v) { return WireReadU16(v + WIRE_FIELD(WireViewport, regionHeight)); }
+
+/**
+ * @brief Écrit une taille d'affichage
+ */
+static inline void WireWriteViewport(uint8_t* v, uint16_t width, uint16_t height, uint16_t regionX, uint16_t regionY,
+                                     uint16_t regionWidth, uint16_t regionHeight) {
+    v[WIRE_FIELD(WireViewport, controlType)] = CONTROL_TYPE_VIEWPORT;
+    WireWriteU16(v + WIRE_FIELD(WireViewport, width), width);
+    WireWriteU16(v + WIRE_FIELD(WireViewport, height), height);
+    WireWriteU16(v + WIRE_FIELD(WireViewport, regionX), regionX);
+    WireWriteU16(v + WIRE_FIELD(WireViewport, regionY), regionY);
+    WireWriteU16(v + WIRE_FIELD(WireViewport, regionWidth), regionWidth);
+    WireWriteU16(v + WIRE_FIELD(WireViewport, regionHeight), regionHeight);
+}
+
+// Accesseurs du message ping/pong (c pointe sur au moins WIRE_CLOCK_SYNC_SIZE octets)
+static inline uint8_t WireControlType(const uint8_t* c) { return c[0]; }
+static inline uint64_t WireClockSyncT0(const uint8_t* c) { return WireReadU64(c + WIRE_FIELD(WireClockSync, t0Us)); }
+static inline uint64_t WireClockSyncT1(const uint8_t* c) { return WireReadU64(c + WIRE_FIELD(WireClockSync, t1Us)); }
+static inline uint64_t WireClockSyncT2(const uint8_t* c) { return WireReadU64(c + WIRE_FIELD(WireClockSync, t2Us)); }
+
+/**
+ * @brief Écrit un message ping/pong au début d'un buffer
+ */
+static inline void WireWriteClockSync(uint8_t* c, uint8_t controlType, uint64_t t0Us, uint64_t t1Us, uint64_t t2Us) {
+    c[WIRE_FIELD(WireClockSync, controlType)] = controlType;
+    WireWriteU64(c + WIRE_FIELD(WireClockSync, t0Us), t0Us);
+    WireWriteU64(c + WIRE_FIELD(WireClockSync, t1Us), t1Us);
+    WireWriteU64(c + WIRE_FIELD(WireClockSync, t2Us), t2Us);
+}
+
+/**
+ * @brief Vérifie la signature d'un handshake (h pointe sur size octets)
+ */
+static inline bool WireHandshakeValidate(const uint8_t* h, uint32_t size) {
+    return h && size >= WIRE_HANDSHAKE_SIZE &&
+           memcmp(h, WIRE_HANDSHAKE_MAGIC, sizeof(WIRE_HANDSHAKE_MAGIC)) == 0;
+}
+
+static inline uint8_t WireHandshakeAeadSupport(const uint8_t* h) { return h[WIRE_FIELD(WireHandshake, aeadSupport)]; }
+static inline uint8_t WireHandshakeCodecSupport(const uint8_t* h) { return h[WIRE_FIELD(WireHandshake, codecSupport)]; }
+
+/**
+ * @brief Écrit le début d'un handshake
+ */
+static inline void WireWriteHandshake(uint8_t* h, uint8_t aeadSupport, uint8_t codecSupport) {
+    memcpy(h, WIRE_HANDSHAKE_MAGIC, sizeof(WIRE_HANDSHAKE_MAGIC));
+    h[WIRE_FIELD(WireHandshake, aeadSupport)] = aeadSupport;
+    h[WIRE_FIELD(WireHandshake, codecSupport)] = codecSupport;
+}
+
+// Accesseurs de la part d'échange de clés (k pointe sur au moins WIRE_KEY_SHARE_SIZE octets)
+static inline uint8_t WireKeyShareMode(const uint8_t* k) { return k[WIRE_FIELD(WireKeyShare, mode)]; }
+static inline const uint8_t* WireKeyShareShare(const uint8_t* k) { return k + WIRE_FIELD(WireKeyShare, share); }
+static inline const uint8_t* WireKeyShareEcho(const uint8_t* k) { return k + WIRE_FIELD(WireKeyShare, echo); }
+static inline const uint8_t* WireKeyShareSessionId(const uint8_t* k) { return k + WIRE_FIELD(WireKeyShare, sessionId); }
+static inline const uint8_t* WireKeyShareMac(const uint8_t* k) { return k + WIRE_FIELD(WireKeyShare, mac); }
+
+/**
+ * @brief Écrit une part d'échange de clés (le MAC est ajouté par HandshakeWriteKeyShare)
+ * @param echo Dernière part reçue du pair (NULL si aucune)
+ * @param sessionId Session à reprendre (NULL en mode complet)
+ */
+static inline void WireWriteKeyShare(uint8_t* k, uint8_t mode, const uint8_t share[32],
+                                     const uint8_t echo[32], const uint8_t sessionId[16]) {
+    k[WIRE_FIELD(WireKeyShare, mode)] = mode;
+    memcpy(k + WIRE_FIELD(WireKeyShare, share), share, 32);
+    if (echo) memcpy(k + WIRE_FIELD(WireKeyShare, echo), echo, 32);
+    else memset(k + WIRE_FIELD(WireKeyShare, echo), 0, 32);
+    if (sessionId) memcpy(k + WIRE_FIELD(WireKeyShare, sessionId), sessionId, 16);
+    else memset(k + WIRE_FIELD(WireKeyShare, sessionId), 0, 16);
+    memset(k + WIRE_FIELD(WireKeyShare, mac), 0, 16);
+}
+
+/**
+ * @brief Compare deux numéros de séquence 32 bits en tenant compte du rebouclage
+ * @return true si a est strictement plus récent que b
+ */
+static inline bool WireSequenceNewer(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) > 0;
+}
+
+#endif // PROTOCOL_H
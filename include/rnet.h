@@ -17,13 +17,20 @@ typedef struct rnetPeer rnetPeer;
 typedef struct rnetTargetPeer rnetTargetPeer;
 
 typedef struct {
-    void* data;
+    void* data;     // Modifiable en place (déchiffrement) jusqu'à rnetFreePacket
     size_t size;
+    int event;      // RNET_EVENT_* : connexion et déconnexion n'ont pas de données
+    void* handle;   // Paquet ENet qui porte les données, libéré par rnetFreePacket
 } rnetPacket;
 
 #define RNET_RELIABLE 1
 #define RNET_UNRELIABLE 0
 
+// Événements rapportés par rnetReceive (hôte d'écoute), le pair concerné par rnetGetLastEventPeer
+#define RNET_EVENT_RECEIVE 0
+#define RNET_EVENT_CONNECT 1
+#define RNET_EVENT_DISCONNECT 2
+
 bool rnetInit(void);
 void rnetShutdown(void);
 rnetPeer* rnetHost(uint16_t port);
@@ -35,6 +42,8 @@ bool rnetReceive(rnetPeer* peer, rnetPacket* packet);
 void rnetFreePacket(rnetPacket* packet);
 bool rnetSendToPeer(rnetPeer* peer, rnetTargetPeer* targetPeer, const void* data, size_t size, int flags);
 rnetTargetPeer* rnetGetLastEventPeer(rnetPeer* peer);
+rnetTargetPeer* rnetConnectPeer(rnetPeer* peer, const char* address, uint16_t port);
+bool rnetGetPeerAddress(rnetTargetPeer* targetPeer, char* address, size_t addressSize, uint16_t* port);
 
 #ifdef NETWORK_IMPL
 #define ENET_IMPLEMENTATION
@@ -147,22 +156,34 @@ bool rnetReceive(rnetPeer* peer, rnetPacket* packet) {
         switch (event.type) {
             case ENET_EVENT_TYPE_CONNECT:
                 if (peer->isServer) {
-                    return true;  // Retourner true pour indiquer une nouvelle connexion
+                    // Paquet vide pour indiquer une nouvelle connexion
+                    packet->data = NULL;
+                    packet->size = 0;
+                    packet->event = RNET_EVENT_CONNECT;
+                    packet->handle = NULL;
+                    return true;
                 }
                 return false;
             
             case ENET_EVENT_TYPE_RECEIVE:
-                packet->data = malloc(event.packet->dataLength);
-                memcpy(packet->data, event.packet->data, event.packet->dataLength);
+                // Le paquet ENet est remis tel quel, sans copie : il est détruit par rnetFreePacket
+                packet->data = event.packet->data;
                 packet->size = event.packet->dataLength;
-                enet_packet_destroy(event.packet);
+                packet->event = RNET_EVENT_RECEIVE;
+                packet->handle = event.packet;
                 return true;
             
             case ENET_EVENT_TYPE_DISCONNECT:
                 if (!peer->isServer) {
                     peer->peer = NULL;
+                    return false;
                 }
-                return false;
+                // Signalée à l'hôte : ENet réattribuera ce pair à une prochaine connexion
+                packet->data = NULL;
+                packet->size = 0;
+                packet->event = RNET_EVENT_DISCONNECT;
+                packet->handle = NULL;
+                return true;
             
             default:
                 return false;
@@ -184,9 +205,30 @@ rnetTargetPeer* rnetGetLastEventPeer(rnetPeer* peer) {
     return peer ? enetPeerToTargetPeer(peer->lastEventPeer) : NULL;
 }
 
+rnetTargetPeer* rnetConnectPeer(rnetPeer* peer, const char* address, uint16_t port) {
+    if (!peer || !peer->host || !address) return NULL;
+    
+    // Connexion sortante depuis l'hôte d'écoute : les deux sens partagent le même port
+    ENetAddress addr = {0};
+    if (enet_address_set_host(&addr, address) != 0) return NULL;
+    addr.port = port;
+    
+    return enetPeerToTargetPeer(enet_host_connect(peer->host, &addr, 2, 0));
+}
+
+bool rnetGetPeerAddress(rnetTargetPeer* targetPeer, char* address, size_t addressSize, uint16_t* port) {
+    if (!targetPeer) return false;
+    
+    ENetPeer* enetPeer = targetPeerToENetPeer(targetPeer);
+    if (address && enet_address_get_host_ip(&enetPeer->address, address, addressSize) != 0) return false;
+    if (port) *port = enetPeer->address.port;
+    return true;
+}
+
 void rnetFreePacket(rnetPacket* packet) {
-    if (packet && packet->data) {
-        free(packet->data);
+    if (packet && packet->handle) {
+        enet_packet_destroy((ENetPacket*)packet->handle);
+        packet->handle = NULL;
         packet->data = NULL;
         packet->size = 0;
     }
@@ -0,0 +1,94 @@
+#ifndef ROI_H
+#define ROI_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../include/tiles.h"
+
+// Côté d'une cellule de la carte : une tuile, soit 4x4 macroblocs vidéo
+#define ROI_CELL_SIZE TILE_SIZE
+
+// Distance au curseur (pixels) en deçà de laquelle l'intérêt est maximal, et au-delà de laquelle il est nul
+#define ROI_CURSOR_RADIUS 64
+#define ROI_CURSOR_FALLOFF 256
+
+// Intérêt ajouté par la fenêtre au premier plan et par une cellule qui vient de changer (sur 255)
+#define ROI_WINDOW_WEIGHT 64
+#define ROI_ACTIVITY_WEIGHT 128
+
+// Intérêt à partir duquel une tuile est codée sans perte plutôt qu'en JPEG, si le débit le permet
+#define ROI_FOCUS_WEIGHT 192
+
+// Écart maximal au quantificateur de l'image vidéo (le pas double tous les 6)
+#define ROI_QP_RANGE 6
+
+/**
+ * @brief Attention de l'utilisateur, en pixels de l'image à coder
+ */
+typedef struct {
+    bool hasCursor;             // Position du curseur connue
+    int cursorX;
+    int cursorY;
+    bool hasWindow;             // Fenêtre au premier plan connue (capture GDI)
+    int windowX;
+    int windowY;
+    int windowWidth;
+    int windowHeight;
+} RoiFocus;
+
+/**
+ * @brief Carte des zones d'intérêt d'une image, par cellules de ROI_CELL_SIZE pixels
+ * @details Recalculée à chaque image d'après le curseur, la fenêtre au premier plan et les
+ *          cellules modifiées récemment (là où l'utilisateur tape, fait défiler ou regarde une
+ *          animation). Les codecs y puisent la qualité de chaque zone : quantificateur par
+ *          macrobloc en vidéo, codage sans perte des tuiles d'intérêt en tuiles.
+ */
+typedef struct RoiMap {
+    int width;                  // Dimensions de l'image analysée
+    int height;
+    int columns;                // Grille de cellules
+    int rows;
+    uint64_t* hashes;           // Par cellule : empreinte de l'image précédente (TileHash)
+    uint8_t* activity;          // Par cellule : 255 à chaque modification, divisé par deux toutes les 4 images
+    uint8_t* weights;           // Par cellule : intérêt, de 0 (périphérie) à 255 (attention de l'utilisateur)
+    int meanWeight;             // Intérêt moyen des cellules actives : les écarts de quantificateur sont centrés dessus
+    bool boostLossless;         // Marge de débit : tuiles d'intérêt sans perte (voir ROI_FOCUS_WEIGHT)
+} RoiMap;
+
+/**
+ * @brief Met à jour la carte pour une nouvelle image
+ * @details La carte repart de zéro (aucune activité) si les dimensions changent.
+ * @param map Carte à mettre à jour
+ * @param image Image à coder (RGBA)
+ * @param focus Curseur et fenêtre au premier plan (NULL : activité seulement)
+ * @return true si la carte correspond à l'image, false en cas d'échec d'allocation
+ */
+bool RoiMapUpdate(RoiMap* map, const Image* image, const RoiFocus* focus);
+
+/**
+ * @brief Intérêt de la cellule qui contient un pixel
+ * @param map Carte à jour
+ * @param x Colonne du pixel
+ * @param y Ligne du pixel
+ * @return Intérêt (0-255), 0 en dehors de la carte
+ */
+uint8_t RoiMapWeight(const RoiMap* map, int x, int y);
+
+/**
+ * @brief Écart de quantificateur de la cellule qui contient un pixel
+ * @details Centré sur l'intérêt moyen des cellules modifiées récemment, les seules qui coûtent des
+ *          octets : la qualité gagnée autour de l'attention est reprise sur la périphérie active,
+ *          pour un débit à peu près inchangé.
+ * @return Écart à ajouter au quantificateur de l'image (-ROI_QP_RANGE à ROI_QP_RANGE)
+ */
+int RoiMapQpOffset(const RoiMap* map, int x, int y);
+
+/**
+ * @brief Libère une carte
+ * @param map Carte à libérer (remise à zéro)
+ */
+void RoiMapFree(RoiMap* map);
+
+#endif // ROI_H
@@ -0,0 +1,55 @@
+#ifndef SCALE_H
+#define SCALE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Réduit une image RGBA de moitié (moyenne de chaque bloc de 2x2 pixels)
+ * @details SSE2 quand il est disponible, résultat identique sans. Une dernière colonne ou ligne
+ *          impaire est ignorée.
+ * @param src Pixels source
+ * @param srcStride Octets par ligne de src
+ * @param width Largeur de la destination (au plus la moitié de la source)
+ * @param height Hauteur de la destination (au plus la moitié de la source)
+ * @param dst Destination de width x height pixels
+ * @param dstStride Octets par ligne de dst
+ */
+void ScaleHalf(const uint8_t* src, size_t srcStride, int width, int height, uint8_t* dst, size_t dstStride);
+
+/**
+ * @brief Réduit une image RGBA au quart (moyenne de chaque bloc de 4x4 pixels), en une seule lecture
+ * @param width Largeur de la destination (au plus le quart de la source)
+ * @param height Hauteur de la destination (au plus le quart de la source)
+ */
+void ScaleQuarter(const uint8_t* src, size_t srcStride, int width, int height, uint8_t* dst, size_t dstStride);
+
+/**
+ * @brief Redimensionne une image RGBA par interpolation bilinéaire, dans un rapport quelconque
+ * @details Passe verticale sur des lignes entières (SSE2), puis passe horizontale. Au-delà d'une
+ *          réduction de moitié, les pixels sautés ne comptent pas : voir ScaleImage.
+ * @return true si l'image a été produite, false en cas d'échec d'allocation
+ */
+bool ScaleBilinear(const uint8_t* src, size_t srcStride, int srcWidth, int srcHeight,
+                   uint8_t* dst, size_t dstStride, int dstWidth, int dstHeight);
+
+/**
+ * @brief Réduit une image RGBA aux dimensions demandées
+ * @details Rapports de 2 et de 4 : moyennes de blocs (ScaleHalf, ScaleQuarter). Sinon, réductions
+ *          de moitié tant que la cible est au moins deux fois plus petite, puis interpolation
+ *          bilinéaire du reste : chaque pixel source compte, sans le coût d'un filtre de Lanczos.
+ * @param src Pixels source
+ * @param srcStride Octets par ligne de src
+ * @param srcWidth Largeur de la source
+ * @param srcHeight Hauteur de la source
+ * @param dst Destination de dstWidth x dstHeight pixels
+ * @param dstStride Octets par ligne de dst
+ * @param dstWidth Largeur de la destination (au plus srcWidth)
+ * @param dstHeight Hauteur de la destination (au plus srcHeight)
+ * @return true si l'image a été réduite, false en cas d'échec d'allocation ou de dimensions invalides
+ */
+bool ScaleImage(const uint8_t* src, size_t srcStride, int srcWidth, int srcHeight,
+                uint8_t* dst, size_t dstStride, int dstWidth, int dstHeight);
+
+#endif // SCALE_H
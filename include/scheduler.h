@@ -0,0 +1,63 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Intervalle entre captures d'un écran figé (ms) : de quoi rattraper un changement non signalé par une saisie
+#define SCHEDULER_IDLE_INTERVAL_MS 1000
+
+// Captures inchangées consécutives avant chaque doublement de l'intervalle
+#define SCHEDULER_RAMP_FRAMES 4
+
+/**
+ * @brief Cadence des captures d'après l'activité de l'écran
+ * @details Pleine cadence (intervalle minimal) tant que les captures changent ; après
+ *          SCHEDULER_RAMP_FRAMES captures identiques, l'intervalle double jusqu'à l'intervalle de
+ *          repos. Une saisie de l'utilisateur (clavier, souris) rétablit aussitôt la pleine cadence,
+ *          sans attendre la prochaine échéance lente. Les échéances suivent une grille fixe plutôt
+ *          que l'heure de la dernière capture : la cadence moyenne ne dérive pas avec la période de
+ *          la boucle qui les consulte.
+ */
+typedef struct {
+    uint64_t minIntervalNs;     // Pleine cadence (CaptureConfig.captureInterval)
+    uint64_t idleIntervalNs;    // Cadence d'un écran figé
+    uint64_t intervalNs;        // Intervalle courant, entre les deux
+    uint64_t nextCaptureNs;     // Prochaine échéance (ClockNowNs), 0 : capture immédiate
+    uint64_t lastCaptureNs;     // Dernière capture
+    int staticFrames;           // Captures inchangées consécutives
+} CaptureScheduler;
+
+/**
+ * @brief Réinitialise la cadence (pleine cadence, capture immédiate)
+ * @param scheduler Planificateur à initialiser
+ * @param minIntervalMs Intervalle à pleine cadence
+ * @param idleIntervalMs Intervalle d'un écran figé (ramené à minIntervalMs s'il est plus court)
+ */
+void SchedulerReset(CaptureScheduler* scheduler, uint32_t minIntervalMs, uint32_t idleIntervalMs);
+
+/**
+ * @brief Indique si l'échéance de la prochaine capture est atteinte
+ * @param scheduler Planificateur
+ * @param now Heure courante (ClockNowNs)
+ */
+bool SchedulerCaptureDue(const CaptureScheduler* scheduler, uint64_t now);
+
+/**
+ * @brief Signale une saisie de l'utilisateur : retour à la pleine cadence
+ * @details La prochaine capture est avancée à un intervalle minimal après la précédente, donc
+ *          immédiate après une période de repos.
+ * @param scheduler Planificateur
+ * @param inputNs Heure de la saisie (ClockNowNs) ; ignorée si elle précède la dernière capture
+ */
+void SchedulerInputActivity(CaptureScheduler* scheduler, uint64_t inputNs);
+
+/**
+ * @brief Enregistre une capture et fixe l'échéance suivante
+ * @param scheduler Planificateur
+ * @param now Heure de la capture (ClockNowNs)
+ * @param changed La capture diffère de la précédente
+ */
+void SchedulerFrameCaptured(CaptureScheduler* scheduler, uint64_t now, bool changed);
+
+#endif // SCHEDULER_H
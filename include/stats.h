@@ -0,0 +1,169 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "clock.h"
+
+/**
+ * @brief Étapes instrumentées du pipeline
+ */
+typedef enum {
+    STAT_STAGE_CAPTURE,     // Copie de l'écran (BitBlt + GetDIBits)
+    STAT_STAGE_SWIZZLE,     // Conversion BGRA -> RGBA
+    STAT_STAGE_SCALE,       // Réduction de la résolution envoyée
+    STAT_STAGE_DETECT,      // Détection de changements
+    STAT_STAGE_MOTION,      // Recherche de défilement (incluse dans la compression)
+    STAT_STAGE_ENCODE,      // Compression
+    STAT_STAGE_SEND,        // Mise en paquet et envoi
+    STAT_STAGE_RECEIVE,     // Traitement d'un paquet de capture reçu
+    STAT_STAGE_PLAYOUT,     // Attente dans le tampon de gigue (réception -> décodage)
+    STAT_STAGE_DECODE,      // Décompression côté visualiseur
+    STAT_STAGE_UPLOAD,      // Envoi de la texture au GPU
+    STAT_STAGE_PRESENT,     // Dessin de la fenêtre (hors attente du FPS cible)
+    STAT_STAGE_COUNT
+} StatStage;
+
+/**
+ * @brief Compteurs cumulés depuis le démarrage
+ */
+typedef enum {
+    STAT_COUNTER_FRAMES_CAPTURED,   // Images capturées
+    STAT_COUNTER_FRAMES_CHANGED,    // Images avec changement détecté
+    STAT_COUNTER_TILES_ENCODED,     // Tuiles compressées (toutes celles d'une image complète)
+    STAT_COUNTER_TILES_PALETTE,     // Tuiles compressées en palette (texte, interface)
+    STAT_COUNTER_TILES_LOSSLESS,    // Tuiles compressées sans perte hors palette (prédiction ou QOI)
+    STAT_COUNTER_TILES_DELTA,       // Tuiles compressées en différence avec l'image acquittée
+    STAT_COUNTER_TILES_REFINED,     // Tuiles figées renvoyées sans perte après un envoi en JPEG
+    STAT_COUNTER_COPY_RECTS,        // Copies de rectangles envoyées à la place de tuiles défilées
+    STAT_COUNTER_VIDEO_KEYFRAMES,   // Images I du codec vidéo (première image, GOP ou référence perdue)
+    STAT_COUNTER_CACHE_HITS,        // Tuiles reprises du cache des visualiseurs au lieu d'être compressées
+    STAT_COUNTER_CACHE_BYTES_SAVED, // Octets économisés par le cache (estimés sur la taille moyenne d'une tuile)
+    STAT_COUNTER_FRAMES_SENT,       // Images envoyées (par pair)
+    STAT_COUNTER_BYTES_SENT,        // Octets envoyés (en-têtes compris)
+    STAT_COUNTER_CURSOR_BYTES_SENT, // Octets envoyés pour le curseur (positions et formes)
+    STAT_COUNTER_FRAMES_RECEIVED,   // Images reçues
+    STAT_COUNTER_BYTES_RECEIVED,    // Octets reçus
+    STAT_COUNTER_PACKETS_DROPPED,   // Paquets écartés (invalides ou périmés)
+    STAT_COUNTER_FRAMES_SKIPPED,    // Images reçues écartées sans être décodées (une plus récente était à afficher)
+    STAT_COUNTER_FRAMES_STALE,      // Images reçues après une plus récente de la même couche, écartées avant décodage
+    STAT_COUNTER_SAMPLES_LOST,      // Mesures perdues (anneau d'un thread plein)
+    STAT_COUNTER_COUNT
+} StatCounter;
+
+// Nombre de mesures conservées par étape pour les percentiles glissants
+#define STATS_WINDOW_SIZE 256
+
+// Histogramme logarithmique : le seau i couvre [2^(i-1), 2^i[ microsecondes
+#define STATS_HISTOGRAM_BUCKETS 24
+
+/**
+ * @brief Résumé d'une étape
+ */
+typedef struct {
+    uint32_t windowCount;                           // Mesures dans la fenêtre glissante
+    double meanMs;                                  // Moyenne sur la fenêtre
+    double p50Ms;                                   // Médiane sur la fenêtre
+    double p99Ms;                                   // 99e percentile sur la fenêtre
+    double maxMs;                                   // Maximum sur la fenêtre
+    uint64_t totalCount;                            // Mesures depuis le démarrage
+    uint64_t histogram[STATS_HISTOGRAM_BUCKETS];    // Histogramme depuis le démarrage
+} StatStageSummary;
+
+/**
+ * @brief Vue instantanée de toutes les statistiques
+ */
+typedef struct {
+    StatStageSummary stages[STAT_STAGE_COUNT];
+    uint64_t counters[STAT_COUNTER_COUNT];
+} StatsSnapshot;
+
+/**
+ * @brief Initialise le système de statistiques
+ */
+void StatsInit(void);
+
+/**
+ * @brief Libère les anneaux des threads et réinitialise les statistiques
+ */
+void StatsShutdown(void);
+
+/**
+ * @brief Marque le début d'une étape
+ * @return Horodatage à transmettre à StatsEnd
+ */
+static inline uint64_t StatsBegin(void) {
+    return ClockNowNs();
+}
+
+/**
+ * @brief Enregistre la durée d'une étape commencée par StatsBegin
+ * @details Sans verrou : la mesure est écrite dans l'anneau propre au thread appelant.
+ */
+void StatsEnd(StatStage stage, uint64_t startNs);
+
+/**
+ * @brief Enregistre une durée mesurée par ailleurs
+ */
+void StatsRecord(StatStage stage, uint64_t durationNs);
+
+/**
+ * @brief Variante de StatsEnd rattachant la mesure à une image (visible dans les traces)
+ * @param frameId Identifiant de l'image traitée (0 si aucune)
+ */
+void StatsEndFrame(StatStage stage, uint64_t startNs, uint32_t frameId);
+
+/**
+ * @brief Variante de StatsRecord rattachant la mesure à une image
+ */
+void StatsRecordFrame(StatStage stage, uint64_t durationNs, uint32_t frameId);
+
+/**
+ * @brief Nomme le thread appelant dans les traces exportées
+ * @param name Nom court (tronqué à 31 caractères)
+ */
+void StatsSetThreadName(const char* name);
+
+/**
+ * @brief Nom d'un thread instrumenté
+ * @param threadIndex Index attribué à l'enregistrement du thread
+ * @return Nom du thread, ou NULL si l'index est inconnu ou le thread anonyme
+ */
+const char* StatsGetThreadName(int threadIndex);
+
+/**
+ * @brief Incrémente un compteur (atomique, utilisable depuis n'importe quel thread)
+ */
+void StatsAddCounter(StatCounter counter, uint64_t value);
+
+/**
+ * @brief Draine les anneaux de tous les threads dans les fenêtres et histogrammes
+ * @details À appeler depuis un seul thread (la boucle principale).
+ */
+void StatsCollect(void);
+
+/**
+ * @brief Calcule les percentiles et copie l'état courant
+ * @param snapshot Structure à remplir
+ */
+void StatsGetSnapshot(StatsSnapshot* snapshot);
+
+/**
+ * @brief Nom lisible d'une étape
+ */
+const char* StatsStageName(StatStage stage);
+
+/**
+ * @brief Nom lisible d'un compteur
+ */
+const char* StatsCounterName(StatCounter counter);
+
+/**
+ * @brief Exporte les résumés, compteurs et mesures récentes au format CSV
+ * @param path Chemin du fichier à écrire
+ * @return true si l'export réussit, false sinon
+ */
+bool StatsExportCsv(const char* path);
+
+#endif // STATS_H
@@ -0,0 +1,78 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Thread natif (HANDLE Win32 ou pthread_t)
+ */
+typedef struct {
+    uintptr_t handle;
+} Thread;
+
+/**
+ * @brief Fonction exécutée par un thread
+ * @param arg Argument transmis à ThreadCreate
+ * @return Code de retour du thread
+ */
+typedef int (*ThreadFunc)(void* arg);
+
+/**
+ * @brief Démarre un thread
+ * @param thread Thread à initialiser
+ * @param func Fonction à exécuter
+ * @param arg Argument transmis à la fonction
+ * @return true si le thread a démarré, false sinon
+ */
+bool ThreadCreate(Thread* thread, ThreadFunc func, void* arg);
+
+/**
+ * @brief Attend la fin d'un thread et libère ses ressources
+ */
+void ThreadJoin(Thread* thread);
+
+/**
+ * @brief Sémaphore natif (HANDLE Win32 ou sem_t POSIX)
+ */
+typedef struct {
+    uintptr_t handle;
+} Semaphore;
+
+/**
+ * @brief Crée un sémaphore
+ * @param semaphore Sémaphore à initialiser
+ * @param initial Valeur initiale
+ * @return true si le sémaphore a été créé, false sinon
+ */
+bool SemaphoreCreate(Semaphore* semaphore, uint32_t initial);
+
+/**
+ * @brief Incrémente un sémaphore, réveillant autant de threads en attente
+ * @param count Valeur à ajouter
+ */
+void SemaphorePost(Semaphore* semaphore, uint32_t count);
+
+/**
+ * @brief Attend que le sémaphore soit positif, puis le décrémente
+ */
+void SemaphoreWait(Semaphore* semaphore);
+
+/**
+ * @brief Libère un sémaphore (aucun thread ne doit l'attendre)
+ */
+void SemaphoreDestroy(Semaphore* semaphore);
+
+/**
+ * @brief Nombre de processeurs logiques disponibles
+ * @return Au moins 1
+ */
+int ThreadCpuCount(void);
+
+/**
+ * @brief Suspend le thread appelant
+ * @param ms Durée en millisecondes
+ */
+void ThreadSleepMs(uint32_t ms);
+
+#endif // THREAD_H
@@ -0,0 +1,121 @@
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Emplacements du cache : avec des tuiles de 64 pixels, 16 Mio de pixels chez le visualiseur
+#define TILE_CACHE_SLOTS 1024
+
+// Seaux de la table des empreintes côté émetteur (puissance de 2)
+#define TILE_CACHE_BUCKETS 2048
+
+// Tuile transmise sans être conservée par le visualiseur
+#define TILE_CACHE_NO_SLOT 0xFFFF
+
+// Images dont l'application est connue de l'émetteur (masque GetAppliedFrames)
+#define TILE_CACHE_CONFIRM_WINDOW 64
+
+/**
+ * @brief Entrée du cache côté émetteur : empreinte seulement, les pixels sont chez le visualiseur
+ */
+typedef struct {
+    uint64_t hash;              // Empreinte des pixels (TileHash)
+    uint32_t storeFrameId;      // Dernière image qui a transmis ces pixels dans l'emplacement
+    bool used;                  // Emplacement occupé
+    bool confirmed;             // storeFrameId appliquée par tous les visualiseurs : référençable
+    int16_t newer;              // Liste LRU (-1 en bout de liste)
+    int16_t older;
+    int16_t chain;              // Entrée suivante du même seau (-1 en fin de chaîne)
+} TileCacheEntry;
+
+/**
+ * @brief Cache de tuiles côté émetteur
+ * @details C'est l'émetteur qui choisit l'emplacement de chaque tuile transmise (la moins
+ *          récemment utilisée est remplacée) : le visualiseur n'a qu'à suivre, sans politique
+ *          d'éviction à reproduire. Une tuile n'est référencée qu'une fois l'image qui l'a
+ *          transmise appliquée par tous les visualiseurs.
+ */
+typedef struct {
+    TileCacheEntry entries[TILE_CACHE_SLOTS];
+    int16_t buckets[TILE_CACHE_BUCKETS]; // Première entrée de chaque seau (-1 si vide)
+    int16_t newest;             // Tête de la liste LRU
+    int16_t oldest;             // Queue de la liste LRU, prochaine victime
+    int used;                   // Emplacements occupés
+} TileCache;
+
+/**
+ * @brief Copie du cache côté visualiseur, remplie aux emplacements désignés par l'émetteur
+ */
+typedef struct {
+    int tileSize;               // Côté des tuiles conservées
+    uint8_t* slots[TILE_CACHE_SLOTS]; // Pixels RGBA de chaque emplacement (NULL si jamais rempli)
+} TileCacheMirror;
+
+/**
+ * @brief Empreinte 64 bits des pixels d'une tuile (dimensions comprises)
+ * @details Accumulation sur 8 voies de 64 bits par blocs de 64 octets, à la manière de XXH3
+ *          (SSE2 quand il est disponible). Propre à l'émetteur : jamais transmise.
+ * @param pixels Premier pixel de la tuile (RGBA)
+ * @param stride Octets d'une ligne à la suivante
+ * @param width Largeur de la tuile en pixels
+ * @param height Hauteur de la tuile en pixels
+ * @return Empreinte des pixels
+ */
+uint64_t TileHash(const uint8_t* pixels, size_t stride, int width, int height);
+
+/**
+ * @brief Vide le cache de l'émetteur (nouveau visualiseur ou image complète)
+ */
+void TileCacheReset(TileCache* cache);
+
+/**
+ * @brief Confirme les tuiles transmises par des images appliquées par tous les visualiseurs
+ * @param cache Cache de l'émetteur
+ * @param baseFrameId Image acquittée par tous les visualiseurs (0 : rien à confirmer)
+ * @param appliedFrames Bit i : image baseFrameId - i appliquée par tous (GetAppliedFrames)
+ */
+void TileCacheConfirm(TileCache* cache, uint32_t baseFrameId, uint64_t appliedFrames);
+
+/**
+ * @brief Cherche une tuile par empreinte et la marque comme la plus récemment utilisée
+ * @return Emplacement de la tuile, -1 si absente
+ */
+int TileCacheFind(TileCache* cache, uint64_t hash);
+
+/**
+ * @brief Enregistre une tuile transmise par une image
+ * @details Une tuile déjà présente garde son emplacement (transmise à nouveau, elle attend une
+ *          nouvelle confirmation) ; sinon l'emplacement le moins récemment utilisé est réattribué.
+ * @param cache Cache de l'émetteur
+ * @param hash Empreinte des pixels
+ * @param frameId Image qui transmet la tuile
+ * @return Emplacement où le visualiseur doit conserver la tuile
+ */
+int TileCacheStore(TileCache* cache, uint64_t hash, uint32_t frameId);
+
+/**
+ * @brief Conserve une tuile reçue dans la copie du cache
+ * @details Un changement de taille de tuile vide la copie.
+ * @param mirror Copie du cache du visualiseur
+ * @param slot Emplacement choisi par l'émetteur
+ * @param pixels Premier pixel de la tuile décodée (RGBA, tileSize x tileSize)
+ * @param stride Octets d'une ligne à la suivante
+ * @param tileSize Côté de la tuile
+ * @return true si la tuile est conservée, false en cas d'échec d'allocation
+ */
+bool TileCacheMirrorStore(TileCacheMirror* mirror, int slot, const uint8_t* pixels, size_t stride, int tileSize);
+
+/**
+ * @brief Pixels d'un emplacement de la copie du cache
+ * @return Pixels RGBA (tileSize x tileSize, lignes contiguës), NULL si l'emplacement est vide
+ */
+const uint8_t* TileCacheMirrorGet(const TileCacheMirror* mirror, int slot, int tileSize);
+
+/**
+ * @brief Libère la copie du cache
+ */
+void TileCacheMirrorFree(TileCacheMirror* mirror);
+
+#endif // TILECACHE_H
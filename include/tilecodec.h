@@ -0,0 +1,115 @@
+#ifndef TILECODEC_H
+#define TILECODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Couleurs au plus pour la palette : texte et interface sur fond uni
+#define TILE_PALETTE_MAX_COLORS 16
+
+// Couleurs au plus pour le codage sans perte d'une zone peu colorée (icônes, texte lissé)
+#define TILE_LOSSLESS_MAX_COLORS 256
+
+// Écart moyen entre pixels voisins (par canal) sous lequel une zone est un dégradé lisse
+#define TILE_SMOOTH_GRADIENT 2
+
+// Taille maximale d'une tuile codée en TILE_CODEC_QOI (4 octets par pixel au pire)
+#define TILE_QOI_MAX_SIZE(width, height) ((width) * (height) * 4)
+
+/**
+ * @brief Codec d'une tuile transmise (valeur de l'octet de codec de chaque tuile, voir WireTileFrame)
+ */
+typedef enum {
+    TILE_CODEC_JPEG = 0,        // Dans l'atlas JPEG : photos, vidéo
+    TILE_CODEC_PALETTE = 1,     // Palette et plages : texte et interface, sans perte
+    TILE_CODEC_LOSSLESS = 2,    // Prédiction et codes de Rice adaptatifs : zones peu colorées, sans perte
+    TILE_CODEC_QOI = 3,         // Opérations d'octets à la QOI : tout contenu, sans perte et très rapide
+    TILE_CODEC_DELTA = 4,       // Différence avec la tuile que le visualiseur affiche, codée en QOI
+    TILE_CODEC_COUNT
+} TileCodec;
+
+/**
+ * @brief Mesures d'une tuile utilisées pour choisir son codec
+ */
+typedef struct {
+    int colors;                 // Couleurs distinctes (TILE_LOSSLESS_MAX_COLORS + 1 au-delà)
+    int flatPixels;             // Pixels identiques à leur voisin de gauche
+    uint64_t gradientEnergy;    // Somme des écarts absolus avec le voisin de gauche (RGB)
+} TileFeatures;
+
+/**
+ * @brief Mesure une tuile : couleurs distinctes, aplats et énergie du gradient horizontal
+ * @details Aplats et gradient sont calculés 4 pixels à la fois (SSE2) ; seuls les pixels qui
+ *          diffèrent de leur voisin passent par la table des couleurs.
+ * @param pixels Premier pixel de la tuile (RGBA, alpha ignoré)
+ * @param stride Octets d'une ligne à la suivante
+ * @param width Largeur de la tuile
+ * @param height Hauteur de la tuile
+ * @param features Mesures produites
+ */
+void TileAnalyze(const uint8_t* pixels, size_t stride, int width, int height, TileFeatures* features);
+
+/**
+ * @brief Choisit le codec d'une tuile d'après ses mesures
+ * @details Peu de couleurs : palette. Jusqu'à TILE_LOSSLESS_MAX_COLORS couleurs, une majorité
+ *          d'aplats ou un dégradé lisse : sans perte. Sinon (contenu photographique) : JPEG.
+ */
+TileCodec TileChooseCodec(const TileFeatures* features, int width, int height);
+
+/**
+ * @brief Compresse une tuile sans perte
+ * @param codec TILE_CODEC_PALETTE, TILE_CODEC_LOSSLESS ou TILE_CODEC_QOI (qui tient toujours
+ *              dans TILE_QOI_MAX_SIZE octets)
+ * @param pixels Premier pixel de la tuile (RGBA, alpha non transmis)
+ * @param stride Octets d'une ligne à la suivante
+ * @param width Largeur de la tuile
+ * @param height Hauteur de la tuile
+ * @param output Données produites
+ * @param capacity Taille de output
+ * @return Taille des données, 0 si elles ne tiennent pas (la tuile doit passer par le JPEG)
+ */
+int TileEncode(TileCodec codec, const uint8_t* pixels, size_t stride, int width, int height,
+               uint8_t* output, int capacity);
+
+/**
+ * @brief Décompresse une tuile sans perte (alpha à 255)
+ * @param codec Codec de la tuile
+ * @param data Données compressées
+ * @param size Taille des données
+ * @param pixels Premier pixel de destination (RGBA)
+ * @param stride Octets d'une ligne à la suivante
+ * @param width Largeur de la tuile
+ * @param height Hauteur de la tuile
+ * @return true si la tuile est complète et valide, false sinon
+ */
+bool TileDecode(TileCodec codec, const uint8_t* data, int size, uint8_t* pixels, size_t stride,
+                int width, int height);
+
+/**
+ * @brief Compresse une tuile en différence (canal par canal) avec son contenu chez le visualiseur
+ * @details Les pixels inchangés donnent des différences nulles, codées en plages : une tuile
+ *          retouchée coûte quelques octets. Tient toujours dans TILE_QOI_MAX_SIZE octets.
+ * @param pixels Premier pixel de la tuile (RGBA, alpha non transmis)
+ * @param stride Octets d'une ligne à la suivante
+ * @param reference Premier pixel de la tuile telle que le visualiseur l'affiche
+ * @param referenceStride Octets d'une ligne à la suivante dans reference
+ * @param width Largeur de la tuile
+ * @param height Hauteur de la tuile
+ * @param output Données produites
+ * @param capacity Taille de output
+ * @return Taille des données, 0 si elles ne tiennent pas
+ */
+int TileEncodeDelta(const uint8_t* pixels, size_t stride, const uint8_t* reference, size_t referenceStride,
+                    int width, int height, uint8_t* output, int capacity);
+
+/**
+ * @brief Décompresse une tuile codée en différence (alpha à 255)
+ * @param reference Tuile affichée par le visualiseur avant cette image (distincte de pixels)
+ * @param referenceStride Octets d'une ligne à la suivante dans reference
+ * @return true si la tuile est complète et valide, false sinon
+ */
+bool TileDecodeDelta(const uint8_t* data, int size, const uint8_t* reference, size_t referenceStride,
+                     uint8_t* pixels, size_t stride, int width, int height);
+
+#endif // TILECODEC_H
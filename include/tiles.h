@@ -0,0 +1,259 @@
+#ifndef TILES_H
+#define TILES_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../include/motion.h"
+#include "../include/tilecache.h"
+#include "../include/tilecodec.h"
+
+// Côté d'une tuile en pixels : multiple de 16 pour que les blocs JPEG ne chevauchent jamais deux tuiles
+#define TILE_SIZE 64
+
+// Les indices de tuiles sont transmis sur 16 bits
+#define TILE_MAX_COUNT 65535
+
+// Tuiles modifiées à partir desquelles un défilement est recherché
+#define TILE_MOTION_MIN_TILES 4
+
+// Retard d'acquittement (en images) au-delà duquel les copies ne sont plus utilisées : un visualiseur
+// qui a perdu l'image précédente ne peut pas les appliquer et doit recevoir les tuiles
+#define TILE_COPY_MAX_ACK_LAG 15
+
+// Taille au-delà de laquelle une tuile codée sans perte passe par le JPEG (octets par pixel)
+#define TILE_CODED_MAX_BYTES_PER_PIXEL 2
+
+// Images sans modification après lesquelles une tuile reçue en JPEG est renvoyée sans perte
+#define TILE_REFINE_STATIC_FRAMES 4
+
+// Drapeaux par tuile de la dernière mise à jour
+#define TILE_FLAG_CHANGED 0x01      // Contenu modifié par la dernière capture
+#define TILE_FLAG_COPIED 0x02       // Entièrement reconstruite par une copie de rectangle
+
+/**
+ * @brief Historique des tuiles côté émetteur
+ * @details Chaque tuile mémorise l'image où son contenu a changé pour la dernière fois :
+ *          les tuiles à envoyer à un visualiseur sont celles modifiées après la dernière
+ *          image qu'il a acquittée, quelles que soient les images perdues entre-temps.
+ */
+typedef struct {
+    uint32_t canvasId;          // Identifiant du canevas, renouvelé quand les dimensions changent
+    int width;                  // Dimensions capturées
+    int height;
+    int columns;                // Grille de tuiles
+    int rows;
+    uint32_t* changedFrame;     // Par tuile : dernière image où son contenu a changé
+    uint32_t* previousChange;   // Par tuile : changement précédent, dont previous garde le contenu
+    uint8_t* flags;             // Par tuile : TILE_FLAG_* de la dernière capture
+    uint32_t* lossyFrame;       // Par tuile : image qui l'a laissée inexacte chez les visualiseurs (JPEG), 0 si exacte
+    uint32_t* refineFrame;      // Par tuile : dernier envoi sans perte, en attente d'acquittement (0 aucun)
+    uint8_t* reference;         // Dernière image analysée (RGBA)
+    uint32_t referenceFrameId;  // Image contenue dans reference
+    uint8_t* previous;          // Contenu des tuiles modifiées par la dernière capture, avant elle (RGBA)
+    uint32_t copySourceFrameId; // Image précédente, source des copies de la dernière capture
+    MotionRect copies[MOTION_MAX_RECTS]; // Défilement de la dernière capture
+    int copyCount;
+} TileHistory;
+
+/**
+ * @brief Choix des codecs des tuiles transmises (TileEncodeCoded)
+ */
+typedef struct {
+    bool lossless;              // Aucune tuile pour le JPEG
+    uint32_t deltaBaseFrameId;  // Image appliquée par tous les visualiseurs (0 : pas de codage en différence)
+    uint32_t deltaSinceFrameId; // Début du mode sans perte : les contenus antérieurs ne sont pas exacts chez le visualiseur
+    const struct RoiMap* roi;   // Tuiles d'intérêt codées sans perte plutôt qu'en JPEG si roi->boostLossless (NULL : aucune)
+    int refineCount;            // Dernières tuiles de la liste : renvois sans perte (TileRefineCollect), jamais en JPEG
+} TileCodingOptions;
+
+/**
+ * @brief Rectangle modifié par la dernière image décodée, à envoyer à la texture
+ */
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} DirtyRect;
+
+/**
+ * @brief Canevas reconstruit côté visualiseur
+ */
+typedef struct {
+    uint32_t canvasId;          // Canevas de l'émetteur reproduit (0 = aucun)
+    uint32_t frameId;           // Dernière image appliquée
+    Image image;                // Pixels courants (RGBA)
+    TileCacheMirror cache;      // Tuiles conservées aux emplacements choisis par l'émetteur
+    DirtyRect* dirtyRects;      // Zones modifiées par la dernière image : plages de tuiles par rangée, fusionnées en hauteur
+    int dirtyCount;
+    uint8_t* dirtyTiles;        // Par tuile : modifiée par la dernière image
+    int* dirtyRuns;             // Par colonne : rectangle de la rangée précédente qui commence à cette colonne (-1 : aucun)
+    int dirtyColumns;           // Grille des tableaux ci-dessus
+    int dirtyRows;
+} TileCanvas;
+
+/**
+ * @brief Tuile que le visualiseur reprend de son cache au lieu de la recevoir
+ */
+typedef struct {
+    uint16_t tile;              // Indice de la tuile dans le canevas
+    uint16_t slot;              // Emplacement du cache
+} TileCacheRef;
+
+/**
+ * @brief Résultat de l'application d'une image en tuiles sur le canevas
+ */
+typedef enum {
+    TILE_APPLY_OK,              // Canevas à jour
+    TILE_APPLY_STALE,           // Image plus ancienne que le canevas, ignorée
+    TILE_APPLY_MISSING_BASE,    // Le canevas ne contient pas l'image de référence : image complète nécessaire
+    TILE_APPLY_MISSING_COPY,    // Copies basées sur une image non reçue : ignorée, l'émetteur renverra les tuiles
+    TILE_APPLY_MISSING_CACHE,   // Emplacement du cache vide : image complète nécessaire
+    TILE_APPLY_ERROR            // Données invalides ou décodage impossible
+} TileApplyResult;
+
+/**
+ * @brief Compare une capture à la précédente, tuile par tuile
+ * @details Le canevas est renouvelé (toutes les tuiles marquées modifiées) si les dimensions changent.
+ *          Si de nombreuses tuiles changent, un défilement est recherché (voir MotionDetect) : les
+ *          tuiles entièrement reconstruites par les copies trouvées sont marquées TILE_FLAG_COPIED.
+ * @param history Historique à mettre à jour
+ * @param image Capture au format RGBA
+ * @param frameId Identifiant de la capture
+ * @param detectMotion Rechercher un défilement par rapport à la capture précédente
+ * @param canvasReset Mis à true si le canevas vient d'être renouvelé (peut être NULL)
+ * @return Nombre de tuiles modifiées par cette capture, -1 en cas d'échec d'allocation
+ */
+int TileHistoryUpdate(TileHistory* history, const Image* image, uint32_t frameId, bool detectMotion, bool* canvasReset);
+
+/**
+ * @brief Liste les tuiles modifiées après une image de référence
+ * @param history Historique des tuiles
+ * @param baseFrameId Image déjà reçue par le visualiseur (0 pour toutes les tuiles)
+ * @param useCopies Les copies de la dernière capture sont envoyées : les tuiles qu'elles reconstruisent sont omises
+ * @param tiles Indices des tuiles (columns * rows entrées au plus)
+ * @return Nombre de tuiles listées
+ */
+int TileHistoryCollect(const TileHistory* history, uint32_t baseFrameId, bool useCopies, uint16_t* tiles);
+
+/**
+ * @brief Liste les tuiles figées à renvoyer sans perte, pour affiner ce qui est parti en JPEG
+ * @details Les envois sans perte précédents sont d'abord confirmés par les acquittements : une tuile
+ *          envoyée par une image appliquée par tous les visualiseurs y est exacte, une image perdue la
+ *          rend de nouveau candidate. Sont listées les tuiles inexactes chez les visualiseurs, déjà
+ *          reçues (modifiées au plus tard à baseFrameId) et inchangées depuis TILE_REFINE_STATIC_FRAMES images.
+ * @param history Historique des tuiles
+ * @param frameId Image en cours de compression
+ * @param baseFrameId Image acquittée par les visualiseurs (0 : image complète, aucune tuile listée)
+ * @param appliedFrames Bit i : image baseFrameId - i appliquée par tous les visualiseurs
+ * @param maxTiles Nombre de tuiles au plus
+ * @param tiles Indices des tuiles (maxTiles entrées au plus)
+ * @return Nombre de tuiles listées
+ */
+int TileRefineCollect(TileHistory* history, uint32_t frameId, uint32_t baseFrameId, uint64_t appliedFrames,
+                      int maxTiles, uint16_t* tiles);
+
+/**
+ * @brief Enregistre l'exactitude chez les visualiseurs des tuiles d'une image
+ * @details Tuiles codées sans perte : en attente de confirmation (voir TileRefineCollect). Tuiles de
+ *          l'atlas JPEG, reprises du cache ou reconstruites par une copie : inexactes, faute de savoir
+ *          comment leur contenu d'origine a été transmis.
+ * @param history Historique des tuiles
+ * @param frameId Image compressée
+ * @param tiles Tuiles transmises, codées sans perte d'abord (voir TileEncodeCoded)
+ * @param codedCount Nombre de tuiles codées sans perte
+ * @param tileCount Nombre de tuiles transmises
+ * @param cached Tuiles reprises du cache
+ * @param cachedCount Nombre de tuiles reprises du cache
+ * @param useCopies Les copies de la dernière capture sont envoyées
+ */
+void TileRefineRecord(TileHistory* history, uint32_t frameId, const uint16_t* tiles, int codedCount, int tileCount,
+                      const TileCacheRef* cached, int cachedCount, bool useCopies);
+
+/**
+ * @brief Sépare les tuiles déjà dans le cache des visualiseurs de celles à transmettre
+ * @details Chaque tuile est identifiée par l'empreinte de ses pixels : une tuile confirmée dans le
+ *          cache est reprise par référence, les autres sont transmises et enregistrées dans le cache.
+ * @param cache Cache de l'émetteur (confirmé au préalable avec TileCacheConfirm)
+ * @param history Historique (dimensions de la grille)
+ * @param image Capture au format RGBA
+ * @param frameId Image en cours de compression
+ * @param tiles Tuiles à envoyer ; en sortie, seulement celles à transmettre
+ * @param count Nombre de tuiles à envoyer
+ * @param cached Tuiles reprises du cache (count entrées au plus)
+ * @param cachedCount Nombre de tuiles reprises du cache
+ * @param slots Emplacement du cache de chaque tuile transmise (count entrées au plus)
+ * @return Nombre de tuiles à transmettre
+ */
+int TileCacheResolve(TileCache* cache, const TileHistory* history, const Image* image, uint32_t frameId,
+                     uint16_t* tiles, int count, TileCacheRef* cached, int* cachedCount, uint16_t* slots);
+
+/**
+ * @brief Code sans perte les tuiles de texte et d'interface, les autres restent pour l'atlas JPEG
+ * @details Le codec de chaque tuile est choisi d'après ses couleurs et son gradient (TileChooseCodec) ;
+ *          en mode sans perte, toutes passent par TILE_CODEC_QOI sans analyse, ou par TILE_CODEC_DELTA
+ *          quand le contenu qu'elles remplacent est connu exactement du visualiseur : changé pour la
+ *          dernière fois entre options->deltaSinceFrameId et options->deltaBaseFrameId. Une tuile
+ *          photographique proche de l'attention de l'utilisateur (options->roi) passe aussi par
+ *          TILE_CODEC_QOI si elle tient dans TILE_CODED_MAX_BYTES_PER_PIXEL ; une tuile renvoyée pour
+ *          être affinée (options->refineCount), quelle que soit sa taille.
+ *          Les tuiles codées sont placées en tête de liste, dans leur ordre, avec leur emplacement.
+ * @param history Historique (dimensions de la grille)
+ * @param image Capture au format RGBA
+ * @param tiles Tuiles à transmettre ; en sortie, les tuiles codées d'abord
+ * @param slots Emplacement du cache de chaque tuile, réordonnés avec elles
+ * @param count Nombre de tuiles à transmettre
+ * @param options Mode sans perte et référence du codage en différence
+ * @param codecs Codec de chaque tuile codée (count entrées au plus)
+ * @param sizes Taille des données de chaque tuile codée (count entrées au plus)
+ * @param data Données des tuiles codées, concaténées (à libérer avec free, NULL si aucune)
+ * @param dataSize Taille totale des données
+ * @return Nombre de tuiles codées, -1 en cas d'échec d'allocation
+ */
+int TileEncodeCoded(const TileHistory* history, const Image* image, uint16_t* tiles, uint16_t* slots, int count,
+                    const TileCodingOptions* options, uint8_t* codecs, uint16_t* sizes, uint8_t** data, uint32_t* dataSize);
+
+/**
+ * @brief Libère un historique de tuiles
+ */
+void TileHistoryFree(TileHistory* history);
+
+/**
+ * @brief Regroupe des tuiles dans une seule image, à compresser en une fois
+ * @details Les tuiles du bord sont complétées en répétant leur dernier pixel.
+ * @param history Historique (dimensions de la grille)
+ * @param image Capture au format RGBA
+ * @param tiles Indices des tuiles à regrouper
+ * @param count Nombre de tuiles
+ * @param atlas Image produite (à libérer avec UnloadImage)
+ * @return Nombre de tuiles par ligne de l'atlas, 0 en cas d'échec
+ */
+int TileBuildAtlas(const TileHistory* history, const Image* image, const uint16_t* tiles, int count, Image* atlas);
+
+/**
+ * @brief Applique une image en tuiles reçue sur le canevas
+ * @details Les copies de rectangles sont appliquées avant les tuiles, à condition que le canevas
+ *          soit exactement à l'image source des copies. Les tuiles reprises du cache sont appliquées
+ *          ensuite, puis les tuiles transmises, conservées dans le cache aux emplacements indiqués.
+ *          Les tuiles codées et l'atlas JPEG sont tous décodés, en parallèle sur le pool de threads
+ *          (workers.h), avant de toucher au canevas. Les zones modifiées sont ensuite listées dans
+ *          canvas->dirtyRects.
+ * @param canvas Canevas du visualiseur
+ * @param data Données de l'image (WireTileFrame, copies, tuiles en cache, indices, tuiles codées, atlas JPEG)
+ * @param size Taille des données
+ * @param frameId Identifiant de l'image
+ * @param width Largeur annoncée par les métadonnées de capture
+ * @param height Hauteur annoncée par les métadonnées de capture
+ * @return Résultat de l'application ; le canevas n'est pas modifié en cas d'échec
+ */
+TileApplyResult TileCanvasApply(TileCanvas* canvas, const uint8_t* data, uint32_t size,
+                                uint32_t frameId, int width, int height);
+
+/**
+ * @brief Libère un canevas
+ */
+void TileCanvasFree(TileCanvas* canvas);
+
+#endif // TILES_H
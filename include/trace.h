@@ -0,0 +1,48 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Nombre d'intervalles conservés par défaut (les plus récents écrasent les plus anciens)
+#define TRACE_DEFAULT_CAPACITY 65536
+
+/**
+ * @brief Initialise l'enregistreur de traces
+ * @details Les intervalles sont alimentés par StatsCollect : chaque mesure d'étape
+ *          drainée des anneaux des threads est copiée dans un tampon binaire circulaire.
+ * @param capacity Nombre d'intervalles conservés (0 pour la valeur par défaut)
+ * @return true si le tampon a pu être alloué, false sinon
+ */
+bool TraceInit(uint32_t capacity);
+
+/**
+ * @brief Libère le tampon de traces
+ */
+void TraceShutdown(void);
+
+/**
+ * @brief Ajoute un intervalle au tampon
+ * @details Appelée uniquement depuis le thread collecteur (StatsCollect).
+ * @param startNs Début de l'intervalle (horloge monotone)
+ * @param durationNs Durée de l'intervalle
+ * @param frameId Image concernée (0 si aucune)
+ * @param stage Étape du pipeline (StatStage)
+ * @param thread Index du thread producteur
+ */
+void TraceAppend(uint64_t startNs, uint32_t durationNs, uint32_t frameId, uint8_t stage, uint8_t thread);
+
+/**
+ * @brief Vide le tampon sans le libérer
+ */
+void TraceClear(void);
+
+/**
+ * @brief Exporte les intervalles au format JSON Chrome Trace Event
+ * @details Le fichier s'ouvre dans chrome://tracing ou ui.perfetto.dev.
+ * @param path Chemin du fichier à écrire
+ * @return true si l'export réussit, false sinon
+ */
+bool TraceExportChromeJson(const char* path);
+
+#endif // TRACE_H
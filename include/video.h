@@ -0,0 +1,127 @@
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../include/colorspace.h"
+#include "../include/tiles.h"
+
+// Côté d'un macrobloc de luminance (8x8 pour chaque plan de chrominance)
+#define VIDEO_MB_SIZE 16
+
+// Reconstructions conservées de part et d'autre : l'émetteur prédit depuis la dernière image acquittée,
+// qui doit encore être chez le visualiseur malgré les images décodées depuis l'acquittement
+#define VIDEO_MAX_REFERENCES 8
+
+// Tranches au plus par image (octet sliceCount de WireVideoFrame)
+#define VIDEO_MAX_SLICES 64
+
+// Déplacement maximal recherché par macrobloc, en pixels
+#define VIDEO_MAX_MOTION 64
+
+/**
+ * @brief Image reconstruite, telle que le décodeur la voit (dimensions arrondies au macrobloc)
+ */
+typedef struct {
+    uint32_t frameId;           // Image reconstruite (0 = emplacement libre)
+    YuvImage picture;           // Luminance et chrominance NV12
+} VideoReference;
+
+/**
+ * @brief Paramètres de codage d'une image
+ */
+typedef struct {
+    int quality;                // Qualité (0-100), convertie en quantificateur
+    int gop;                    // Images au plus entre deux images I (0 = seulement à la demande)
+    int slices;                 // Tranches de lignes de macroblocs, décodables indépendamment
+    const struct RoiMap* roi;   // Écart de quantificateur par macrobloc selon l'intérêt (NULL : uniforme)
+} VideoEncodeOptions;
+
+/**
+ * @brief État du codeur : reconstructions des dernières images, identiques à celles du décodeur
+ */
+typedef struct {
+    uint32_t streamId;          // Flux vidéo, renouvelé quand les dimensions changent
+    int width;                  // Dimensions de l'image
+    int height;
+    int mbColumns;              // Grille de macroblocs
+    int mbRows;
+    YuvImage input;             // Image à coder, bords répétés jusqu'au macrobloc
+    VideoReference references[VIDEO_MAX_REFERENCES];
+    int16_t* motion;            // Par macrobloc : déplacement choisi (x, y), prédicteur du suivant
+    int framesSinceIntra;       // Images P depuis la dernière image I
+} VideoEncoder;
+
+/**
+ * @brief État du décodeur du visualiseur
+ */
+typedef struct {
+    uint32_t streamId;          // Flux reproduit (0 = aucun)
+    uint32_t frameId;           // Dernière image décodée
+    int width;
+    int height;
+    int mbColumns;
+    int mbRows;
+    VideoReference references[VIDEO_MAX_REFERENCES];
+    int16_t* motion;
+    Image image;                // Dernière image décodée (RGBA)
+    DirtyRect dirty;            // Zone modifiée par la dernière image (l'image entière)
+} VideoDecoder;
+
+/**
+ * @brief Quantificateur correspondant à une qualité
+ * @param quality Qualité (0-100)
+ * @return Quantificateur (10 à 51)
+ */
+int VideoQualityToQp(int quality);
+
+/**
+ * @brief Code une image en I ou en P
+ * @details Image P si la reconstruction de referenceFrameId est encore conservée et que le GOP n'est pas
+ *          écoulé, image I sinon. Chaque macrobloc d'une image P est sauté (recopié de la référence),
+ *          prédit par déplacement ou codé en intra ; le résidu passe par la transformée entière 4x4
+ *          de H.264 et des codes de Golomb exponentiels ; avec options->roi, chaque macrobloc transmet
+ *          son écart au quantificateur du macrobloc précédent. Le flux n'est pas du H.264 : seul ce module le lit.
+ * @param encoder État du codeur (remis à zéro si les dimensions changent)
+ * @param input Image NV12 à coder
+ * @param frameId Identifiant de l'image
+ * @param referenceFrameId Dernière image acquittée par les visualiseurs (0 pour forcer une image I)
+ * @param options Paramètres de codage
+ * @param data Reçoit l'image codée (WireVideoFrame et tranches), à libérer avec free
+ * @param size Reçoit la taille de data
+ * @return true si l'image a été codée, false en cas d'échec d'allocation
+ */
+bool VideoEncode(VideoEncoder* encoder, const YuvImage* input, uint32_t frameId, uint32_t referenceFrameId,
+                 const VideoEncodeOptions* options, uint8_t** data, uint32_t* size);
+
+/**
+ * @brief Libère les reconstructions du codeur
+ * @param encoder Codeur à libérer (remis à zéro)
+ */
+void VideoEncoderFree(VideoEncoder* encoder);
+
+/**
+ * @brief Décode une image vidéo reçue et met à jour decoder->image
+ * @details Les tranches sont décodées en parallèle sur le pool de threads (workers.h), puis
+ *          converties en RGBA par bandes.
+ * @param decoder État du décodeur
+ * @param data Image codée (WireVideoFrame et tranches)
+ * @param size Taille de data
+ * @param frameId Identifiant de l'image
+ * @param width Dimensions de l'image
+ * @param height Dimensions de l'image
+ * @return TILE_APPLY_OK, TILE_APPLY_STALE, TILE_APPLY_MISSING_BASE si la référence n'est plus conservée
+ *         (image I nécessaire) ou TILE_APPLY_ERROR
+ */
+TileApplyResult VideoDecoderApply(VideoDecoder* decoder, const uint8_t* data, uint32_t size,
+                                  uint32_t frameId, int width, int height);
+
+/**
+ * @brief Libère les reconstructions et l'image du décodeur
+ * @param decoder Décodeur à libérer (remis à zéro)
+ */
+void VideoDecoderFree(VideoDecoder* decoder);
+
+#endif // VIDEO_H
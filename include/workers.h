@@ -0,0 +1,48 @@
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Threads auxiliaires au plus (l'appelant participe en plus)
+#define WORKER_MAX_THREADS 16
+
+/**
+ * @brief Tâche exécutée par le pool, une fois par indice
+ * @param context Contexte transmis à WorkerPoolRun
+ * @param index Indice de la tâche (0 à count - 1)
+ */
+typedef void (*WorkerJob)(void* context, int index);
+
+/**
+ * @brief Démarre le pool de threads de décodage
+ * @details Un pool déjà démarré est d'abord arrêté. Sans thread auxiliaire, WorkerPoolRun
+ *          exécute les tâches dans le thread appelant.
+ * @param threads Threads auxiliaires (négatif : un par processeur, moins l'appelant)
+ * @return Nombre de threads auxiliaires démarrés
+ */
+int WorkerPoolInit(int threads);
+
+/**
+ * @brief Arrête le pool et attend la fin de ses threads
+ */
+void WorkerPoolShutdown(void);
+
+/**
+ * @brief Nombre de threads qui se partagent les tâches, appelant compris
+ * @return Au moins 1
+ */
+int WorkerPoolSize(void);
+
+/**
+ * @brief Exécute job(context, i) pour i de 0 à count - 1 et attend la fin de toutes les tâches
+ * @details Les tâches sont distribuées dynamiquement entre l'appelant et les threads du pool :
+ *          elles doivent être indépendantes et écrire dans des zones disjointes. Un seul thread
+ *          (celui de l'affichage) soumet des tâches à la fois.
+ * @param job Tâche à exécuter
+ * @param context Contexte partagé par les tâches
+ * @param count Nombre de tâches
+ */
+void WorkerPoolRun(WorkerJob job, void* context, int count);
+
+#endif // WORKERS_H
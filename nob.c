@@ -25,9 +25,9 @@ int main(int argc, char **argv)
             nob_cmd_append(&cmd, "-O2", "-march=native", "-ffast-math");
         #endif
         nob_cmd_append(&cmd, "-I./include", "-L./lib");
-        nob_cmd_append(&cmd, "./src/main.c", "./src/capture.c", "./src/network.c");
+        nob_cmd_append(&cmd, "./src/main.c", "./src/capture.c", "./src/network.c", "./src/clock.c", "./src/stats.c", "./src/trace.c", "./src/thread.c", "./src/log.c", "./src/crypto.c", "./src/keys.c", "./src/handshake.c", "./src/tiles.c", "./src/cursor.c", "./src/motion.c", "./src/tilecache.c", "./src/tilecodec.c", "./src/colorspace.c", "./src/video.c", "./src/codec.c", "./src/scale.c", "./src/roi.c", "./src/scheduler.c", "./src/workers.c", "./src/jitter.c");
         nob_cmd_append(&cmd, "-o", "./build/client");
-        nob_cmd_append(&cmd, "-lraylib", "-lenet", "-lopengl32", "-lgdi32", "-lwinmm", "-lws2_32");
+        nob_cmd_append(&cmd, "-lraylib", "-lenet", "-lopengl32", "-lgdi32", "-lwinmm", "-lws2_32", "-lbcrypt");
         if (!nob_cmd_run_sync(cmd)) return 1;
     }
     printf("----------\n");
@@ -1,8 +1,16 @@
 #include "../include/capture.h"
+#include "../include/clock.h"
+#include "../include/stats.h"
+#include "../include/log.h"
+#include "../include/codec.h"
+#include "../include/cursor.h"
+#include "../include/scale.h"
+#include "../include/thread.h"
+#include "../include/workers.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
+#include <math.h>
 
 // Variables statiques pour le système de capture
 static bool captureSystemInitialized = false;
@@ -13,18 +21,53 @@ static int virtualScreenWidth = 0;
 static int virtualScreenHeight = 0;
 static int virtualScreenLeft = 0;
 static int virtualScreenTop = 0;
+static uint32_t nextFrameId = 1;
+static void* codecEncoders[CAPTURE_LAYER_COUNT][CODEC_ID_COUNT] = {0}; // État de l'émetteur de chaque codec utilisé, par couche
+
+// Contrôle de débit : facteur de résolution appliqué en plus de la taille d'affichage du visualiseur
+#define RATE_WINDOW_NS 1000000000ULL    // Débit mesuré par fenêtres d'une seconde
+static const float rateScaleSteps[] = { 1.0f, 0.75f, 0.5f, 0.35f, 0.25f };
+static int rateStep = 0;
+static uint64_t rateWindowStartNs = 0;
+static uint64_t rateWindowBytes = 0;
+static bool rateHeadroom = true;        // Débit sous 80 % de la cible : place pour les tuiles d'intérêt sans perte
+
+// Octets par image accordés au renvoi sans perte des tuiles figées quand aucun débit n'est visé
+#define REFINE_DEFAULT_BUDGET (64 * 1024)
+
+// Dernière réduction appliquée à une couche, conservée tant que la nouvelle cible en est proche
+typedef struct {
+    int sourceWidth;
+    int sourceHeight;
+    int targetWidth;
+    int targetHeight;
+} ScaleState;
+static ScaleState scaleStates[CAPTURE_LAYER_COUNT] = {0};
+
+// Zones d'intérêt de la dernière image de chaque couche (CaptureConfig.roiQuality)
+static RoiMap roiMaps[CAPTURE_LAYER_COUNT] = {0};
+
+// Zone de l'écran couverte par la dernière capture (coordonnées de l'écran virtuel), pour placer le curseur
+static int captureOriginX = 0;
+static int captureOriginY = 0;
+static int captureAreaWidth = 0;
+static int captureAreaHeight = 0;
+
+// Forme courante du curseur, extraite seulement quand le curseur système change
+static CursorShape cursorShape = {0};
 
 #ifdef _WIN32
 // Structures et variables spécifiques à Windows
 static HDC hdcScreen = NULL;
 static HDC hdcMemDC = NULL;
 static HBITMAP hbmScreen = NULL;
+static HCURSOR cursorHandle = NULL;
 #endif
 
 // Fonction d'initialisation avec configuration
 bool InitCaptureSystem(CaptureConfig* config) {
     if (captureSystemInitialized) {
-        printf("[INFO] Système de capture déjà initialisé, mise à jour de la configuration\n");
+        LOG_INFO(LOG_MODULE_CAPTURE, "Système de capture déjà initialisé, mise à jour de la configuration");
         if (config) {
             UpdateCaptureConfig(*config);
         }
@@ -43,19 +86,31 @@ bool InitCaptureSystem(CaptureConfig* config) {
         currentConfig.changeThreshold = 5;
         currentConfig.autoAdjustQuality = true;
         currentConfig.targetMonitor = -1; // Tous les moniteurs
+        currentConfig.detectScroll = true;
+        currentConfig.useTileCache = true;
+        currentConfig.tileCodecs = true;
+        currentConfig.lossless = false;
+        currentConfig.yuvOutput = false;
+        currentConfig.codec = CODEC_ID_TILES;
+        currentConfig.videoGop = 120;
+        currentConfig.videoSlices = 4;
+        currentConfig.scaleToViewer = true;
+        currentConfig.maxBitrateKbps = 0;
+        currentConfig.roiQuality = true;
+        currentConfig.refineTiles = true;
     }
     
     // Détection des moniteurs
     monitorCount = GetMonitorsInfo(NULL, 0);
     if (monitorCount <= 0) {
-        printf("[ERROR] Aucun moniteur détecté\n");
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Aucun moniteur détecté");
         return false;
     }
     
     // Allocation de la mémoire pour les informations sur les moniteurs
     monitors = (MonitorInfo*)malloc(monitorCount * sizeof(MonitorInfo));
     if (!monitors) {
-        printf("[ERROR] Impossible d'allouer de la mémoire pour les moniteurs\n");
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer de la mémoire pour les moniteurs");
         return false;
     }
     
@@ -79,22 +134,22 @@ bool InitCaptureSystem(CaptureConfig* config) {
         if (right > virtualScreenWidth) virtualScreenWidth = right;
         if (bottom > virtualScreenHeight) virtualScreenHeight = bottom;
         
-        printf("[INFO] Moniteur %d: %s (%dx%d à %d,%d)%s\n", 
-               monitors[i].index, 
-               monitors[i].name, 
-               monitors[i].width, 
-               monitors[i].height,
-               monitors[i].x,
-               monitors[i].y,
-               monitors[i].isPrimary ? " (principal)" : "");
+        LOG_INFO(LOG_MODULE_CAPTURE, "Moniteur %d: %s (%dx%d à %d,%d)%s", 
+                                     monitors[i].index, 
+                                     monitors[i].name, 
+                                     monitors[i].width, 
+                                     monitors[i].height,
+                                     monitors[i].x,
+                                     monitors[i].y,
+                                     monitors[i].isPrimary ? " (principal)" : "");
     }
     
     // Ajustement des dimensions virtuelles
     virtualScreenWidth -= virtualScreenLeft;
     virtualScreenHeight -= virtualScreenTop;
     
-    printf("[INFO] Écran virtuel: %dx%d (origine à %d,%d)\n", 
-           virtualScreenWidth, virtualScreenHeight, virtualScreenLeft, virtualScreenTop);
+    LOG_INFO(LOG_MODULE_CAPTURE, "Écran virtuel: %dx%d (origine à %d,%d)", 
+                                 virtualScreenWidth, virtualScreenHeight, virtualScreenLeft, virtualScreenTop);
     
     // Sélection de la méthode de capture
     if (currentConfig.method == CAPTURE_METHOD_AUTO) {
@@ -108,7 +163,7 @@ bool InitCaptureSystem(CaptureConfig* config) {
     // Initialisation spécifique à la méthode de capture
     switch (currentConfig.method) {
         case CAPTURE_METHOD_RAYLIB:
-            printf("[INFO] Utilisation de la méthode de capture raylib\n");
+            LOG_INFO(LOG_MODULE_CAPTURE, "Utilisation de la méthode de capture raylib");
             break;
             
         case CAPTURE_METHOD_WIN_GDI:
@@ -116,7 +171,7 @@ bool InitCaptureSystem(CaptureConfig* config) {
             // Initialisation des contextes de périphérique Windows
             hdcScreen = GetDC(NULL);
             if (!hdcScreen) {
-                printf("[ERROR] Impossible d'obtenir le contexte de périphérique de l'écran\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'obtenir le contexte de périphérique de l'écran");
                 free(monitors);
                 monitors = NULL;
                 return false;
@@ -124,7 +179,7 @@ bool InitCaptureSystem(CaptureConfig* config) {
             
             hdcMemDC = CreateCompatibleDC(hdcScreen);
             if (!hdcMemDC) {
-                printf("[ERROR] Impossible de créer un contexte de périphérique compatible\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible de créer un contexte de périphérique compatible");
                 ReleaseDC(NULL, hdcScreen);
                 hdcScreen = NULL;
                 free(monitors);
@@ -132,21 +187,21 @@ bool InitCaptureSystem(CaptureConfig* config) {
                 return false;
             }
             
-            printf("[INFO] Utilisation de la méthode de capture Windows GDI\n");
+            LOG_INFO(LOG_MODULE_CAPTURE, "Utilisation de la méthode de capture Windows GDI");
 #else
-            printf("[WARNING] Méthode Windows GDI non disponible, utilisation de raylib\n");
+            LOG_WARNING(LOG_MODULE_CAPTURE, "Méthode Windows GDI non disponible, utilisation de raylib");
             currentConfig.method = CAPTURE_METHOD_RAYLIB;
 #endif
             break;
             
         default:
-            printf("[WARNING] Méthode de capture non reconnue, utilisation de raylib\n");
+            LOG_WARNING(LOG_MODULE_CAPTURE, "Méthode de capture non reconnue, utilisation de raylib");
             currentConfig.method = CAPTURE_METHOD_RAYLIB;
             break;
     }
     
     captureSystemInitialized = true;
-    printf("[INFO] Système de capture initialisé avec succès\n");
+    LOG_INFO(LOG_MODULE_CAPTURE, "Système de capture initialisé avec succès");
     return true;
 }
 
@@ -178,9 +233,21 @@ void CloseCaptureSystem(void) {
     }
     
     monitorCount = 0;
+    for (int layer = 0; layer < CAPTURE_LAYER_COUNT; layer++) {
+        for (int i = 0; i < CODEC_ID_COUNT; i++) {
+            if (codecEncoders[layer][i]) CodecGet((uint32_t)i)->destroyEncoder(codecEncoders[layer][i]);
+            codecEncoders[layer][i] = NULL;
+        }
+        RoiMapFree(&roiMaps[layer]);
+    }
+    free(cursorShape.pixels);
+    memset(&cursorShape, 0, sizeof(cursorShape));
+#ifdef _WIN32
+    cursorHandle = NULL;
+#endif
     captureSystemInitialized = false;
     
-    printf("[INFO] Système de capture terminé\n");
+    LOG_INFO(LOG_MODULE_CAPTURE, "Système de capture terminé");
 }
 
 int GetMonitorsInfo(MonitorInfo* output, int maxMonitors) {
@@ -250,6 +317,35 @@ int GetMonitorsInfo(MonitorInfo* output, int maxMonitors) {
     return count;
 }
 
+// NV12 demandé par la configuration ou par le codec configuré
+static bool CaptureWantsYuv(void) {
+    const Codec* codec = CodecGet(currentConfig.codec);
+    return currentConfig.yuvOutput || (codec && (codec->capabilities & CODEC_CAP_YUV));
+}
+
+// Plans NV12 de la capture si la configuration les demande (NULL sinon ou si l'allocation échoue)
+static YuvImage* CaptureYuvTarget(CaptureData* capture) {
+    if (!CaptureWantsYuv()) return NULL;
+    if (!YuvImageAlloc(&capture->yuv, capture->image.width, capture->image.height)) {
+        LOG_WARNING(LOG_MODULE_CAPTURE, "Impossible d'allouer l'image NV12");
+        return NULL;
+    }
+    return &capture->yuv;
+}
+
+// Capture raylib, déjà en RGBA : le NV12 n'a pas pu être produit pendant la lecture du bitmap
+static void CaptureRgbaToYuv(CaptureData* capture) {
+    if (!CaptureWantsYuv() || capture->yuv.y) return;
+    if (capture->image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return;
+    YuvImage* yuv = CaptureYuvTarget(capture);
+    if (!yuv) return;
+    
+    uint64_t convertStart = StatsBegin();
+    ColorConvertRgbaToNv12((const uint8_t*)capture->image.data, (size_t)capture->image.width * 4,
+                           capture->image.width, capture->image.height, yuv);
+    StatsEndFrame(STAT_STAGE_SWIZZLE, convertStart, capture->frameId);
+}
+
 CaptureData CaptureScreen(void) {
     if (currentConfig.targetMonitor >= 0 && currentConfig.targetMonitor < monitorCount) {
         // Capture d'un moniteur spécifique
@@ -259,7 +355,7 @@ CaptureData CaptureScreen(void) {
         CaptureData captureData = {0};
         
         if (!captureSystemInitialized) {
-            printf("[ERROR] Le système de capture n'est pas initialisé\n");
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Le système de capture n'est pas initialisé");
             return captureData;
         }
         
@@ -267,13 +363,20 @@ CaptureData CaptureScreen(void) {
         captureData.width = virtualScreenWidth;
         captureData.height = virtualScreenHeight;
         captureData.monitorIndex = -1; // Tous les moniteurs
-        captureData.timestamp = time(NULL);
+        captureOriginX = virtualScreenLeft;
+        captureOriginY = virtualScreenTop;
+        captureAreaWidth = virtualScreenWidth;
+        captureAreaHeight = virtualScreenHeight;
+        captureData.frameId = nextFrameId++;
+        captureData.timestamp = ClockNowNs();
         
         // Capture selon la méthode choisie
+        uint64_t stageStart = StatsBegin();
         switch (currentConfig.method) {
             case CAPTURE_METHOD_RAYLIB:
                 // Raylib ne peut pas capturer tous les moniteurs directement, on utilise le premier
                 captureData.image = LoadImageFromScreen();
+                StatsEndFrame(STAT_STAGE_CAPTURE, stageStart, captureData.frameId);
                 break;
                 
             case CAPTURE_METHOD_WIN_GDI:
@@ -286,7 +389,7 @@ CaptureData CaptureScreen(void) {
                 
                 hbmScreen = CreateCompatibleBitmap(hdcScreen, virtualScreenWidth, virtualScreenHeight);
                 if (!hbmScreen) {
-                    printf("[ERROR] Impossible de créer un bitmap compatible\n");
+                    LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible de créer un bitmap compatible");
                     return captureData;
                 }
                 
@@ -296,7 +399,7 @@ CaptureData CaptureScreen(void) {
                 // Copie de l'écran dans le bitmap
                 if (!BitBlt(hdcMemDC, 0, 0, virtualScreenWidth, virtualScreenHeight,
                           hdcScreen, virtualScreenLeft, virtualScreenTop, SRCCOPY)) {
-                    printf("[ERROR] Échec de BitBlt\n");
+                    LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de BitBlt");
                     SelectObject(hdcMemDC, hOldBitmap);
                     return captureData;
                 }
@@ -316,6 +419,8 @@ CaptureData CaptureScreen(void) {
                 // Récupération des données du bitmap
                 if (screenData && GetDIBits(hdcMemDC, hbmScreen, 0, virtualScreenHeight, 
                                          screenData, &bmi, DIB_RGB_COLORS)) {
+                    StatsEndFrame(STAT_STAGE_CAPTURE, stageStart, captureData.frameId);
+                    
                     // Conversion des données en format raylib
                     captureData.image.data = malloc(virtualScreenWidth * virtualScreenHeight * 4);
                     if (captureData.image.data) {
@@ -324,15 +429,13 @@ CaptureData CaptureScreen(void) {
                         captureData.image.mipmaps = 1;
                         captureData.image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
                         
-                        // Copie et conversion BGRA (Windows) à RGBA (raylib)
-                        for (int i = 0; i < virtualScreenWidth * virtualScreenHeight; i++) {
-                            unsigned char* dst = (unsigned char*)captureData.image.data + i * 4;
-                            unsigned char* src = screenData + i * 4;
-                            dst[0] = src[2]; // R <- B
-                            dst[1] = src[1]; // G <- G
-                            dst[2] = src[0]; // B <- R
-                            dst[3] = 255;    // A (opaque)
-                        }
+                        uint64_t swizzleStart = StatsBegin();
+                        // Conversion BGRA (Windows) en RGBA (raylib), et en NV12 pendant la même lecture si demandé
+                        ColorConvertBgra(screenData, (size_t)captureData.image.width * 4,
+                                         captureData.image.width, captureData.image.height,
+                                         (uint8_t*)captureData.image.data, (size_t)captureData.image.width * 4,
+                                         CaptureYuvTarget(&captureData));
+                        StatsEndFrame(STAT_STAGE_SWIZZLE, swizzleStart, captureData.frameId);
                     }
                     
                     free(screenData);
@@ -344,24 +447,25 @@ CaptureData CaptureScreen(void) {
                 break;
                 
             default:
-                printf("[ERROR] Méthode de capture non implémentée\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Méthode de capture non implémentée");
                 break;
         }
         
         // Création de la texture pour l'affichage si l'image a été capturée
         if (captureData.image.data) {
+            CaptureRgbaToYuv(&captureData);
+            uint64_t uploadStart = StatsBegin();
             captureData.texture = LoadTextureFromImage(captureData.image);
+            StatsEndFrame(STAT_STAGE_UPLOAD, uploadStart, captureData.frameId);
+            StatsAddCounter(STAT_COUNTER_FRAMES_CAPTURED, 1);
         } else {
-            printf("[ERROR] Échec de la capture d'écran\n");
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de la capture d'écran");
         }
         
         // Initialisation des autres champs
         captureData.compressedData = NULL;
         captureData.compressedSize = 0;
-        captureData.encryptedData = NULL;
-        captureData.encryptedSize = 0;
         captureData.isCompressed = false;
-        captureData.isEncrypted = false;
         captureData.previousFrame = NULL;
         captureData.hasChanged = true; // Première capture, donc considérée comme un changement
         
@@ -373,14 +477,14 @@ CaptureData CaptureMonitor(int monitorIndex) {
     CaptureData captureData = {0};
     
     if (!captureSystemInitialized) {
-        printf("[ERROR] Le système de capture n'est pas initialisé\n");
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Le système de capture n'est pas initialisé");
         return captureData;
     }
     
     // Vérification de l'index du moniteur
     if (monitorIndex < 0 || monitorIndex >= monitorCount) {
-        printf("[ERROR] Index de moniteur invalide: %d (doit être entre 0 et %d)\n", 
-               monitorIndex, monitorCount - 1);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Index de moniteur invalide: %d (doit être entre 0 et %d)", 
+                                      monitorIndex, monitorCount - 1);
         return captureData;
     }
     
@@ -388,14 +492,21 @@ CaptureData CaptureMonitor(int monitorIndex) {
     captureData.width = monitors[monitorIndex].width;
     captureData.height = monitors[monitorIndex].height;
     captureData.monitorIndex = monitorIndex;
-    captureData.timestamp = time(NULL);
+    captureOriginX = monitors[monitorIndex].x;
+    captureOriginY = monitors[monitorIndex].y;
+    captureAreaWidth = monitors[monitorIndex].width;
+    captureAreaHeight = monitors[monitorIndex].height;
+    captureData.frameId = nextFrameId++;
+    captureData.timestamp = ClockNowNs();
     
     // Capture selon la méthode choisie
+    uint64_t stageStart = StatsBegin();
     switch (currentConfig.method) {
         case CAPTURE_METHOD_RAYLIB:
             // Avec raylib, on peut seulement capturer le moniteur actuel où la fenêtre est affichée
             // Ceci est une limitation de raylib
             captureData.image = LoadImageFromScreen();
+            StatsEndFrame(STAT_STAGE_CAPTURE, stageStart, captureData.frameId);
             break;
             
         case CAPTURE_METHOD_WIN_GDI:
@@ -410,7 +521,7 @@ CaptureData CaptureMonitor(int monitorIndex) {
                                              monitors[monitorIndex].width, 
                                              monitors[monitorIndex].height);
             if (!hbmScreen) {
-                printf("[ERROR] Impossible de créer un bitmap compatible\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible de créer un bitmap compatible");
                 return captureData;
             }
             
@@ -420,7 +531,7 @@ CaptureData CaptureMonitor(int monitorIndex) {
             // Copie de l'écran dans le bitmap
             if (!BitBlt(hdcMemDC, 0, 0, monitors[monitorIndex].width, monitors[monitorIndex].height,
                       hdcScreen, monitors[monitorIndex].x, monitors[monitorIndex].y, SRCCOPY)) {
-                printf("[ERROR] Échec de BitBlt\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de BitBlt");
                 SelectObject(hdcMemDC, hOldBitmap);
                 return captureData;
             }
@@ -441,6 +552,8 @@ CaptureData CaptureMonitor(int monitorIndex) {
             // Récupération des données du bitmap
             if (screenData && GetDIBits(hdcMemDC, hbmScreen, 0, monitors[monitorIndex].height, 
                                      screenData, &bmi, DIB_RGB_COLORS)) {
+                StatsEndFrame(STAT_STAGE_CAPTURE, stageStart, captureData.frameId);
+                
                 // Conversion des données en format raylib
                 captureData.image.data = malloc(monitors[monitorIndex].width * 
                                              monitors[monitorIndex].height * 4);
@@ -450,15 +563,13 @@ CaptureData CaptureMonitor(int monitorIndex) {
                     captureData.image.mipmaps = 1;
                     captureData.image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
                     
-                    // Copie et conversion BGRA (Windows) à RGBA (raylib)
-                    for (int i = 0; i < monitors[monitorIndex].width * monitors[monitorIndex].height; i++) {
-                        unsigned char* dst = (unsigned char*)captureData.image.data + i * 4;
-                        unsigned char* src = screenData + i * 4;
-                        dst[0] = src[2]; // R <- B
-                        dst[1] = src[1]; // G <- G
-                        dst[2] = src[0]; // B <- R
-                        dst[3] = 255;    // A (opaque)
-                    }
+                    uint64_t swizzleStart = StatsBegin();
+                    // Conversion BGRA (Windows) en RGBA (raylib), et en NV12 pendant la même lecture si demandé
+                    ColorConvertBgra(screenData, (size_t)captureData.image.width * 4,
+                                     captureData.image.width, captureData.image.height,
+                                     (uint8_t*)captureData.image.data, (size_t)captureData.image.width * 4,
+                                     CaptureYuvTarget(&captureData));
+                    StatsEndFrame(STAT_STAGE_SWIZZLE, swizzleStart, captureData.frameId);
                 }
                 
                 free(screenData);
@@ -470,24 +581,25 @@ CaptureData CaptureMonitor(int monitorIndex) {
             break;
             
         default:
-            printf("[ERROR] Méthode de capture non implémentée\n");
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Méthode de capture non implémentée");
             break;
     }
     
     // Création de la texture pour l'affichage si l'image a été capturée
     if (captureData.image.data) {
+        CaptureRgbaToYuv(&captureData);
+        uint64_t uploadStart = StatsBegin();
         captureData.texture = LoadTextureFromImage(captureData.image);
+        StatsEndFrame(STAT_STAGE_UPLOAD, uploadStart, captureData.frameId);
+        StatsAddCounter(STAT_COUNTER_FRAMES_CAPTURED, 1);
     } else {
-        printf("[ERROR] Échec de la capture du moniteur %d\n", monitorIndex);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de la capture du moniteur %d", monitorIndex);
     }
     
     // Initialisation des autres champs
     captureData.compressedData = NULL;
     captureData.compressedSize = 0;
-    captureData.encryptedData = NULL;
-    captureData.encryptedSize = 0;
     captureData.isCompressed = false;
-    captureData.isEncrypted = false;
     captureData.previousFrame = NULL;
     captureData.hasChanged = true; // Première capture, donc considérée comme un changement
     
@@ -498,7 +610,7 @@ CaptureData CaptureScreenRegion(Rectangle region) {
     CaptureData captureData = {0};
     
     if (!captureSystemInitialized) {
-        printf("[ERROR] Le système de capture n'est pas initialisé\n");
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Le système de capture n'est pas initialisé");
         return captureData;
     }
     
@@ -509,8 +621,8 @@ CaptureData CaptureScreenRegion(Rectangle region) {
     if (region.y + region.height > virtualScreenHeight) region.height = virtualScreenHeight - region.y;
     
     if (region.width <= 0 || region.height <= 0) {
-        printf("[ERROR] Région de capture invalide: %.0fx%.0f à (%.0f,%.0f)\n", 
-               region.width, region.height, region.x, region.y);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Région de capture invalide: %.0fx%.0f à (%.0f,%.0f)", 
+                                      region.width, region.height, region.x, region.y);
         return captureData;
     }
     
@@ -518,9 +630,15 @@ CaptureData CaptureScreenRegion(Rectangle region) {
     captureData.width = (int)region.width;
     captureData.height = (int)region.height;
     captureData.monitorIndex = -1; // Région spécifique
-    captureData.timestamp = time(NULL);
+    captureOriginX = virtualScreenLeft + (int)region.x;
+    captureOriginY = virtualScreenTop + (int)region.y;
+    captureAreaWidth = (int)region.width;
+    captureAreaHeight = (int)region.height;
+    captureData.frameId = nextFrameId++;
+    captureData.timestamp = ClockNowNs();
     
     // Capture selon la méthode choisie
+    uint64_t stageStart = StatsBegin();
     switch (currentConfig.method) {
         case CAPTURE_METHOD_RAYLIB:
             // On capture tout l'écran et on extrait la région
@@ -530,6 +648,7 @@ CaptureData CaptureScreenRegion(Rectangle region) {
                                                  (Rectangle){region.x, region.y, region.width, region.height});
                 UnloadImage(fullScreenImage);
             }
+            StatsEndFrame(STAT_STAGE_CAPTURE, stageStart, captureData.frameId);
             break;
             
         case CAPTURE_METHOD_WIN_GDI:
@@ -542,7 +661,7 @@ CaptureData CaptureScreenRegion(Rectangle region) {
             
             hbmScreen = CreateCompatibleBitmap(hdcScreen, (int)region.width, (int)region.height);
             if (!hbmScreen) {
-                printf("[ERROR] Impossible de créer un bitmap compatible\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible de créer un bitmap compatible");
                 return captureData;
             }
             
@@ -555,7 +674,7 @@ CaptureData CaptureScreenRegion(Rectangle region) {
                       virtualScreenLeft + (int)region.x, 
                       virtualScreenTop + (int)region.y, 
                       SRCCOPY)) {
-                printf("[ERROR] Échec de BitBlt\n");
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de BitBlt");
                 SelectObject(hdcMemDC, hOldBitmap);
                 return captureData;
             }
@@ -575,6 +694,8 @@ CaptureData CaptureScreenRegion(Rectangle region) {
             // Récupération des données du bitmap
             if (screenData && GetDIBits(hdcMemDC, hbmScreen, 0, (int)region.height, 
                                      screenData, &bmi, DIB_RGB_COLORS)) {
+                StatsEndFrame(STAT_STAGE_CAPTURE, stageStart, captureData.frameId);
+                
                 // Conversion des données en format raylib
                 captureData.image.data = malloc((int)region.width * (int)region.height * 4);
                 if (captureData.image.data) {
@@ -583,15 +704,13 @@ CaptureData CaptureScreenRegion(Rectangle region) {
                     captureData.image.mipmaps = 1;
                     captureData.image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
                     
-                    // Copie et conversion BGRA (Windows) à RGBA (raylib)
-                    for (int i = 0; i < (int)region.width * (int)region.height; i++) {
-                        unsigned char* dst = (unsigned char*)captureData.image.data + i * 4;
-                        unsigned char* src = screenData + i * 4;
-                        dst[0] = src[2]; // R <- B
-                        dst[1] = src[1]; // G <- G
-                        dst[2] = src[0]; // B <- R
-                        dst[3] = 255;    // A (opaque)
-                    }
+                    uint64_t swizzleStart = StatsBegin();
+                    // Conversion BGRA (Windows) en RGBA (raylib), et en NV12 pendant la même lecture si demandé
+                    ColorConvertBgra(screenData, (size_t)captureData.image.width * 4,
+                                     captureData.image.width, captureData.image.height,
+                                     (uint8_t*)captureData.image.data, (size_t)captureData.image.width * 4,
+                                     CaptureYuvTarget(&captureData));
+                    StatsEndFrame(STAT_STAGE_SWIZZLE, swizzleStart, captureData.frameId);
                 }
                 
                 free(screenData);
@@ -603,24 +722,25 @@ CaptureData CaptureScreenRegion(Rectangle region) {
             break;
             
         default:
-            printf("[ERROR] Méthode de capture non implémentée\n");
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Méthode de capture non implémentée");
             break;
     }
     
     // Création de la texture pour l'affichage si l'image a été capturée
     if (captureData.image.data) {
+        CaptureRgbaToYuv(&captureData);
+        uint64_t uploadStart = StatsBegin();
         captureData.texture = LoadTextureFromImage(captureData.image);
+        StatsEndFrame(STAT_STAGE_UPLOAD, uploadStart, captureData.frameId);
+        StatsAddCounter(STAT_COUNTER_FRAMES_CAPTURED, 1);
     } else {
-        printf("[ERROR] Échec de la capture de la région\n");
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de la capture de la région");
     }
     
     // Initialisation des autres champs
     captureData.compressedData = NULL;
     captureData.compressedSize = 0;
-    captureData.encryptedData = NULL;
-    captureData.encryptedSize = 0;
     captureData.isCompressed = false;
-    captureData.isEncrypted = false;
     captureData.previousFrame = NULL;
     captureData.hasChanged = true; // Première capture, donc considérée comme un changement
     
@@ -633,6 +753,7 @@ void UnloadCaptureData(CaptureData* capture) {
     // Libération des ressources raylib
     if (capture->image.data != NULL) UnloadImage(capture->image);
     if (capture->texture.id > 0) UnloadTexture(capture->texture);
+    YuvImageFree(&capture->yuv);
     
     // Libération des données compressées
     if (capture->compressedData != NULL) {
@@ -642,14 +763,6 @@ void UnloadCaptureData(CaptureData* capture) {
         capture->isCompressed = false;
     }
     
-    // Libération des données chiffrées
-    if (capture->encryptedData != NULL) {
-        free(capture->encryptedData);
-        capture->encryptedData = NULL;
-        capture->encryptedSize = 0;
-        capture->isEncrypted = false;
-    }
-    
     // Libération de l'image précédente
     if (capture->previousFrame != NULL) {
         free(capture->previousFrame);
@@ -662,77 +775,266 @@ void UnloadCaptureData(CaptureData* capture) {
     capture->hasChanged = false;
     capture->monitorIndex = -1;
     capture->timestamp = 0;
+    capture->encodeStartNs = 0;
+    capture->encodeEndNs = 0;
+    capture->sendNs = 0;
+    capture->receiveNs = 0;
+    capture->decodeNs = 0;
+    capture->presentNs = 0;
 }
 
-bool CompressCaptureData(CaptureData* capture, int quality) {
-    if (capture == NULL || !capture->image.data) return false;
-    
-    // Limiter la qualité entre 0 et 100
-    if (quality < 0) quality = 0;
-    if (quality > 100) quality = 100;
+// Dimensions réduites pour un rapport donné : les rapports de 1/2 et 1/4 restent exacts
+static void ScaleTarget(int width, int height, float ratio, int* targetWidth, int* targetHeight) {
+    if (ratio >= 0.5f && ratio < 0.55f) {
+        *targetWidth = width / 2;
+        *targetHeight = height / 2;
+    } else if (ratio >= 0.25f && ratio < 0.28f) {
+        *targetWidth = width / 4;
+        *targetHeight = height / 4;
+    } else {
+        // Dimensions paires pour le sous-échantillonnage de la chrominance (NV12)
+        *targetWidth = (int)(width * ratio) & ~1;
+        *targetHeight = (int)(height * ratio) & ~1;
+    }
+    if (*targetWidth < 2) *targetWidth = 2;
+    if (*targetHeight < 2) *targetHeight = 2;
+}
+
+bool ExtractCaptureRegion(const CaptureData* capture, Rectangle region, CaptureData* detail) {
+    if (capture == NULL || detail == NULL || !capture->image.data) return false;
+    if (capture->image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return false;
+    
+    // Région bornée à l'image
+    int x = region.x < 0 ? 0 : (int)region.x;
+    int y = region.y < 0 ? 0 : (int)region.y;
+    int right = (int)(region.x + region.width);
+    int bottom = (int)(region.y + region.height);
+    if (right > capture->image.width) right = capture->image.width;
+    if (bottom > capture->image.height) bottom = capture->image.height;
+    int width = right - x;
+    int height = bottom - y;
+    if (width <= 0 || height <= 0) return false;
+    
+    unsigned char* pixels = (unsigned char*)malloc((size_t)width * height * 4);
+    if (!pixels) {
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer la région %dx%d de l'image %u", width, height, capture->frameId);
+        return false;
+    }
+    size_t sourceStride = (size_t)capture->image.width * 4;
+    for (int row = 0; row < height; row++) {
+        memcpy(pixels + (size_t)row * width * 4,
+               (const unsigned char*)capture->image.data + (size_t)(y + row) * sourceStride + (size_t)x * 4,
+               (size_t)width * 4);
+    }
     
-    // Libérer les données compressées existantes
-    if (capture->compressedData != NULL) {
-        free(capture->compressedData);
-        capture->compressedData = NULL;
-        capture->compressedSize = 0;
+    memset(detail, 0, sizeof(*detail));
+    detail->image = (Image){ pixels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    detail->width = width;
+    detail->height = height;
+    detail->sourceX = x;
+    detail->sourceY = y;
+    detail->layer = CAPTURE_LAYER_DETAIL;
+    detail->codec = capture->codec;
+    detail->hasChanged = capture->hasChanged;
+    detail->monitorIndex = capture->monitorIndex;
+    detail->frameId = capture->frameId;
+    detail->timestamp = capture->timestamp;
+    return true;
+}
+
+bool ScaleCaptureData(CaptureData* capture, int viewerWidth, int viewerHeight) {
+    if (capture == NULL || !capture->image.data || (unsigned)capture->layer >= CAPTURE_LAYER_COUNT) return false;
+    
+    int width = capture->image.width;
+    int height = capture->image.height;
+    capture->sourceWidth = width;
+    capture->sourceHeight = height;
+    if (capture->image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return true;
+    
+    // Taille d'affichage du visualiseur, sans agrandir, puis réduction du contrôle de débit
+    float ratio = 1.0f;
+    if (currentConfig.scaleToViewer && viewerWidth > 0 && viewerHeight > 0) {
+        ratio = fminf((float)viewerWidth / width, (float)viewerHeight / height);
+        if (ratio > 1.0f) ratio = 1.0f;
     }
+    ratio *= rateScaleSteps[rateStep];
     
-    // Méthode de compression améliorée
-    // Nous utilisons JPEG pour une meilleure compression
+    // Presque la taille capturée : le filtrage coûterait plus qu'il n'économise
+    ScaleState* state = &scaleStates[capture->layer];
+    if (ratio > 0.9f) {
+        state->targetWidth = 0;
+        state->targetHeight = 0;
+        return true;
+    }
     
-    // Créer un nom de fichier temporaire
-    char tempFile[256] = {0};
-    sprintf(tempFile, "temp_capture_%llu.jpg", (unsigned long long)capture->timestamp);
+    int targetWidth;
+    int targetHeight;
+    ScaleTarget(width, height, ratio, &targetWidth, &targetHeight);
     
-    // Convertir l'image en JPG avec la qualité spécifiée
-    ExportImage(capture->image, tempFile);
+    // Cible à moins de 10 % de la précédente : garder celle-ci, le canevas des visualiseurs reste valable
+    if (state->targetWidth > 0 && width == state->sourceWidth && height == state->sourceHeight &&
+        abs(targetWidth - state->targetWidth) * 10 < state->targetWidth &&
+        abs(targetHeight - state->targetHeight) * 10 < state->targetHeight) {
+        targetWidth = state->targetWidth;
+        targetHeight = state->targetHeight;
+    }
     
-    // Charger le fichier en mémoire
-    FILE* file = fopen(tempFile, "rb");
-    if (!file) {
-        printf("[ERROR] Impossible d'ouvrir le fichier temporaire pour la compression\n");
+    uint64_t stageStart = StatsBegin();
+    unsigned char* scaled = (unsigned char*)malloc((size_t)targetWidth * targetHeight * 4);
+    if (!scaled || !ScaleImage((const uint8_t*)capture->image.data, (size_t)width * 4, width, height,
+                               scaled, (size_t)targetWidth * 4, targetWidth, targetHeight)) {
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible de réduire l'image %u en %dx%d", capture->frameId, targetWidth, targetHeight);
+        free(scaled);
         return false;
     }
     
-    // Obtenir la taille du fichier
-    fseek(file, 0, SEEK_END);
-    long fileSize = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    // L'image réduite remplace la capture ; le NV12 éventuel sera recalculé par le codec
+    UnloadImage(capture->image);
+    capture->image.data = scaled;
+    capture->image.width = targetWidth;
+    capture->image.height = targetHeight;
+    capture->image.mipmaps = 1;
+    YuvImageFree(&capture->yuv);
+    capture->width = targetWidth;
+    capture->height = targetHeight;
+    StatsEndFrame(STAT_STAGE_SCALE, stageStart, capture->frameId);
+    
+    state->sourceWidth = width;
+    state->sourceHeight = height;
+    state->targetWidth = targetWidth;
+    state->targetHeight = targetHeight;
+    return true;
+}
+
+// Débit mesuré sur la dernière seconde : la résolution baisse d'un cran au-delà de maxBitrateKbps,
+// remonte d'un cran sous la moitié
+static void UpdateRateControl(const CaptureData* capture) {
+    if (currentConfig.maxBitrateKbps <= 0) {
+        rateStep = 0;
+        rateHeadroom = true;
+        return;
+    }
+    
+    rateWindowBytes += (uint64_t)capture->compressedSize;
+    uint64_t elapsed = capture->encodeEndNs - rateWindowStartNs;
+    if (rateWindowStartNs == 0 || elapsed > 10 * RATE_WINDOW_NS) {
+        rateWindowStartNs = capture->encodeEndNs;
+        rateWindowBytes = 0;
+        return;
+    }
+    if (elapsed < RATE_WINDOW_NS) return;
+    
+    uint64_t kbps = rateWindowBytes * 8 * 1000000ULL / elapsed;
+    rateHeadroom = kbps * 10 < (uint64_t)currentConfig.maxBitrateKbps * 8;
+    int stepCount = (int)(sizeof(rateScaleSteps) / sizeof(rateScaleSteps[0]));
+    if (kbps * 10 > (uint64_t)currentConfig.maxBitrateKbps * 11 && rateStep < stepCount - 1) {
+        rateStep++;
+        LOG_INFO(LOG_MODULE_CAPTURE, "Débit de %llu kbit/s: résolution envoyée réduite à %.0f %%",
+                                     (unsigned long long)kbps, rateScaleSteps[rateStep] * 100.0f);
+    } else if (kbps * 2 < (uint64_t)currentConfig.maxBitrateKbps && rateStep > 0) {
+        rateStep--;
+        LOG_INFO(LOG_MODULE_CAPTURE, "Débit de %llu kbit/s: résolution envoyée remontée à %.0f %%",
+                                     (unsigned long long)kbps, rateScaleSteps[rateStep] * 100.0f);
+    }
+    rateWindowStartNs = capture->encodeEndNs;
+    rateWindowBytes = 0;
+}
+
+// Marge du renvoi sans perte des tuiles figées : un huitième du débit visé par image, seulement sous
+// 80 % de la cible (les renvois, comptés dans le débit mesuré, n'emmènent pas au-delà de 95 %)
+static uint32_t RefineBudget(void) {
+    if (!currentConfig.refineTiles) return 0;
+    if (currentConfig.maxBitrateKbps <= 0) return REFINE_DEFAULT_BUDGET;
+    if (!rateHeadroom || rateStep > 0) return 0;
+    uint64_t bytesPerFrame = (uint64_t)currentConfig.maxBitrateKbps * 125 * currentConfig.captureInterval / 1000;
+    return (uint32_t)(bytesPerFrame / 8);
+}
+
+// Curseur et fenêtre au premier plan, ramenés aux pixels de l'image à coder (réduite, ou région zoomée)
+static void ReadRoiFocus(const CaptureData* capture, RoiFocus* focus) {
+    memset(focus, 0, sizeof(*focus));
     
-    // Allouer de la mémoire pour les données compressées
-    capture->compressedData = (unsigned char*)malloc(fileSize);
-    if (capture->compressedData == NULL) {
-        fclose(file);
-        remove(tempFile);
-        printf("[ERROR] Impossible d'allouer de la mémoire pour les données compressées\n");
-        return false;
+#ifdef _WIN32
+    // Seule la capture GDI connaît la position de la zone capturée dans l'écran virtuel
+    if (currentConfig.method != CAPTURE_METHOD_WIN_GDI) return;
+    
+    int sourceWidth = capture->sourceWidth > 0 ? capture->sourceWidth : capture->width;
+    int sourceHeight = capture->sourceHeight > 0 ? capture->sourceHeight : capture->height;
+    if (sourceWidth <= 0 || sourceHeight <= 0) return;
+    float scaleX = (float)capture->width / sourceWidth;
+    float scaleY = (float)capture->height / sourceHeight;
+    int originX = captureOriginX + capture->sourceX;
+    int originY = captureOriginY + capture->sourceY;
+    
+    POINT cursor;
+    if (GetCursorPos(&cursor)) {
+        focus->hasCursor = true;
+        focus->cursorX = (int)((cursor.x - originX) * scaleX);
+        focus->cursorY = (int)((cursor.y - originY) * scaleY);
     }
     
-    // Lire les données du fichier
-    capture->compressedSize = (int)fread(capture->compressedData, 1, fileSize, file);
-    fclose(file);
+    // Fenêtre active, sauf le bureau lui-même (elle couvrirait tout l'écran)
+    HWND window = GetForegroundWindow();
+    RECT rect;
+    if (window && window != GetDesktopWindow() && window != GetShellWindow() && GetWindowRect(window, &rect)) {
+        focus->hasWindow = true;
+        focus->windowX = (int)((rect.left - originX) * scaleX);
+        focus->windowY = (int)((rect.top - originY) * scaleY);
+        focus->windowWidth = (int)((rect.right - rect.left) * scaleX);
+        focus->windowHeight = (int)((rect.bottom - rect.top) * scaleY);
+    }
+#else
+    (void)capture;
+#endif
+}
+
+// État de l'émetteur d'un codec pour une couche, créé à sa première image
+static void* CaptureEncoder(const Codec* codec, CaptureLayer layer) {
+    if (!codecEncoders[layer][codec->id]) codecEncoders[layer][codec->id] = codec->createEncoder();
+    return codecEncoders[layer][codec->id];
+}
+
+bool CompressCaptureData(CaptureData* capture, int quality) {
+    if (capture == NULL || !capture->image.data) return false;
+    
+    // Limiter la qualité entre 0 et 100
+    if (quality < 0) quality = 0;
+    if (quality > 100) quality = 100;
     
-    // Supprimer le fichier temporaire
-    remove(tempFile);
+    capture->encodeStartNs = ClockNowNs();
     
-    if (capture->compressedSize <= 0) {
+    // Libérer les données compressées existantes
+    if (capture->compressedData != NULL) {
         free(capture->compressedData);
         capture->compressedData = NULL;
         capture->compressedSize = 0;
-        printf("[ERROR] Échec de la compression de l'image\n");
-        return false;
     }
     
-    capture->isCompressed = true;
-    
-    // Calcul du ratio de compression
-    int originalSize = capture->width * capture->height * 4; // RGBA
-    float ratio = (float)originalSize / capture->compressedSize;
+    const Codec* codec = CodecGet(capture->codec);
+    void* encoder = codec && (unsigned)capture->layer < CAPTURE_LAYER_COUNT ? CaptureEncoder(codec, capture->layer) : NULL;
+    if (!encoder) {
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Codec %d indisponible pour l'image %u", (int)capture->codec, capture->frameId);
+        return false;
+    }
     
-    printf("[INFO] Image compressée: %d octets (qualité: %d, ratio: %.2f:1)\n", 
-           capture->compressedSize, quality, ratio);
+    // Zones d'intérêt : la qualité suit l'attention de l'utilisateur, à débit à peu près constant
+    capture->roi = NULL;
+    if (currentConfig.roiQuality && capture->image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+        RoiFocus focus;
+        ReadRoiFocus(capture, &focus);
+        RoiMap* map = &roiMaps[capture->layer];
+        if (RoiMapUpdate(map, &capture->image, &focus)) {
+            map->boostLossless = rateHeadroom && rateStep == 0;
+            capture->roi = map;
+        }
+    }
+    capture->refineBudget = RefineBudget();
+    if (!codec->encode(encoder, capture, &currentConfig, quality)) return false;
     
+    capture->isCompressed = true;
+    capture->encodeEndNs = ClockNowNs();
+    StatsRecordFrame(STAT_STAGE_ENCODE, capture->encodeEndNs - capture->encodeStartNs, capture->frameId);
+    UpdateRateControl(capture);
     return true;
 }
 
@@ -741,19 +1043,25 @@ bool DetectChanges(CaptureData* capture, int threshold) {
     if (threshold < 0) threshold = 0;
     if (threshold > 100) threshold = 100;
     
+    uint64_t stageStart = StatsBegin();
+    
     // Si c'est la première capture ou si pas d'image précédente, considérer comme changée
     if (!capture->previousFrame) {
         int imgSize = capture->width * capture->height * 4;
+        capture->changedPixels = capture->width * capture->height;
         capture->previousFrame = (unsigned char*)malloc(imgSize);
         
         if (capture->previousFrame) {
             // Copie de l'image actuelle comme référence pour les comparaisons futures
             memcpy(capture->previousFrame, capture->image.data, imgSize);
             capture->hasChanged = true;
+            StatsEndFrame(STAT_STAGE_DETECT, stageStart, capture->frameId);
+            StatsAddCounter(STAT_COUNTER_FRAMES_CHANGED, 1);
             return true;
         } else {
-            printf("[ERROR] Impossible d'allouer de la mémoire pour la comparaison\n");
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer de la mémoire pour la comparaison");
             capture->hasChanged = true;
+            StatsAddCounter(STAT_COUNTER_FRAMES_CHANGED, 1);
             return true;
         }
     }
@@ -779,6 +1087,7 @@ bool DetectChanges(CaptureData* capture, int threshold) {
     }
     
     // Calcul du pourcentage de changement
+    capture->changedPixels = differentPixels;
     float changePercentage = 100.0f * differentPixels / totalPixels;
     
     // Mise à jour de l'image précédente pour la prochaine comparaison
@@ -788,9 +1097,10 @@ bool DetectChanges(CaptureData* capture, int threshold) {
     bool changed = changePercentage >= (float)(100 - threshold) / 10.0f;
     capture->hasChanged = changed;
     
+    // Pas de printf ici : appelé à chaque image, le coût de la console fausserait la mesure
+    StatsEndFrame(STAT_STAGE_DETECT, stageStart, capture->frameId);
     if (changed) {
-        printf("[INFO] Changement détecté: %.2f%% des pixels ont changé (seuil: %d%%)\n", 
-               changePercentage, (100 - threshold) / 10);
+        StatsAddCounter(STAT_COUNTER_FRAMES_CHANGED, 1);
     }
     
     return changed;
@@ -798,7 +1108,7 @@ bool DetectChanges(CaptureData* capture, int threshold) {
 
 bool UpdateCaptureConfig(CaptureConfig config) {
     if (!captureSystemInitialized) {
-        printf("[ERROR] Le système de capture n'est pas initialisé\n");
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Le système de capture n'est pas initialisé");
         return false;
     }
     
@@ -814,9 +1124,11 @@ bool UpdateCaptureConfig(CaptureConfig config) {
     if (currentConfig.changeThreshold < 0) currentConfig.changeThreshold = 0;
     if (currentConfig.changeThreshold > 100) currentConfig.changeThreshold = 100;
     
+    if (currentConfig.maxBitrateKbps < 0) currentConfig.maxBitrateKbps = 0;
+    
     // Vérification du moniteur cible
     if (currentConfig.targetMonitor >= monitorCount) {
-        printf("[WARNING] Index de moniteur invalide, utilisation de tous les moniteurs\n");
+        LOG_WARNING(LOG_MODULE_CAPTURE, "Index de moniteur invalide, utilisation de tous les moniteurs");
         currentConfig.targetMonitor = -1;
     }
     
@@ -829,15 +1141,522 @@ bool UpdateCaptureConfig(CaptureConfig config) {
 #endif
     } else if (currentConfig.method == CAPTURE_METHOD_WIN_GDI) {
 #ifndef _WIN32
-        printf("[WARNING] Méthode Windows GDI non disponible, utilisation de raylib\n");
+        LOG_WARNING(LOG_MODULE_CAPTURE, "Méthode Windows GDI non disponible, utilisation de raylib");
         currentConfig.method = CAPTURE_METHOD_RAYLIB;
 #endif
     }
     
-    printf("[INFO] Configuration de capture mise à jour\n");
+    LOG_INFO(LOG_MODULE_CAPTURE, "Configuration de capture mise à jour");
+    return true;
+}
+
+uint32_t GetCaptureCanvasId(CaptureLayer layer, CodecId codec) {
+    const Codec* entry = CodecGet(codec);
+    if (!entry || (unsigned)layer >= CAPTURE_LAYER_COUNT || !codecEncoders[layer][codec]) return 0;
+    return entry->encoderStreamId(codecEncoders[layer][codec]);
+}
+
+const RoiMap* GetCaptureRoiMap(CaptureLayer layer) {
+    if ((unsigned)layer >= CAPTURE_LAYER_COUNT || !roiMaps[layer].weights) return NULL;
+    return &roiMaps[layer];
+}
+
+#ifdef _WIN32
+// Extraction de la forme d'un curseur système en RGBA ; shape->pixels est à libérer avec free
+static bool ExtractCursorShape(HCURSOR cursor, CursorShape* shape) {
+    ICONINFO iconInfo = {0};
+    if (!GetIconInfo(cursor, &iconInfo)) return false;
+    
+    // Curseur monochrome : le masque contient le masque AND puis le masque XOR, l'un sous l'autre
+    BITMAP bitmap = {0};
+    GetObject(iconInfo.hbmColor ? iconInfo.hbmColor : iconInfo.hbmMask, sizeof(bitmap), &bitmap);
+    int width = bitmap.bmWidth;
+    int height = iconInfo.hbmColor ? bitmap.bmHeight : bitmap.bmHeight / 2;
+    int hotspotX = (int)iconInfo.xHotspot;
+    int hotspotY = (int)iconInfo.yHotspot;
+    if (iconInfo.hbmColor) DeleteObject(iconInfo.hbmColor);
+    if (iconInfo.hbmMask) DeleteObject(iconInfo.hbmMask);
+    
+    if (width <= 0 || height <= 0) return false;
+    if (width > CURSOR_MAX_SIZE) width = CURSOR_MAX_SIZE;
+    if (height > CURSOR_MAX_SIZE) height = CURSOR_MAX_SIZE;
+    
+    BITMAPINFO bmi = {0};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height; // Négatif pour orientation de haut en bas
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    
+    void* bits = NULL;
+    HBITMAP dib = CreateDIBSection(hdcMemDC, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    size_t size = (size_t)width * height * 4;
+    uint8_t* onBlack = (uint8_t*)malloc(size);
+    uint8_t* pixels = (uint8_t*)malloc(size);
+    if (!dib || !bits || !onBlack || !pixels) {
+        if (dib) DeleteObject(dib);
+        free(onBlack);
+        free(pixels);
+        return false;
+    }
+    
+    // Dessin sur fond noir puis sur fond blanc : l'écart entre les deux donne l'opacité de chaque
+    // pixel, quel que soit le format du curseur (couleur, masque alpha ou monochrome)
+    HGDIOBJ oldBitmap = SelectObject(hdcMemDC, dib);
+    memset(bits, 0x00, size);
+    DrawIconEx(hdcMemDC, 0, 0, cursor, width, height, 0, NULL, DI_NORMAL);
+    GdiFlush();
+    memcpy(onBlack, bits, size);
+    memset(bits, 0xFF, size);
+    DrawIconEx(hdcMemDC, 0, 0, cursor, width, height, 0, NULL, DI_NORMAL);
+    GdiFlush();
+    const uint8_t* onWhite = (const uint8_t*)bits;
+    
+    for (size_t i = 0; i < size; i += 4) {
+        int alpha = 255 - (onWhite[i + 1] - onBlack[i + 1]);
+        
+        if (alpha > 255) {
+            // Pixel qui inverse l'écran (curseur texte) : rendu en noir, lisible sur un fond clair
+            pixels[i + 0] = 0;
+            pixels[i + 1] = 0;
+            pixels[i + 2] = 0;
+            pixels[i + 3] = 255;
+        } else {
+            // Couleur retrouvée à partir du rendu sur fond noir (prémultiplié par l'opacité), BGRA -> RGBA
+            for (int c = 0; c < 3; c++) {
+                int value = alpha > 0 ? onBlack[i + 2 - c] * 255 / alpha : 0;
+                pixels[i + c] = (uint8_t)(value > 255 ? 255 : value);
+            }
+            pixels[i + 3] = (uint8_t)(alpha < 0 ? 0 : alpha);
+        }
+    }
+    
+    SelectObject(hdcMemDC, oldBitmap);
+    DeleteObject(dib);
+    free(onBlack);
+    
+    shape->width = width;
+    shape->height = height;
+    shape->hotspotX = hotspotX < width ? hotspotX : width - 1;
+    shape->hotspotY = hotspotY < height ? hotspotY : height - 1;
+    shape->pixels = pixels;
+    shape->shapeId = CursorShapeHash(shape);
+    return true;
+}
+#endif
+
+bool CaptureCursor(CursorState* state, bool* shapeChanged) {
+    if (shapeChanged) *shapeChanged = false;
+    if (!state) return false;
+    memset(state, 0, sizeof(*state));
+    
+    // Seule la capture GDI connaît la position de la zone capturée dans l'écran virtuel
+    if (!captureSystemInitialized || currentConfig.method != CAPTURE_METHOD_WIN_GDI) return false;
+    
+#ifdef _WIN32
+    CURSORINFO cursorInfo = {0};
+    cursorInfo.cbSize = sizeof(cursorInfo);
+    if (!GetCursorInfo(&cursorInfo)) return false;
+    
+    // Curseur masqué (jeu, vidéo plein écran) : l'état reste invisible
+    if (!(cursorInfo.flags & CURSOR_SHOWING) || !cursorInfo.hCursor) return true;
+    
+    // Le curseur système a changé : nouvelle extraction, mais seule une empreinte différente est une nouvelle forme
+    if (cursorInfo.hCursor != cursorHandle) {
+        CursorShape shape = {0};
+        if (!ExtractCursorShape(cursorInfo.hCursor, &shape)) {
+            LOG_DEBUG(LOG_MODULE_CAPTURE, "Forme du curseur illisible");
+            return false;
+        }
+        cursorHandle = cursorInfo.hCursor;
+        
+        if (shape.shapeId != cursorShape.shapeId) {
+            free(cursorShape.pixels);
+            cursorShape = shape;
+            if (shapeChanged) *shapeChanged = true;
+        } else {
+            free(shape.pixels);
+        }
+    }
+    
+    state->x = cursorInfo.ptScreenPos.x - captureOriginX;
+    state->y = cursorInfo.ptScreenPos.y - captureOriginY;
+    state->shapeId = cursorShape.shapeId;
+    
+    // Visible si une partie de la forme recouvre la zone capturée
+    int left = state->x - cursorShape.hotspotX;
+    int top = state->y - cursorShape.hotspotY;
+    state->visible = cursorShape.pixels &&
+                     left + cursorShape.width > 0 && left < captureAreaWidth &&
+                     top + cursorShape.height > 0 && top < captureAreaHeight;
     return true;
+#else
+    return false;
+#endif
+}
+
+const CursorShape* GetCaptureCursorShape(void) {
+    return cursorShape.pixels ? &cursorShape : NULL;
+}
+
+bool GetLastInputTime(uint64_t* inputNs) {
+    if (!inputNs) return false;
+    
+#ifdef _WIN32
+    LASTINPUTINFO inputInfo = {0};
+    inputInfo.cbSize = sizeof(inputInfo);
+    if (!GetLastInputInfo(&inputInfo)) return false;
+    
+    // Compteur en millisecondes depuis le démarrage : ramené à l'horloge monotone par son ancienneté
+    uint64_t ageNs = (uint64_t)(DWORD)(GetTickCount() - inputInfo.dwTime) * 1000000ULL;
+    uint64_t now = ClockNowNs();
+    *inputNs = now > ageNs ? now - ageNs : 0;
+    return true;
+#else
+    return false;
+#endif
 }
 
 CaptureConfig GetCaptureConfig(void) {
     return currentConfig;
+}
+
+// Bureau synthétique : barre de titre, panneau latéral, texte sur fond blanc et photo texturée.
+// D'une image à l'autre (variant), une ligne de texte et le bruit de la photo changent
+static void DrawSyntheticDesktop(uint8_t* pixels, int width, int height, int variant) {
+    uint32_t noise = 0x12345678u + (uint32_t)variant;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t color;
+            noise = noise * 1103515245u + 12345u;
+            if (y < 32) {
+                color = 0x303030;
+            } else if (x < width / 6) {
+                color = 0xF0F0F0;
+            } else if (x > width * 2 / 3 && y > height / 2) {
+                color = ((x * 3 + y) & 0xFF) | (((x + y * 2) & 0xFF) << 8) | (((noise >> 16) & 0x3F) << 16);
+            } else {
+                // Glyphes de 8x16 pixels tirés de leur position
+                int line = y / 16;
+                int edit = line == variant % (height / 16) ? variant : 0;
+                uint32_t glyph = (uint32_t)(x / 8 + line * 977 + edit) * 2654435761u;
+                bool ink = (y % 16) < 11 && (x % 8) < 6 && ((glyph >> (((y % 16) * 6 + x % 8) % 29)) & 1);
+                color = ink ? 0x202020 : 0xFFFFFF;
+            }
+            uint32_t pixel = color | 0xFF000000u;
+            memcpy(pixels + ((size_t)y * width + x) * 4, &pixel, 4);
+        }
+    }
+}
+
+// Vidéo synthétique : une fenêtre au centre du bureau où une texture lisse défile en diagonale
+static void DrawSyntheticMovie(uint8_t* pixels, int width, int height, int variant) {
+    DrawSyntheticDesktop(pixels, width, height, 0);
+    for (int y = height / 6; y < height * 5 / 6; y++) {
+        for (int x = width / 6; x < width * 5 / 6; x++) {
+            int u = x + variant * 6;
+            int v = y + variant * 3;
+            int r = abs(((u + v / 2) & 511) - 256);
+            int g = abs(((v * 2 - u / 3) & 511) - 256);
+            int b = abs(((u / 2 + v) & 1023) - 512) / 2 + ((u ^ v) & 15);
+            uint32_t pixel = (uint32_t)(r > 255 ? 255 : r) | ((uint32_t)(g > 255 ? 255 : g) << 8) |
+                             ((uint32_t)(b > 255 ? 255 : b) << 16) | 0xFF000000u;
+            memcpy(pixels + ((size_t)y * width + x) * 4, &pixel, 4);
+        }
+    }
+}
+
+// Rapport signal sur bruit crête (dB) des composantes RGB d'une image décodée
+static double ImagePsnr(const uint8_t* decoded, const uint8_t* source, size_t pixelCount) {
+    uint64_t squared = 0;
+    for (size_t i = 0; i < pixelCount * 4; i++) {
+        if ((i & 3) == 3) continue;
+        int difference = (int)decoded[i] - (int)source[i];
+        squared += (uint64_t)(difference * difference);
+    }
+    if (squared == 0) return 99.0;
+    double mse = (double)squared / (double)(pixelCount * 3);
+    return 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+// Décodage des mêmes images avec 1, 2, 4... threads jusqu'au nombre de processeurs : débit et
+// accélération par rapport au décodage séquentiel, dont le résultat doit être reproduit à l'identique
+static bool BenchmarkParallelDecode(CaptureData* capture, int frames, int quality, const char* name, bool movie) {
+    const Codec* codec = CodecGet(capture->codec);
+    int width = capture->width;
+    int height = capture->height;
+    size_t imageSize = (size_t)width * height * 4;
+    uint8_t** encoded = (uint8_t**)calloc((size_t)frames, sizeof(uint8_t*));
+    uint32_t* sizes = (uint32_t*)calloc((size_t)frames, sizeof(uint32_t));
+    uint32_t* frameIds = (uint32_t*)calloc((size_t)frames, sizeof(uint32_t));
+    uint8_t* reference = (uint8_t*)malloc(imageSize);
+    bool success = encoded && sizes && frameIds && reference;
+    
+    // Images codées une fois : complètes sur le bureau, prédites de la précédente (acquittée aussitôt) en film
+    uint32_t firstFrameId = capture->frameId + 1;
+    for (int f = 0; f < frames && success; f++) {
+        if (movie) {
+            DrawSyntheticMovie((uint8_t*)capture->image.data, width, height, f);
+        } else {
+            DrawSyntheticDesktop((uint8_t*)capture->image.data, width, height, f);
+        }
+        if (codec->capabilities & CODEC_CAP_YUV) {
+            if (!YuvImageAlloc(&capture->yuv, width, height)) {
+                success = false;
+                break;
+            }
+            ColorConvertRgbaToNv12((const uint8_t*)capture->image.data, (size_t)width * 4, width, height, &capture->yuv);
+        }
+        capture->baseFrameId = movie && f > 0 ? capture->frameId : 0;
+        capture->frameId = firstFrameId + (uint32_t)f;
+        capture->timestamp = ClockNowNs();
+        success = CompressCaptureData(capture, quality);
+        if (success) {
+            encoded[f] = (uint8_t*)malloc((size_t)capture->compressedSize);
+            success = encoded[f] != NULL;
+        }
+        if (success) {
+            memcpy(encoded[f], capture->compressedData, (size_t)capture->compressedSize);
+            sizes[f] = (uint32_t)capture->compressedSize;
+            frameIds[f] = capture->frameId;
+        }
+    }
+    
+    int cpuCount = ThreadCpuCount();
+    if (cpuCount > WORKER_MAX_THREADS + 1) cpuCount = WORKER_MAX_THREADS + 1;
+    double sequentialNs = 0.0;
+    for (int threads = 1; success; threads = threads * 2 < cpuCount ? threads * 2 : cpuCount) {
+        WorkerPoolInit(threads - 1);
+        void* decoder = codec->createDecoder();
+        success = decoder != NULL;
+        
+        uint64_t decodeNs = 0;
+        for (int f = 0; f < frames && success; f++) {
+            uint64_t decodeStart = ClockNowNs();
+            success = codec->decode(decoder, encoded[f], sizes[f], frameIds[f], width, height) == TILE_APPLY_OK;
+            decodeNs += ClockNowNs() - decodeStart;
+        }
+        if (success) {
+            const Image* decoded = codec->decodedImage(decoder);
+            if (threads == 1) {
+                memcpy(reference, decoded->data, imageSize);
+                sequentialNs = (double)decodeNs;
+            } else if (memcmp(reference, decoded->data, imageSize) != 0) {
+                LOG_ERROR(LOG_MODULE_CAPTURE, "Décodage parallèle (%s, %d threads) différent du décodage séquentiel",
+                          name, threads);
+                success = false;
+            }
+        }
+        if (success) {
+            double megabytes = (double)imageSize * frames / (1024.0 * 1024.0);
+            LOG_INFO(LOG_MODULE_CAPTURE, "%-10s %2d threads : décodage %8.1f Mo/s (x%.2f)",
+                     name, threads,
+                     decodeNs > 0 ? megabytes * 1e9 / (double)decodeNs : 0.0,
+                     decodeNs > 0 ? sequentialNs / (double)decodeNs : 0.0);
+        }
+        if (decoder) codec->destroyDecoder(decoder);
+        if (threads == cpuCount) break;
+    }
+    
+    for (int f = 0; encoded && f < frames; f++) free(encoded[f]);
+    free(encoded);
+    free(sizes);
+    free(frameIds);
+    free(reference);
+    return success;
+}
+
+bool RunCaptureBenchmark(int frames) {
+    const int width = 1920;
+    const int height = 1080;
+    const size_t imageSize = (size_t)width * height * 4;
+    const struct { const char* name; CodecId codec; bool tileCodecs; bool lossless; bool delta; bool movie; } modes[] = {
+        { "jpeg", CODEC_ID_TILES, false, false, false, false },
+        { "mixte", CODEC_ID_TILES, true, false, false, false },
+        { "sans perte", CODEC_ID_TILES, false, true, false, false },
+        { "différence", CODEC_ID_TILES, false, true, true, false },
+        { "vidéo", CODEC_ID_VIDEO, false, false, true, false },
+        { "film jpeg", CODEC_ID_TILES, true, false, true, true },
+        { "film vidéo", CODEC_ID_VIDEO, false, false, true, true },
+    };
+    const int modeCount = (int)(sizeof(modes) / sizeof(modes[0]));
+    if (frames <= 0) frames = 1;
+    
+    // Sans cache ni copies : seul le codage des tuiles est mesuré. Images complètes, sauf en
+    // différence où chaque image est acquittée aussitôt (seules les tuiles modifiées partent).
+    // Les modes vidéo prédisent chaque image de la précédente, acquittée de la même façon
+    CaptureConfig savedConfig = currentConfig;
+    int savedRateStep = rateStep;
+    currentConfig.useTileCache = false;
+    currentConfig.detectScroll = false;
+    currentConfig.maxBitrateKbps = 0;
+    currentConfig.roiQuality = false;
+    currentConfig.refineTiles = false;
+    
+    CaptureData capture = {0};
+    capture.image = GenImageColor(width, height, BLACK);
+    capture.width = width;
+    capture.height = height;
+    void* decoders[CODEC_ID_COUNT] = {0};
+    bool success = capture.image.data != NULL;
+    
+    LOG_INFO(LOG_MODULE_CAPTURE, "Banc d'essai : %d images %dx%d par mode", frames, width, height);
+    for (int m = 0; m < modeCount && success; m++) {
+        currentConfig.tileCodecs = modes[m].tileCodecs;
+        currentConfig.lossless = modes[m].lossless;
+        const Codec* codec = CodecGet(modes[m].codec);
+        capture.codec = codec->id;
+        if (!decoders[codec->id]) decoders[codec->id] = codec->createDecoder();
+        if (!decoders[codec->id]) {
+            success = false;
+            break;
+        }
+        
+        uint64_t encodeNs = 0;
+        uint64_t decodeNs = 0;
+        uint64_t bytes = 0;
+        double psnr = 0.0;
+        bool exact = true;
+        for (int f = 0; f < frames; f++) {
+            if (modes[m].movie) {
+                DrawSyntheticMovie((uint8_t*)capture.image.data, width, height, f);
+            } else {
+                DrawSyntheticDesktop((uint8_t*)capture.image.data, width, height, f);
+            }
+            
+            // NV12 produit à la capture, hors de la mesure d'encodage
+            if (codec->capabilities & CODEC_CAP_YUV) {
+                if (!YuvImageAlloc(&capture.yuv, width, height)) {
+                    success = false;
+                    break;
+                }
+                ColorConvertRgbaToNv12((const uint8_t*)capture.image.data, (size_t)width * 4, width, height, &capture.yuv);
+            }
+            capture.baseFrameId = modes[m].delta && f > 0 ? capture.frameId : 0;
+            capture.frameId = (uint32_t)(m * frames + f + 1);
+            capture.timestamp = ClockNowNs();
+            if (!CompressCaptureData(&capture, savedConfig.quality)) {
+                success = false;
+                break;
+            }
+            encodeNs += capture.encodeEndNs - capture.encodeStartNs;
+            bytes += (uint64_t)capture.compressedSize;
+            
+            uint64_t decodeStart = ClockNowNs();
+            TileApplyResult result = codec->decode(decoders[codec->id], capture.compressedData,
+                                                   (uint32_t)capture.compressedSize, capture.frameId, width, height);
+            decodeNs += ClockNowNs() - decodeStart;
+            if (result != TILE_APPLY_OK) {
+                success = false;
+                break;
+            }
+            const Image* decoded = codec->decodedImage(decoders[codec->id]);
+            if (memcmp(decoded->data, capture.image.data, imageSize) != 0) exact = false;
+            psnr += ImagePsnr((const uint8_t*)decoded->data, (const uint8_t*)capture.image.data, (size_t)width * height);
+        }
+        if (!success) {
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Banc d'essai interrompu : échec en mode %s", modes[m].name);
+            break;
+        }
+        
+        double megabytes = (double)imageSize * frames / (1024.0 * 1024.0);
+        LOG_INFO(LOG_MODULE_CAPTURE, "%-10s encodage %8.1f Mo/s (%5.1f ms/image), décodage %8.1f Mo/s, "
+                 "taux %6.1f:1 (%7.1f Ko/image), %s",
+                 modes[m].name,
+                 encodeNs > 0 ? megabytes * 1e9 / (double)encodeNs : 0.0,
+                 (double)encodeNs / 1e6 / frames,
+                 decodeNs > 0 ? megabytes * 1e9 / (double)decodeNs : 0.0,
+                 bytes > 0 ? (double)imageSize * frames / (double)bytes : 0.0,
+                 (double)bytes / 1024.0 / frames,
+                 exact ? "image exacte" : TextFormat("PSNR %.1f dB", psnr / frames));
+        
+        // Le mode sans perte doit restituer chaque pixel
+        if (modes[m].lossless && !exact) {
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Le mode sans perte n'a pas restitué l'image exacte");
+            success = false;
+        }
+    }
+    
+    // Décodage parallèle côté visualiseur : tuiles toutes codées sans perte, et vidéo en autant de
+    // tranches que de processeurs (le pool initial est rétabli ensuite)
+    if (success) {
+        int savedThreads = WorkerPoolSize() - 1;
+        int cpuCount = ThreadCpuCount();
+        LOG_INFO(LOG_MODULE_CAPTURE, "Décodage parallèle : %d processeurs", cpuCount);
+        
+        capture.codec = CODEC_ID_TILES;
+        currentConfig.tileCodecs = false;
+        currentConfig.lossless = true;
+        success = BenchmarkParallelDecode(&capture, frames, savedConfig.quality, "sans perte", false);
+        
+        capture.codec = CODEC_ID_VIDEO;
+        currentConfig.lossless = false;
+        currentConfig.videoSlices = cpuCount > savedConfig.videoSlices ? cpuCount : savedConfig.videoSlices;
+        if (success) success = BenchmarkParallelDecode(&capture, frames, savedConfig.quality, "film vidéo", true);
+        if (!success) LOG_ERROR(LOG_MODULE_CAPTURE, "Banc d'essai interrompu : échec du décodage parallèle");
+        WorkerPoolInit(savedThreads);
+    }
+    
+    // Étage de couleurs des codecs vidéo : BGRA vers RGBA et NV12 en une lecture, puis retour en RGBA
+    if (success) {
+        YuvImage yuv = {0};
+        uint8_t* rgba = (uint8_t*)malloc(imageSize);
+        if (rgba && YuvImageAlloc(&yuv, width, height)) {
+            uint64_t forwardNs = 0;
+            uint64_t inverseNs = 0;
+            for (int f = 0; f < frames; f++) {
+                uint64_t forwardStart = ClockNowNs();
+                ColorConvertBgra((const uint8_t*)capture.image.data, (size_t)width * 4, width, height,
+                                 rgba, (size_t)width * 4, &yuv);
+                uint64_t inverseStart = ClockNowNs();
+                ColorConvertNv12ToRgba(&yuv, rgba, (size_t)width * 4);
+                forwardNs += inverseStart - forwardStart;
+                inverseNs += ClockNowNs() - inverseStart;
+            }
+            double megabytes = (double)imageSize * frames / (1024.0 * 1024.0);
+            LOG_INFO(LOG_MODULE_CAPTURE, "%-10s BGRA vers RGBA + NV12 %8.1f Mo/s, NV12 vers RGBA %8.1f Mo/s",
+                     "couleurs",
+                     forwardNs > 0 ? megabytes * 1e9 / (double)forwardNs : 0.0,
+                     inverseNs > 0 ? megabytes * 1e9 / (double)inverseNs : 0.0);
+        }
+        free(rgba);
+        YuvImageFree(&yuv);
+    }
+    
+    // Réduction de la résolution envoyée : moitié exacte (moyennes de blocs) et rapport quelconque
+    if (success) {
+        uint8_t* scaled = (uint8_t*)malloc(imageSize);
+        if (scaled) {
+            uint64_t halfNs = 0;
+            uint64_t bilinearNs = 0;
+            for (int f = 0; f < frames; f++) {
+                uint64_t halfStart = ClockNowNs();
+                ScaleImage((const uint8_t*)capture.image.data, (size_t)width * 4, width, height,
+                           scaled, (size_t)(width / 2) * 4, width / 2, height / 2);
+                uint64_t bilinearStart = ClockNowNs();
+                ScaleImage((const uint8_t*)capture.image.data, (size_t)width * 4, width, height,
+                           scaled, (size_t)1366 * 4, 1366, 768);
+                halfNs += bilinearStart - halfStart;
+                bilinearNs += ClockNowNs() - bilinearStart;
+            }
+            double megabytes = (double)imageSize * frames / (1024.0 * 1024.0);
+            LOG_INFO(LOG_MODULE_CAPTURE, "%-10s moitié %8.1f Mo/s, vers 1366x768 %8.1f Mo/s",
+                     "réduction",
+                     halfNs > 0 ? megabytes * 1e9 / (double)halfNs : 0.0,
+                     bilinearNs > 0 ? megabytes * 1e9 / (double)bilinearNs : 0.0);
+        }
+        free(scaled);
+    }
+    
+    // La prochaine capture repartira d'un nouveau canevas et d'un nouveau flux vidéo
+    for (int i = 0; i < CODEC_ID_COUNT; i++) {
+        const Codec* codec = CodecGet((uint32_t)i);
+        if (decoders[i]) codec->destroyDecoder(decoders[i]);
+        if (codecEncoders[CAPTURE_LAYER_FULL][i]) codec->flushEncoder(codecEncoders[CAPTURE_LAYER_FULL][i]);
+    }
+    UnloadCaptureData(&capture);
+    currentConfig = savedConfig;
+    rateStep = savedRateStep;
+    return success;
 }
\ No newline at end of file
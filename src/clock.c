@@ -0,0 +1,65 @@
+#include "../include/clock.h"
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t ClockNowNs(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {0};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    
+    // Séparation secondes/reste pour éviter le débordement de counter * 1e9
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ULL + remainder * 1000000000ULL / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void ClockOffsetReset(ClockOffsetEstimator* estimator) {
+    if (!estimator) return;
+    memset(estimator, 0, sizeof(*estimator));
+}
+
+void ClockOffsetAddSample(ClockOffsetEstimator* estimator, uint64_t t0, uint64_t t1, uint64_t t2, uint64_t t3) {
+    if (!estimator || t3 < t0 || t2 < t1) return;
+    
+    // RTT hors temps de traitement chez le pair, décalage = distant - local
+    uint64_t rtt = (t3 - t0) - (t2 - t1);
+    int64_t offset = ((int64_t)(t1 - t0) + (int64_t)(t2 - t3)) / 2;
+    
+    estimator->offsetNs[estimator->next] = offset;
+    estimator->rttNs[estimator->next] = rtt;
+    estimator->next = (estimator->next + 1) % CLOCK_OFFSET_SAMPLES;
+    if (estimator->count < CLOCK_OFFSET_SAMPLES) estimator->count++;
+    
+    // Retenir l'échantillon au plus petit RTT de la fenêtre
+    int best = 0;
+    for (int i = 1; i < estimator->count; i++) {
+        if (estimator->rttNs[i] < estimator->rttNs[best]) best = i;
+    }
+    
+    estimator->bestOffsetNs = estimator->offsetNs[best];
+    estimator->bestRttNs = estimator->rttNs[best];
+    estimator->isValid = true;
+}
+
+uint64_t ClockRemoteToLocalNs(const ClockOffsetEstimator* estimator, uint64_t remoteNs) {
+    if (!estimator || !estimator->isValid) return remoteNs;
+    return (uint64_t)((int64_t)remoteNs - estimator->bestOffsetNs);
+}
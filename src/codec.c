@@ -0,0 +1,472 @@
+#include "../include/codec.h"
+#include "../include/capture.h"
+#include "../include/video.h"
+#include "../include/protocol.h"
+#include "../include/stats.h"
+#include "../include/log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief État de l'émetteur du codec en tuiles
+ */
+typedef struct {
+    TileHistory history;            // Tuiles modifiées depuis chaque image, par canevas
+    TileCache cache;                // Tuiles conservées par les visualiseurs
+    uint32_t tileBytesEstimate;     // Taille moyenne d'une tuile compressée, pour estimer les octets économisés
+    uint32_t refineBytesEstimate;   // Taille moyenne d'une tuile renvoyée sans perte, pour tenir capture->refineBudget
+    uint32_t losslessSinceFrameId;  // Première image du mode sans perte en cours (0 hors de ce mode)
+} TileFrameEncoder;
+
+// Compression JPEG d'une image ; retourne un buffer à libérer avec free
+static unsigned char* EncodeJpeg(Image image, uint64_t timestamp, int* size) {
+    // Créer un nom de fichier temporaire
+    char tempFile[256] = {0};
+    sprintf(tempFile, "temp_capture_%llu.jpg", (unsigned long long)timestamp);
+    
+    // Convertir l'image en JPG
+    ExportImage(image, tempFile);
+    
+    // Charger le fichier en mémoire
+    FILE* file = fopen(tempFile, "rb");
+    if (!file) {
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'ouvrir le fichier temporaire pour la compression");
+        return NULL;
+    }
+    
+    // Obtenir la taille du fichier
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    // Allouer de la mémoire pour les données compressées
+    unsigned char* data = fileSize > 0 ? (unsigned char*)malloc(fileSize) : NULL;
+    if (data == NULL) {
+        fclose(file);
+        remove(tempFile);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer de la mémoire pour les données compressées");
+        return NULL;
+    }
+    
+    // Lire les données du fichier
+    *size = (int)fread(data, 1, fileSize, file);
+    fclose(file);
+    
+    // Supprimer le fichier temporaire
+    remove(tempFile);
+    
+    if (*size <= 0) {
+        free(data);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de la compression de l'image");
+        return NULL;
+    }
+    return data;
+}
+
+static void* TilesCreateEncoder(void) {
+    TileFrameEncoder* encoder = (TileFrameEncoder*)calloc(1, sizeof(TileFrameEncoder));
+    if (encoder) TileCacheReset(&encoder->cache);
+    return encoder;
+}
+
+// Seules les tuiles modifiées depuis capture->baseFrameId, regroupées dans une seule image JPEG
+// sauf celles codées sans perte ; une image complète si baseFrameId vaut 0 ou si le canevas change
+static bool TilesEncode(void* state, CaptureData* capture, const CaptureConfig* config, int quality) {
+    TileFrameEncoder* encoder = (TileFrameEncoder*)state;
+    (void)quality; // ExportImage n'a pas de réglage de qualité
+    
+    // Tuiles modifiées par cette capture ; un nouveau canevas invalide toute image de référence
+    bool canvasReset = false;
+    if (TileHistoryUpdate(&encoder->history, &capture->image, capture->frameId,
+                          config->detectScroll, &canvasReset) < 0) {
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Échec du découpage en tuiles de l'image %u", capture->frameId);
+        return false;
+    }
+    if (canvasReset || !WireSequenceNewer(capture->frameId, capture->baseFrameId)) {
+        capture->baseFrameId = 0;
+    }
+    capture->canvasId = encoder->history.canvasId;
+    
+    // Tuiles que les visualiseurs n'ont pas encore : toutes pour une image complète
+    size_t total = (size_t)encoder->history.columns * encoder->history.rows;
+    uint16_t* tiles = (uint16_t*)malloc(total * sizeof(uint16_t));
+    uint16_t* slots = (uint16_t*)malloc(total * sizeof(uint16_t));
+    uint16_t* codedSizes = (uint16_t*)malloc(total * sizeof(uint16_t));
+    uint8_t* codecs = (uint8_t*)malloc(total);
+    TileCacheRef* cached = (TileCacheRef*)malloc(total * sizeof(TileCacheRef));
+    if (!tiles || !slots || !codedSizes || !codecs || !cached) {
+        free(tiles);
+        free(slots);
+        free(codedSizes);
+        free(codecs);
+        free(cached);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer la liste des tuiles");
+        return false;
+    }
+    
+    // Les copies partent de l'image précédente : utiles seulement si les visualiseurs suivent de près,
+    // sinon celui qui l'a perdue attendrait trop longtemps les tuiles correspondantes
+    bool useCopies = encoder->history.copyCount > 0 && capture->baseFrameId != 0 &&
+                     encoder->history.copySourceFrameId - capture->baseFrameId <= TILE_COPY_MAX_ACK_LAG;
+    uint16_t copyCount = useCopies ? (uint16_t)encoder->history.copyCount : 0;
+    int tileCount = TileHistoryCollect(&encoder->history, capture->baseFrameId, useCopies, tiles);
+    
+    // Début du mode sans perte : les tuiles reçues avant, et le cache, ne sont pas exacts chez les visualiseurs
+    if (!config->lossless) {
+        encoder->losslessSinceFrameId = 0;
+    } else if (encoder->losslessSinceFrameId == 0) {
+        encoder->losslessSinceFrameId = capture->frameId;
+        TileCacheReset(&encoder->cache);
+    }
+    
+    // Tuiles déjà vues (barres d'outils, retour à une fenêtre précédente) : référencées dans le cache.
+    // Une image complète s'adresse à un visualiseur dont le cache est inconnu : on repart de zéro
+    int cachedCount = 0;
+    if (config->useTileCache) {
+        if (capture->baseFrameId == 0) TileCacheReset(&encoder->cache);
+        TileCacheConfirm(&encoder->cache, capture->baseFrameId, capture->appliedFrames);
+        tileCount = TileCacheResolve(&encoder->cache, &encoder->history, &capture->image, capture->frameId,
+                                     tiles, tileCount, cached, &cachedCount, slots);
+    } else {
+        for (int i = 0; i < tileCount; i++) slots[i] = TILE_CACHE_NO_SLOT;
+    }
+    
+    // Tuiles figées parties en JPEG, renvoyées sans perte dans la marge accordée par le contrôle de débit,
+    // déduction faite de ce que cette image coûte déjà : les visualiseurs reçoivent vite une version
+    // approchée pendant l'activité, puis exacte quand l'écran se calme, sans pic de débit
+    int refineCount = 0;
+    if (config->tileCodecs || config->lossless) {
+        if (encoder->refineBytesEstimate == 0) encoder->refineBytesEstimate = TILE_SIZE * TILE_SIZE * 3;
+        uint32_t frameEstimate = (uint32_t)tileCount * encoder->tileBytesEstimate;
+        int maxRefine = capture->refineBudget > frameEstimate
+                            ? (int)((capture->refineBudget - frameEstimate) / encoder->refineBytesEstimate) : 0;
+        refineCount = TileRefineCollect(&encoder->history, capture->frameId, capture->baseFrameId,
+                                        capture->appliedFrames, maxRefine, tiles + tileCount);
+        
+        // Le cache des visualiseurs garde la version JPEG : son emplacement est réécrit avec la version exacte
+        size_t stride = (size_t)capture->image.width * 4;
+        for (int i = tileCount; i < tileCount + refineCount; i++) {
+            slots[i] = TILE_CACHE_NO_SLOT;
+            if (!config->useTileCache) continue;
+            int x0 = (tiles[i] % encoder->history.columns) * TILE_SIZE;
+            int y0 = (tiles[i] / encoder->history.columns) * TILE_SIZE;
+            int tileWidth = capture->image.width - x0 < TILE_SIZE ? capture->image.width - x0 : TILE_SIZE;
+            int tileHeight = capture->image.height - y0 < TILE_SIZE ? capture->image.height - y0 : TILE_SIZE;
+            uint64_t hash = TileHash((const uint8_t*)capture->image.data + (size_t)y0 * stride + (size_t)x0 * 4,
+                                     stride, tileWidth, tileHeight);
+            slots[i] = (uint16_t)TileCacheStore(&encoder->cache, hash, capture->frameId);
+        }
+        tileCount += refineCount;
+    }
+    
+    // Texte et interface codés sans perte : le JPEG les brouillerait pour un gain faible.
+    // En mode sans perte, toutes les tuiles le sont, en différence avec l'image acquittée si possible
+    uint8_t* coded = NULL;
+    uint32_t codedSize = 0;
+    int codedCount = 0;
+    if ((config->tileCodecs || config->lossless) && tileCount > 0) {
+        TileCodingOptions options = { config->lossless, capture->baseFrameId, encoder->losslessSinceFrameId,
+                                      capture->roi, refineCount };
+        codedCount = TileEncodeCoded(&encoder->history, &capture->image, tiles, slots, tileCount, &options,
+                                     codecs, codedSizes, &coded, &codedSize);
+        if (codedCount < 0) {
+            LOG_WARNING(LOG_MODULE_CAPTURE, "Échec du codage sans perte des tuiles de l'image %u, tout passe par le JPEG",
+                        capture->frameId);
+            codedCount = 0;
+        }
+    }
+    
+    // Méthode de compression améliorée
+    // Les autres tuiles sont regroupées dans une seule image JPEG : un seul en-tête et une seule table par image
+    unsigned char* jpeg = NULL;
+    int jpegSize = 0;
+    int atlasColumns = 0;
+    if (tileCount > codedCount) {
+        Image atlas = {0};
+        atlasColumns = TileBuildAtlas(&encoder->history, &capture->image, tiles + codedCount, tileCount - codedCount, &atlas);
+        if (atlasColumns > 0) {
+            jpeg = EncodeJpeg(atlas, capture->timestamp, &jpegSize);
+            UnloadImage(atlas);
+        }
+        if (!jpeg) {
+            free(tiles);
+            free(slots);
+            free(codedSizes);
+            free(codecs);
+            free(cached);
+            free(coded);
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Échec de la compression des tuiles de l'image %u", capture->frameId);
+            return false;
+        }
+    }
+    
+    // En-tête de l'image en tuiles et ses listes, tuiles codées sans perte, puis atlas compressé
+    uint32_t headerSize = WireTileFrameHeaderSize(copyCount, (uint32_t)cachedCount, (uint32_t)tileCount,
+                                                  (uint32_t)codedCount);
+    capture->compressedData = (unsigned char*)malloc(headerSize + (size_t)codedSize + (size_t)jpegSize);
+    if (capture->compressedData == NULL) {
+        free(tiles);
+        free(slots);
+        free(codedSizes);
+        free(codecs);
+        free(cached);
+        free(coded);
+        free(jpeg);
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer de la mémoire pour les données compressées");
+        return false;
+    }
+    
+    WireWriteTileFrame(capture->compressedData, capture->canvasId, capture->baseFrameId,
+                       TILE_SIZE, (uint16_t)tileCount, (uint16_t)atlasColumns, copyCount, (uint16_t)cachedCount,
+                       (uint16_t)codedCount);
+    if (copyCount > 0) {
+        uint8_t* copies = capture->compressedData + WIRE_TILE_FRAME_SIZE;
+        WireWriteU32(copies, encoder->history.copySourceFrameId);
+        for (int i = 0; i < copyCount; i++) {
+            const MotionRect* rect = &encoder->history.copies[i];
+            WireWriteCopyRect(copies + 4 + (size_t)i * WIRE_COPY_RECT_SIZE,
+                              (uint16_t)rect->srcX, (uint16_t)rect->srcY, (uint16_t)rect->dstX,
+                              (uint16_t)rect->dstY, (uint16_t)rect->width, (uint16_t)rect->height);
+        }
+    }
+    uint8_t* references = capture->compressedData + WireTileFrameCachedOffset(copyCount);
+    for (int i = 0; i < cachedCount; i++) {
+        WireWriteCachedTile(references + (size_t)i * WIRE_CACHED_TILE_SIZE, cached[i].tile, cached[i].slot);
+    }
+    uint8_t* indices = capture->compressedData + WireTileFrameIndicesOffset(copyCount, (uint32_t)cachedCount);
+    for (int i = 0; i < tileCount; i++) {
+        WireWriteU16(indices + 2 * i, tiles[i]);
+        WireWriteU16(indices + 2 * (tileCount + i), slots[i]);
+    }
+    TileRefineRecord(&encoder->history, capture->frameId, tiles, codedCount, tileCount, cached, cachedCount, useCopies);
+    
+    uint8_t* codecList = capture->compressedData +
+                         WireTileFrameCodecsOffset(copyCount, (uint32_t)cachedCount, (uint32_t)tileCount);
+    int paletteCount = 0;
+    int deltaCount = 0;
+    int refinedCount = 0;
+    uint32_t refinedBytes = 0;
+    for (int i = 0; i < codedCount; i++) {
+        codecList[i] = codecs[i];
+        WireWriteU16(codecList + codedCount + 2 * i, codedSizes[i]);
+        if (codecs[i] == TILE_CODEC_PALETTE) paletteCount++;
+        if (codecs[i] == TILE_CODEC_DELTA) deltaCount++;
+        
+        // Seules les tuiles affinées sont antérieures à l'image de référence
+        if (refineCount > 0 && !WireSequenceNewer(encoder->history.changedFrame[tiles[i]], capture->baseFrameId)) {
+            refinedCount++;
+            refinedBytes += codedSizes[i];
+        }
+    }
+    if (coded) memcpy(capture->compressedData + headerSize, coded, codedSize);
+    if (jpeg) memcpy(capture->compressedData + headerSize + codedSize, jpeg, jpegSize);
+    capture->compressedSize = (int)(headerSize + codedSize) + jpegSize;
+    capture->tileCount = tileCount;
+    free(tiles);
+    free(slots);
+    free(codedSizes);
+    free(codecs);
+    free(cached);
+    free(coded);
+    free(jpeg);
+    
+    // Économie estimée sur la taille moyenne récente d'une tuile compressée, moins la référence
+    if (tileCount > 0) {
+        uint32_t frameAverage = ((uint32_t)jpegSize + codedSize) / (uint32_t)tileCount;
+        encoder->tileBytesEstimate = encoder->tileBytesEstimate == 0 ? frameAverage : (encoder->tileBytesEstimate * 7 + frameAverage) / 8;
+    }
+    if (refinedCount > 0) {
+        encoder->refineBytesEstimate = (encoder->refineBytesEstimate * 7 + refinedBytes / (uint32_t)refinedCount) / 8;
+    }
+    if (cachedCount > 0) {
+        StatsAddCounter(STAT_COUNTER_CACHE_HITS, (uint64_t)cachedCount);
+        if (encoder->tileBytesEstimate > WIRE_CACHED_TILE_SIZE) {
+            StatsAddCounter(STAT_COUNTER_CACHE_BYTES_SAVED, (uint64_t)cachedCount * (encoder->tileBytesEstimate - WIRE_CACHED_TILE_SIZE));
+        }
+    }
+    
+    StatsAddCounter(STAT_COUNTER_TILES_ENCODED, (uint64_t)tileCount);
+    StatsAddCounter(STAT_COUNTER_TILES_PALETTE, (uint64_t)paletteCount);
+    StatsAddCounter(STAT_COUNTER_TILES_LOSSLESS, (uint64_t)(codedCount - paletteCount - deltaCount));
+    StatsAddCounter(STAT_COUNTER_TILES_DELTA, (uint64_t)deltaCount);
+    StatsAddCounter(STAT_COUNTER_TILES_REFINED, (uint64_t)refinedCount);
+    StatsAddCounter(STAT_COUNTER_COPY_RECTS, copyCount);
+    
+    return true;
+}
+
+static uint32_t TilesEncoderStreamId(const void* state) {
+    return ((const TileFrameEncoder*)state)->history.canvasId;
+}
+
+static void TilesFlushEncoder(void* state) {
+    TileFrameEncoder* encoder = (TileFrameEncoder*)state;
+    TileHistoryFree(&encoder->history);
+    TileCacheReset(&encoder->cache);
+    encoder->tileBytesEstimate = 0;
+    encoder->refineBytesEstimate = 0;
+    encoder->losslessSinceFrameId = 0;
+}
+
+static void TilesDestroyEncoder(void* state) {
+    if (!state) return;
+    TileHistoryFree(&((TileFrameEncoder*)state)->history);
+    free(state);
+}
+
+static bool TilesParseFrame(const uint8_t* data, uint32_t size, CodecFrameInfo* info) {
+    if (!WireTileFrameValidate(data, size)) return false;
+    info->streamId = WireTileFrameCanvasId(data);
+    info->baseFrameId = WireTileFrameBaseFrameId(data);
+    info->tileCount = WireTileFrameTileCount(data);
+    return true;
+}
+
+static void* TilesCreateDecoder(void) {
+    return calloc(1, sizeof(TileCanvas));
+}
+
+static TileApplyResult TilesDecode(void* decoder, const uint8_t* data, uint32_t size, uint32_t frameId,
+                                   int width, int height) {
+    return TileCanvasApply((TileCanvas*)decoder, data, size, frameId, width, height);
+}
+
+static uint32_t TilesDecoderStreamId(const void* decoder) {
+    return ((const TileCanvas*)decoder)->canvasId;
+}
+
+static const Image* TilesDecodedImage(const void* decoder) {
+    return &((const TileCanvas*)decoder)->image;
+}
+
+static int TilesDirtyRects(const void* decoder, const DirtyRect** rects) {
+    *rects = ((const TileCanvas*)decoder)->dirtyRects;
+    return ((const TileCanvas*)decoder)->dirtyCount;
+}
+
+static void TilesDestroyDecoder(void* decoder) {
+    if (!decoder) return;
+    TileCanvasFree((TileCanvas*)decoder);
+    free(decoder);
+}
+
+static void* VideoCreateEncoder(void) {
+    return calloc(1, sizeof(VideoEncoder));
+}
+
+// Image entière, prédite depuis la dernière image acquittée si le codeur la conserve encore
+static bool VideoEncodeCapture(void* encoder, CaptureData* capture, const CaptureConfig* config, int quality) {
+    // NV12 produit pendant la capture, sinon converti ici (image chargée ou générée)
+    if (!capture->yuv.y) {
+        if (capture->image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 ||
+            !YuvImageAlloc(&capture->yuv, capture->image.width, capture->image.height)) {
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible de convertir l'image %u en NV12", capture->frameId);
+            return false;
+        }
+        ColorConvertRgbaToNv12((const uint8_t*)capture->image.data, (size_t)capture->image.width * 4,
+                               capture->image.width, capture->image.height, &capture->yuv);
+    }
+    
+    VideoEncodeOptions options = { quality, config->videoGop, config->videoSlices, capture->roi };
+    uint8_t* data = NULL;
+    uint32_t size = 0;
+    if (!VideoEncode((VideoEncoder*)encoder, &capture->yuv, capture->frameId, capture->baseFrameId, &options,
+                     &data, &size)) {
+        LOG_ERROR(LOG_MODULE_CAPTURE, "Échec du codage vidéo de l'image %u", capture->frameId);
+        return false;
+    }
+    
+    capture->compressedData = data;
+    capture->compressedSize = (int)size;
+    capture->canvasId = ((VideoEncoder*)encoder)->streamId;
+    capture->baseFrameId = WireVideoFrameReferenceFrameId(data);
+    capture->tileCount = 0;
+    if (capture->baseFrameId == 0) StatsAddCounter(STAT_COUNTER_VIDEO_KEYFRAMES, 1);
+    return true;
+}
+
+static uint32_t VideoEncoderStreamId(const void* encoder) {
+    return ((const VideoEncoder*)encoder)->streamId;
+}
+
+static void VideoFlushEncoder(void* encoder) {
+    VideoEncoderFree((VideoEncoder*)encoder);
+}
+
+static void VideoDestroyEncoder(void* encoder) {
+    if (!encoder) return;
+    VideoEncoderFree((VideoEncoder*)encoder);
+    free(encoder);
+}
+
+static bool VideoParseFrame(const uint8_t* data, uint32_t size, CodecFrameInfo* info) {
+    if (!WireVideoFrameValidate(data, size)) return false;
+    info->streamId = WireVideoFrameStreamId(data);
+    info->baseFrameId = WireVideoFrameReferenceFrameId(data);
+    info->tileCount = 0;
+    return true;
+}
+
+static void* VideoCreateDecoder(void) {
+    return calloc(1, sizeof(VideoDecoder));
+}
+
+static TileApplyResult VideoDecode(void* decoder, const uint8_t* data, uint32_t size, uint32_t frameId,
+                                   int width, int height) {
+    return VideoDecoderApply((VideoDecoder*)decoder, data, size, frameId, width, height);
+}
+
+static uint32_t VideoDecoderStreamId(const void* decoder) {
+    return ((const VideoDecoder*)decoder)->streamId;
+}
+
+static const Image* VideoDecodedImage(const void* decoder) {
+    return &((const VideoDecoder*)decoder)->image;
+}
+
+static int VideoDirtyRects(const void* decoder, const DirtyRect** rects) {
+    *rects = &((const VideoDecoder*)decoder)->dirty;
+    return ((const VideoDecoder*)decoder)->image.data ? 1 : 0;
+}
+
+static void VideoDestroyDecoder(void* decoder) {
+    if (!decoder) return;
+    VideoDecoderFree((VideoDecoder*)decoder);
+    free(decoder);
+}
+
+// Registre, indexé par CodecId et rangé du plus rapide au plus lent
+static const Codec registry[CODEC_ID_COUNT] = {
+    {
+        CODEC_ID_TILES, "tuiles", CODEC_CAP_LOSSLESS | CODEC_CAP_INTER,
+        TilesCreateEncoder, TilesEncode, TilesEncoderStreamId, TilesFlushEncoder, TilesDestroyEncoder,
+        TilesParseFrame, TilesCreateDecoder, TilesDecode, TilesDecoderStreamId, TilesDecodedImage, TilesDirtyRects,
+        TilesDestroyDecoder
+    },
+    {
+        CODEC_ID_VIDEO, "vidéo", CODEC_CAP_INTER | CODEC_CAP_YUV | CODEC_CAP_SLICES,
+        VideoCreateEncoder, VideoEncodeCapture, VideoEncoderStreamId, VideoFlushEncoder, VideoDestroyEncoder,
+        VideoParseFrame, VideoCreateDecoder, VideoDecode, VideoDecoderStreamId, VideoDecodedImage, VideoDirtyRects,
+        VideoDestroyDecoder
+    },
+};
+
+const Codec* CodecGet(uint32_t id) {
+    return id < CODEC_ID_COUNT ? &registry[id] : NULL;
+}
+
+uint32_t CodecSupportedCodecs(void) {
+    uint32_t support = 0;
+    for (int i = 0; i < CODEC_ID_COUNT; i++) support |= CODEC_SUPPORT_BIT(registry[i].id);
+    return support;
+}
+
+CodecId CodecSelect(CodecId preferred, uint32_t remoteSupport) {
+    uint32_t common = CodecSupportedCodecs() & (remoteSupport | CODEC_SUPPORT_BIT(CODEC_ID_TILES));
+    if ((unsigned)preferred < CODEC_ID_COUNT && (common & CODEC_SUPPORT_BIT(preferred))) return preferred;
+    for (int i = 0; i < CODEC_ID_COUNT; i++) {
+        if (common & CODEC_SUPPORT_BIT(registry[i].id)) return registry[i].id;
+    }
+    return CODEC_ID_TILES;
+}
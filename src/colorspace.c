@@ -0,0 +1,256 @@
+#include "../include/colorspace.h"
+#include <stdlib.h>
+#include <string.h>
+
+// SSE2 fait partie de l'ABI x86-64 : pas de détection à l'exécution
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define COLORSPACE_SSE2 1
+#endif
+
+// BT.601 en plage limitée, coefficients sur 8 bits de fraction (ceux de libyuv et de FFmpeg) :
+// Y = (66 R + 129 G + 25 B) / 256 + 16, U et V sur la somme des 4 pixels d'un bloc 2x2
+#define Y_R 66
+#define Y_G 129
+#define Y_B 25
+#define U_R (-38)
+#define U_G (-74)
+#define U_B 112
+#define V_R 112
+#define V_G (-94)
+#define V_B (-18)
+
+// Retour en RGB : 298 = 255 / 219 et 409, 100, 208, 516 les coefficients de chrominance, sur 8 bits
+#define INV_Y 298
+#define INV_RV 409
+#define INV_GU (-100)
+#define INV_GV (-208)
+#define INV_BU 516
+
+bool YuvImageAlloc(YuvImage* image, int width, int height) {
+    if (!image || width <= 0 || height <= 0) return false;
+    if (image->y && image->width == width && image->height == height) return true;
+    
+    // Un seul bloc : la chrominance suit la luminance
+    int uvStride = ((width + 1) / 2) * 2;
+    size_t ySize = (size_t)width * height;
+    size_t uvSize = (size_t)uvStride * ((height + 1) / 2);
+    uint8_t* planes = (uint8_t*)malloc(ySize + uvSize);
+    if (!planes) return false;
+    
+    YuvImageFree(image);
+    image->width = width;
+    image->height = height;
+    image->y = planes;
+    image->uv = planes + ySize;
+    image->yStride = width;
+    image->uvStride = uvStride;
+    return true;
+}
+
+void YuvImageFree(YuvImage* image) {
+    if (!image) return;
+    free(image->y);
+    memset(image, 0, sizeof(*image));
+}
+
+static inline uint8_t LumaOf(int r, int g, int b) {
+    return (uint8_t)(((Y_R * r + Y_G * g + Y_B * b + 128) >> 8) + 16);
+}
+
+static inline uint8_t ClampByte(int value) {
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+#ifdef COLORSPACE_SSE2
+// Coefficients d'une composante dans l'ordre des octets du pixel (alpha à 0), pour _mm_madd_epi16
+static inline __m128i PixelCoefficients(bool bgra, int r, int g, int b) {
+    return bgra ? _mm_setr_epi16((short)b, (short)g, (short)r, 0, (short)b, (short)g, (short)r, 0)
+                : _mm_setr_epi16((short)r, (short)g, (short)b, 0, (short)r, (short)g, (short)b, 0);
+}
+
+// Somme des deux moitiés de chaque paire d'entiers 32 bits : résultats dans les voies 0 et 2
+static inline __m128i AddPairs(__m128i products) {
+    return _mm_add_epi32(products, _mm_srli_epi64(products, 32));
+}
+
+// Luminance de 4 pixels, en 4 entiers 32 bits
+static inline __m128i Luma4(__m128i pixels, __m128i coeffs) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = AddPairs(_mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coeffs));
+    __m128i hi = AddPairs(_mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coeffs));
+    __m128i sums = _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)),
+                                      _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+    return _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(sums, _mm_set1_epi32(128)), 8), _mm_set1_epi32(16));
+}
+
+// Écrit 4 entiers 32 bits déjà dans [0, 255] comme 4 octets
+static inline void Store4Bytes(uint8_t* dst, __m128i values) {
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(values, values), values);
+    uint32_t bytes = (uint32_t)_mm_cvtsi128_si32(packed);
+    memcpy(dst, &bytes, 4);
+}
+
+// BGRA vers RGBA opaque : échange des octets 0 et 2 de chaque pixel
+static inline __m128i SwapRedBlue(__m128i pixels) {
+    __m128i green = _mm_and_si128(pixels, _mm_set1_epi32(0x0000FF00));
+    __m128i red = _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32(0x000000FF));
+    __m128i blue = _mm_slli_epi32(_mm_and_si128(pixels, _mm_set1_epi32(0x000000FF)), 16);
+    return _mm_or_si128(_mm_or_si128(green, red), _mm_or_si128(blue, _mm_set1_epi32((int)0xFF000000u)));
+}
+#endif
+
+// Conversion commune : 2 lignes à la fois, pour que chaque bloc de chrominance soit lu une seule fois.
+// Une dernière ligne ou colonne impaire est dupliquée dans son bloc
+static void ConvertToNv12(const uint8_t* src, size_t stride, int width, int height, bool bgra,
+                          uint8_t* rgba, size_t rgbaStride, YuvImage* yuv) {
+    int ri = bgra ? 2 : 0;
+    int bi = bgra ? 0 : 2;
+#ifdef COLORSPACE_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i yCoeffs = PixelCoefficients(bgra, Y_R, Y_G, Y_B);
+    __m128i uCoeffs = PixelCoefficients(bgra, U_R, U_G, U_B);
+    __m128i vCoeffs = PixelCoefficients(bgra, V_R, V_G, V_B);
+#endif
+    
+    for (int y = 0; y < height; y += 2) {
+        bool pair = y + 1 < height;
+        const uint8_t* row0 = src + (size_t)y * stride;
+        const uint8_t* row1 = pair ? row0 + stride : row0;
+        uint8_t* out0 = rgba ? rgba + (size_t)y * rgbaStride : NULL;
+        uint8_t* out1 = rgba && pair ? out0 + rgbaStride : NULL;
+        uint8_t* luma0 = yuv ? yuv->y + (size_t)y * yuv->yStride : NULL;
+        uint8_t* luma1 = yuv && pair ? luma0 + yuv->yStride : NULL;
+        uint8_t* chroma = yuv ? yuv->uv + (size_t)(y / 2) * yuv->uvStride : NULL;
+        int x = 0;
+        
+#ifdef COLORSPACE_SSE2
+        for (; x + 4 <= width; x += 4) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(row0 + (size_t)x * 4));
+            __m128i b = _mm_loadu_si128((const __m128i*)(row1 + (size_t)x * 4));
+            if (out0) {
+                _mm_storeu_si128((__m128i*)(out0 + (size_t)x * 4), SwapRedBlue(a));
+                if (out1) _mm_storeu_si128((__m128i*)(out1 + (size_t)x * 4), SwapRedBlue(b));
+            }
+            if (!yuv) continue;
+            
+            Store4Bytes(luma0 + x, Luma4(a, yCoeffs));
+            if (luma1) Store4Bytes(luma1 + x, Luma4(b, yCoeffs));
+            
+            // Somme de chaque bloc 2x2 sur 16 bits (au plus 1020), puis produit scalaire avec U et V
+            __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            __m128i blocks = _mm_unpacklo_epi64(_mm_add_epi16(s01, _mm_srli_si128(s01, 8)),
+                                                _mm_add_epi16(s23, _mm_srli_si128(s23, 8)));
+            __m128i u = AddPairs(_mm_madd_epi16(blocks, uCoeffs));
+            __m128i v = AddPairs(_mm_madd_epi16(blocks, vCoeffs));
+            __m128i uv = _mm_unpacklo_epi32(_mm_shuffle_epi32(u, _MM_SHUFFLE(3, 1, 2, 0)),
+                                            _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 1, 2, 0)));
+            uv = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(uv, _mm_set1_epi32(512)), 10), _mm_set1_epi32(128));
+            Store4Bytes(chroma + x, uv);
+        }
+#endif
+        
+        for (; x < width; x += 2) {
+            int x1 = x + 1 < width ? x + 1 : x;
+            const uint8_t* block[4] = { row0 + (size_t)x * 4, row0 + (size_t)x1 * 4,
+                                        row1 + (size_t)x * 4, row1 + (size_t)x1 * 4 };
+            int sumR = 0, sumG = 0, sumB = 0;
+            for (int i = 0; i < 4; i++) {
+                const uint8_t* p = block[i];
+                sumR += p[ri];
+                sumG += p[1];
+                sumB += p[bi];
+                
+                // Pixels réels seulement : les doublons de bord ne sont pas écrits
+                if ((i & 1) && x1 == x) continue;
+                if (i >= 2 && !pair) continue;
+                int column = i & 1 ? x1 : x;
+                uint8_t* out = i < 2 ? out0 : out1;
+                if (out) {
+                    out += (size_t)column * 4;
+                    out[0] = p[ri];
+                    out[1] = p[1];
+                    out[2] = p[bi];
+                    out[3] = 255;
+                }
+                uint8_t* luma = i < 2 ? luma0 : luma1;
+                if (luma) luma[column] = LumaOf(p[ri], p[1], p[bi]);
+            }
+            if (chroma) {
+                chroma[x] = (uint8_t)(((U_R * sumR + U_G * sumG + U_B * sumB + 512) >> 10) + 128);
+                chroma[x + 1] = (uint8_t)(((V_R * sumR + V_G * sumG + V_B * sumB + 512) >> 10) + 128);
+            }
+        }
+    }
+}
+
+void ColorConvertBgra(const uint8_t* bgra, size_t stride, int width, int height,
+                      uint8_t* rgba, size_t rgbaStride, YuvImage* yuv) {
+    if (!bgra || width <= 0 || height <= 0) return;
+    if (yuv && (!yuv->y || yuv->width != width || yuv->height != height)) yuv = NULL;
+    if (!rgba && !yuv) return;
+    ConvertToNv12(bgra, stride, width, height, true, rgba, rgbaStride, yuv);
+}
+
+void ColorConvertRgbaToNv12(const uint8_t* rgba, size_t stride, int width, int height, YuvImage* yuv) {
+    if (!rgba || !yuv || !yuv->y || yuv->width != width || yuv->height != height) return;
+    ConvertToNv12(rgba, stride, width, height, false, NULL, 0, yuv);
+}
+
+void ColorConvertNv12ToRgba(const YuvImage* yuv, uint8_t* rgba, size_t stride) {
+    if (!yuv || !yuv->y || !rgba) return;
+#ifdef COLORSPACE_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i lumaCoeffs = _mm_setr_epi16(INV_Y, 128, INV_Y, 128, INV_Y, 128, INV_Y, 128);
+    __m128i redCoeffs = _mm_setr_epi16(0, INV_RV, 0, INV_RV, 0, INV_RV, 0, INV_RV);
+    __m128i greenCoeffs = _mm_setr_epi16(INV_GU, INV_GV, INV_GU, INV_GV, INV_GU, INV_GV, INV_GU, INV_GV);
+    __m128i blueCoeffs = _mm_setr_epi16(INV_BU, 0, INV_BU, 0, INV_BU, 0, INV_BU, 0);
+    __m128i opaque = _mm_set1_epi8((char)0xFF);
+#endif
+    
+    for (int y = 0; y < yuv->height; y++) {
+        const uint8_t* luma = yuv->y + (size_t)y * yuv->yStride;
+        const uint8_t* chroma = yuv->uv + (size_t)(y / 2) * yuv->uvStride;
+        uint8_t* out = rgba + (size_t)y * stride;
+        int x = 0;
+        
+#ifdef COLORSPACE_SSE2
+        for (; x + 8 <= yuv->width; x += 8) {
+            // 8 pixels, 4 blocs de chrominance : (Y - 16, 1) et (U - 128, V - 128) par pixel, en 16 bits
+            __m128i c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(luma + x)), zero),
+                                      _mm_set1_epi16(16));
+            __m128i de = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(chroma + x)), zero),
+                                       _mm_set1_epi16(128));
+            __m128i cHalves[2] = { _mm_unpacklo_epi16(c, _mm_set1_epi16(1)), _mm_unpackhi_epi16(c, _mm_set1_epi16(1)) };
+            __m128i deHalves[2] = { _mm_unpacklo_epi32(de, de), _mm_unpackhi_epi32(de, de) };
+            __m128i channels[3][2];
+            for (int h = 0; h < 2; h++) {
+                __m128i base = _mm_madd_epi16(cHalves[h], lumaCoeffs);
+                channels[0][h] = _mm_srai_epi32(_mm_add_epi32(base, _mm_madd_epi16(deHalves[h], redCoeffs)), 8);
+                channels[1][h] = _mm_srai_epi32(_mm_add_epi32(base, _mm_madd_epi16(deHalves[h], greenCoeffs)), 8);
+                channels[2][h] = _mm_srai_epi32(_mm_add_epi32(base, _mm_madd_epi16(deHalves[h], blueCoeffs)), 8);
+            }
+            // Saturation en octets, puis entrelacement RGBA
+            __m128i r = _mm_packs_epi32(channels[0][0], channels[0][1]);
+            __m128i g = _mm_packs_epi32(channels[1][0], channels[1][1]);
+            __m128i b = _mm_packs_epi32(channels[2][0], channels[2][1]);
+            __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+            __m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), opaque);
+            _mm_storeu_si128((__m128i*)(out + (size_t)x * 4), _mm_unpacklo_epi16(rg, ba));
+            _mm_storeu_si128((__m128i*)(out + (size_t)x * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+        }
+#endif
+        
+        for (; x < yuv->width; x++) {
+            int c = INV_Y * (luma[x] - 16) + 128;
+            int d = chroma[(x / 2) * 2] - 128;
+            int e = chroma[(x / 2) * 2 + 1] - 128;
+            uint8_t* p = out + (size_t)x * 4;
+            p[0] = ClampByte((c + INV_RV * e) >> 8);
+            p[1] = ClampByte((c + INV_GU * d + INV_GV * e) >> 8);
+            p[2] = ClampByte((c + INV_BU * d) >> 8);
+            p[3] = 255;
+        }
+    }
+}
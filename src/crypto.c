@@ -0,0 +1,946 @@
+#include "../include/crypto.h"
+#include "../include/clock.h"
+#include "../include/log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#include <bcrypt.h>
+#endif
+
+// Chemins accélérés : SSE2 fait partie de l'ABI x86-64, AES-NI/PCLMUL sont détectés à l'exécution
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRYPTO_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CRYPTO_SSE2 1
+#endif
+
+// Fonctions utilitaires privées
+static inline uint32_t Load32LE(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void Store32LE(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void Store64LE(uint8_t* p, uint64_t v) {
+    Store32LE(p, (uint32_t)v);
+    Store32LE(p + 4, (uint32_t)(v >> 32));
+}
+
+static inline void Store64BE(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+// Comparaison en temps constant (pas de sortie anticipée sur le premier octet différent)
+static bool CryptoEqual(const uint8_t* a, const uint8_t* b, size_t size) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < size; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+void CryptoWipe(void* data, size_t size) {
+    volatile uint8_t* p = (volatile uint8_t*)data;
+    while (size--) *p++ = 0;
+}
+
+bool CryptoRandomBytes(void* data, size_t size) {
+    if (!data) return false;
+#ifdef _WIN32
+    return BCryptGenRandom(NULL, (unsigned char*)data, (unsigned long)size,
+                           BCRYPT_USE_SYSTEM_PREFERRED_RNG) == 0;
+#else
+    FILE* file = fopen("/dev/urandom", "rb");
+    if (!file) return false;
+    size_t readSize = fread(data, 1, size, file);
+    fclose(file);
+    return readSize == size;
+#endif
+}
+
+// ChaCha20 (RFC 8439)
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CHACHA_QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = ROTL32(d, 16);   \
+    c += d; b ^= c; b = ROTL32(b, 12);   \
+    a += b; d ^= a; d = ROTL32(d, 8);    \
+    c += d; b ^= c; b = ROTL32(b, 7);
+
+static void ChaCha20Setup(uint32_t state[16], const uint8_t key[32], uint32_t counter, const uint8_t nonce[12]) {
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) state[4 + i] = Load32LE(key + 4 * i);
+    state[12] = counter;
+    state[13] = Load32LE(nonce);
+    state[14] = Load32LE(nonce + 4);
+    state[15] = Load32LE(nonce + 8);
+}
+
+static void ChaCha20Block(const uint32_t state[16], uint8_t out[64]) {
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    
+    for (int i = 0; i < 10; i++) {
+        CHACHA_QUARTER_ROUND(x[0], x[4], x[8],  x[12])
+        CHACHA_QUARTER_ROUND(x[1], x[5], x[9],  x[13])
+        CHACHA_QUARTER_ROUND(x[2], x[6], x[10], x[14])
+        CHACHA_QUARTER_ROUND(x[3], x[7], x[11], x[15])
+        CHACHA_QUARTER_ROUND(x[0], x[5], x[10], x[15])
+        CHACHA_QUARTER_ROUND(x[1], x[6], x[11], x[12])
+        CHACHA_QUARTER_ROUND(x[2], x[7], x[8],  x[13])
+        CHACHA_QUARTER_ROUND(x[3], x[4], x[9],  x[14])
+    }
+    
+    for (int i = 0; i < 16; i++) Store32LE(out + 4 * i, x[i] + state[i]);
+}
+
+#ifdef CRYPTO_SSE2
+#define SSE_ROTL32(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define SSE_QUARTER_ROUND(a, b, c, d)                                           \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = SSE_ROTL32(d, 16);    \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = SSE_ROTL32(b, 12);    \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = SSE_ROTL32(d, 8);     \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = SSE_ROTL32(b, 7);
+
+// Quatre blocs en parallèle : chaque registre contient le même mot des quatre blocs
+static void ChaCha20Blocks4(const uint32_t state[16], uint8_t out[256]) {
+    __m128i x[16], orig[16];
+    for (int i = 0; i < 16; i++) orig[i] = _mm_set1_epi32((int)state[i]);
+    orig[12] = _mm_add_epi32(orig[12], _mm_set_epi32(3, 2, 1, 0));
+    memcpy(x, orig, sizeof(x));
+    
+    for (int i = 0; i < 10; i++) {
+        SSE_QUARTER_ROUND(x[0], x[4], x[8],  x[12])
+        SSE_QUARTER_ROUND(x[1], x[5], x[9],  x[13])
+        SSE_QUARTER_ROUND(x[2], x[6], x[10], x[14])
+        SSE_QUARTER_ROUND(x[3], x[7], x[11], x[15])
+        SSE_QUARTER_ROUND(x[0], x[5], x[10], x[15])
+        SSE_QUARTER_ROUND(x[1], x[6], x[11], x[12])
+        SSE_QUARTER_ROUND(x[2], x[7], x[8],  x[13])
+        SSE_QUARTER_ROUND(x[3], x[4], x[9],  x[14])
+    }
+    
+    // Transposition 4x4 : on repasse d'un mot par registre à quatre mots consécutifs par bloc
+    for (int w = 0; w < 16; w += 4) {
+        __m128i a = _mm_add_epi32(x[w], orig[w]);
+        __m128i b = _mm_add_epi32(x[w + 1], orig[w + 1]);
+        __m128i c = _mm_add_epi32(x[w + 2], orig[w + 2]);
+        __m128i d = _mm_add_epi32(x[w + 3], orig[w + 3]);
+        
+        __m128i ab01 = _mm_unpacklo_epi32(a, b);
+        __m128i cd01 = _mm_unpacklo_epi32(c, d);
+        __m128i ab23 = _mm_unpackhi_epi32(a, b);
+        __m128i cd23 = _mm_unpackhi_epi32(c, d);
+        
+        _mm_storeu_si128((__m128i*)(out + 0 * 64 + 4 * w), _mm_unpacklo_epi64(ab01, cd01));
+        _mm_storeu_si128((__m128i*)(out + 1 * 64 + 4 * w), _mm_unpackhi_epi64(ab01, cd01));
+        _mm_storeu_si128((__m128i*)(out + 2 * 64 + 4 * w), _mm_unpacklo_epi64(ab23, cd23));
+        _mm_storeu_si128((__m128i*)(out + 3 * 64 + 4 * w), _mm_unpackhi_epi64(ab23, cd23));
+    }
+}
+#endif
+
+// Flux de clé appliqué de in vers out (in == out : en place)
+static void ChaCha20Xor(const uint8_t key[32], uint32_t counter, const uint8_t nonce[12],
+                        const uint8_t* in, uint8_t* out, size_t size) {
+    uint32_t state[16];
+    ChaCha20Setup(state, key, counter, nonce);
+    
+#ifdef CRYPTO_SSE2
+    uint8_t stream[256];
+    while (size >= sizeof(stream)) {
+        ChaCha20Blocks4(state, stream);
+        for (size_t i = 0; i < sizeof(stream); i += 16) {
+            __m128i d = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i k = _mm_loadu_si128((const __m128i*)(stream + i));
+            _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(d, k));
+        }
+        state[12] += 4;
+        in += sizeof(stream);
+        out += sizeof(stream);
+        size -= sizeof(stream);
+    }
+    CryptoWipe(stream, sizeof(stream));
+#endif
+    
+    uint8_t block[64];
+    while (size > 0) {
+        ChaCha20Block(state, block);
+        size_t n = size < sizeof(block) ? size : sizeof(block);
+        for (size_t i = 0; i < n; i++) out[i] = in[i] ^ block[i];
+        state[12]++;
+        in += n;
+        out += n;
+        size -= n;
+    }
+    
+    CryptoWipe(block, sizeof(block));
+    CryptoWipe(state, sizeof(state));
+}
+
+// Poly1305 (arithmétique en 5 limbs de 26 bits)
+
+typedef struct {
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+    uint8_t buffer[16];
+    size_t leftover;
+} Poly1305State;
+
+static void Poly1305Init(Poly1305State* st, const uint8_t key[32]) {
+    st->r[0] = (Load32LE(key + 0)) & 0x3ffffff;
+    st->r[1] = (Load32LE(key + 3) >> 2) & 0x3ffff03;
+    st->r[2] = (Load32LE(key + 6) >> 4) & 0x3ffc0ff;
+    st->r[3] = (Load32LE(key + 9) >> 6) & 0x3f03fff;
+    st->r[4] = (Load32LE(key + 12) >> 8) & 0x00fffff;
+    memset(st->h, 0, sizeof(st->h));
+    for (int i = 0; i < 4; i++) st->pad[i] = Load32LE(key + 16 + 4 * i);
+    st->leftover = 0;
+}
+
+static void Poly1305Blocks(Poly1305State* st, const uint8_t* m, size_t size, uint32_t hibit) {
+    const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2], r3 = st->r[3], r4 = st->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+    
+    while (size >= 16) {
+        h0 += (Load32LE(m + 0)) & 0x3ffffff;
+        h1 += (Load32LE(m + 3) >> 2) & 0x3ffffff;
+        h2 += (Load32LE(m + 6) >> 4) & 0x3ffffff;
+        h3 += (Load32LE(m + 9) >> 6) & 0x3ffffff;
+        h4 += (Load32LE(m + 12) >> 8) | hibit;
+        
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+        
+        uint32_t c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+        
+        m += 16;
+        size -= 16;
+    }
+    
+    st->h[0] = h0; st->h[1] = h1; st->h[2] = h2; st->h[3] = h3; st->h[4] = h4;
+}
+
+static void Poly1305Update(Poly1305State* st, const uint8_t* m, size_t size) {
+    if (st->leftover) {
+        size_t want = 16 - st->leftover;
+        if (want > size) want = size;
+        memcpy(st->buffer + st->leftover, m, want);
+        st->leftover += want;
+        m += want;
+        size -= want;
+        if (st->leftover < 16) return;
+        Poly1305Blocks(st, st->buffer, 16, 1u << 24);
+        st->leftover = 0;
+    }
+    
+    size_t blocks = size & ~(size_t)15;
+    if (blocks) {
+        Poly1305Blocks(st, m, blocks, 1u << 24);
+        m += blocks;
+        size -= blocks;
+    }
+    
+    if (size) {
+        memcpy(st->buffer, m, size);
+        st->leftover = size;
+    }
+}
+
+// Complète avec des zéros jusqu'au prochain multiple de 16 (construction AEAD)
+static void Poly1305Pad16(Poly1305State* st, size_t size) {
+    static const uint8_t zeros[16] = {0};
+    if (size % 16) Poly1305Update(st, zeros, 16 - size % 16);
+}
+
+static void Poly1305Finish(Poly1305State* st, uint8_t mac[16]) {
+    if (st->leftover) {
+        st->buffer[st->leftover] = 1;
+        memset(st->buffer + st->leftover + 1, 0, 16 - st->leftover - 1);
+        Poly1305Blocks(st, st->buffer, 16, 0);
+    }
+    
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+    uint32_t c;
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+    
+    // g = h - p ; on garde g si h >= p (sélection sans branche)
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+    
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+    
+    // h = (h + pad) mod 2^128
+    h0 = (h0 | (h1 << 26));
+    h1 = ((h1 >> 6) | (h2 << 20));
+    h2 = ((h2 >> 12) | (h3 << 14));
+    h3 = ((h3 >> 18) | (h4 << 8));
+    
+    uint64_t f;
+    f = (uint64_t)h0 + st->pad[0];             h0 = (uint32_t)f;
+    f = (uint64_t)h1 + st->pad[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + st->pad[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + st->pad[3] + (f >> 32); h3 = (uint32_t)f;
+    
+    Store32LE(mac + 0, h0);
+    Store32LE(mac + 4, h1);
+    Store32LE(mac + 8, h2);
+    Store32LE(mac + 12, h3);
+    
+    CryptoWipe(st, sizeof(*st));
+}
+
+// Tag ChaCha20-Poly1305 sur les données chiffrées
+static void ChaChaPolyTag(const uint8_t key[32], const uint8_t nonce[12],
+                          const uint8_t* aad, size_t aadSize,
+                          const uint8_t* cipher, size_t size, uint8_t tag[16]) {
+    // Clé Poly1305 à usage unique : premier bloc du flux (compteur 0)
+    uint32_t state[16];
+    uint8_t block[64];
+    ChaCha20Setup(state, key, 0, nonce);
+    ChaCha20Block(state, block);
+    
+    Poly1305State poly;
+    Poly1305Init(&poly, block);
+    if (aadSize) Poly1305Update(&poly, aad, aadSize);
+    Poly1305Pad16(&poly, aadSize);
+    if (size) Poly1305Update(&poly, cipher, size);
+    Poly1305Pad16(&poly, size);
+    
+    uint8_t lengths[16];
+    Store64LE(lengths, aadSize);
+    Store64LE(lengths + 8, size);
+    Poly1305Update(&poly, lengths, sizeof(lengths));
+    Poly1305Finish(&poly, tag);
+    
+    CryptoWipe(block, sizeof(block));
+    CryptoWipe(state, sizeof(state));
+}
+
+// AES-256-GCM (AES-NI + PCLMULQDQ)
+
+#ifdef CRYPTO_X86
+#define AES_TARGET __attribute__((target("aes,pclmul,ssse3,sse4.1")))
+
+AES_TARGET static inline __m128i AesKeyAssist1(__m128i t1, __m128i t2) {
+    t2 = _mm_shuffle_epi32(t2, 0xff);
+    __m128i t4 = _mm_slli_si128(t1, 4);
+    t1 = _mm_xor_si128(t1, t4);
+    t4 = _mm_slli_si128(t4, 4);
+    t1 = _mm_xor_si128(t1, t4);
+    t4 = _mm_slli_si128(t4, 4);
+    t1 = _mm_xor_si128(t1, t4);
+    return _mm_xor_si128(t1, t2);
+}
+
+AES_TARGET static inline __m128i AesKeyAssist2(__m128i t1, __m128i t3) {
+    __m128i t2 = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(t1, 0x00), 0xaa);
+    __m128i t4 = _mm_slli_si128(t3, 4);
+    t3 = _mm_xor_si128(t3, t4);
+    t4 = _mm_slli_si128(t4, 4);
+    t3 = _mm_xor_si128(t3, t4);
+    t4 = _mm_slli_si128(t4, 4);
+    t3 = _mm_xor_si128(t3, t4);
+    return _mm_xor_si128(t3, t2);
+}
+
+// aeskeygenassist exige une constante immédiate, d'où la macro
+#define AES_EXPAND_ROUND(rcon, index)                                           \
+    t1 = AesKeyAssist1(t1, _mm_aeskeygenassist_si128(t3, rcon));                \
+    ks[index] = t1;                                                             \
+    if ((index) + 1 < 15) {                                                     \
+        t3 = AesKeyAssist2(t1, t3);                                             \
+        ks[(index) + 1] = t3;                                                   \
+    }
+
+AES_TARGET static void Aes256ExpandKey(const uint8_t key[32], uint8_t roundKeys[15 * 16]) {
+    __m128i ks[15];
+    __m128i t1 = _mm_loadu_si128((const __m128i*)key);
+    __m128i t3 = _mm_loadu_si128((const __m128i*)(key + 16));
+    ks[0] = t1;
+    ks[1] = t3;
+    AES_EXPAND_ROUND(0x01, 2)
+    AES_EXPAND_ROUND(0x02, 4)
+    AES_EXPAND_ROUND(0x04, 6)
+    AES_EXPAND_ROUND(0x08, 8)
+    AES_EXPAND_ROUND(0x10, 10)
+    AES_EXPAND_ROUND(0x20, 12)
+    AES_EXPAND_ROUND(0x40, 14)
+    
+    for (int i = 0; i < 15; i++) _mm_storeu_si128((__m128i*)(roundKeys + 16 * i), ks[i]);
+    CryptoWipe(ks, sizeof(ks));
+}
+
+AES_TARGET static inline __m128i Aes256EncryptBlock(const __m128i* ks, __m128i block) {
+    block = _mm_xor_si128(block, ks[0]);
+    for (int i = 1; i < 14; i++) block = _mm_aesenc_si128(block, ks[i]);
+    return _mm_aesenclast_si128(block, ks[14]);
+}
+
+// Multiplication dans GF(2^128) sur des opérandes à octets inversés (Intel, algorithme 5)
+AES_TARGET static inline __m128i GfMul(__m128i a, __m128i b) {
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t4 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t5 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t6 = _mm_clmulepi64_si128(a, b, 0x11);
+    
+    t4 = _mm_xor_si128(t4, t5);
+    t5 = _mm_slli_si128(t4, 8);
+    t4 = _mm_srli_si128(t4, 8);
+    t3 = _mm_xor_si128(t3, t5);
+    t6 = _mm_xor_si128(t6, t4);
+    
+    // Décalage d'un bit à gauche du produit de 256 bits (convention réfléchie)
+    __m128i t7 = _mm_srli_epi32(t3, 31);
+    __m128i t8 = _mm_srli_epi32(t6, 31);
+    t3 = _mm_slli_epi32(t3, 1);
+    t6 = _mm_slli_epi32(t6, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    t3 = _mm_or_si128(t3, t7);
+    t6 = _mm_or_si128(t6, t8);
+    t6 = _mm_or_si128(t6, t9);
+    
+    // Réduction modulo x^128 + x^7 + x^2 + x + 1
+    t7 = _mm_slli_epi32(t3, 31);
+    t8 = _mm_slli_epi32(t3, 30);
+    t9 = _mm_slli_epi32(t3, 25);
+    t7 = _mm_xor_si128(t7, t8);
+    t7 = _mm_xor_si128(t7, t9);
+    t8 = _mm_srli_si128(t7, 4);
+    t7 = _mm_slli_si128(t7, 12);
+    t3 = _mm_xor_si128(t3, t7);
+    
+    __m128i t2 = _mm_srli_epi32(t3, 1);
+    t4 = _mm_srli_epi32(t3, 2);
+    t5 = _mm_srli_epi32(t3, 7);
+    t2 = _mm_xor_si128(t2, t4);
+    t2 = _mm_xor_si128(t2, t5);
+    t2 = _mm_xor_si128(t2, t8);
+    t3 = _mm_xor_si128(t3, t2);
+    return _mm_xor_si128(t6, t3);
+}
+
+AES_TARGET static void AesGcmSetup(AeadContext* ctx) {
+    Aes256ExpandKey(ctx->key, ctx->aesRoundKeys);
+    
+    const __m128i* ks = (const __m128i*)ctx->aesRoundKeys;
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i roundKeys[15];
+    for (int i = 0; i < 15; i++) roundKeys[i] = _mm_loadu_si128(ks + i);
+    
+    __m128i h = Aes256EncryptBlock(roundKeys, _mm_setzero_si128());
+    _mm_storeu_si128((__m128i*)ctx->ghashKey, _mm_shuffle_epi8(h, bswap));
+    CryptoWipe(roundKeys, sizeof(roundKeys));
+}
+
+AES_TARGET static __m128i GhashUpdate(__m128i y, __m128i h, const uint8_t* data, size_t size) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    
+    while (size >= 16) {
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), bswap);
+        y = GfMul(_mm_xor_si128(y, x), h);
+        data += 16;
+        size -= 16;
+    }
+    
+    if (size) {
+        uint8_t last[16] = {0};
+        memcpy(last, data, size);
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)last), bswap);
+        y = GfMul(_mm_xor_si128(y, x), h);
+    }
+    return y;
+}
+
+// Tag GCM : GHASH(A, C) ^ E(K, J0)
+AES_TARGET static void AesGcmTag(const AeadContext* ctx, const uint8_t nonce[12],
+                                 const uint8_t* aad, size_t aadSize,
+                                 const uint8_t* cipher, size_t size, uint8_t tag[16]) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i ks[15];
+    for (int i = 0; i < 15; i++) ks[i] = _mm_loadu_si128((const __m128i*)(ctx->aesRoundKeys + 16 * i));
+    __m128i h = _mm_loadu_si128((const __m128i*)ctx->ghashKey);
+    
+    __m128i y = _mm_setzero_si128();
+    y = GhashUpdate(y, h, aad, aadSize);
+    y = GhashUpdate(y, h, cipher, size);
+    
+    uint8_t lengths[16];
+    Store64BE(lengths, (uint64_t)aadSize * 8);
+    Store64BE(lengths + 8, (uint64_t)size * 8);
+    y = GhashUpdate(y, h, lengths, sizeof(lengths));
+    
+    uint8_t j0[16];
+    memcpy(j0, nonce, 12);
+    j0[12] = 0; j0[13] = 0; j0[14] = 0; j0[15] = 1;
+    __m128i mask = Aes256EncryptBlock(ks, _mm_loadu_si128((const __m128i*)j0));
+    
+    _mm_storeu_si128((__m128i*)tag, _mm_xor_si128(_mm_shuffle_epi8(y, bswap), mask));
+    CryptoWipe(ks, sizeof(ks));
+}
+
+// Chiffrement CTR à partir de inc32(J0), quatre blocs en vol pour remplir le pipeline AES (in == out : en place)
+AES_TARGET static void AesGcmCtr(const AeadContext* ctx, const uint8_t nonce[12], const uint8_t* in, uint8_t* out,
+                                 size_t size) {
+    __m128i ks[15];
+    for (int i = 0; i < 15; i++) ks[i] = _mm_loadu_si128((const __m128i*)(ctx->aesRoundKeys + 16 * i));
+    
+    uint8_t base[16] = {0};
+    memcpy(base, nonce, 12);
+    __m128i counterBlock = _mm_loadu_si128((const __m128i*)base);
+    uint32_t counter = 2;
+    
+#define GCM_COUNTER(n) _mm_insert_epi32(counterBlock, (int)__builtin_bswap32(counter + (n)), 3)
+    
+    while (size >= 64) {
+        __m128i b0 = _mm_xor_si128(GCM_COUNTER(0), ks[0]);
+        __m128i b1 = _mm_xor_si128(GCM_COUNTER(1), ks[0]);
+        __m128i b2 = _mm_xor_si128(GCM_COUNTER(2), ks[0]);
+        __m128i b3 = _mm_xor_si128(GCM_COUNTER(3), ks[0]);
+        for (int r = 1; r < 14; r++) {
+            b0 = _mm_aesenc_si128(b0, ks[r]);
+            b1 = _mm_aesenc_si128(b1, ks[r]);
+            b2 = _mm_aesenc_si128(b2, ks[r]);
+            b3 = _mm_aesenc_si128(b3, ks[r]);
+        }
+        b0 = _mm_aesenclast_si128(b0, ks[14]);
+        b1 = _mm_aesenclast_si128(b1, ks[14]);
+        b2 = _mm_aesenclast_si128(b2, ks[14]);
+        b3 = _mm_aesenclast_si128(b3, ks[14]);
+        
+        const __m128i* src = (const __m128i*)in;
+        __m128i* dst = (__m128i*)out;
+        _mm_storeu_si128(dst + 0, _mm_xor_si128(_mm_loadu_si128(src + 0), b0));
+        _mm_storeu_si128(dst + 1, _mm_xor_si128(_mm_loadu_si128(src + 1), b1));
+        _mm_storeu_si128(dst + 2, _mm_xor_si128(_mm_loadu_si128(src + 2), b2));
+        _mm_storeu_si128(dst + 3, _mm_xor_si128(_mm_loadu_si128(src + 3), b3));
+        
+        counter += 4;
+        in += 64;
+        out += 64;
+        size -= 64;
+    }
+    
+    while (size > 0) {
+        uint8_t stream[16];
+        _mm_storeu_si128((__m128i*)stream, Aes256EncryptBlock(ks, GCM_COUNTER(0)));
+        size_t n = size < 16 ? size : 16;
+        for (size_t i = 0; i < n; i++) out[i] = in[i] ^ stream[i];
+        counter++;
+        in += n;
+        out += n;
+        size -= n;
+    }
+    
+#undef GCM_COUNTER
+    CryptoWipe(ks, sizeof(ks));
+}
+#endif // CRYPTO_X86
+
+// API publique
+
+uint32_t AeadSupportedAlgorithms(void) {
+    uint32_t support = AEAD_SUPPORT_BIT(AEAD_ALGORITHM_CHACHA20_POLY1305);
+    
+#ifdef CRYPTO_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul") &&
+        __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1")) {
+        support |= AEAD_SUPPORT_BIT(AEAD_ALGORITHM_AES_256_GCM);
+    }
+#endif
+    
+    return support;
+}
+
+AeadAlgorithm AeadSelectAlgorithm(uint32_t localSupport, uint32_t remoteSupport) {
+    uint32_t common = localSupport & remoteSupport;
+    if (common & AEAD_SUPPORT_BIT(AEAD_ALGORITHM_AES_256_GCM)) return AEAD_ALGORITHM_AES_256_GCM;
+    if (common & AEAD_SUPPORT_BIT(AEAD_ALGORITHM_CHACHA20_POLY1305)) return AEAD_ALGORITHM_CHACHA20_POLY1305;
+    return AEAD_ALGORITHM_NONE;
+}
+
+const char* AeadAlgorithmName(AeadAlgorithm algorithm) {
+    switch (algorithm) {
+        case AEAD_ALGORITHM_CHACHA20_POLY1305: return "ChaCha20-Poly1305";
+        case AEAD_ALGORITHM_AES_256_GCM: return "AES-256-GCM";
+        default: return "aucun";
+    }
+}
+
+bool AeadInit(AeadContext* ctx, AeadAlgorithm algorithm, const uint8_t key[AEAD_KEY_SIZE]) {
+    if (!ctx || !key) return false;
+    if (!(AeadSupportedAlgorithms() & AEAD_SUPPORT_BIT(algorithm))) return false;
+    
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->algorithm = algorithm;
+    memcpy(ctx->key, key, AEAD_KEY_SIZE);
+    
+#ifdef CRYPTO_X86
+    if (algorithm == AEAD_ALGORITHM_AES_256_GCM) {
+        AesGcmSetup(ctx);
+    }
+#endif
+    return true;
+}
+
+void AeadSeal(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+              const uint8_t* aad, size_t aadSize,
+              uint8_t* data, size_t size, uint8_t tag[AEAD_TAG_SIZE]) {
+    AeadSealTo(ctx, nonce, aad, aadSize, data, data, size, tag);
+}
+
+void AeadSealTo(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+                const uint8_t* aad, size_t aadSize,
+                const uint8_t* plaintext, uint8_t* cipher, size_t size, uint8_t tag[AEAD_TAG_SIZE]) {
+    switch (ctx->algorithm) {
+        case AEAD_ALGORITHM_CHACHA20_POLY1305:
+            ChaCha20Xor(ctx->key, 1, nonce, plaintext, cipher, size);
+            ChaChaPolyTag(ctx->key, nonce, aad, aadSize, cipher, size, tag);
+            break;
+        
+#ifdef CRYPTO_X86
+        case AEAD_ALGORITHM_AES_256_GCM:
+            AesGcmCtr(ctx, nonce, plaintext, cipher, size);
+            AesGcmTag(ctx, nonce, aad, aadSize, cipher, size, tag);
+            break;
+#endif
+        
+        default:
+            memset(tag, 0, AEAD_TAG_SIZE);
+            break;
+    }
+}
+
+bool AeadOpen(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+              const uint8_t* aad, size_t aadSize,
+              uint8_t* data, size_t size, const uint8_t tag[AEAD_TAG_SIZE]) {
+    uint8_t expected[AEAD_TAG_SIZE];
+    
+    switch (ctx->algorithm) {
+        case AEAD_ALGORITHM_CHACHA20_POLY1305:
+            ChaChaPolyTag(ctx->key, nonce, aad, aadSize, data, size, expected);
+            if (!CryptoEqual(expected, tag, AEAD_TAG_SIZE)) return false;
+            ChaCha20Xor(ctx->key, 1, nonce, data, data, size);
+            return true;
+        
+#ifdef CRYPTO_X86
+        case AEAD_ALGORITHM_AES_256_GCM:
+            AesGcmTag(ctx, nonce, aad, aadSize, data, size, expected);
+            if (!CryptoEqual(expected, tag, AEAD_TAG_SIZE)) return false;
+            AesGcmCtr(ctx, nonce, data, data, size);
+            return true;
+#endif
+        
+        default:
+            return false;
+    }
+}
+
+void AeadWipe(AeadContext* ctx) {
+    if (ctx) CryptoWipe(ctx, sizeof(*ctx));
+}
+
+// Vecteurs de test et banc d'essai
+
+// RFC 8439 §2.8.2 : clé 80..9f, texte clair "Ladies and Gentlemen of the class of '99..."
+static const uint8_t rfc8439Nonce[12] = {
+    0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+};
+static const uint8_t rfc8439Aad[12] = {
+    0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7
+};
+static const uint8_t rfc8439Cipher[114] = {
+    0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc,
+    0x53, 0xef, 0x7e, 0xc2, 0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+    0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6, 0x3d, 0xbe, 0xa4, 0x5e,
+    0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+    0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6,
+    0x7e, 0xcd, 0x3b, 0x36, 0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+    0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58, 0xfa, 0xb3, 0x24, 0xe4,
+    0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+    0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65,
+    0x86, 0xce, 0xc6, 0x4b, 0x61, 0x16
+};
+static const uint8_t rfc8439Tag[16] = {
+    0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+};
+
+// GCM, cas de test 16 de McGrew et Viega (AES-256, 60 octets, 20 octets de données associées)
+static const uint8_t gcmKey[32] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+static const uint8_t gcmNonce[12] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88
+};
+static const uint8_t gcmAad[20] = {
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xab, 0xad, 0xda, 0xd2
+};
+static const uint8_t gcmPlain[60] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+    0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+    0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39
+};
+static const uint8_t gcmCipher[60] = {
+    0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d,
+    0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa,
+    0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38,
+    0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 0xbc, 0xc9, 0xf6, 0x62
+};
+static const uint8_t gcmTag[16] = {
+    0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55, 0x1b
+};
+
+/**
+ * @brief Tags de référence (OpenSSL) sur des messages longs
+ * @details Tailles choisies pour traverser les chemins vectorisés (4 blocs ChaCha20 de 64 octets,
+ *          4 blocs AES de 16 octets) et leurs restes. Clé, nonce, données associées et texte clair
+ *          suivent CryptoTestPattern.
+ */
+static const struct {
+    size_t size;
+    uint8_t tag[2][AEAD_TAG_SIZE];  // ChaCha20-Poly1305 puis AES-256-GCM
+} longVectors[] = {
+    { 63, {
+        { 0x03, 0x39, 0xb5, 0x90, 0x84, 0x86, 0x31, 0xf2, 0x5b, 0xb8, 0xe5, 0xc7, 0x87, 0x95, 0xc5, 0xc5 },
+        { 0xf7, 0x38, 0x67, 0x59, 0x54, 0xfb, 0xd6, 0x5e, 0x7a, 0xd3, 0xa0, 0xb0, 0xe3, 0xac, 0x41, 0xa2 } } },
+    { 256, {
+        { 0x3b, 0x35, 0x20, 0x0f, 0x9d, 0xe5, 0x7b, 0x39, 0xb6, 0x45, 0x48, 0x5f, 0x72, 0x57, 0xbe, 0x04 },
+        { 0xe1, 0x21, 0x74, 0x71, 0xde, 0x3b, 0x8a, 0x01, 0x1b, 0x02, 0x33, 0x6a, 0xc8, 0xaa, 0xe6, 0x19 } } },
+    { 4173, {
+        { 0x63, 0xcd, 0x6a, 0x6f, 0x97, 0x31, 0x37, 0x10, 0x1d, 0x1d, 0x0d, 0x30, 0xd0, 0x43, 0x7f, 0x82 },
+        { 0x3d, 0xf7, 0x50, 0x5c, 0xcf, 0x3e, 0xfc, 0x0a, 0x59, 0xe3, 0x9e, 0x4b, 0x4c, 0x27, 0xca, 0x74 } } },
+    { 65599, {
+        { 0x18, 0xa7, 0x13, 0x94, 0x50, 0x63, 0xd7, 0xf0, 0x72, 0x02, 0xfc, 0x3c, 0xca, 0x9b, 0x3d, 0xd5 },
+        { 0x96, 0xf2, 0x62, 0x2c, 0x8e, 0xc3, 0xaf, 0x70, 0x4e, 0xb9, 0x65, 0xa0, 0x5e, 0x12, 0x9d, 0xdc } } },
+};
+
+static void CryptoTestPattern(AeadAlgorithm algorithm, uint8_t key[AEAD_KEY_SIZE], uint8_t nonce[AEAD_NONCE_SIZE],
+                              uint8_t aad[13], uint8_t* plaintext, size_t size) {
+    for (int i = 0; i < AEAD_KEY_SIZE; i++) key[i] = (uint8_t)(i * 7 + algorithm);
+    for (int i = 0; i < AEAD_NONCE_SIZE; i++) nonce[i] = (uint8_t)(0xA0 + i);
+    for (int i = 0; i < 13; i++) aad[i] = (uint8_t)(i * 3);
+    for (size_t i = 0; i < size; i++) plaintext[i] = (uint8_t)(i * 131 + 7);
+}
+
+/**
+ * @brief Vérifie un vecteur : scellement vers un autre buffer et en place, puis ouverture
+ * @param expectedCipher Texte chiffré attendu, NULL pour ne vérifier que le tag
+ * @param work Buffer de travail d'au moins 2 * size octets
+ */
+static bool AeadCheckVector(const AeadContext* ctx, const uint8_t nonce[AEAD_NONCE_SIZE],
+                            const uint8_t* aad, size_t aadSize, const uint8_t* plaintext, size_t size,
+                            const uint8_t* expectedCipher, const uint8_t expectedTag[AEAD_TAG_SIZE], uint8_t* work) {
+    uint8_t* cipher = work;
+    uint8_t* inPlace = work + size;
+    uint8_t tag[AEAD_TAG_SIZE];
+    
+    AeadSealTo(ctx, nonce, aad, aadSize, plaintext, cipher, size, tag);
+    if (memcmp(tag, expectedTag, AEAD_TAG_SIZE) != 0) return false;
+    if (expectedCipher && memcmp(cipher, expectedCipher, size) != 0) return false;
+    
+    memcpy(inPlace, plaintext, size);
+    AeadSeal(ctx, nonce, aad, aadSize, inPlace, size, tag);
+    if (memcmp(tag, expectedTag, AEAD_TAG_SIZE) != 0 || memcmp(inPlace, cipher, size) != 0) return false;
+    
+    // Tag altéré : refusé sans toucher aux données
+    tag[size % AEAD_TAG_SIZE] ^= 0x01;
+    if (AeadOpen(ctx, nonce, aad, aadSize, inPlace, size, tag)) return false;
+    if (memcmp(inPlace, cipher, size) != 0) return false;
+    tag[size % AEAD_TAG_SIZE] ^= 0x01;
+    
+    return AeadOpen(ctx, nonce, aad, aadSize, inPlace, size, tag) && memcmp(inPlace, plaintext, size) == 0;
+}
+
+bool AeadSelfTest(void) {
+    uint32_t support = AeadSupportedAlgorithms();
+    size_t maxSize = 0;
+    for (size_t v = 0; v < sizeof(longVectors) / sizeof(longVectors[0]); v++) {
+        if (longVectors[v].size > maxSize) maxSize = longVectors[v].size;
+    }
+    
+    uint8_t* plaintext = (uint8_t*)malloc(maxSize);
+    uint8_t* work = (uint8_t*)malloc(maxSize * 2);
+    bool passed = plaintext && work;
+    AeadContext ctx;
+    
+    if (passed) {
+        uint8_t key[AEAD_KEY_SIZE];
+        for (int i = 0; i < AEAD_KEY_SIZE; i++) key[i] = (uint8_t)(0x80 + i);
+        static const char ladies[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                                     "for the future, sunscreen would be it.";
+        if (!AeadInit(&ctx, AEAD_ALGORITHM_CHACHA20_POLY1305, key) ||
+            !AeadCheckVector(&ctx, rfc8439Nonce, rfc8439Aad, sizeof(rfc8439Aad), (const uint8_t*)ladies,
+                             sizeof(rfc8439Cipher), rfc8439Cipher, rfc8439Tag, work)) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Auto-test : vecteur RFC 8439 de ChaCha20-Poly1305 refusé");
+            passed = false;
+        }
+    }
+    
+    if (passed && (support & AEAD_SUPPORT_BIT(AEAD_ALGORITHM_AES_256_GCM))) {
+        if (!AeadInit(&ctx, AEAD_ALGORITHM_AES_256_GCM, gcmKey) ||
+            !AeadCheckVector(&ctx, gcmNonce, gcmAad, sizeof(gcmAad), gcmPlain, sizeof(gcmPlain),
+                             gcmCipher, gcmTag, work)) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Auto-test : vecteur GCM 16 d'AES-256-GCM refusé");
+            passed = false;
+        }
+    }
+    
+    for (int a = AEAD_ALGORITHM_CHACHA20_POLY1305; a <= AEAD_ALGORITHM_AES_256_GCM && passed; a++) {
+        AeadAlgorithm algorithm = (AeadAlgorithm)a;
+        if (!(support & AEAD_SUPPORT_BIT(algorithm))) continue;
+        for (size_t v = 0; v < sizeof(longVectors) / sizeof(longVectors[0]) && passed; v++) {
+            uint8_t key[AEAD_KEY_SIZE];
+            uint8_t nonce[AEAD_NONCE_SIZE];
+            uint8_t aad[13];
+            size_t size = longVectors[v].size;
+            CryptoTestPattern(algorithm, key, nonce, aad, plaintext, size);
+            if (!AeadInit(&ctx, algorithm, key) ||
+                !AeadCheckVector(&ctx, nonce, aad, sizeof(aad), plaintext, size, NULL,
+                                 longVectors[v].tag[algorithm - AEAD_ALGORITHM_CHACHA20_POLY1305], work)) {
+                LOG_ERROR(LOG_MODULE_NETWORK, "Auto-test : %s refusé sur %zu octets",
+                          AeadAlgorithmName(algorithm), size);
+                passed = false;
+            }
+        }
+    }
+    
+    if (passed) {
+        LOG_INFO(LOG_MODULE_NETWORK, "Auto-test du chiffrement : vecteurs de référence validés (%s%s)",
+                 AeadAlgorithmName(AEAD_ALGORITHM_CHACHA20_POLY1305),
+                 (support & AEAD_SUPPORT_BIT(AEAD_ALGORITHM_AES_256_GCM)) ? ", AES-256-GCM" : "");
+    }
+    
+    AeadWipe(&ctx);
+    free(plaintext);
+    free(work);
+    return passed;
+}
+
+bool RunCryptoBenchmark(int frames) {
+    // Tailles d'une image 4K : différence typique, image clé JPEG, RGBA brut
+    const struct { const char* name; size_t size; } sizes[] = {
+        { "diff 64K", 64 * 1024 },
+        { "JPEG 1M", 1024 * 1024 },
+        { "RGBA 4K", (size_t)3840 * 2160 * 4 },
+    };
+    const int sizeCount = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    const double fps = 30.0;
+    if (frames <= 0) frames = 1;
+    if (!AeadSelfTest()) return false;
+    
+    size_t maxSize = sizes[sizeCount - 1].size;
+    uint8_t* plaintext = (uint8_t*)malloc(maxSize);
+    uint8_t* cipher = (uint8_t*)malloc(maxSize);
+    if (!plaintext || !cipher) {
+        free(plaintext);
+        free(cipher);
+        return false;
+    }
+    
+    uint8_t key[AEAD_KEY_SIZE];
+    uint8_t nonce[AEAD_NONCE_SIZE];
+    uint8_t aad[13];
+    CryptoTestPattern(AEAD_ALGORITHM_CHACHA20_POLY1305, key, nonce, aad, plaintext, maxSize);
+    
+    uint32_t support = AeadSupportedAlgorithms();
+    bool success = true;
+    LOG_INFO(LOG_MODULE_NETWORK, "Banc d'essai du chiffrement : %d images par taille, coût à %.0f images/s", frames, fps);
+    for (int a = AEAD_ALGORITHM_CHACHA20_POLY1305; a <= AEAD_ALGORITHM_AES_256_GCM && success; a++) {
+        AeadAlgorithm algorithm = (AeadAlgorithm)a;
+        AeadContext ctx;
+        if (!(support & AEAD_SUPPORT_BIT(algorithm))) {
+            LOG_INFO(LOG_MODULE_NETWORK, "%-17s non supporté par ce processeur", AeadAlgorithmName(algorithm));
+            continue;
+        }
+        AeadInit(&ctx, algorithm, key);
+        
+        for (int s = 0; s < sizeCount && success; s++) {
+            size_t size = sizes[s].size;
+            uint8_t tag[AEAD_TAG_SIZE];
+            uint64_t sealNs = 0;
+            uint64_t openNs = 0;
+            for (int f = 0; f < frames; f++) {
+                Store32LE(nonce, (uint32_t)f);
+                uint64_t start = ClockNowNs();
+                AeadSealTo(&ctx, nonce, aad, sizeof(aad), plaintext, cipher, size, tag);
+                uint64_t sealed = ClockNowNs();
+                success = AeadOpen(&ctx, nonce, aad, sizeof(aad), cipher, size, tag);
+                openNs += ClockNowNs() - sealed;
+                sealNs += sealed - start;
+                if (!success) break;
+            }
+            if (!success || memcmp(cipher, plaintext, size) != 0) {
+                LOG_ERROR(LOG_MODULE_NETWORK, "%s : aller-retour incorrect sur %zu octets", AeadAlgorithmName(algorithm), size);
+                success = false;
+                break;
+            }
+            
+            double megabytes = (double)size * frames / (1024.0 * 1024.0);
+            double sealSeconds = sealNs > 0 ? sealNs / 1e9 : 1e-9;
+            double openSeconds = openNs > 0 ? openNs / 1e9 : 1e-9;
+            LOG_INFO(LOG_MODULE_NETWORK, "%-17s %-8s scellement %8.1f Mo/s (%5.1f %% d'un cœur), "
+                     "ouverture %8.1f Mo/s (%5.1f %%)", AeadAlgorithmName(algorithm), sizes[s].name,
+                     megabytes / sealSeconds, 100.0 * fps * sealSeconds / frames,
+                     megabytes / openSeconds, 100.0 * fps * openSeconds / frames);
+        }
+        AeadWipe(&ctx);
+    }
+    
+    CryptoWipe(key, sizeof(key));
+    free(plaintext);
+    free(cipher);
+    return success;
+}
@@ -0,0 +1,96 @@
+#include "../include/cursor.h"
+#include "../include/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Entrée du cache des formes
+typedef struct {
+    CursorShape shape;
+    uint64_t lastUsed;          // Dernière utilisation (compteur croissant)
+} CursorCacheEntry;
+
+// Variables statiques
+static CursorCacheEntry cursorCache[CURSOR_CACHE_SIZE] = {0};
+static uint64_t cursorCacheClock = 0;
+
+// Fonctions utilitaires privées
+static uint32_t HashBytes(uint32_t hash, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t HashInt(uint32_t hash, int value) {
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    return HashBytes(hash, bytes, sizeof(bytes));
+}
+
+// Implémentation des fonctions publiques
+uint32_t CursorShapeHash(const CursorShape* shape) {
+    uint32_t hash = 2166136261u;
+    hash = HashInt(hash, shape->width);
+    hash = HashInt(hash, shape->height);
+    hash = HashInt(hash, shape->hotspotX);
+    hash = HashInt(hash, shape->hotspotY);
+    if (shape->pixels) {
+        hash = HashBytes(hash, shape->pixels, (size_t)shape->width * shape->height * 4);
+    }
+    return hash != 0 ? hash : 1;
+}
+
+bool CursorCacheStore(const CursorShape* shape) {
+    if (!shape || !shape->pixels || shape->shapeId == 0 || shape->width <= 0 || shape->height <= 0 ||
+        shape->width > CURSOR_MAX_SIZE || shape->height > CURSOR_MAX_SIZE) {
+        return false;
+    }
+    
+    // Forme déjà connue : elle redevient la plus récente
+    CursorCacheEntry* victim = &cursorCache[0];
+    for (int i = 0; i < CURSOR_CACHE_SIZE; i++) {
+        CursorCacheEntry* entry = &cursorCache[i];
+        if (entry->shape.pixels && entry->shape.shapeId == shape->shapeId) {
+            entry->lastUsed = ++cursorCacheClock;
+            return true;
+        }
+        
+        // Emplacement libre en priorité, sinon la forme la moins récemment utilisée
+        if (!victim->shape.pixels) continue;
+        if (!entry->shape.pixels || entry->lastUsed < victim->lastUsed) victim = entry;
+    }
+    
+    size_t size = (size_t)shape->width * shape->height * 4;
+    uint8_t* pixels = (uint8_t*)malloc(size);
+    if (!pixels) {
+        LOG_ERROR(LOG_MODULE_APP, "Impossible d'allouer la forme du curseur (%dx%d)", shape->width, shape->height);
+        return false;
+    }
+    memcpy(pixels, shape->pixels, size);
+    
+    free(victim->shape.pixels);
+    victim->shape = *shape;
+    victim->shape.pixels = pixels;
+    victim->lastUsed = ++cursorCacheClock;
+    return true;
+}
+
+const CursorShape* CursorCacheFind(uint32_t shapeId) {
+    if (shapeId == 0) return NULL;
+    
+    for (int i = 0; i < CURSOR_CACHE_SIZE; i++) {
+        if (cursorCache[i].shape.pixels && cursorCache[i].shape.shapeId == shapeId) {
+            cursorCache[i].lastUsed = ++cursorCacheClock;
+            return &cursorCache[i].shape;
+        }
+    }
+    return NULL;
+}
+
+void CursorCacheClear(void) {
+    for (int i = 0; i < CURSOR_CACHE_SIZE; i++) {
+        free(cursorCache[i].shape.pixels);
+    }
+    memset(cursorCache, 0, sizeof(cursorCache));
+    cursorCacheClock = 0;
+}
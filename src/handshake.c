@@ -0,0 +1,310 @@
+#include "../include/handshake.h"
+#include "../include/protocol.h"
+#include "../include/clock.h"
+#include <string.h>
+
+// Sel de PBKDF2 et étiquette HKDF, propres à l'application et à la version du protocole
+#define PSK_SALT "C_Screenshare PSK v1"
+#define SESSION_LABEL "C_Screenshare session v1"
+
+/**
+ * @brief Matériau produit par HKDF pour une session
+ */
+typedef struct {
+    uint8_t lowToHighKey[AEAD_KEY_SIZE];                // Sens part la plus petite -> la plus grande
+    uint8_t highToLowKey[AEAD_KEY_SIZE];
+    uint8_t lowToHighPrefix[HANDSHAKE_NONCE_PREFIX_SIZE];
+    uint8_t highToLowPrefix[HANDSHAKE_NONCE_PREFIX_SIZE];
+    uint8_t nextSessionId[HANDSHAKE_SESSION_ID_SIZE];   // Identifiant pour la prochaine reprise
+    uint8_t nextSecret[SHA256_DIGEST_SIZE];             // Secret pour la prochaine reprise
+} SessionMaterial;
+
+/**
+ * @brief Session mémorisée pour une reprise
+ */
+typedef struct {
+    bool isValid;
+    uint8_t sessionId[HANDSHAKE_SESSION_ID_SIZE];
+    uint8_t secret[SHA256_DIGEST_SIZE];
+    char address[64];
+    int port;
+    uint64_t expiresNs;
+    uint32_t canvasId;      // Dernière image acquittée par le pair sur cette session
+    uint32_t frameId;
+} CachedSession;
+
+static CachedSession sessionCache[HANDSHAKE_SESSION_CACHE_SIZE];
+static uint8_t cachedPsk[HANDSHAKE_PSK_SIZE];
+static uint8_t cachedPasswordHash[SHA256_DIGEST_SIZE];
+static bool hasCachedPsk = false;
+
+// Fonctions utilitaires privées
+static bool ConstantTimeEqual(const uint8_t* a, const uint8_t* b, size_t size) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < size; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static void ForgetSession(CachedSession* session) {
+    CryptoWipe(session, sizeof(*session));
+}
+
+static CachedSession* FindSessionByAddress(const char* address, int port, uint64_t now) {
+    for (int i = 0; i < HANDSHAKE_SESSION_CACHE_SIZE; i++) {
+        CachedSession* session = &sessionCache[i];
+        if (session->isValid && session->expiresNs > now && session->port == port &&
+            strcmp(session->address, address) == 0) {
+            return session;
+        }
+    }
+    return NULL;
+}
+
+// Côté écoute, le port source du pair change à chaque connexion : la reprise se fait par identifiant
+static CachedSession* FindSessionById(const uint8_t sessionId[HANDSHAKE_SESSION_ID_SIZE], uint64_t now) {
+    for (int i = 0; i < HANDSHAKE_SESSION_CACHE_SIZE; i++) {
+        CachedSession* session = &sessionCache[i];
+        if (session->isValid && session->expiresNs > now &&
+            ConstantTimeEqual(session->sessionId, sessionId, HANDSHAKE_SESSION_ID_SIZE)) {
+            return session;
+        }
+    }
+    return NULL;
+}
+
+static CachedSession* StoreSession(const SessionMaterial* material, const char* address, int port, uint64_t now) {
+    // Une seule entrée par adresse ; sinon une case libre, expirée, ou la plus ancienne
+    CachedSession* slot = FindSessionByAddress(address, port, now);
+    for (int i = 0; i < HANDSHAKE_SESSION_CACHE_SIZE && !slot; i++) {
+        if (!sessionCache[i].isValid || sessionCache[i].expiresNs <= now) slot = &sessionCache[i];
+    }
+    if (!slot) {
+        slot = &sessionCache[0];
+        for (int i = 1; i < HANDSHAKE_SESSION_CACHE_SIZE; i++) {
+            if (sessionCache[i].expiresNs < slot->expiresNs) slot = &sessionCache[i];
+        }
+    }
+    
+    slot->isValid = true;
+    memcpy(slot->sessionId, material->nextSessionId, sizeof(slot->sessionId));
+    memcpy(slot->secret, material->nextSecret, sizeof(slot->secret));
+    strncpy(slot->address, address, sizeof(slot->address) - 1);
+    slot->address[sizeof(slot->address) - 1] = '\0';
+    slot->port = port;
+    slot->expiresNs = now + HANDSHAKE_SESSION_LIFETIME_NS;
+    slot->canvasId = 0;
+    slot->frameId = 0;
+    return slot;
+}
+
+static bool BeginFull(HandshakeState* state) {
+    HandshakeReset(state);
+    if (!CryptoRandomBytes(state->privateKey, sizeof(state->privateKey))) return false;
+    X25519PublicKey(state->localShare, state->privateKey);
+    state->mode = HANDSHAKE_MODE_FULL;
+    return true;
+}
+
+static bool BeginResume(HandshakeState* state, const CachedSession* session) {
+    HandshakeReset(state);
+    if (!CryptoRandomBytes(state->localShare, sizeof(state->localShare))) return false;
+    memcpy(state->sessionId, session->sessionId, sizeof(state->sessionId));
+    memcpy(state->resumeSecret, session->secret, sizeof(state->resumeSecret));
+    state->mode = HANDSHAKE_MODE_RESUME;
+    return true;
+}
+
+static bool DeriveSessionKeys(HandshakeState* state, const uint8_t psk[HANDSHAKE_PSK_SIZE],
+                              const uint8_t* peerShare, AeadAlgorithm algorithm, SessionMaterial* material) {
+    // Les deux côtés doivent s'accorder sur l'ordre des parts (jamais égales sauf réflexion)
+    int order = memcmp(state->localShare, peerShare, HANDSHAKE_SHARE_SIZE);
+    if (order == 0) return false;
+    bool localIsLow = order < 0;
+    
+    uint8_t ikm[SHA256_DIGEST_SIZE];
+    if (state->mode == HANDSHAKE_MODE_FULL) {
+        if (!X25519(ikm, state->privateKey, peerShare)) return false;
+    } else {
+        memcpy(ikm, state->resumeSecret, sizeof(ikm));
+    }
+    
+    // Transcription : mode, parts ordonnées et session reprise
+    uint8_t info[sizeof(SESSION_LABEL) + 1 + 2 * HANDSHAKE_SHARE_SIZE + HANDSHAKE_SESSION_ID_SIZE];
+    uint8_t* p = info;
+    memcpy(p, SESSION_LABEL, sizeof(SESSION_LABEL));
+    p += sizeof(SESSION_LABEL);
+    *p++ = (uint8_t)state->mode;
+    memcpy(p, localIsLow ? state->localShare : peerShare, HANDSHAKE_SHARE_SIZE);
+    p += HANDSHAKE_SHARE_SIZE;
+    memcpy(p, localIsLow ? peerShare : state->localShare, HANDSHAKE_SHARE_SIZE);
+    p += HANDSHAKE_SHARE_SIZE;
+    if (state->mode == HANDSHAKE_MODE_RESUME) memcpy(p, state->sessionId, HANDSHAKE_SESSION_ID_SIZE);
+    else memset(p, 0, HANDSHAKE_SESSION_ID_SIZE);
+    
+    uint8_t prk[SHA256_DIGEST_SIZE];
+    HkdfSha256Extract(psk, HANDSHAKE_PSK_SIZE, ikm, sizeof(ikm), prk);
+    HkdfSha256Expand(prk, info, sizeof(info), (uint8_t*)material, sizeof(*material));
+    CryptoWipe(ikm, sizeof(ikm));
+    CryptoWipe(prk, sizeof(prk));
+    
+    SessionKeys* keys = &state->keys;
+    if (!AeadInit(&keys->txContext, algorithm, localIsLow ? material->lowToHighKey : material->highToLowKey) ||
+        !AeadInit(&keys->rxContext, algorithm, localIsLow ? material->highToLowKey : material->lowToHighKey)) {
+        CryptoWipe(keys, sizeof(*keys));
+        return false;
+    }
+    memcpy(keys->txNoncePrefix, localIsLow ? material->lowToHighPrefix : material->highToLowPrefix,
+           sizeof(keys->txNoncePrefix));
+    keys->txNonceCounter = 0;
+    keys->algorithm = algorithm;
+    keys->isResumed = state->mode == HANDSHAKE_MODE_RESUME;
+    keys->isEstablished = true;
+    return true;
+}
+
+// API publique
+void HandshakeDerivePsk(const char* password, uint8_t psk[HANDSHAKE_PSK_SIZE]) {
+    uint8_t passwordHash[SHA256_DIGEST_SIZE];
+    Sha256Context ctx;
+    Sha256Init(&ctx);
+    Sha256Update(&ctx, PSK_SALT, sizeof(PSK_SALT));
+    Sha256Update(&ctx, password, strlen(password));
+    Sha256Final(&ctx, passwordHash);
+    
+    if (!hasCachedPsk || !ConstantTimeEqual(passwordHash, cachedPasswordHash, sizeof(passwordHash))) {
+        // Nouveau mot de passe : les sessions en cache ne sont plus valables
+        HandshakeForgetAll();
+        Pbkdf2Sha256((const uint8_t*)password, strlen(password),
+                     (const uint8_t*)PSK_SALT, sizeof(PSK_SALT),
+                     HANDSHAKE_PBKDF2_ITERATIONS, cachedPsk, sizeof(cachedPsk));
+        memcpy(cachedPasswordHash, passwordHash, sizeof(cachedPasswordHash));
+        hasCachedPsk = true;
+    }
+    
+    memcpy(psk, cachedPsk, HANDSHAKE_PSK_SIZE);
+    CryptoWipe(passwordHash, sizeof(passwordHash));
+}
+
+bool HandshakeBegin(HandshakeState* state, const char* peerAddress, int peerPort) {
+    if (!state) return false;
+    
+    const CachedSession* session = FindSessionByAddress(peerAddress, peerPort, ClockNowNs());
+    return session ? BeginResume(state, session) : BeginFull(state);
+}
+
+void HandshakeWriteKeyShare(const HandshakeState* state, const uint8_t psk[HANDSHAKE_PSK_SIZE], uint8_t* message) {
+    uint8_t* keyShare = message + WIRE_HANDSHAKE_SIZE;
+    WireWriteKeyShare(keyShare, (uint8_t)state->mode, state->localShare,
+                      state->hasPeerShare ? state->peerShare : NULL,
+                      state->mode == HANDSHAKE_MODE_RESUME ? state->sessionId : NULL);
+    
+    // Le MAC couvre aussi les algorithmes annoncés : pas de retour forcé vers un algorithme plus faible
+    uint8_t mac[SHA256_DIGEST_SIZE];
+    HmacSha256(psk, HANDSHAKE_PSK_SIZE, message, WIRE_HANDSHAKE_SIZE + WIRE_KEY_SHARE_SIZE - HANDSHAKE_MAC_SIZE, mac);
+    memcpy(keyShare + WIRE_FIELD(WireKeyShare, mac), mac, HANDSHAKE_MAC_SIZE);
+}
+
+HandshakeResult HandshakeProcessKeyShare(HandshakeState* state, const uint8_t psk[HANDSHAKE_PSK_SIZE],
+                                         const uint8_t* message, AeadAlgorithm algorithm,
+                                         const char* peerAddress, int peerPort, bool* replyNeeded) {
+    const uint8_t* keyShare = message + WIRE_HANDSHAKE_SIZE;
+    *replyNeeded = false;
+    
+    uint8_t mac[SHA256_DIGEST_SIZE];
+    HmacSha256(psk, HANDSHAKE_PSK_SIZE, message, WIRE_HANDSHAKE_SIZE + WIRE_KEY_SHARE_SIZE - HANDSHAKE_MAC_SIZE, mac);
+    if (!ConstantTimeEqual(mac, WireKeyShareMac(keyShare), HANDSHAKE_MAC_SIZE)) return HANDSHAKE_RESULT_ERROR;
+    
+    uint8_t mode = WireKeyShareMode(keyShare);
+    if (mode != HANDSHAKE_MODE_FULL && mode != HANDSHAKE_MODE_RESUME) return HANDSHAKE_RESULT_ERROR;
+    
+    const uint8_t* peerShare = WireKeyShareShare(keyShare);
+    const uint8_t* peerSessionId = WireKeyShareSessionId(keyShare);
+    uint64_t now = ClockNowNs();
+    
+    // Part déjà utilisée pour les clés actuelles (réponse à notre propre réponse)
+    if (state->keys.isEstablished && memcmp(peerShare, state->usedPeerShare, HANDSHAKE_SHARE_SIZE) == 0) {
+        *replyNeeded = memcmp(WireKeyShareEcho(keyShare), state->localShare, HANDSHAKE_SHARE_SIZE) != 0;
+        return HANDSHAKE_RESULT_ESTABLISHED;
+    }
+    
+    // Nouvelle part nécessaire : aucune encore, la nôtre a déjà servi, ou reprise refusée par le pair
+    bool compatible = state->mode == mode &&
+                      (mode == HANDSHAKE_MODE_FULL ||
+                       memcmp(state->sessionId, peerSessionId, HANDSHAKE_SESSION_ID_SIZE) == 0);
+    if (state->mode == HANDSHAKE_MODE_NONE || state->localShareUsed ||
+        (state->mode == HANDSHAKE_MODE_RESUME && !compatible)) {
+        const CachedSession* session = mode == HANDSHAKE_MODE_RESUME ? FindSessionById(peerSessionId, now) : NULL;
+        if (!(session ? BeginResume(state, session) : BeginFull(state))) return HANDSHAKE_RESULT_ERROR;
+        compatible = state->mode == mode;
+    }
+    
+    memcpy(state->peerShare, peerShare, HANDSHAKE_SHARE_SIZE);
+    state->hasPeerShare = true;
+    *replyNeeded = memcmp(WireKeyShareEcho(keyShare), state->localShare, HANDSHAKE_SHARE_SIZE) != 0;
+    if (!compatible) return HANDSHAKE_RESULT_WAITING;
+    
+    SessionMaterial material;
+    if (!DeriveSessionKeys(state, psk, peerShare, algorithm, &material)) {
+        CryptoWipe(&material, sizeof(material));
+        return HANDSHAKE_RESULT_ERROR;
+    }
+    state->localShareUsed = true;
+    memcpy(state->usedPeerShare, peerShare, HANDSHAKE_SHARE_SIZE);
+    
+    // Le secret de reprise ne sert qu'une fois : la session suivante en reçoit un nouveau,
+    // ainsi que l'état des images de la session reprise
+    uint32_t canvasId = 0;
+    uint32_t frameId = 0;
+    if (state->mode == HANDSHAKE_MODE_RESUME) {
+        CachedSession* previous = FindSessionById(state->sessionId, now);
+        if (previous) {
+            canvasId = previous->canvasId;
+            frameId = previous->frameId;
+            ForgetSession(previous);
+        }
+    }
+    CachedSession* ticket = StoreSession(&material, peerAddress, peerPort, now);
+    ticket->canvasId = canvasId;
+    ticket->frameId = frameId;
+    memcpy(state->ticketId, material.nextSessionId, sizeof(state->ticketId));
+    
+    CryptoWipe(&material, sizeof(material));
+    return HANDSHAKE_RESULT_ESTABLISHED;
+}
+
+void HandshakeSetFrameState(const HandshakeState* state, uint32_t canvasId, uint32_t frameId) {
+    if (!state || !state->keys.isEstablished) return;
+    
+    CachedSession* ticket = FindSessionById(state->ticketId, ClockNowNs());
+    if (ticket) {
+        ticket->canvasId = canvasId;
+        ticket->frameId = frameId;
+    }
+}
+
+bool HandshakeGetFrameState(const HandshakeState* state, uint32_t* canvasId, uint32_t* frameId) {
+    if (!state || !state->keys.isEstablished) return false;
+    
+    const CachedSession* ticket = FindSessionById(state->ticketId, ClockNowNs());
+    if (!ticket || ticket->canvasId == 0) return false;
+    
+    if (canvasId) *canvasId = ticket->canvasId;
+    if (frameId) *frameId = ticket->frameId;
+    return true;
+}
+
+void HandshakeReset(HandshakeState* state) {
+    if (!state) return;
+    AeadWipe(&state->keys.txContext);
+    AeadWipe(&state->keys.rxContext);
+    CryptoWipe(state, sizeof(*state));
+}
+
+void HandshakeForgetAll(void) {
+    for (int i = 0; i < HANDSHAKE_SESSION_CACHE_SIZE; i++) {
+        ForgetSession(&sessionCache[i]);
+    }
+    CryptoWipe(cachedPsk, sizeof(cachedPsk));
+    CryptoWipe(cachedPasswordHash, sizeof(cachedPasswordHash));
+    hasCachedPsk = false;
+}
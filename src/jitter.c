@@ -0,0 +1,89 @@
+#include "../include/jitter.h"
+#include "../include/stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Fonctions utilitaires privées
+static void DiscardFrames(JitterBuffer* buffer, int count) {
+    for (int i = 0; i < count; i++) {
+        free(buffer->frames[i].compressedData);
+    }
+    memmove(&buffer->frames[0], &buffer->frames[count], (size_t)(buffer->count - count) * sizeof(CaptureData));
+    buffer->count -= count;
+    if (count > 0) StatsAddCounter(STAT_COUNTER_FRAMES_SKIPPED, (uint64_t)count);
+}
+
+// Heure de sortie d'une image en mode fluide ; une image sans horodatage sort aussitôt
+static uint64_t PlayoutTime(const JitterBuffer* buffer, const CaptureData* frame) {
+    if (frame->timestamp == 0 || !buffer->hasTransit) return frame->receiveNs;
+    
+    int64_t target = buffer->meanTransitNs + (int64_t)JitterPlayoutDelayNs(buffer);
+    int64_t playout = (int64_t)frame->timestamp + target;
+    return playout > (int64_t)frame->receiveNs ? (uint64_t)playout : frame->receiveNs;
+}
+
+// Implémentation des fonctions publiques
+void JitterPush(JitterBuffer* buffer, const CaptureData* frame, PlayoutPolicy policy) {
+    if (!buffer || !frame) return;
+    
+    // Transit et gigue des images horodatées (horloge de l'émetteur synchronisée)
+    if (frame->timestamp != 0 && frame->receiveNs != 0) {
+        int64_t transit = (int64_t)(frame->receiveNs - frame->timestamp);
+        if (!buffer->hasTransit) {
+            buffer->meanTransitNs = transit;
+            buffer->jitterNs = 0;
+            buffer->hasTransit = true;
+        } else {
+            int64_t difference = transit - buffer->lastTransitNs;
+            uint64_t magnitude = (uint64_t)(difference < 0 ? -difference : difference);
+            buffer->jitterNs = buffer->jitterNs + magnitude / 16 - buffer->jitterNs / 16;
+            buffer->meanTransitNs += (transit - buffer->meanTransitNs) / 16;
+        }
+        buffer->lastTransitNs = transit;
+    }
+    
+    // Latence minimale : les images en attente ne seront jamais affichées, inutile de les garder
+    if (policy == PLAYOUT_POLICY_LATENCY) {
+        DiscardFrames(buffer, buffer->count);
+    } else if (buffer->count == JITTER_CAPACITY) {
+        DiscardFrames(buffer, 1);
+    }
+    buffer->frames[buffer->count++] = *frame;
+}
+
+bool JitterPop(JitterBuffer* buffer, PlayoutPolicy policy, uint64_t now, CaptureData* frame) {
+    if (!buffer || !frame || buffer->count == 0) return false;
+    
+    // La plus récente des images dont l'heure est venue ; les précédentes ne seraient jamais vues
+    int due = buffer->count - 1;
+    if (policy == PLAYOUT_POLICY_SMOOTH) {
+        while (due >= 0 && PlayoutTime(buffer, &buffer->frames[due]) > now) due--;
+        if (due < 0) return false;
+    }
+    DiscardFrames(buffer, due);
+    
+    *frame = buffer->frames[0];
+    memmove(&buffer->frames[0], &buffer->frames[1], (size_t)(buffer->count - 1) * sizeof(CaptureData));
+    buffer->count--;
+    if (frame->receiveNs != 0 && now > frame->receiveNs) {
+        StatsRecordFrame(STAT_STAGE_PLAYOUT, now - frame->receiveNs, frame->frameId);
+    }
+    return true;
+}
+
+uint64_t JitterPlayoutDelayNs(const JitterBuffer* buffer) {
+    if (!buffer || !buffer->hasTransit) return 0;
+    
+    uint64_t delay = buffer->jitterNs * JITTER_DELAY_FACTOR;
+    uint64_t maxDelay = (uint64_t)JITTER_MAX_DELAY_MS * 1000000ULL;
+    return delay < maxDelay ? delay : maxDelay;
+}
+
+void JitterReset(JitterBuffer* buffer) {
+    if (!buffer) return;
+    
+    for (int i = 0; i < buffer->count; i++) {
+        free(buffer->frames[i].compressedData);
+    }
+    memset(buffer, 0, sizeof(*buffer));
+}
@@ -0,0 +1,481 @@
+#include "../include/keys.h"
+#include "../include/crypto.h"
+#include <string.h>
+
+// Fonctions utilitaires privées
+static inline uint32_t Load32BE(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void Store32BE(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint64_t Load64LE(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline void Store64LE(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+// SHA-256 (FIPS 180-4)
+
+static const uint32_t sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR32(v, n) (((v) >> (n)) | ((v) << (32 - (n))))
+
+static void Sha256Compress(uint32_t state[8], const uint8_t block[SHA256_BLOCK_SIZE]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) w[i] = Load32BE(block + 4 * i);
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + sha256RoundConstants[i] + w[i];
+        uint32_t s0 = ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void Sha256Init(Sha256Context* ctx) {
+    static const uint32_t initialState[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, initialState, sizeof(initialState));
+    ctx->totalSize = 0;
+    ctx->bufferSize = 0;
+}
+
+void Sha256Update(Sha256Context* ctx, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    ctx->totalSize += size;
+    
+    if (ctx->bufferSize > 0) {
+        size_t take = SHA256_BLOCK_SIZE - ctx->bufferSize;
+        if (take > size) take = size;
+        memcpy(ctx->buffer + ctx->bufferSize, p, take);
+        ctx->bufferSize += take;
+        p += take;
+        size -= take;
+        if (ctx->bufferSize < SHA256_BLOCK_SIZE) return;
+        Sha256Compress(ctx->state, ctx->buffer);
+        ctx->bufferSize = 0;
+    }
+    
+    // Blocs complets compressés directement depuis l'entrée
+    while (size >= SHA256_BLOCK_SIZE) {
+        Sha256Compress(ctx->state, p);
+        p += SHA256_BLOCK_SIZE;
+        size -= SHA256_BLOCK_SIZE;
+    }
+    
+    memcpy(ctx->buffer, p, size);
+    ctx->bufferSize = size;
+}
+
+void Sha256Final(Sha256Context* ctx, uint8_t digest[SHA256_DIGEST_SIZE]) {
+    uint64_t totalBits = ctx->totalSize * 8;
+    
+    // Bourrage : 0x80, zéros, puis la longueur en bits sur 64 bits big-endian
+    ctx->buffer[ctx->bufferSize++] = 0x80;
+    if (ctx->bufferSize > SHA256_BLOCK_SIZE - 8) {
+        memset(ctx->buffer + ctx->bufferSize, 0, SHA256_BLOCK_SIZE - ctx->bufferSize);
+        Sha256Compress(ctx->state, ctx->buffer);
+        ctx->bufferSize = 0;
+    }
+    memset(ctx->buffer + ctx->bufferSize, 0, SHA256_BLOCK_SIZE - 8 - ctx->bufferSize);
+    Store32BE(ctx->buffer + SHA256_BLOCK_SIZE - 8, (uint32_t)(totalBits >> 32));
+    Store32BE(ctx->buffer + SHA256_BLOCK_SIZE - 4, (uint32_t)totalBits);
+    Sha256Compress(ctx->state, ctx->buffer);
+    
+    for (int i = 0; i < 8; i++) Store32BE(digest + 4 * i, ctx->state[i]);
+    CryptoWipe(ctx, sizeof(*ctx));
+}
+
+void Sha256(const void* data, size_t size, uint8_t digest[SHA256_DIGEST_SIZE]) {
+    Sha256Context ctx;
+    Sha256Init(&ctx);
+    Sha256Update(&ctx, data, size);
+    Sha256Final(&ctx, digest);
+}
+
+// HMAC-SHA256 (RFC 2104)
+
+void HmacSha256Init(HmacSha256Context* ctx, const uint8_t* key, size_t keySize) {
+    uint8_t block[SHA256_BLOCK_SIZE] = {0};
+    
+    // Une clé plus longue qu'un bloc est d'abord hachée
+    if (keySize > SHA256_BLOCK_SIZE) {
+        Sha256(key, keySize, block);
+    } else if (keySize > 0) {
+        memcpy(block, key, keySize);
+    }
+    
+    for (int i = 0; i < SHA256_BLOCK_SIZE; i++) block[i] ^= 0x36;
+    Sha256Init(&ctx->inner);
+    Sha256Update(&ctx->inner, block, sizeof(block));
+    
+    for (int i = 0; i < SHA256_BLOCK_SIZE; i++) block[i] ^= 0x36 ^ 0x5c;
+    Sha256Init(&ctx->outer);
+    Sha256Update(&ctx->outer, block, sizeof(block));
+    
+    CryptoWipe(block, sizeof(block));
+}
+
+void HmacSha256Update(HmacSha256Context* ctx, const void* data, size_t size) {
+    Sha256Update(&ctx->inner, data, size);
+}
+
+void HmacSha256Final(HmacSha256Context* ctx, uint8_t mac[SHA256_DIGEST_SIZE]) {
+    uint8_t innerDigest[SHA256_DIGEST_SIZE];
+    Sha256Final(&ctx->inner, innerDigest);
+    Sha256Update(&ctx->outer, innerDigest, sizeof(innerDigest));
+    Sha256Final(&ctx->outer, mac);
+    CryptoWipe(innerDigest, sizeof(innerDigest));
+}
+
+void HmacSha256(const uint8_t* key, size_t keySize, const void* data, size_t size,
+                uint8_t mac[SHA256_DIGEST_SIZE]) {
+    HmacSha256Context ctx;
+    HmacSha256Init(&ctx, key, keySize);
+    HmacSha256Update(&ctx, data, size);
+    HmacSha256Final(&ctx, mac);
+}
+
+// PBKDF2-HMAC-SHA256 (RFC 8018)
+
+void Pbkdf2Sha256(const uint8_t* password, size_t passwordSize,
+                  const uint8_t* salt, size_t saltSize,
+                  uint32_t iterations, uint8_t* out, size_t outSize) {
+    // Les états ipad/opad ne dépendent que du mot de passe : calculés une fois,
+    // chaque itération ne coûte plus que deux compressions
+    HmacSha256Context keyed;
+    HmacSha256Init(&keyed, password, passwordSize);
+    
+    for (uint32_t blockIndex = 1; outSize > 0; blockIndex++) {
+        uint8_t counter[4];
+        uint8_t u[SHA256_DIGEST_SIZE];
+        uint8_t t[SHA256_DIGEST_SIZE];
+        HmacSha256Context ctx = keyed;
+        
+        Store32BE(counter, blockIndex);
+        HmacSha256Update(&ctx, salt, saltSize);
+        HmacSha256Update(&ctx, counter, sizeof(counter));
+        HmacSha256Final(&ctx, u);
+        memcpy(t, u, sizeof(t));
+        
+        for (uint32_t i = 1; i < iterations; i++) {
+            ctx = keyed;
+            HmacSha256Update(&ctx, u, sizeof(u));
+            HmacSha256Final(&ctx, u);
+            for (int j = 0; j < SHA256_DIGEST_SIZE; j++) t[j] ^= u[j];
+        }
+        
+        size_t take = outSize < sizeof(t) ? outSize : sizeof(t);
+        memcpy(out, t, take);
+        out += take;
+        outSize -= take;
+        
+        CryptoWipe(u, sizeof(u));
+        CryptoWipe(t, sizeof(t));
+    }
+    
+    CryptoWipe(&keyed, sizeof(keyed));
+}
+
+// HKDF-SHA256 (RFC 5869)
+
+void HkdfSha256Extract(const uint8_t* salt, size_t saltSize,
+                       const uint8_t* ikm, size_t ikmSize,
+                       uint8_t prk[SHA256_DIGEST_SIZE]) {
+    static const uint8_t zeroSalt[SHA256_DIGEST_SIZE] = {0};
+    if (!salt) {
+        salt = zeroSalt;
+        saltSize = sizeof(zeroSalt);
+    }
+    HmacSha256(salt, saltSize, ikm, ikmSize, prk);
+}
+
+bool HkdfSha256Expand(const uint8_t prk[SHA256_DIGEST_SIZE],
+                      const uint8_t* info, size_t infoSize,
+                      uint8_t* out, size_t outSize) {
+    if (outSize > 255 * SHA256_DIGEST_SIZE) return false;
+    
+    uint8_t t[SHA256_DIGEST_SIZE];
+    size_t tSize = 0;
+    
+    for (uint8_t counter = 1; outSize > 0; counter++) {
+        HmacSha256Context ctx;
+        HmacSha256Init(&ctx, prk, SHA256_DIGEST_SIZE);
+        HmacSha256Update(&ctx, t, tSize);
+        HmacSha256Update(&ctx, info, infoSize);
+        HmacSha256Update(&ctx, &counter, 1);
+        HmacSha256Final(&ctx, t);
+        tSize = sizeof(t);
+        
+        size_t take = outSize < sizeof(t) ? outSize : sizeof(t);
+        memcpy(out, t, take);
+        out += take;
+        outSize -= take;
+    }
+    
+    CryptoWipe(t, sizeof(t));
+    return true;
+}
+
+// X25519 (RFC 7748), corps premier 2^255 - 19 en 5 limbs de 51 bits
+
+typedef uint64_t Fe[5];
+typedef unsigned __int128 FeWide;
+
+#define FE_MASK ((1ULL << 51) - 1)
+
+static void FeFromBytes(Fe h, const uint8_t s[32]) {
+    h[0] = Load64LE(s) & FE_MASK;
+    h[1] = (Load64LE(s + 6) >> 3) & FE_MASK;
+    h[2] = (Load64LE(s + 12) >> 6) & FE_MASK;
+    h[3] = (Load64LE(s + 19) >> 1) & FE_MASK;
+    h[4] = (Load64LE(s + 24) >> 12) & FE_MASK;  // Le bit 255 est ignoré (RFC 7748 §5)
+}
+
+// Réduction complète modulo p puis sérialisation little-endian
+static void FeToBytes(uint8_t s[32], const Fe h) {
+    uint64_t t[5] = { h[0], h[1], h[2], h[3], h[4] };
+    
+#define FE_CARRY()                                      \
+    t[1] += t[0] >> 51; t[0] &= FE_MASK;                \
+    t[2] += t[1] >> 51; t[1] &= FE_MASK;                \
+    t[3] += t[2] >> 51; t[2] &= FE_MASK;                \
+    t[4] += t[3] >> 51; t[3] &= FE_MASK;
+#define FE_CARRY_WRAP() FE_CARRY() t[0] += 19 * (t[4] >> 51); t[4] &= FE_MASK;
+    
+    FE_CARRY_WRAP()
+    FE_CARRY_WRAP()
+    
+    // t < 2^255 ; on ajoute 19 pour savoir si t >= p, puis on retire 2^255 + 19 via le bit 255
+    t[0] += 19;
+    FE_CARRY_WRAP()
+    t[0] += (1ULL << 51) - 19;
+    t[1] += (1ULL << 51) - 1;
+    t[2] += (1ULL << 51) - 1;
+    t[3] += (1ULL << 51) - 1;
+    t[4] += (1ULL << 51) - 1;
+    FE_CARRY()
+    t[4] &= FE_MASK;
+    
+#undef FE_CARRY_WRAP
+#undef FE_CARRY
+    
+    Store64LE(s, t[0] | (t[1] << 51));
+    Store64LE(s + 8, (t[1] >> 13) | (t[2] << 38));
+    Store64LE(s + 16, (t[2] >> 26) | (t[3] << 25));
+    Store64LE(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+static inline void FeAdd(Fe out, const Fe a, const Fe b) {
+    for (int i = 0; i < 5; i++) out[i] = a[i] + b[i];
+}
+
+// a - b + 2p : reste positif tant que les limbs de b sont < 2^52
+static inline void FeSub(Fe out, const Fe a, const Fe b) {
+    out[0] = a[0] + 0xFFFFFFFFFFFDAULL - b[0];
+    for (int i = 1; i < 5; i++) out[i] = a[i] + 0xFFFFFFFFFFFFEULL - b[i];
+}
+
+// Propagation des retenues d'un produit sur 128 bits vers 5 limbs de 51 bits
+static inline void FeCarryWide(Fe out, FeWide t0, FeWide t1, FeWide t2, FeWide t3, FeWide t4) {
+    t1 += (uint64_t)(t0 >> 51);
+    t2 += (uint64_t)(t1 >> 51);
+    t3 += (uint64_t)(t2 >> 51);
+    t4 += (uint64_t)(t3 >> 51);
+    
+    uint64_t r0 = (uint64_t)t0 & FE_MASK;
+    out[1] = (uint64_t)t1 & FE_MASK;
+    out[2] = (uint64_t)t2 & FE_MASK;
+    out[3] = (uint64_t)t3 & FE_MASK;
+    out[4] = (uint64_t)t4 & FE_MASK;
+    
+    // Le débordement au-delà de 2^255 revient multiplié par 19
+    r0 += (uint64_t)(t4 >> 51) * 19;
+    out[1] += r0 >> 51;
+    out[0] = r0 & FE_MASK;
+}
+
+static void FeMul(Fe out, const Fe a, const Fe b) {
+    uint64_t b1 = b[1] * 19, b2 = b[2] * 19, b3 = b[3] * 19, b4 = b[4] * 19;
+    
+    FeWide t0 = (FeWide)a[0] * b[0] + (FeWide)a[1] * b4 + (FeWide)a[2] * b3 + (FeWide)a[3] * b2 + (FeWide)a[4] * b1;
+    FeWide t1 = (FeWide)a[0] * b[1] + (FeWide)a[1] * b[0] + (FeWide)a[2] * b4 + (FeWide)a[3] * b3 + (FeWide)a[4] * b2;
+    FeWide t2 = (FeWide)a[0] * b[2] + (FeWide)a[1] * b[1] + (FeWide)a[2] * b[0] + (FeWide)a[3] * b4 + (FeWide)a[4] * b3;
+    FeWide t3 = (FeWide)a[0] * b[3] + (FeWide)a[1] * b[2] + (FeWide)a[2] * b[1] + (FeWide)a[3] * b[0] + (FeWide)a[4] * b4;
+    FeWide t4 = (FeWide)a[0] * b[4] + (FeWide)a[1] * b[3] + (FeWide)a[2] * b[2] + (FeWide)a[3] * b[1] + (FeWide)a[4] * b[0];
+    
+    FeCarryWide(out, t0, t1, t2, t3, t4);
+}
+
+// Carré : les produits croisés sont doublés plutôt que calculés deux fois (15 multiplications au lieu de 25)
+static void FeSquare(Fe out, const Fe a) {
+    uint64_t a0x2 = a[0] * 2, a1x2 = a[1] * 2;
+    uint64_t a2x38 = a[2] * 38, a3x19 = a[3] * 19, a4x19 = a[4] * 19, a4x38 = a[4] * 38;
+    
+    FeWide t0 = (FeWide)a[0] * a[0] + (FeWide)a4x38 * a[1] + (FeWide)a2x38 * a[3];
+    FeWide t1 = (FeWide)a0x2 * a[1] + (FeWide)a4x38 * a[2] + (FeWide)a3x19 * a[3];
+    FeWide t2 = (FeWide)a0x2 * a[2] + (FeWide)a[1] * a[1] + (FeWide)a4x38 * a[3];
+    FeWide t3 = (FeWide)a0x2 * a[3] + (FeWide)a1x2 * a[2] + (FeWide)a4x19 * a[4];
+    FeWide t4 = (FeWide)a0x2 * a[4] + (FeWide)a1x2 * a[3] + (FeWide)a[2] * a[2];
+    
+    FeCarryWide(out, t0, t1, t2, t3, t4);
+}
+
+static void FeSquareTimes(Fe out, const Fe a, int count) {
+    FeSquare(out, a);
+    for (int i = 1; i < count; i++) FeSquare(out, out);
+}
+
+// z^(p - 2) par la chaîne d'additions classique (254 carrés, 11 multiplications)
+static void FeInvert(Fe out, const Fe z) {
+    Fe z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+    
+    FeSquare(z2, z);
+    FeSquareTimes(t, z2, 2);
+    FeMul(z9, t, z);
+    FeMul(z11, z9, z2);
+    FeSquare(t, z11);
+    FeMul(z2_5_0, t, z9);
+    FeSquareTimes(t, z2_5_0, 5);
+    FeMul(z2_10_0, t, z2_5_0);
+    FeSquareTimes(t, z2_10_0, 10);
+    FeMul(z2_20_0, t, z2_10_0);
+    FeSquareTimes(t, z2_20_0, 20);
+    FeMul(t, t, z2_20_0);
+    FeSquareTimes(t, t, 10);
+    FeMul(z2_50_0, t, z2_10_0);
+    FeSquareTimes(t, z2_50_0, 50);
+    FeMul(z2_100_0, t, z2_50_0);
+    FeSquareTimes(t, z2_100_0, 100);
+    FeMul(t, t, z2_100_0);
+    FeSquareTimes(t, t, 50);
+    FeMul(t, t, z2_50_0);
+    FeSquareTimes(t, t, 5);
+    FeMul(out, t, z11);
+}
+
+// Échange conditionnel en temps constant
+static inline void FeSwap(Fe a, Fe b, uint64_t swap) {
+    uint64_t mask = 0 - swap;
+    for (int i = 0; i < 5; i++) {
+        uint64_t x = mask & (a[i] ^ b[i]);
+        a[i] ^= x;
+        b[i] ^= x;
+    }
+}
+
+// Échelle de Montgomery sur la coordonnée u
+static void X25519Ladder(uint8_t out[32], const uint8_t scalar[32], const uint8_t point[32]) {
+    static const Fe a24 = { 121665, 0, 0, 0, 0 };
+    uint8_t e[32];
+    Fe x1, x2 = { 1 }, z2 = { 0 }, x3, z3 = { 1 };
+    Fe a, aa, b, bb, c, d, da, cb, t;
+    uint64_t swap = 0;
+    
+    memcpy(e, scalar, sizeof(e));
+    e[0] &= 248;
+    e[31] &= 127;
+    e[31] |= 64;
+    
+    FeFromBytes(x1, point);
+    memcpy(x3, x1, sizeof(Fe));
+    
+    for (int pos = 254; pos >= 0; pos--) {
+        uint64_t bit = (e[pos >> 3] >> (pos & 7)) & 1;
+        swap ^= bit;
+        FeSwap(x2, x3, swap);
+        FeSwap(z2, z3, swap);
+        swap = bit;
+        
+        FeAdd(a, x2, z2);
+        FeSquare(aa, a);
+        FeSub(b, x2, z2);
+        FeSquare(bb, b);
+        FeSub(t, aa, bb);       // E
+        FeAdd(c, x3, z3);
+        FeSub(d, x3, z3);
+        FeMul(da, d, a);
+        FeMul(cb, c, b);
+        
+        FeAdd(x3, da, cb);
+        FeSquare(x3, x3);
+        FeSub(z3, da, cb);
+        FeSquare(z3, z3);
+        FeMul(z3, z3, x1);
+        FeMul(x2, aa, bb);
+        FeMul(z2, a24, t);
+        FeAdd(z2, z2, aa);
+        FeMul(z2, t, z2);
+    }
+    
+    FeSwap(x2, x3, swap);
+    FeSwap(z2, z3, swap);
+    
+    FeInvert(z2, z2);
+    FeMul(x2, x2, z2);
+    FeToBytes(out, x2);
+    
+    CryptoWipe(e, sizeof(e));
+    CryptoWipe(x2, sizeof(Fe));
+    CryptoWipe(x3, sizeof(Fe));
+}
+
+bool X25519(uint8_t shared[X25519_KEY_SIZE], const uint8_t scalar[X25519_KEY_SIZE],
+            const uint8_t point[X25519_KEY_SIZE]) {
+    X25519Ladder(shared, scalar, point);
+    
+    // Un résultat nul trahit un point de petit ordre : le secret ne serait pas contributif
+    uint8_t zero = 0;
+    for (int i = 0; i < X25519_KEY_SIZE; i++) zero |= shared[i];
+    return zero != 0;
+}
+
+void X25519PublicKey(uint8_t publicKey[X25519_KEY_SIZE], const uint8_t privateKey[X25519_KEY_SIZE]) {
+    static const uint8_t basePoint[X25519_KEY_SIZE] = { 9 };
+    X25519Ladder(publicKey, privateKey, basePoint);
+}
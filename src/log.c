@@ -0,0 +1,264 @@
+#include "../include/log.h"
+#include "../include/clock.h"
+#include "../include/thread.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+
+#define LOG_QUEUE_CAPACITY 1024 // Puissance de deux
+#define LOG_MESSAGE_SIZE 256
+#define LOG_IDLE_SLEEP_MS 5     // Attente du thread d'écriture quand la file est vide
+
+/**
+ * @brief Message en attente d'écriture
+ */
+typedef struct {
+    uint64_t timeNs;
+    uint8_t level;
+    uint8_t module;
+    char text[LOG_MESSAGE_SIZE];
+} LogEntry;
+
+/**
+ * @brief Case de la file bornée multi-producteurs / mono-consommateur
+ * @details sequence == position : libre pour le producteur de cette position ;
+ *          sequence == position + 1 : message publié, prêt pour le consommateur.
+ */
+typedef struct {
+    _Atomic size_t sequence;
+    LogEntry entry;
+} LogSlot;
+
+static const char* levelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR", "NONE" };
+static const char* moduleNames[LOG_MODULE_COUNT] = { "app", "capture", "network", "stats" };
+
+static LogSlot slots[LOG_QUEUE_CAPACITY];
+static _Atomic size_t enqueuePos = 0;
+static size_t dequeuePos = 0;               // Propriété du thread d'écriture
+
+// Niveau minimal + 1 par module ; 0 = non configuré (INFO par défaut)
+static _Atomic uint8_t moduleLevels[LOG_MODULE_COUNT];
+static _Atomic bool writerRunning = false;
+static _Atomic uint32_t droppedCount = 0;
+static Thread writerThread;
+static FILE* logFile = NULL;
+static uint64_t startNs = 0;
+
+// Écriture finale d'un message (thread d'écriture, ou appelant en mode synchrone)
+static void OutputEntry(const LogEntry* entry) {
+    double seconds = (double)(entry->timeNs - startNs) / 1e9;
+    fprintf(stdout, "[%9.3f] [%s] [%s] %s\n", seconds,
+            levelNames[entry->level], moduleNames[entry->module], entry->text);
+    if (logFile) {
+        fprintf(logFile, "[%9.3f] [%s] [%s] %s\n", seconds,
+                levelNames[entry->level], moduleNames[entry->module], entry->text);
+    }
+}
+
+static bool Enqueue(const LogEntry* entry) {
+    size_t pos = atomic_load_explicit(&enqueuePos, memory_order_relaxed);
+    LogSlot* slot;
+    
+    for (;;) {
+        slot = &slots[pos & (LOG_QUEUE_CAPACITY - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        
+        if (diff == 0) {
+            // Case libre : on tente de réserver la position
+            if (atomic_compare_exchange_weak_explicit(&enqueuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // File pleine : le consommateur n'a pas encore libéré cette case
+            return false;
+        } else {
+            pos = atomic_load_explicit(&enqueuePos, memory_order_relaxed);
+        }
+    }
+    
+    slot->entry = *entry;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+// Vide la file ; retourne le nombre de messages écrits
+static int DrainQueue(void) {
+    int written = 0;
+    
+    for (;;) {
+        LogSlot* slot = &slots[dequeuePos & (LOG_QUEUE_CAPACITY - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence != dequeuePos + 1) break;
+        
+        OutputEntry(&slot->entry);
+        atomic_store_explicit(&slot->sequence, dequeuePos + LOG_QUEUE_CAPACITY, memory_order_release);
+        dequeuePos++;
+        written++;
+    }
+    
+    uint32_t dropped = atomic_exchange(&droppedCount, 0);
+    if (dropped > 0) {
+        LogEntry entry = { ClockNowNs(), LOG_LEVEL_WARNING, LOG_MODULE_APP, {0} };
+        snprintf(entry.text, sizeof(entry.text), "%u messages perdus (file de journalisation pleine)", dropped);
+        OutputEntry(&entry);
+        written++;
+    }
+    
+    if (written > 0) {
+        fflush(stdout);
+        if (logFile) fflush(logFile);
+    }
+    return written;
+}
+
+static int WriterMain(void* arg) {
+    (void)arg;
+    
+    while (atomic_load(&writerRunning)) {
+        if (DrainQueue() == 0) {
+            ThreadSleepMs(LOG_IDLE_SLEEP_MS);
+        }
+    }
+    
+    // Derniers messages publiés avant l'arrêt
+    DrainQueue();
+    return 0;
+}
+
+bool LogInit(const char* filePath) {
+    if (atomic_load(&writerRunning)) return true;
+    
+    if (startNs == 0) startNs = ClockNowNs();
+    
+    for (size_t i = 0; i < LOG_QUEUE_CAPACITY; i++) {
+        atomic_store_explicit(&slots[i].sequence, i, memory_order_relaxed);
+    }
+    atomic_store(&enqueuePos, 0);
+    dequeuePos = 0;
+    
+    if (filePath) {
+        logFile = fopen(filePath, "a");
+        if (!logFile) {
+            LOG_WARNING(LOG_MODULE_APP, "Impossible d'ouvrir le fichier de journal %s", filePath);
+        }
+    }
+    
+    atomic_store(&writerRunning, true);
+    if (!ThreadCreate(&writerThread, WriterMain, NULL)) {
+        atomic_store(&writerRunning, false);
+        LOG_WARNING(LOG_MODULE_APP, "Thread de journalisation indisponible, écriture synchrone");
+        return false;
+    }
+    return true;
+}
+
+void LogShutdown(void) {
+    if (atomic_exchange(&writerRunning, false)) {
+        ThreadJoin(&writerThread);
+    }
+    
+    if (logFile) {
+        fclose(logFile);
+        logFile = NULL;
+    }
+}
+
+void LogSetLevel(LogModule module, LogLevel level) {
+    if ((unsigned)module >= LOG_MODULE_COUNT || (unsigned)level > LOG_LEVEL_NONE) return;
+    atomic_store_explicit(&moduleLevels[module], (uint8_t)(level + 1), memory_order_relaxed);
+}
+
+void LogSetAllLevels(LogLevel level) {
+    for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+        LogSetLevel((LogModule)m, level);
+    }
+}
+
+static bool ParseName(const char* text, size_t length, const char** names, int count, int* result) {
+    for (int i = 0; i < count; i++) {
+        if (strlen(names[i]) != length) continue;
+        
+        bool match = true;
+        for (size_t c = 0; c < length && match; c++) {
+            match = tolower((unsigned char)text[c]) == tolower((unsigned char)names[i][c]);
+        }
+        if (match) {
+            *result = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogConfigure(const char* spec) {
+    if (!spec) return false;
+    
+    int level;
+    const char* separator = strchr(spec, '=');
+    if (!separator) {
+        if (!ParseName(spec, strlen(spec), levelNames, LOG_LEVEL_NONE + 1, &level)) return false;
+        LogSetAllLevels((LogLevel)level);
+        return true;
+    }
+    
+    int module;
+    if (!ParseName(spec, (size_t)(separator - spec), moduleNames, LOG_MODULE_COUNT, &module)) return false;
+    if (!ParseName(separator + 1, strlen(separator + 1), levelNames, LOG_LEVEL_NONE + 1, &level)) return false;
+    LogSetLevel((LogModule)module, (LogLevel)level);
+    return true;
+}
+
+bool LogIsEnabled(LogModule module, LogLevel level) {
+    if ((unsigned)module >= LOG_MODULE_COUNT) return false;
+    uint8_t stored = atomic_load_explicit(&moduleLevels[module], memory_order_relaxed);
+    LogLevel threshold = stored ? (LogLevel)(stored - 1) : LOG_LEVEL_INFO;
+    return level >= threshold && level < LOG_LEVEL_NONE;
+}
+
+void LogWrite(LogLevel level, LogModule module, LogRateLimit* site, const char* format, ...) {
+    uint64_t now = ClockNowNs();
+    uint32_t suppressed = 0;
+    
+    // Limitation de débit : une nouvelle fenêtre remet le quota à zéro
+    if (site) {
+        uint64_t windowStart = atomic_load_explicit(&site->windowStartNs, memory_order_relaxed);
+        if (now - windowStart >= LOG_RATE_LIMIT_WINDOW_NS &&
+            atomic_compare_exchange_strong(&site->windowStartNs, &windowStart, now)) {
+            atomic_store(&site->count, 0);
+        }
+        
+        if (atomic_fetch_add(&site->count, 1) >= LOG_RATE_LIMIT_BURST) {
+            atomic_fetch_add_explicit(&site->suppressed, 1, memory_order_relaxed);
+            return;
+        }
+        suppressed = atomic_exchange(&site->suppressed, 0);
+    }
+    
+    LogEntry entry;
+    entry.timeNs = now;
+    entry.level = (uint8_t)level;
+    entry.module = (uint8_t)module;
+    
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(entry.text, sizeof(entry.text), format, args);
+    va_end(args);
+    
+    if (suppressed > 0 && length >= 0 && (size_t)length < sizeof(entry.text)) {
+        snprintf(entry.text + length, sizeof(entry.text) - (size_t)length,
+                 " (+%u messages similaires supprimés)", suppressed);
+    }
+    
+    if (!atomic_load(&writerRunning)) {
+        if (startNs == 0) startNs = now;
+        OutputEntry(&entry);
+        return;
+    }
+    
+    if (!Enqueue(&entry)) {
+        atomic_fetch_add_explicit(&droppedCount, 1, memory_order_relaxed);
+    }
+}
@@ -23,6 +23,14 @@
 #include "../include/capture.h"
 #include "../include/network.h"
 #include "../include/ui.h"
+#include "../include/clock.h"
+#include "../include/stats.h"
+#include "../include/trace.h"
+#include "../include/log.h"
+#include "../include/codec.h"
+#include "../include/crypto.h"
+#include "../include/workers.h"
+#include "../include/scheduler.h"
 
 // Constantes
 #define WINDOW_WIDTH \
@@ -40,6 +48,11 @@
 #define APP_NAME "C_Screenshare - Peer-to-Peer Screen Sharing"
 #define MAX_IP_LENGTH 64
 #define DEFAULT_PORT 7890
+#define CONNECTION_TIMEOUT_NS 10000000000ULL // 10 secondes sans activité réseau
+#define CURSOR_REFRESH_NS 200000000ULL // Position du curseur renvoyée au moins toutes les 200 ms (flux sans garantie)
+#define VIEW_ZOOM_STEP 1.25f // Agrandissement par cran de molette en mode visualisation
+#define VIEW_ZOOM_MAX 16.0f // Agrandissement maximal de l'image reçue
+#define OVERVIEW_DIVISOR 4 // Pendant un zoom, la zone entière n'est envoyée qu'au quart de l'affichage
 
 // États de l'application
 typedef enum {
@@ -72,6 +85,17 @@ typedef struct {
     Rectangle captureRegion;    // Région de capture (utilisée en mode partage)
     CaptureData currentCapture; // Dernière capture effectuée
     bool hasCaptureData;        // Indique si des données de capture sont disponibles
+    CaptureScheduler captureScheduler; // Cadence des captures selon l'activité de l'écran (mode partage)
+    void* viewerDecoders[CAPTURE_LAYER_COUNT][CODEC_ID_COUNT]; // Décodeur de chaque couche et codec reçus, créé à sa première image (mode visualisation)
+    CaptureData detailCapture;  // Région zoomée reçue, dessinée par-dessus la zone entière (mode visualisation)
+    bool hasDetailData;         // Indique si une région zoomée est disponible
+    float viewZoom;             // Agrandissement de l'image reçue (1 : ajustée à la fenêtre)
+    Vector2 viewCenter;         // Centre de la vue, en fraction de la zone capturée
+    CursorState sentCursor;     // Dernière position du curseur envoyée (mode partage)
+    uint64_t lastCursorSendNs;  // Envoi de cette position
+    CursorState viewerCursor;   // Curseur de l'émetteur, dessiné par-dessus l'image (mode visualisation)
+    Texture2D cursorTexture;    // Texture de la forme du curseur reçu
+    uint32_t cursorTextureShapeId; // Forme chargée dans cursorTexture (0 si aucune)
     UIPage currentPage;         // Page UI actuelle
     
     // Informations réseau
@@ -84,9 +108,27 @@ typedef struct {
     int remotePeerPort;          // Port du pair distant pour la connexion
     int connectedPeerID;         // ID du pair connecté (-1 si aucun)
     bool isConnecting;           // Indique si une connexion est en cours
-    int lastNetworkActivity;     // Horodatage de la dernière activité réseau
+    uint64_t lastNetworkActivity; // Horodatage monotone de la dernière activité réseau (ns)
     char connectionStatus[256];  // Message de statut de connexion
     char connectionPassword[64]; // Mot de passe pour le chiffrement
+    
+    // Latence de bout en bout en mode visualisation
+    bool pendingPresent;         // Une image reçue attend son premier affichage
+    bool hasLatency;             // Indique si la latence mesurée est valide
+    double captureToPresentMs;   // Latence capture -> affichage de la dernière image
+    double networkMs;            // Part réseau (envoi -> réception)
+    double decodeMs;             // Part décompression (réception -> fin du décodage)
+    
+    // Instrumentation
+    bool showStatsOverlay;       // Affiche le panneau des statistiques par étape (F3)
+    bool showRoiOverlay;         // Affiche la carte des zones d'intérêt par-dessus la capture (F6)
+    int statsExportCount;        // Nombre d'exports CSV effectués (F4)
+    int traceExportCount;        // Nombre d'exports de trace effectués (F5)
+    const char* traceOutputPath; // Trace écrite à la fermeture (option --trace), NULL sinon
+    
+    // Envoi des zones modifiées à la texture (mode visualisation)
+    uint8_t* uploadBuffer;       // Zone moins large que l'image, recopiée en lignes contiguës
+    size_t uploadCapacity;       // Taille allouée de uploadBuffer
 } AppContext;
 
 // Prototypes de fonctions
@@ -99,15 +141,77 @@ void ToggleSharing(AppContext* ctx);
 void ToggleMinimized(AppContext* ctx);
 bool GetLocalIPAddress(char* ipBuffer, int bufferSize);
 void RenderTopBar(AppContext* ctx); // Nouvelle fonction pour afficher la barre supérieure
+void DisplayReceivedCapture(AppContext* ctx, CaptureData* received);
+void UploadDirtyRects(AppContext* ctx, Texture2D texture, const Image* image, const DirtyRect* rects, int count);
+void RenderStatsOverlay(AppContext* ctx);
+void RenderRoiOverlay(AppContext* ctx, int posX, int posY, int displayWidth, int displayHeight);
+void UpdateSharedCursor(AppContext* ctx, uint64_t now);
+void RenderViewerCursor(AppContext* ctx, int posX, int posY, float scale);
+bool GetViewLayout(AppContext* ctx, float* scale, int* posX, int* posY);
+void HandleViewZoom(AppContext* ctx);
+void UpdateViewerViewport(AppContext* ctx);
+void SendViewportDetail(AppContext* ctx, const ViewerViewport* viewport);
 
 // Nouvelles fonctions pour la gestion des connexions réseau
 void ConnectToPeerByIP(AppContext* ctx);
 void DisconnectFromCurrentPeer(AppContext* ctx);
 void ToggleEncryption(AppContext* ctx);
 
-int main(void) {
+int main(int argc, char** argv) {
     // Initialisation du contexte de l'application
     AppContext appContext = {0};
+    
+    const char* logFilePath = NULL;
+    int benchmarkFrames = 0;
+    int selfTestIterations = 0;
+    
+    // Options de ligne de commande
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            appContext.traceOutputPath = argv[++i];
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            if (!LogConfigure(argv[++i])) {
+                LOG_WARNING(LOG_MODULE_APP, "Niveau de journal invalide: %s", argv[i]);
+            }
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            if (!LogConfigure(argv[++i])) {
+                LOG_WARNING(LOG_MODULE_APP, "Règle de journal invalide (module=niveau): %s", argv[i]);
+            }
+        } else if (strcmp(argv[i], "--log-file") == 0 && i + 1 < argc) {
+            logFilePath = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            benchmarkFrames = i + 1 < argc && argv[i + 1][0] != '-' ? atoi(argv[++i]) : 30;
+        } else if (strcmp(argv[i], "--selftest") == 0) {
+            selfTestIterations = i + 1 < argc && argv[i + 1][0] != '-' ? atoi(argv[++i]) : 100000;
+        } else {
+            LOG_WARNING(LOG_MODULE_APP, "Option inconnue ignorée: %s", argv[i]);
+            LOG_INFO(LOG_MODULE_APP, "Usage: %s [--trace fichier.json] [--log-level niveau] "
+                                     "[--log module=niveau] [--log-file fichier] [--bench [images]] "
+                                     "[--selftest [itérations]]", argv[0]);
+        }
+    }
+    
+    // Journalisation asynchrone : les threads de capture et réseau ne bloquent plus sur la console
+    LogInit(logFilePath);
+    
+    // Banc d'essai des codecs : pas de fenêtre, le résultat est dans le journal
+    if (benchmarkFrames > 0) {
+        StatsInit();
+        bool benchmarkPassed = RunCaptureBenchmark(benchmarkFrames);
+        benchmarkPassed = RunCryptoBenchmark(benchmarkFrames) && benchmarkPassed;
+        LogShutdown();
+        return benchmarkPassed ? 0 : 1;
+    }
+    
+    // Auto-test du format réseau, sans fenêtre ni connexion
+    if (selfTestIterations > 0) {
+        StatsInit();
+        bool selfTestPassed = RunNetworkSelfTest(selfTestIterations);
+        selfTestPassed = AeadSelfTest() && selfTestPassed;
+        LogShutdown();
+        return selfTestPassed ? 0 : 1;
+    }
+    
     appContext.running = true;
     appContext.state = APP_STATE_IDLE;
     appContext.captureInterval = (int) (1000 / TARGET_FPS); // 10 FPS par défaut
@@ -129,6 +233,7 @@ int main(void) {
     
     // Nettoyage
     CloseApplication(&appContext);
+    LogShutdown();
     
     return 0;
 }
@@ -141,6 +246,15 @@ void InitApplication(AppContext* ctx) {
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, APP_NAME);
     SetTargetFPS(60);
     
+    // Initialisation de l'instrumentation avant tout thread producteur
+    StatsInit();
+    StatsSetThreadName("main");
+    TraceInit(0);
+    
+    // Threads du décodage parallèle des tuiles et des tranches vidéo (un par processeur)
+    int decodeThreads = WorkerPoolInit(-1);
+    LOG_INFO(LOG_MODULE_APP, "Décodage parallèle sur %d threads", decodeThreads + 1);
+    
     // Configuration du système de capture avec les nouvelles options
     CaptureConfig captureConfig = {0};
     captureConfig.method = CAPTURE_METHOD_AUTO; // Sélection automatique de la meilleure méthode
@@ -150,10 +264,22 @@ void InitApplication(AppContext* ctx) {
     captureConfig.changeThreshold = 5;  // 5% de tolérance pour les changements
     captureConfig.autoAdjustQuality = true;
     captureConfig.targetMonitor = -1;   // Capturer tous les moniteurs par défaut
+    captureConfig.detectScroll = true;  // Défilements envoyés comme copies de rectangles
+    captureConfig.useTileCache = true;  // Tuiles déjà vues référencées dans le cache des visualiseurs
+    captureConfig.tileCodecs = true;    // Texte et interface sans perte, photos en JPEG
+    captureConfig.lossless = false;     // true : aucune perte (CAO, code), au prix de la bande passante
+    captureConfig.yuvOutput = false;    // true : image NV12 en plus du RGBA, pour un codec vidéo
+    captureConfig.codec = CODEC_ID_TILES; // CODEC_ID_VIDEO : images P (vidéos, jeux), si le visualiseur le décode
+    captureConfig.videoGop = 120;       // Image I au moins toutes les 120 images en mode vidéo
+    captureConfig.videoSlices = 4;      // Tranches décodables indépendamment en mode vidéo
+    captureConfig.scaleToViewer = true; // Pas plus de pixels que la fenêtre du visualiseur n'en affiche
+    captureConfig.maxBitrateKbps = 0;   // Ex. 8000 : résolution réduite au-delà de 8 Mbit/s
+    captureConfig.roiQuality = true;    // Meilleure qualité autour du curseur et de la fenêtre active
+    captureConfig.refineTiles = true;   // Tuiles figées parties en JPEG renvoyées sans perte quand le débit le permet
     
     // Initialisation du système de capture avec la configuration
     if (!InitCaptureSystem(&captureConfig)) {
-        printf("[ERROR] Échec de l'initialisation du système de capture\n");
+        LOG_ERROR(LOG_MODULE_APP, "Échec de l'initialisation du système de capture");
         ctx->running = false;
         return;
     }
@@ -166,36 +292,38 @@ void InitApplication(AppContext* ctx) {
         GetMonitorHeight(0)
     };
     
-    printf("[INFO] Région de capture initialisée: %.0fx%.0f\n", 
-           ctx->captureRegion.width, ctx->captureRegion.height);
+    LOG_INFO(LOG_MODULE_APP, "Région de capture initialisée: %.0fx%.0f", 
+                             ctx->captureRegion.width, ctx->captureRegion.height);
     
     // Initialisation des informations réseau
     ctx->localPort = DEFAULT_PORT;
     if (!GetLocalIPAddress(ctx->localIP, MAX_IP_LENGTH)) {
-        printf("[WARNING] Impossible d'obtenir l'adresse IP locale, utilisation de 127.0.0.1\n");
+        LOG_WARNING(LOG_MODULE_APP, "Impossible d'obtenir l'adresse IP locale, utilisation de 127.0.0.1");
         strncpy(ctx->localIP, "127.0.0.1", MAX_IP_LENGTH);
     }
     
-    printf("[INFO] Adresse IP locale: %s:%d\n", ctx->localIP, ctx->localPort);
+    LOG_INFO(LOG_MODULE_APP, "Adresse IP locale: %s:%d", ctx->localIP, ctx->localPort);
     
     // Initialisation du système réseau P2P
     if (InitNetworkSystem(ctx->localPort)) {
         ctx->networkInitialized = true;
         strcpy(ctx->connectionStatus, "Réseau initialisé, en attente de connexion");
-        printf("[INFO] Système réseau initialisé sur le port %d\n", ctx->localPort);
+        LOG_INFO(LOG_MODULE_APP, "Système réseau initialisé sur le port %d", ctx->localPort);
     } else {
         ctx->networkInitialized = false;
         strcpy(ctx->connectionStatus, "Échec de l'initialisation réseau");
-        printf("[ERROR] Échec de l'initialisation du système réseau\n");
+        LOG_ERROR(LOG_MODULE_APP, "Échec de l'initialisation du système réseau");
     }
     
     // Initialisation des autres variables réseau
     ctx->connectedPeerID = -1;
     ctx->isConnecting = false;
     ctx->remotePeerPort = DEFAULT_PORT;
-    ctx->lastNetworkActivity = GetTime();
+    ctx->viewZoom = 1.0f;
+    ctx->viewCenter = (Vector2){ 0.5f, 0.5f };
+    ctx->lastNetworkActivity = ClockNowNs();
     
-    printf("[INFO] Application initialisée avec succès\n");
+    LOG_INFO(LOG_MODULE_APP, "Application initialisée avec succès");
 }
 
 void CloseApplication(AppContext* ctx) {
@@ -206,13 +334,31 @@ void CloseApplication(AppContext* ctx) {
         UnloadCaptureData(&ctx->currentCapture);
         ctx->hasCaptureData = false;
     }
+    if (ctx->hasDetailData) {
+        UnloadCaptureData(&ctx->detailCapture);
+        ctx->hasDetailData = false;
+    }
+    for (int layer = 0; layer < CAPTURE_LAYER_COUNT; layer++) {
+        for (int i = 0; i < CODEC_ID_COUNT; i++) {
+            if (ctx->viewerDecoders[layer][i]) CodecGet((uint32_t)i)->destroyDecoder(ctx->viewerDecoders[layer][i]);
+            ctx->viewerDecoders[layer][i] = NULL;
+        }
+    }
+    if (ctx->cursorTexture.id > 0) {
+        UnloadTexture(ctx->cursorTexture);
+        ctx->cursorTexture.id = 0;
+    }
+    free(ctx->uploadBuffer);
+    ctx->uploadBuffer = NULL;
+    ctx->uploadCapacity = 0;
+    WorkerPoolShutdown();
     
     // Fermeture du système de capture
     CloseCaptureSystem();
     
     // Fermeture du système réseau
     if (ctx->networkInitialized) {
-        printf("[INFO] Fermeture du système réseau\n");
+        LOG_INFO(LOG_MODULE_APP, "Fermeture du système réseau");
         CloseNetworkSystem();
         ctx->networkInitialized = false;
     }
@@ -220,34 +366,78 @@ void CloseApplication(AppContext* ctx) {
     // Fermeture de la fenêtre raylib
     CloseWindow();
     
-    printf("[INFO] Application fermée\n");
+    // Trace demandée en ligne de commande : dernier drainage puis export
+    if (ctx->traceOutputPath) {
+        StatsCollect();
+        TraceExportChromeJson(ctx->traceOutputPath);
+    }
+    TraceShutdown();
+    StatsShutdown();
+    
+    LOG_INFO(LOG_MODULE_APP, "Application fermée");
 }
 
 void UpdateApplication(AppContext* ctx) {
     if (!ctx || !ctx->running) return;
     
+    // Récupération des mesures publiées par les différents threads
+    StatsCollect();
+    
     // Traitement des événements réseau
     if (ctx->networkInitialized) {
         int processedPackets = ProcessNetworkEvents();
         if (processedPackets > 0) {
-            ctx->lastNetworkActivity = GetTime();
+            ctx->lastNetworkActivity = ClockNowNs();
+        }
+        
+        // Affichage de la dernière image reçue d'un pair, zone entière puis région zoomée
+        CaptureData received = {0};
+        while (ctx->state != APP_STATE_SHARING && ReceiveCaptureData(&received)) {
+            DisplayReceivedCapture(ctx, &received);
+        }
+        
+        // Curseur de l'émetteur, reçu indépendamment des images
+        if (ctx->state != APP_STATE_SHARING) {
+            ReceiveCursorState(&ctx->viewerCursor);
+        }
+        
+        // Taille de la fenêtre et région zoomée, pour que l'émetteur n'envoie pas plus de pixels qu'elles n'en affichent
+        if (ctx->state != APP_STATE_SHARING) {
+            UpdateViewerViewport(ctx);
         }
     }
     
-    // En mode partage, faire une capture à intervalle régulier
-    static double lastCaptureTime = 0;
-    double currentTime = GetTime();
+    // En mode partage, capture à la cadence du planificateur : pleine cadence pendant l'activité,
+    // une image par seconde sur un écran figé
+    uint64_t currentTime = ClockNowNs();
+    
+    // Curseur envoyé à chaque image de la boucle, sans attendre la prochaine capture
+    if (ctx->state == APP_STATE_SHARING && ctx->networkInitialized && ctx->connectedPeerID >= 0) {
+        UpdateSharedCursor(ctx, currentTime);
+    }
+    
+    // Une saisie de l'utilisateur annonce un changement : retour immédiat à la pleine cadence
+    uint64_t inputTime = 0;
+    if (ctx->state == APP_STATE_SHARING && GetLastInputTime(&inputTime)) {
+        SchedulerInputActivity(&ctx->captureScheduler, inputTime);
+    }
     
-    if (ctx->state == APP_STATE_SHARING && 
-        (currentTime - lastCaptureTime) * 1000 >= ctx->captureInterval) {
+    if (ctx->state == APP_STATE_SHARING && SchedulerCaptureDue(&ctx->captureScheduler, currentTime)) {
         
         // Récupération de la configuration actuelle
         CaptureConfig config = GetCaptureConfig();
         
         // Libération de la capture précédente si elle existe
+        unsigned char* previousFrame = NULL;
+        int previousWidth = 0;
+        int previousHeight = 0;
         if (ctx->hasCaptureData) {
-            // Conserver les données précédentes pour la détection de changements
-            // UnloadCaptureData libère automatiquement ces ressources
+            // Conserver l'image précédente pour la détection de changements ;
+            // UnloadCaptureData libère les autres ressources
+            previousFrame = ctx->currentCapture.previousFrame;
+            previousWidth = ctx->currentCapture.width;
+            previousHeight = ctx->currentCapture.height;
+            ctx->currentCapture.previousFrame = NULL;
             UnloadCaptureData(&ctx->currentCapture);
             ctx->hasCaptureData = false;
         }
@@ -268,7 +458,41 @@ void UpdateApplication(AppContext* ctx) {
         if (ctx->currentCapture.image.data != NULL) {
             ctx->hasCaptureData = true;
             
-            // Détection des changements si activée
+            // Codec configuré s'il est décodé par le pair ; seules les tuiles modifiées depuis la dernière
+            // image acquittée par le pair seront compressées
+            ctx->currentCapture.codec = config.codec;
+            if (ctx->networkInitialized && ctx->connectedPeerID >= 0) {
+                CodecId codec = CodecSelect(config.codec, GetPeerCodecSupport(ctx->connectedPeerID));
+                ctx->currentCapture.codec = codec;
+                uint32_t canvasId = GetCaptureCanvasId(CAPTURE_LAYER_FULL, codec);
+                ctx->currentCapture.baseFrameId = GetAcknowledgedFrame(ctx->connectedPeerID, canvasId);
+                ctx->currentCapture.appliedFrames = GetAppliedFrames(ctx->connectedPeerID, canvasId,
+                                                                     ctx->currentCapture.baseFrameId);
+            }
+            
+            // Résolution ramenée à la fenêtre du visualiseur et au débit visé, avant toute comparaison
+            ViewerViewport viewport = {0};
+            if (ctx->networkInitialized && ctx->connectedPeerID >= 0) {
+                GetPeerViewport(ctx->connectedPeerID, &viewport);
+            }
+            int viewerWidth = viewport.width;
+            int viewerHeight = viewport.height;
+            
+            // Région zoomée par le visualiseur : envoyée à part à la résolution affichée, la zone entière
+            // seulement en aperçu pour les bords découverts pendant un déplacement
+            if (viewport.regionWidth > 0 && viewport.regionHeight > 0 &&
+                (viewport.regionWidth < ctx->currentCapture.width || viewport.regionHeight < ctx->currentCapture.height)) {
+                SendViewportDetail(ctx, &viewport);
+                viewerWidth /= OVERVIEW_DIVISOR;
+                viewerHeight /= OVERVIEW_DIVISOR;
+            }
+            ScaleCaptureData(&ctx->currentCapture, viewerWidth, viewerHeight);
+            
+            // Détection des changements si activée, contre la capture précédente de mêmes dimensions
+            if (previousWidth == ctx->currentCapture.width && previousHeight == ctx->currentCapture.height) {
+                ctx->currentCapture.previousFrame = previousFrame;
+                previousFrame = NULL;
+            }
             if (config.detectChanges) {
                 DetectChanges(&ctx->currentCapture, config.changeThreshold);
                 
@@ -289,34 +513,33 @@ void UpdateApplication(AppContext* ctx) {
             
             // Envoi des données de capture via le réseau si connecté à un pair
             if (ctx->networkInitialized && ctx->connectedPeerID >= 0) {
-                // Chiffrer les données si le chiffrement est activé
-                if (ctx->encryptionEnabled) {
-                    EncryptCaptureData(&ctx->currentCapture);
-                }
-                
                 // Envoyer les données au pair connecté
                 if (SendCaptureData(ctx->connectedPeerID, &ctx->currentCapture)) {
                     strcpy(ctx->connectionStatus, "Capture envoyée avec succès");
                 } else {
                     strcpy(ctx->connectionStatus, "Échec de l'envoi de la capture");
-                    printf("[ERROR] Échec de l'envoi des données de capture au pair %d\n", 
-                           ctx->connectedPeerID);
+                    LOG_ERROR(LOG_MODULE_APP, "Échec de l'envoi des données de capture au pair %d", 
+                                              ctx->connectedPeerID);
                 }
             }
         } else {
-            printf("[ERROR] Échec de la capture d'écran\n");
+            LOG_ERROR(LOG_MODULE_APP, "Échec de la capture d'écran");
         }
+        free(previousFrame);
         
-        lastCaptureTime = currentTime;
+        // Échéance suivante : le moindre pixel modifié maintient la pleine cadence, un écran figé la
+        // fait descendre. Sans détection de changements, toute capture compte comme modifiée
+        bool changed = !ctx->hasCaptureData || !config.detectChanges || ctx->currentCapture.changedPixels > 0;
+        SchedulerFrameCaptured(&ctx->captureScheduler, currentTime, changed);
     }
     
     // Vérifier l'état de la connexion (timeout, etc.)
     if (ctx->networkInitialized && ctx->connectedPeerID >= 0) {
-        double timeSinceLastActivity = currentTime - ctx->lastNetworkActivity;
+        uint64_t timeSinceLastActivity = currentTime - ctx->lastNetworkActivity;
         
         // Si aucune activité pendant 10 secondes, on considère la connexion comme perdue
-        if (timeSinceLastActivity > 10.0) {
-            printf("[WARNING] Timeout de connexion avec le pair %d\n", ctx->connectedPeerID);
+        if (timeSinceLastActivity > CONNECTION_TIMEOUT_NS) {
+            LOG_WARNING(LOG_MODULE_APP, "Timeout de connexion avec le pair %d", ctx->connectedPeerID);
             DisconnectFromPeer(ctx->connectedPeerID);
             ctx->connectedPeerID = -1;
             strcpy(ctx->connectionStatus, "Connexion perdue (timeout)");
@@ -327,6 +550,7 @@ void UpdateApplication(AppContext* ctx) {
 void RenderApplication(AppContext* ctx) {
     if (!ctx || !ctx->running) return;
     
+    uint64_t presentStart = StatsBegin();
     BeginDrawing();
     ClearBackground(RAYWHITE);
     
@@ -338,21 +562,44 @@ void RenderApplication(AppContext* ctx) {
     
     // Affichage de la capture si disponible
     if (ctx->hasCaptureData) {
-        // Calculer les dimensions pour afficher l'image à l'échelle dans la fenêtre
-        float scale = fmin((float)GetScreenWidth() / ctx->currentCapture.width, 
-                           (float)GetScreenHeight() / ctx->currentCapture.height);
+        // Calculer les dimensions pour afficher l'image à l'échelle dans la fenêtre, d'après la zone
+        // capturée : une image réduite par l'émetteur est agrandie par le GPU
+        int sourceWidth = ctx->currentCapture.sourceWidth > 0 ? ctx->currentCapture.sourceWidth : ctx->currentCapture.width;
+        int sourceHeight = ctx->currentCapture.sourceHeight > 0 ? ctx->currentCapture.sourceHeight : ctx->currentCapture.height;
+        float scale;
+        int posX;
+        int posY;
+        GetViewLayout(ctx, &scale, &posX, &posY);
         
-        int displayWidth = (int)(ctx->currentCapture.width * scale);
-        int displayHeight = (int)(ctx->currentCapture.height * scale);
-        int posX = (GetScreenWidth() - displayWidth) / 2;
-        int posY = (GetScreenHeight() - displayHeight) / 2;
+        int displayWidth = (int)(sourceWidth * scale);
+        int displayHeight = (int)(sourceHeight * scale);
         
         // Afficher la texture
         DrawTexturePro(ctx->currentCapture.texture, 
-                     (Rectangle){0, 0, (float)ctx->currentCapture.width, (float)ctx->currentCapture.height},
+                     (Rectangle){0, 0, (float)ctx->currentCapture.texture.width, (float)ctx->currentCapture.texture.height},
                      (Rectangle){(float)posX, (float)posY, (float)displayWidth, (float)displayHeight},
                      (Vector2){0, 0}, 0.0f, WHITE);
         
+        // Région zoomée, reçue à la résolution affichée, par-dessus l'aperçu de la zone entière
+        if (ctx->hasDetailData && ctx->viewZoom > 1.0f) {
+            const CaptureData* detail = &ctx->detailCapture;
+            DrawTexturePro(detail->texture,
+                         (Rectangle){0, 0, (float)detail->texture.width, (float)detail->texture.height},
+                         (Rectangle){posX + detail->sourceX * scale, posY + detail->sourceY * scale,
+                                     detail->sourceWidth * scale, detail->sourceHeight * scale},
+                         (Vector2){0, 0}, 0.0f, WHITE);
+        }
+        
+        // Zones d'intérêt de la dernière image envoyée
+        if (ctx->showRoiOverlay && ctx->state == APP_STATE_SHARING) {
+            RenderRoiOverlay(ctx, posX, posY, displayWidth, displayHeight);
+        }
+        
+        // Curseur de l'émetteur dessiné localement : ses mouvements ne modifient pas l'image
+        if (ctx->state == APP_STATE_VIEWING) {
+            RenderViewerCursor(ctx, posX, posY, scale);
+        }
+        
         // Afficher des informations sur la capture
         int y = 40; // Position Y initiale
         
@@ -365,13 +612,39 @@ void RenderApplication(AppContext* ctx) {
             sourceText = "Région personnalisée";
         }
         
-        DrawText(TextFormat("Capture: %dx%d (%s)", 
-                           ctx->currentCapture.width, 
-                           ctx->currentCapture.height,
-                           sourceText), 
-                 10, y, 20, DARKGRAY);
+        if (ctx->currentCapture.width != sourceWidth || ctx->currentCapture.height != sourceHeight) {
+            DrawText(TextFormat("Capture: %dx%d envoyée en %dx%d (%s)", 
+                               sourceWidth, 
+                               sourceHeight,
+                               ctx->currentCapture.width, 
+                               ctx->currentCapture.height,
+                               sourceText), 
+                     10, y, 20, DARKGRAY);
+        } else {
+            DrawText(TextFormat("Capture: %dx%d (%s)", 
+                               ctx->currentCapture.width, 
+                               ctx->currentCapture.height,
+                               sourceText), 
+                     10, y, 20, DARKGRAY);
+        }
         y += 30;
         
+        // Zoom du visualiseur
+        if (ctx->state == APP_STATE_VIEWING && ctx->viewZoom > 1.0f) {
+            if (ctx->hasDetailData) {
+                DrawText(TextFormat("Zoom: x%.1f, région %dx%d envoyée en %dx%d", 
+                                   ctx->viewZoom,
+                                   ctx->detailCapture.sourceWidth,
+                                   ctx->detailCapture.sourceHeight,
+                                   ctx->detailCapture.width,
+                                   ctx->detailCapture.height), 
+                         10, y, 20, DARKGRAY);
+            } else {
+                DrawText(TextFormat("Zoom: x%.1f", ctx->viewZoom), 10, y, 20, DARKGRAY);
+            }
+            y += 30;
+        }
+        
         // Méthode de capture utilisée
         const char* methodText = "raylib";
         if (config.method == CAPTURE_METHOD_WIN_GDI) {
@@ -385,10 +658,19 @@ void RenderApplication(AppContext* ctx) {
             float ratio = (float)(ctx->currentCapture.width * ctx->currentCapture.height * 4) / 
                          ctx->currentCapture.compressedSize;
             
-            DrawText(TextFormat("Compression: %d Ko (Ratio: %.2f:1)", 
-                              ctx->currentCapture.compressedSize / 1024,
-                              ratio), 
-                    10, y, 20, DARKGRAY);
+            if (ctx->currentCapture.codec == CODEC_ID_VIDEO) {
+                DrawText(TextFormat("Compression: %d Ko, image %s (Ratio: %.2f:1)", 
+                                  ctx->currentCapture.compressedSize / 1024,
+                                  ctx->currentCapture.baseFrameId != 0 ? "P" : "I",
+                                  ratio), 
+                        10, y, 20, DARKGRAY);
+            } else {
+                DrawText(TextFormat("Compression: %d Ko, %d tuiles (Ratio: %.2f:1)", 
+                                  ctx->currentCapture.compressedSize / 1024,
+                                  ctx->currentCapture.tileCount,
+                                  ratio), 
+                        10, y, 20, DARKGRAY);
+            }
             y += 30;
         }
         
@@ -407,8 +689,9 @@ void RenderApplication(AppContext* ctx) {
         y += 30;
         
         // Informations d'intervalle et qualité
-        DrawText(TextFormat("Intervalle: %d ms, Qualité: %d%%", 
-                          ctx->captureInterval, ctx->captureQuality), 
+        DrawText(TextFormat("Intervalle: %d ms (actuel %d ms), Qualité: %d%%", 
+                          ctx->captureInterval, (int)(ctx->captureScheduler.intervalNs / 1000000ULL),
+                          ctx->captureQuality), 
                 10, y, 20, DARKGRAY);
         y += 30;
         
@@ -426,12 +709,21 @@ void RenderApplication(AppContext* ctx) {
             }
             
             if (ctx->encryptionEnabled) {
-                DrawText("Chiffrement: Activé", 10, y, 20, GREEN);
+                DrawText(TextFormat("Chiffrement: Activé (%s)", GetPeerCipherName(ctx->connectedPeerID)), 
+                         10, y, 20, GREEN);
             } else {
                 DrawText("Chiffrement: Désactivé", 10, y, 20, GRAY);
             }
             y += 30;
         }
+        
+        // Latence de bout en bout de la dernière image reçue
+        if (ctx->state == APP_STATE_VIEWING && ctx->hasLatency) {
+            DrawText(TextFormat("Latence: %.1f ms (réseau %.1f ms, décodage %.1f ms)", 
+                              ctx->captureToPresentMs, ctx->networkMs, ctx->decodeMs), 
+                    10, y, 20, DARKGRAY);
+            y += 30;
+        }
 
         // Current fps on white rectangle
         DrawRectangle(0, y+10, 90, 20, WHITE);
@@ -439,7 +731,7 @@ void RenderApplication(AppContext* ctx) {
     }
     
     // Affichage de l'état et des contrôles
-    int bottomY = GetScreenHeight() - 120;
+    int bottomY = GetScreenHeight() - 180;
     
     // Affichage de l'état de l'application
     DrawText(ctx->state == APP_STATE_SHARING ? "État: Partage en cours" : "État: En attente", 
@@ -463,8 +755,37 @@ void RenderApplication(AppContext* ctx) {
     
     DrawText("E: Activer/Désactiver chiffrement | ESC: Quitter | F11: Plein écran", 
              10, bottomY, 20, DARKGRAY);
+    bottomY += 30;
+    
+    DrawText("F3: Statistiques | F4: Exporter (CSV) | F5: Exporter la trace (JSON) | F7: Latence/Fluidité", 
+             10, bottomY, 20, DARKGRAY);
+    bottomY += 30;
+    
+    DrawText("Molette: Zoom | Clic droit: Déplacer la vue | Z: Vue entière | F6: Zones d'intérêt", 
+             10, bottomY, 20, DARKGRAY);
+    
+    if (ctx->showStatsOverlay) {
+        RenderStatsOverlay(ctx);
+    }
     
+    // EndDrawing inclut l'attente du FPS cible : elle est exclue de la mesure
+    StatsEndFrame(STAT_STAGE_PRESENT, presentStart, ctx->hasCaptureData ? ctx->currentCapture.frameId : 0);
     EndDrawing();
+    
+    // Première présentation d'une image reçue : mesure de la latence capture -> affichage
+    if (ctx->pendingPresent) {
+        CaptureData* frame = &ctx->currentCapture;
+        frame->presentNs = ClockNowNs();
+        ctx->pendingPresent = false;
+        
+        // timestamp vaut 0 tant que l'horloge de l'émetteur n'est pas synchronisée
+        ctx->hasLatency = frame->timestamp != 0;
+        if (ctx->hasLatency) {
+            ctx->captureToPresentMs = ClockNsToMs((int64_t)(frame->presentNs - frame->timestamp));
+            ctx->networkMs = ClockNsToMs((int64_t)(frame->receiveNs - frame->sendNs));
+            ctx->decodeMs = ClockNsToMs((int64_t)(frame->decodeNs - frame->receiveNs));
+        }
+    }
 }
 
 void HandleEvents(AppContext* ctx) {
@@ -520,17 +841,45 @@ void HandleEvents(AppContext* ctx) {
     if (IsKeyPressed(KEY_F11)) {
         ToggleFullscreen();
     }
+    
+    // Statistiques du pipeline
+    if (IsKeyPressed(KEY_F3)) {
+        ctx->showStatsOverlay = !ctx->showStatsOverlay;
+    }
+    
+    if (IsKeyPressed(KEY_F4)) {
+        StatsExportCsv(TextFormat("stats_%d.csv", ctx->statsExportCount++));
+    }
+    
+    if (IsKeyPressed(KEY_F5)) {
+        TraceExportChromeJson(TextFormat("trace_%d.json", ctx->traceExportCount++));
+    }
+    
+    if (IsKeyPressed(KEY_F6)) {
+        ctx->showRoiOverlay = !ctx->showRoiOverlay;
+    }
+    
+    // Présentation des images reçues : latence minimale ou retard adapté à la gigue
+    if (IsKeyPressed(KEY_F7)) {
+        SetPlayoutPolicy(GetPlayoutPolicy() == PLAYOUT_POLICY_SMOOTH ? PLAYOUT_POLICY_LATENCY : PLAYOUT_POLICY_SMOOTH);
+    }
+    
+    // Zoom et déplacement dans l'image reçue
+    if (ctx->state == APP_STATE_VIEWING) {
+        HandleViewZoom(ctx);
+    }
 }
 
 void ToggleSharing(AppContext* ctx) {
     if (!ctx) return;
     
-    if (ctx->state == APP_STATE_IDLE) {
+    if (ctx->state == APP_STATE_IDLE || ctx->state == APP_STATE_VIEWING) {
         ctx->state = APP_STATE_SHARING;
-        printf("[INFO] Démarrage du partage d'écran\n");
+        SchedulerReset(&ctx->captureScheduler, (uint32_t)ctx->captureInterval, SCHEDULER_IDLE_INTERVAL_MS);
+        LOG_INFO(LOG_MODULE_APP, "Démarrage du partage d'écran");
     } else if (ctx->state == APP_STATE_SHARING) {
         ctx->state = APP_STATE_IDLE;
-        printf("[INFO] Arrêt du partage d'écran\n");
+        LOG_INFO(LOG_MODULE_APP, "Arrêt du partage d'écran");
     }
 }
 
@@ -542,6 +891,369 @@ void ToggleMinimized(AppContext* ctx) {
     // Dans l'étape 5, nous intégrerons ici la gestion de la zone de notification
 }
 
+// Fonction pour décoder et afficher une image reçue d'un pair
+void UpdateSharedCursor(AppContext* ctx, uint64_t now) {
+    CursorState cursor;
+    bool shapeChanged = false;
+    if (!CaptureCursor(&cursor, &shapeChanged)) return;
+    
+    // Nouvelle forme envoyée une seule fois ; le visualiseur la garde en cache
+    if (shapeChanged && !SendCursorShape(ctx->connectedPeerID, GetCaptureCursorShape())) {
+        LOG_DEBUG(LOG_MODULE_APP, "Échec de l'envoi de la forme du curseur");
+    }
+    
+    // Position envoyée quand elle change, et périodiquement pour compenser une perte
+    bool changed = cursor.visible != ctx->sentCursor.visible || cursor.x != ctx->sentCursor.x ||
+                   cursor.y != ctx->sentCursor.y || cursor.shapeId != ctx->sentCursor.shapeId;
+    if (!changed && now - ctx->lastCursorSendNs < CURSOR_REFRESH_NS) return;
+    
+    if (SendCursorState(ctx->connectedPeerID, &cursor)) {
+        ctx->sentCursor = cursor;
+        ctx->lastCursorSendNs = now;
+    }
+}
+
+void RenderViewerCursor(AppContext* ctx, int posX, int posY, float scale) {
+    if (!ctx->viewerCursor.visible) return;
+    
+    // Texture rechargée seulement quand la forme change
+    if (ctx->viewerCursor.shapeId != ctx->cursorTextureShapeId) {
+        const CursorShape* shape = CursorCacheFind(ctx->viewerCursor.shapeId);
+        if (!shape) return; // Forme demandée à l'émetteur, pas encore reçue
+        
+        if (ctx->cursorTexture.id > 0) UnloadTexture(ctx->cursorTexture);
+        Image image = { shape->pixels, shape->width, shape->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        ctx->cursorTexture = LoadTextureFromImage(image);
+        ctx->cursorTextureShapeId = shape->shapeId;
+    }
+    
+    const CursorShape* shape = CursorCacheFind(ctx->cursorTextureShapeId);
+    if (!shape || ctx->cursorTexture.id == 0) return;
+    
+    // Même échelle que l'image, le point actif sur la position reçue
+    Rectangle source = { 0, 0, (float)shape->width, (float)shape->height };
+    Rectangle destination = { posX + (ctx->viewerCursor.x - shape->hotspotX) * scale,
+                              posY + (ctx->viewerCursor.y - shape->hotspotY) * scale,
+                              shape->width * scale, shape->height * scale };
+    DrawTexturePro(ctx->cursorTexture, source, destination, (Vector2){0, 0}, 0.0f, WHITE);
+}
+
+// Position et échelle de la zone capturée dans la fenêtre, d'après le zoom et le centre de la vue
+bool GetViewLayout(AppContext* ctx, float* scale, int* posX, int* posY) {
+    if (!ctx->hasCaptureData) return false;
+    
+    int sourceWidth = ctx->currentCapture.sourceWidth > 0 ? ctx->currentCapture.sourceWidth : ctx->currentCapture.width;
+    int sourceHeight = ctx->currentCapture.sourceHeight > 0 ? ctx->currentCapture.sourceHeight : ctx->currentCapture.height;
+    if (sourceWidth <= 0 || sourceHeight <= 0) return false;
+    
+    float zoom = ctx->state == APP_STATE_VIEWING && ctx->viewZoom > 1.0f ? ctx->viewZoom : 1.0f;
+    *scale = fminf((float)GetScreenWidth() / sourceWidth, (float)GetScreenHeight() / sourceHeight) * zoom;
+    
+    // Centre borné pour que la vue ne sorte pas de l'image ; centrée si l'image tient dans la fenêtre
+    float displayWidth = sourceWidth * *scale;
+    float displayHeight = sourceHeight * *scale;
+    float halfX = GetScreenWidth() / (2.0f * displayWidth);
+    float halfY = GetScreenHeight() / (2.0f * displayHeight);
+    ctx->viewCenter.x = halfX >= 0.5f ? 0.5f : fminf(fmaxf(ctx->viewCenter.x, halfX), 1.0f - halfX);
+    ctx->viewCenter.y = halfY >= 0.5f ? 0.5f : fminf(fmaxf(ctx->viewCenter.y, halfY), 1.0f - halfY);
+    
+    *posX = (int)(GetScreenWidth() / 2.0f - ctx->viewCenter.x * displayWidth);
+    *posY = (int)(GetScreenHeight() / 2.0f - ctx->viewCenter.y * displayHeight);
+    return true;
+}
+
+// Molette : zoom autour du pointeur ; bouton droit ou milieu : déplacement ; Z : vue entière
+void HandleViewZoom(AppContext* ctx) {
+    float scale;
+    int posX;
+    int posY;
+    if (!GetViewLayout(ctx, &scale, &posX, &posY)) return;
+    
+    int sourceWidth = ctx->currentCapture.sourceWidth > 0 ? ctx->currentCapture.sourceWidth : ctx->currentCapture.width;
+    int sourceHeight = ctx->currentCapture.sourceHeight > 0 ? ctx->currentCapture.sourceHeight : ctx->currentCapture.height;
+    
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        // Le point sous le pointeur reste sous le pointeur
+        Vector2 mouse = GetMousePosition();
+        float pointX = (mouse.x - posX) / scale;
+        float pointY = (mouse.y - posY) / scale;
+        float zoom = fminf(fmaxf(ctx->viewZoom * powf(VIEW_ZOOM_STEP, wheel), 1.0f), VIEW_ZOOM_MAX);
+        float newScale = scale * zoom / ctx->viewZoom;
+        ctx->viewCenter.x = (pointX * newScale + GetScreenWidth() / 2.0f - mouse.x) / (sourceWidth * newScale);
+        ctx->viewCenter.y = (pointY * newScale + GetScreenHeight() / 2.0f - mouse.y) / (sourceHeight * newScale);
+        ctx->viewZoom = zoom;
+    }
+    
+    if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT) || IsMouseButtonDown(MOUSE_BUTTON_MIDDLE)) {
+        Vector2 delta = GetMouseDelta();
+        ctx->viewCenter.x -= delta.x / (sourceWidth * scale);
+        ctx->viewCenter.y -= delta.y / (sourceHeight * scale);
+    }
+    
+    if (IsKeyPressed(KEY_Z)) {
+        ctx->viewZoom = 1.0f;
+        ctx->viewCenter = (Vector2){ 0.5f, 0.5f };
+    }
+}
+
+// Annonce la fenêtre et, pendant un zoom, la région visible en pixels de la zone capturée
+void UpdateViewerViewport(AppContext* ctx) {
+    ViewerViewport viewport = { GetScreenWidth(), GetScreenHeight(), 0, 0, 0, 0 };
+    
+    float scale;
+    int posX;
+    int posY;
+    if (ctx->viewZoom > 1.0f && GetViewLayout(ctx, &scale, &posX, &posY)) {
+        int sourceWidth = ctx->currentCapture.sourceWidth > 0 ? ctx->currentCapture.sourceWidth : ctx->currentCapture.width;
+        int sourceHeight = ctx->currentCapture.sourceHeight > 0 ? ctx->currentCapture.sourceHeight : ctx->currentCapture.height;
+        
+        // Région arrondie vers l'extérieur pour couvrir les pixels partiellement visibles
+        int left = (int)fmaxf(floorf(-posX / scale), 0.0f);
+        int top = (int)fmaxf(floorf(-posY / scale), 0.0f);
+        int right = (int)fminf(ceilf((GetScreenWidth() - posX) / scale), (float)sourceWidth);
+        int bottom = (int)fminf(ceilf((GetScreenHeight() - posY) / scale), (float)sourceHeight);
+        if (right - left < sourceWidth || bottom - top < sourceHeight) {
+            viewport.regionX = left;
+            viewport.regionY = top;
+            viewport.regionWidth = right - left;
+            viewport.regionHeight = bottom - top;
+        }
+    }
+    
+    // Plus de zoom : la région reçue ne sert plus
+    if (viewport.regionWidth == 0 && ctx->hasDetailData) {
+        UnloadCaptureData(&ctx->detailCapture);
+        ctx->hasDetailData = false;
+    }
+    SetViewerViewport(&viewport);
+}
+
+// Région zoomée par le visualiseur, extraite de la capture en pleine résolution et codée sur son propre canevas
+void SendViewportDetail(AppContext* ctx, const ViewerViewport* viewport) {
+    CaptureData detail;
+    Rectangle region = { (float)viewport->regionX, (float)viewport->regionY,
+                         (float)viewport->regionWidth, (float)viewport->regionHeight };
+    if (!ExtractCaptureRegion(&ctx->currentCapture, region, &detail)) return;
+    
+    // Acquittements propres à la couche : un déplacement de la région est retrouvé par la détection de défilement
+    uint32_t canvasId = GetCaptureCanvasId(CAPTURE_LAYER_DETAIL, detail.codec);
+    detail.baseFrameId = GetAcknowledgedFrame(ctx->connectedPeerID, canvasId);
+    detail.appliedFrames = GetAppliedFrames(ctx->connectedPeerID, canvasId, detail.baseFrameId);
+    
+    // Résolution native tant que la région est affichée agrandie, réduite à la fenêtre sinon
+    if (!ScaleCaptureData(&detail, viewport->width, viewport->height) ||
+        !CompressCaptureData(&detail, ctx->captureQuality) ||
+        !SendCaptureData(ctx->connectedPeerID, &detail)) {
+        LOG_DEBUG(LOG_MODULE_APP, "Région zoomée de l'image %u non envoyée", detail.frameId);
+    }
+    UnloadCaptureData(&detail);
+}
+
+void DisplayReceivedCapture(AppContext* ctx, CaptureData* received) {
+    if (!ctx || !received || !received->compressedData) return;
+    
+    // Décodeur de la couche et du codec de l'image (validés à la réception), créé à sa première image
+    const Codec* codec = CodecGet(received->codec);
+    CaptureLayer layer = received->layer;
+    if (!ctx->viewerDecoders[layer][codec->id]) ctx->viewerDecoders[layer][codec->id] = codec->createDecoder();
+    void* decoder = ctx->viewerDecoders[layer][codec->id];
+    if (!decoder) {
+        LOG_ERROR(LOG_MODULE_APP, "Impossible de créer le décodeur %s", codec->name);
+        UnloadCaptureData(received);
+        return;
+    }
+    
+    // Seules les tuiles modifiées depuis l'image de référence sont décodées et recopiées dans le canevas ;
+    // une image vidéo est décodée entière, prédite depuis une image déjà décodée
+    uint64_t decodeStart = StatsBegin();
+    TileApplyResult result = codec->decode(decoder, received->compressedData, (uint32_t)received->compressedSize,
+                                           received->frameId, received->width, received->height);
+    received->decodeNs = ClockNowNs();
+    StatsRecordFrame(STAT_STAGE_DECODE, received->decodeNs - decodeStart, received->frameId);
+    
+    if (result != TILE_APPLY_OK) {
+        if (result == TILE_APPLY_STALE) {
+            StatsAddCounter(STAT_COUNTER_FRAMES_STALE, 1);
+        } else if (result == TILE_APPLY_MISSING_BASE) {
+            LOG_DEBUG(LOG_MODULE_APP, "Image %u ignorée: image de référence %u absente, image complète demandée",
+                                      received->frameId, received->baseFrameId);
+        } else if (result == TILE_APPLY_MISSING_CACHE) {
+            LOG_DEBUG(LOG_MODULE_APP, "Image %u ignorée: tuile absente du cache, image complète demandée",
+                                      received->frameId);
+        } else if (result == TILE_APPLY_MISSING_COPY) {
+            LOG_DEBUG(LOG_MODULE_APP, "Image %u ignorée: copies basées sur une image non reçue",
+                                      received->frameId);
+        } else if (result == TILE_APPLY_ERROR) {
+            LOG_ERROR(LOG_MODULE_APP, "Échec du décodage de l'image %u", received->frameId);
+        }
+        
+        // Canevas désynchronisé : l'émetteur repart d'une image complète. Des copies manquées ne le
+        // désynchronisent pas : sans nouvel acquittement, l'émetteur renverra bientôt les tuiles
+        if (result != TILE_APPLY_STALE && result != TILE_APPLY_MISSING_COPY) {
+            AcknowledgeCaptureFrame(received->sourcePeerId, layer, 0, 0);
+        }
+        UnloadCaptureData(received);
+        return;
+    }
+    AcknowledgeCaptureFrame(received->sourcePeerId, layer, codec->decoderStreamId(decoder), received->frameId);
+    
+    // Chaque couche a sa texture, la région zoomée est dessinée par-dessus la zone entière
+    CaptureData* target = layer == CAPTURE_LAYER_DETAIL ? &ctx->detailCapture : &ctx->currentCapture;
+    bool* hasTarget = layer == CAPTURE_LAYER_DETAIL ? &ctx->hasDetailData : &ctx->hasCaptureData;
+    
+    uint64_t uploadStart = StatsBegin();
+    
+    // Réutiliser la texture précédente si les dimensions n'ont pas changé ; si elle contient déjà
+    // l'image précédente de ce décodeur, seules les zones modifiées sont envoyées
+    const Image* canvas = codec->decodedImage(decoder);
+    if (*hasTarget && target->texture.id > 0 &&
+        target->texture.width == canvas->width &&
+        target->texture.height == canvas->height) {
+        received->texture = target->texture;
+        target->texture.id = 0;
+        const DirtyRect* rects = NULL;
+        int rectCount = codec->dirtyRects(decoder, &rects);
+        if (target->textureDecoder == decoder && rectCount > 0) {
+            UploadDirtyRects(ctx, received->texture, canvas, rects, rectCount);
+        } else {
+            UpdateTexture(received->texture, canvas->data);
+        }
+    } else {
+        received->texture = LoadTextureFromImage(*canvas);
+    }
+    received->textureDecoder = decoder;
+    
+    // Image réduite par l'émetteur : interpolée à l'agrandissement plutôt qu'en gros pixels
+    bool reduced = received->sourceWidth > received->width || received->sourceHeight > received->height;
+    SetTextureFilter(received->texture, reduced ? TEXTURE_FILTER_BILINEAR : TEXTURE_FILTER_POINT);
+    StatsEndFrame(STAT_STAGE_UPLOAD, uploadStart, received->frameId);
+    
+    if (*hasTarget) {
+        UnloadCaptureData(target);
+    }
+    
+    *target = *received;
+    *hasTarget = true;
+    if (layer == CAPTURE_LAYER_FULL) {
+        ctx->pendingPresent = true;
+        ctx->state = APP_STATE_VIEWING;
+    }
+}
+
+void UploadDirtyRects(AppContext* ctx, Texture2D texture, const Image* image, const DirtyRect* rects, int count) {
+    size_t stride = (size_t)image->width * 4;
+    for (int i = 0; i < count; i++) {
+        const DirtyRect* rect = &rects[i];
+        const uint8_t* pixels = (const uint8_t*)image->data + (size_t)rect->y * stride + (size_t)rect->x * 4;
+        
+        // UpdateTextureRec attend des lignes contiguës : une bande de toute la largeur est lue en place
+        if (rect->width != image->width) {
+            size_t rowSize = (size_t)rect->width * 4;
+            size_t needed = rowSize * rect->height;
+            if (needed > ctx->uploadCapacity) {
+                uint8_t* buffer = (uint8_t*)realloc(ctx->uploadBuffer, needed);
+                if (!buffer) {
+                    UpdateTexture(texture, image->data);
+                    return;
+                }
+                ctx->uploadBuffer = buffer;
+                ctx->uploadCapacity = needed;
+            }
+            for (int y = 0; y < rect->height; y++) {
+                memcpy(ctx->uploadBuffer + (size_t)y * rowSize, pixels + (size_t)y * stride, rowSize);
+            }
+            pixels = ctx->uploadBuffer;
+        }
+        UpdateTextureRec(texture, (Rectangle){ (float)rect->x, (float)rect->y, (float)rect->width, (float)rect->height },
+                         pixels);
+    }
+}
+
+// Intérêt de chaque cellule en surimpression : rouge au plus fort, transparent en périphérie
+void RenderRoiOverlay(AppContext* ctx, int posX, int posY, int displayWidth, int displayHeight) {
+    const RoiMap* map = GetCaptureRoiMap(CAPTURE_LAYER_FULL);
+    if (!map || map->width != ctx->currentCapture.width || map->height != ctx->currentCapture.height) return;
+    
+    // Cellules en pixels de l'image envoyée, agrandies comme elle à l'affichage
+    float scaleX = (float)displayWidth / map->width;
+    float scaleY = (float)displayHeight / map->height;
+    for (int row = 0; row < map->rows; row++) {
+        for (int column = 0; column < map->columns; column++) {
+            uint8_t weight = map->weights[row * map->columns + column];
+            if (weight == 0) continue;
+            
+            float x = posX + column * ROI_CELL_SIZE * scaleX;
+            float y = posY + row * ROI_CELL_SIZE * scaleY;
+            float width = fminf(ROI_CELL_SIZE, map->width - column * ROI_CELL_SIZE) * scaleX;
+            float height = fminf(ROI_CELL_SIZE, map->height - row * ROI_CELL_SIZE) * scaleY;
+            Color color = weight >= ROI_FOCUS_WEIGHT ? RED : ORANGE;
+            DrawRectangleRec((Rectangle){ x, y, width, height }, Fade(color, weight / 255.0f * 0.45f));
+        }
+    }
+    DrawText(TextFormat("Intérêt moyen: %d%s", map->meanWeight, map->boostLossless ? ", tuiles d'intérêt sans perte" : ""),
+             posX + 10, posY + displayHeight - 30, 20, RED);
+}
+
+// Panneau semi-transparent : percentiles glissants par étape et compteurs
+void RenderStatsOverlay(AppContext* ctx) {
+    if (!ctx) return;
+    
+    StatsSnapshot snapshot;
+    StatsGetSnapshot(&snapshot);
+    
+    const int lineHeight = 18;
+    const int width = 420;
+    const int height = (STAT_STAGE_COUNT + STAT_COUNTER_COUNT + 5) * lineHeight + 10;
+    int x = GetScreenWidth() - width - 10;
+    int y = 40;
+    
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.7f));
+    x += 10;
+    y += 5;
+    
+    DrawText("Étape        p50 ms   p99 ms   max ms   mesures", x, y, 16, YELLOW);
+    y += lineHeight;
+    
+    for (int s = 0; s < STAT_STAGE_COUNT; s++) {
+        const StatStageSummary* stage = &snapshot.stages[s];
+        Color color = stage->windowCount > 0 ? RAYWHITE : GRAY;
+        DrawText(TextFormat("%-12s %7.2f  %7.2f  %7.2f  %8llu", StatsStageName((StatStage)s),
+                            stage->p50Ms, stage->p99Ms, stage->maxMs,
+                            (unsigned long long)stage->totalCount),
+                 x, y, 16, color);
+        y += lineHeight;
+    }
+    
+    y += lineHeight;
+    DrawText("Compteurs", x, y, 16, YELLOW);
+    y += lineHeight;
+    
+    for (int c = 0; c < STAT_COUNTER_COUNT; c++) {
+        DrawText(TextFormat("%-16s %llu", StatsCounterName((StatCounter)c),
+                            (unsigned long long)snapshot.counters[c]),
+                 x, y, 16, RAYWHITE);
+        y += lineHeight;
+    }
+    
+    // Efficacité du cache : tuiles reprises parmi toutes les tuiles à envoyer
+    uint64_t hits = snapshot.counters[STAT_COUNTER_CACHE_HITS];
+    uint64_t lookups = hits + snapshot.counters[STAT_COUNTER_TILES_ENCODED];
+    DrawText(TextFormat("cache tuiles     %.1f %% repris, %.1f Mo économisés",
+                        lookups > 0 ? 100.0 * hits / lookups : 0.0,
+                        snapshot.counters[STAT_COUNTER_CACHE_BYTES_SAVED] / (1024.0 * 1024.0)),
+             x, y, 16, lookups > 0 ? RAYWHITE : GRAY);
+    y += lineHeight;
+    
+    // Présentation des images reçues : retard de lecture visé en mode fluide
+    uint64_t jitterNs = 0;
+    uint64_t delayNs = GetPlayoutDelayNs(&jitterNs);
+    bool smooth = GetPlayoutPolicy() == PLAYOUT_POLICY_SMOOTH;
+    DrawText(TextFormat("lecture          %s, retard %.1f ms, gigue %.1f ms",
+                        smooth ? "fluide" : "latence minimale", smooth ? delayNs / 1e6 : 0.0, jitterNs / 1e6),
+             x, y, 16, RAYWHITE);
+}
+
 // Fonction pour obtenir l'adresse IP locale
 bool GetLocalIPAddress(char* ipBuffer, int bufferSize) {
     if (!ipBuffer || bufferSize <= 0) return false;
@@ -553,13 +1265,13 @@ bool GetLocalIPAddress(char* ipBuffer, int bufferSize) {
     // Initialisation de Winsock
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        printf("[ERROR] Échec de l'initialisation de WSAStartup\n");
+        LOG_ERROR(LOG_MODULE_APP, "Échec de l'initialisation de WSAStartup");
         return false;
     }
     
     char hostname[256] = {0};
     if (gethostname(hostname, sizeof(hostname)) != 0) {
-        printf("[ERROR] Échec de l'obtention du hostname\n");
+        LOG_ERROR(LOG_MODULE_APP, "Échec de l'obtention du hostname");
         WSACleanup();
         return false;
     }
@@ -569,7 +1281,7 @@ bool GetLocalIPAddress(char* ipBuffer, int bufferSize) {
     hints.ai_socktype = SOCK_STREAM;
     
     if (getaddrinfo(hostname, NULL, &hints, &result) != 0) {
-        printf("[ERROR] Échec de getaddrinfo\n");
+        LOG_ERROR(LOG_MODULE_APP, "Échec de getaddrinfo");
         WSACleanup();
         return false;
     }
@@ -610,7 +1322,7 @@ bool GetLocalIPAddress(char* ipBuffer, int bufferSize) {
                            ipBuffer, bufferSize,
                            NULL, 0, NI_NUMERICHOST);
             if (s != 0) {
-                printf("[ERROR] getnameinfo() a échoué: %s\n", gai_strerror(s));
+                LOG_ERROR(LOG_MODULE_APP, "getnameinfo() a échoué: %s", gai_strerror(s));
                 freeifaddrs(ifaddr);
                 return false;
             }
@@ -646,7 +1358,7 @@ void ConnectToPeerByIP(AppContext* ctx) {
     
     // Vérifier si on est déjà connecté
     if (ctx->connectedPeerID >= 0) {
-        printf("[INFO] Déjà connecté au pair ID %d, déconnexion d'abord\n", ctx->connectedPeerID);
+        LOG_INFO(LOG_MODULE_APP, "Déjà connecté au pair ID %d, déconnexion d'abord", ctx->connectedPeerID);
         DisconnectFromCurrentPeer(ctx);
     }
     
@@ -677,7 +1389,7 @@ void ConnectToPeerByIP(AppContext* ctx) {
             }
         }
         
-        ctx->lastNetworkActivity = GetTime();
+        ctx->lastNetworkActivity = ClockNowNs();
     } else {
         sprintf(ctx->connectionStatus, "Échec de connexion à %s:%d", 
                ctx->remotePeerIP, ctx->remotePeerPort);
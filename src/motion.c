@@ -0,0 +1,218 @@
+#include "../include/motion.h"
+#include "../include/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Empreinte réservée aux lignes d'une seule couleur : elles concordent avec n'importe quel décalage
+#define UNIFORM_LINE 0
+
+// Cases de la table des empreintes de la référence
+#define SLOT_EMPTY (-1)
+#define SLOT_AMBIGUOUS (-2)
+
+// Ensemble de lignes parallèles d'une image : des rangées (défilement vertical) ou des colonnes
+typedef struct {
+    const uint8_t* origin;      // Premier pixel de la première ligne
+    size_t lineStep;            // Octets d'une ligne à la suivante
+    size_t pixelStep;           // Octets d'un pixel au suivant dans une ligne
+    int length;                 // Pixels par ligne
+} LineSet;
+
+// Fonctions utilitaires privées
+static uint32_t ReadPixel(const uint8_t* p) {
+    uint32_t pixel;
+    memcpy(&pixel, p, sizeof(pixel));
+    return pixel;
+}
+
+static uint64_t HashLine(const LineSet* set, int line) {
+    const uint8_t* p = set->origin + (size_t)line * set->lineStep;
+    uint32_t first = ReadPixel(p);
+    uint64_t hash = 14695981039346656037ULL;
+    bool uniform = true;
+    
+    for (int i = 0; i < set->length; i++, p += set->pixelStep) {
+        uint32_t pixel = ReadPixel(p);
+        uniform = uniform && pixel == first;
+        hash = (hash ^ pixel) * 1099511628211ULL;
+    }
+    if (uniform) return UNIFORM_LINE;
+    return hash != UNIFORM_LINE ? hash : 1;
+}
+
+static bool LinesEqual(const LineSet* a, int lineA, const LineSet* b, int lineB) {
+    const uint8_t* pa = a->origin + (size_t)lineA * a->lineStep;
+    const uint8_t* pb = b->origin + (size_t)lineB * b->lineStep;
+    if (a->pixelStep == 4) return memcmp(pa, pb, (size_t)a->length * 4) == 0;
+    
+    for (int i = 0; i < a->length; i++, pa += a->pixelStep, pb += b->pixelStep) {
+        if (memcmp(pa, pb, 4) != 0) return false;
+    }
+    return true;
+}
+
+// Décalage majoritaire entre les lignes de la référence et celles de l'image courante, 0 si aucun
+static int FindShift(const LineSet* reference, const LineSet* current, int lines,
+                     const uint64_t* referenceHashes, const uint64_t* currentHashes) {
+    // Table d'adressage ouvert : empreinte d'une ligne de référence -> indice de la ligne
+    int tableSize = 1;
+    while (tableSize < lines * 2) tableSize <<= 1;
+    uint64_t* slotHash = (uint64_t*)malloc((size_t)tableSize * sizeof(uint64_t));
+    int* slotLine = (int*)malloc((size_t)tableSize * sizeof(int));
+    int* votes = (int*)calloc((size_t)lines * 2 + 1, sizeof(int));
+    if (!slotHash || !slotLine || !votes) {
+        free(slotHash);
+        free(slotLine);
+        free(votes);
+        return 0;
+    }
+    for (int i = 0; i < tableSize; i++) slotLine[i] = SLOT_EMPTY;
+    
+    for (int line = 0; line < lines; line++) {
+        uint64_t hash = referenceHashes[line];
+        if (hash == UNIFORM_LINE) continue;
+        
+        int slot = (int)(hash & (uint64_t)(tableSize - 1));
+        while (slotLine[slot] != SLOT_EMPTY && slotHash[slot] != hash) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        
+        // Ligne répétée dans la référence : sa position est ambiguë, elle ne vote pas
+        slotLine[slot] = slotLine[slot] == SLOT_EMPTY ? line : SLOT_AMBIGUOUS;
+        slotHash[slot] = hash;
+    }
+    
+    // Chaque ligne modifiée retrouvée ailleurs dans la référence vote pour son décalage
+    for (int line = 0; line < lines; line++) {
+        uint64_t hash = currentHashes[line];
+        if (hash == UNIFORM_LINE || hash == referenceHashes[line]) continue;
+        
+        int slot = (int)(hash & (uint64_t)(tableSize - 1));
+        while (slotLine[slot] != SLOT_EMPTY && slotHash[slot] != hash) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        
+        int source = slotLine[slot];
+        if (source >= 0 && LinesEqual(current, line, reference, source)) {
+            votes[line - source + lines]++;
+        }
+    }
+    
+    int bestShift = 0;
+    int bestVotes = MOTION_MIN_VOTES - 1;
+    for (int shift = -lines + 1; shift < lines; shift++) {
+        if (shift != 0 && votes[shift + lines] > bestVotes) {
+            bestVotes = votes[shift + lines];
+            bestShift = shift;
+        }
+    }
+    
+    free(slotHash);
+    free(slotLine);
+    free(votes);
+    return bestShift;
+}
+
+// Bandes de lignes identiques à la référence décalée, en indices de lignes de la zone
+static int CollectRuns(const LineSet* reference, const LineSet* current, int lines, int shift,
+                       int* runStart, int* runLength, int maxRuns) {
+    int count = 0;
+    int start = -1;
+    
+    for (int line = 0; line <= lines; line++) {
+        int source = line - shift;
+        bool match = line < lines && source >= 0 && source < lines &&
+                     LinesEqual(current, line, reference, source);
+        
+        if (match && start < 0) start = line;
+        if (!match && start >= 0) {
+            if (line - start >= MOTION_MIN_RUN && count < maxRuns) {
+                runStart[count] = start;
+                runLength[count] = line - start;
+                count++;
+            }
+            start = -1;
+        }
+    }
+    return count;
+}
+
+// Recherche dans une direction : rangées (vertical) ou colonnes de la zone
+static int DetectDirection(const uint8_t* reference, const uint8_t* current, int width,
+                           MotionRect area, bool vertical, MotionRect* rects, int maxRects) {
+    size_t stride = (size_t)width * 4;
+    size_t offset = (size_t)area.srcY * stride + (size_t)area.srcX * 4;
+    int lines = vertical ? area.height : area.width;
+    
+    LineSet referenceLines = { reference + offset, vertical ? stride : 4, vertical ? 4 : stride,
+                               vertical ? area.width : area.height };
+    LineSet currentLines = referenceLines;
+    currentLines.origin = current + offset;
+    
+    uint64_t* hashes = (uint64_t*)malloc((size_t)lines * 2 * sizeof(uint64_t));
+    if (!hashes) return 0;
+    for (int line = 0; line < lines; line++) {
+        hashes[line] = HashLine(&referenceLines, line);
+        hashes[lines + line] = HashLine(&currentLines, line);
+    }
+    
+    int shift = FindShift(&referenceLines, &currentLines, lines, hashes, hashes + lines);
+    free(hashes);
+    if (shift == 0) return 0;
+    
+    int runStart[MOTION_MAX_RECTS];
+    int runLength[MOTION_MAX_RECTS];
+    int runs = CollectRuns(&referenceLines, &currentLines, lines, shift, runStart, runLength,
+                           maxRects < MOTION_MAX_RECTS ? maxRects : MOTION_MAX_RECTS);
+    
+    for (int i = 0; i < runs; i++) {
+        MotionRect* rect = &rects[i];
+        if (vertical) {
+            rect->srcX = area.srcX;
+            rect->dstX = area.srcX;
+            rect->srcY = area.srcY + runStart[i] - shift;
+            rect->dstY = area.srcY + runStart[i];
+            rect->width = area.width;
+            rect->height = runLength[i];
+        } else {
+            rect->srcX = area.srcX + runStart[i] - shift;
+            rect->dstX = area.srcX + runStart[i];
+            rect->srcY = area.srcY;
+            rect->dstY = area.srcY;
+            rect->width = runLength[i];
+            rect->height = area.height;
+        }
+    }
+    
+    if (runs > 0) {
+        LOG_DEBUG(LOG_MODULE_CAPTURE, "Défilement %s de %d pixels: %d rectangle(s) copié(s)",
+                                      vertical ? "vertical" : "horizontal", shift, runs);
+    }
+    return runs;
+}
+
+// Implémentation des fonctions publiques
+int MotionDetect(const uint8_t* reference, const uint8_t* current, int width, int height,
+                 MotionRect area, MotionRect* rects, int maxRects) {
+    if (!reference || !current || !rects || maxRects <= 0) return 0;
+    
+    // Zone bornée à l'image ; trop petite pour contenir une bande utile
+    if (area.srcX < 0) {
+        area.width += area.srcX;
+        area.srcX = 0;
+    }
+    if (area.srcY < 0) {
+        area.height += area.srcY;
+        area.srcY = 0;
+    }
+    if (area.srcX + area.width > width) area.width = width - area.srcX;
+    if (area.srcY + area.height > height) area.height = height - area.srcY;
+    if (area.width < MOTION_MIN_RUN || area.height < MOTION_MIN_RUN) return 0;
+    
+    // Défilement vertical (documents, pages web), le plus courant, puis horizontal
+    int count = DetectDirection(reference, current, width, area, true, rects, maxRects);
+    if (count == 0) {
+        count = DetectDirection(reference, current, width, area, false, rects, maxRects);
+    }
+    return count;
+}
@@ -2,73 +2,146 @@
 
 #include "../include/rnet.h"
 #include "../include/network.h"
+#include "../include/protocol.h"
+#include "../include/codec.h"
+#include "../include/clock.h"
+#include "../include/stats.h"
+#include "../include/log.h"
+#include "../include/crypto.h"
+#include "../include/handshake.h"
+#include "../include/cursor.h"
+#include "../include/jitter.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
 // Constantes
 #define MAX_PEERS 32
 #define CONNECTION_TIMEOUT 5000 // ms
-#define PACKET_TYPE_CAPTURE 1
-#define PACKET_TYPE_CONTROL 2
-#define PACKET_TYPE_HANDSHAKE 3
+#define CLOCK_SYNC_INTERVAL_NS 1000000000ULL // Un ping par seconde et par pair
+#define CURSOR_REQUEST_INTERVAL_NS 250000000ULL // Nouvelle demande d'une forme manquante après 250 ms
 
-// Structure d'en-tête de paquet
+// Place réservée autour de la charge utile pour chiffrer en place :
+// [en-tête][nonce][charge utile][tag]. Sans chiffrement, l'en-tête est écrit juste devant la charge utile.
+#define PACKET_HEADROOM (WIRE_HEADER_SIZE + WIRE_AEAD_NONCE_SIZE)
+#define PACKET_TAILROOM WIRE_AEAD_TAG_SIZE
+#define PACKET_PAYLOAD(packet) ((packet) + PACKET_HEADROOM)
+
+_Static_assert(WIRE_AEAD_NONCE_SIZE == AEAD_NONCE_SIZE && WIRE_AEAD_TAG_SIZE == AEAD_TAG_SIZE,
+               "Le format réseau doit suivre les tailles AEAD");
+
+// Acquittements d'une couche d'images (CaptureLayer) par un visualiseur
+typedef struct {
+    bool hasFrameAck;                           // Le pair a acquitté une image de notre canevas
+    uint32_t ackedCanvasId;                     // Canevas de tuiles acquitté par le pair
+    uint32_t ackedFrameId;                      // Dernière image acquittée sur ce canevas
+    uint64_t appliedFrames;                     // Bit i : acquittement de l'image ackedFrameId - i reçu
+} LayerAck;
+
+// État de transport propre à chaque pair (parallèle à connectedPeers)
 typedef struct {
-    uint8_t type;       // Type de paquet (capture, contrôle, handshake)
-    uint8_t flags;      // Drapeaux spécifiques au type de paquet
-    uint16_t sequence;  // Numéro de séquence pour la vérification de l'ordre
-    uint32_t timestamp; // Horodatage pour mesurer la latence
-    uint32_t dataSize;  // Taille des données
-} PacketHeader;
+    rnetTargetPeer* transport;                  // Pair ENet associé
+    bool handshakePending;                      // Handshake à envoyer dès la connexion établie
+    bool handshakeSent;                         // Notre handshake a été envoyé sur ce transport
+    AeadAlgorithm aeadAlgorithm;                // Algorithme choisi pour ce pair (le plus rapide commun)
+    uint32_t codecSupport;                      // Codecs que le pair sait décoder (0 avant son handshake)
+    uint32_t txSequence[PACKET_STREAM_COUNT];   // Prochain numéro de séquence émis par flux
+    uint32_t rxSequence[PACKET_STREAM_COUNT];   // Dernier numéro de séquence reçu par flux
+    bool rxStarted[PACKET_STREAM_COUNT];        // Indique si un paquet a déjà été reçu sur le flux
+    ClockOffsetEstimator clock;                 // Décalage entre l'horloge du pair et la nôtre
+    uint64_t lastPingNs;                        // Dernier ping envoyé
+    HandshakeState handshake;                   // Échange de clés et clés de session de ce pair
+    LayerAck acks[CAPTURE_LAYER_COUNT];         // Acquittements de chaque couche
+    uint32_t rxFrameId[CAPTURE_LAYER_COUNT];    // Dernière image acceptée de chaque couche
+    bool rxFrameStarted[CAPTURE_LAYER_COUNT];   // Indique si une image a déjà été acceptée sur la couche
+    bool frameStateSent;                        // Notre dernier acquittement a été renvoyé sur ce transport
+    bool viewportSent;                          // Notre taille d'affichage a été envoyée sur ce transport
+    ViewerViewport viewport;                    // Affichage du pair (taille 0 : inconnu, pas de limite)
+    uint32_t requestedShapeId;                  // Dernière forme de curseur demandée au pair
+    uint64_t shapeRequestNs;                    // Envoi de cette demande
+} PeerLink;
 
 // Variables statiques
 static bool networkInitialized = false;
 static rnetPeer* hostPeer = NULL;
 static Peer connectedPeers[MAX_PEERS] = {0};
+static PeerLink peerLinks[MAX_PEERS] = {0};
 static int peerCount = 0;
-static uint16_t nextSequence = 0;
 static EncryptionSession encSession = {0};
+static uint32_t localAeadSupport = 0;
+static JitterBuffer receivedFrames[CAPTURE_LAYER_COUNT] = {0}; // Images reçues de chaque couche, en attente d'affichage
+static PlayoutPolicy playoutPolicy = PLAYOUT_POLICY_LATENCY;
+static CursorState receivedCursor = {0};
+static bool hasReceivedCursor = false;
+
+// Dernière image appliquée en tant que visualiseur, annoncée à chaque connexion
+static uint32_t appliedCanvasId = 0;
+static uint32_t appliedFrameId = 0;
+
+// Affichage en tant que visualiseur, annoncé à chaque connexion (taille 0 : pas de limite)
+static ViewerViewport localViewport = {0};
 
 // Fonctions utilitaires privées
 static int FindPeerById(int id);
 static int FindPeerByAddress(const char* address, int port);
+static int FindPeerByTransport(rnetTargetPeer* transport);
 static int AddPeer(const char* address, int port);
 static void UpdatePeerStatus(int index, bool isConnected);
+static uint8_t* AllocPacket(uint32_t payloadSize);
+static bool SendPreparedPacket(int peerId, uint8_t type, uint8_t* packet, uint8_t* sealed, uint32_t payloadSize, int flags);
 static bool SendPacket(int peerId, uint8_t type, const void* data, uint32_t size, int flags);
-static void HandleCapturePacket(const PacketHeader* header, const void* data, size_t size, int senderId);
-static void HandleControlPacket(const PacketHeader* header, const void* data, size_t size, int senderId);
-static void HandleHandshakePacket(const PacketHeader* header, const void* data, size_t size, int senderId);
+static void SendClockPings(uint64_t now);
+static void ResetPeerLink(int index, rnetTargetPeer* transport);
+static void HandleConnectEvent(rnetTargetPeer* sender);
+static void HandleDisconnectEvent(rnetTargetPeer* sender);
+static bool AcceptFrameId(PeerLink* link, CaptureLayer layer, uint32_t frameId);
+static void ResetReceivedFrames(PeerLink* link);
+static void HandleCapturePacket(const WirePacketView* packet, int senderId, uint64_t receiveNs);
+static void HandleControlPacket(const WirePacketView* packet, int senderId, uint64_t receiveNs);
+static void HandleCursorPacket(const WirePacketView* packet, int senderId, uint64_t receiveNs);
+static void HandleHandshakePacket(const WirePacketView* packet, int senderId);
+static void SendHandshake(int index);
+static void SendFrameState(int index);
+static void SendViewport(int index);
+static void SetFrameAck(int index, CaptureLayer layer, uint32_t canvasId, uint32_t frameId);
+static const LayerAck* FindLayerAck(const PeerLink* link, uint32_t canvasId);
+static int ClampU16(int value);
+static bool OpenEncryptedPacket(int senderIndex, uint8_t* data, WirePacketView* view);
 
 // Implémentation des fonctions publiques
 bool InitNetworkSystem(int port) {
     if (networkInitialized) {
-        printf("[INFO] Système réseau déjà initialisé\n");
+        LOG_INFO(LOG_MODULE_NETWORK, "Système réseau déjà initialisé");
         return true;
     }
     
     // Initialisation de rnet
     if (!rnetInit()) {
-        printf("[ERROR] Échec de l'initialisation de rnet\n");
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec de l'initialisation de rnet");
         return false;
     }
     
     // Création d'un hôte sur le port spécifié
     hostPeer = rnetHost((uint16_t)port);
     if (!hostPeer) {
-        printf("[ERROR] Impossible de créer un hôte sur le port %d\n", port);
+        LOG_ERROR(LOG_MODULE_NETWORK, "Impossible de créer un hôte sur le port %d", port);
         rnetShutdown();
         return false;
     }
     
     // Initialisation des tableaux et variables
     memset(connectedPeers, 0, sizeof(connectedPeers));
+    memset(peerLinks, 0, sizeof(peerLinks));
     peerCount = 0;
-    nextSequence = 0;
+    
+    // Algorithmes accélérés disponibles sur cette machine
+    localAeadSupport = AeadSupportedAlgorithms();
+    LOG_INFO(LOG_MODULE_NETWORK, "Chiffrement disponible: %s%s",
+                                 AeadAlgorithmName(AEAD_ALGORITHM_CHACHA20_POLY1305),
+                                 (localAeadSupport & AEAD_SUPPORT_BIT(AEAD_ALGORITHM_AES_256_GCM)) ? ", AES-256-GCM (AES-NI)" : "");
     
     networkInitialized = true;
-    printf("[INFO] Système réseau initialisé sur le port %d\n", port);
+    LOG_INFO(LOG_MODULE_NETWORK, "Système réseau initialisé sur le port %d", port);
     return true;
 }
 
@@ -82,22 +155,37 @@ void CloseNetworkSystem(void) {
         }
     }
     
+    // Effacement des clés de session et des sessions en cache
+    for (int i = 0; i < peerCount; i++) {
+        HandshakeReset(&peerLinks[i].handshake);
+    }
+    HandshakeForgetAll();
+    
+    // Formes de curseur reçues
+    CursorCacheClear();
+    hasReceivedCursor = false;
+    
     // Fermeture de l'hôte
     if (hostPeer) {
         rnetClose(hostPeer);
         hostPeer = NULL;
     }
     
+    // Libération des images reçues non consommées
+    for (int layer = 0; layer < CAPTURE_LAYER_COUNT; layer++) {
+        JitterReset(&receivedFrames[layer]);
+    }
+    
     // Arrêt de rnet
     rnetShutdown();
     
     networkInitialized = false;
-    printf("[INFO] Système réseau fermé\n");
+    LOG_INFO(LOG_MODULE_NETWORK, "Système réseau fermé");
 }
 
 int ConnectToPeer(const char* address, int port) {
     if (!networkInitialized || !hostPeer) {
-        printf("[ERROR] Système réseau non initialisé\n");
+        LOG_ERROR(LOG_MODULE_NETWORK, "Système réseau non initialisé");
         return -1;
     }
     
@@ -105,142 +193,153 @@ int ConnectToPeer(const char* address, int port) {
     int existingIndex = FindPeerByAddress(address, port);
     if (existingIndex >= 0) {
         if (connectedPeers[existingIndex].isConnected) {
-            printf("[INFO] Déjà connecté au pair %s:%d (ID %d)\n", 
-                  address, port, connectedPeers[existingIndex].id);
+            LOG_INFO(LOG_MODULE_NETWORK, "Déjà connecté au pair %s:%d (ID %d)", 
+                                        address, port, connectedPeers[existingIndex].id);
             return connectedPeers[existingIndex].id;
         } else {
             // Le pair existe mais n'est pas connecté, on réutilise son entrée
-            printf("[INFO] Reconnexion au pair %s:%d (ID %d)\n", 
-                  address, port, connectedPeers[existingIndex].id);
+            LOG_INFO(LOG_MODULE_NETWORK, "Reconnexion au pair %s:%d (ID %d)", 
+                                        address, port, connectedPeers[existingIndex].id);
         }
     } else {
         // Ajouter un nouveau pair
         existingIndex = AddPeer(address, port);
         if (existingIndex < 0) {
-            printf("[ERROR] Impossible d'ajouter un nouveau pair, limite atteinte\n");
+            LOG_ERROR(LOG_MODULE_NETWORK, "Impossible d'ajouter un nouveau pair, limite atteinte");
             return -1;
         }
     }
     
-    // Création d'une connexion vers le pair
-    rnetPeer* connectionPeer = rnetConnect(address, (uint16_t)port);
-    if (!connectionPeer) {
-        printf("[ERROR] Échec de la connexion à %s:%d\n", address, port);
+    // Création d'une connexion vers le pair depuis l'hôte d'écoute
+    rnetTargetPeer* transport = rnetConnectPeer(hostPeer, address, (uint16_t)port);
+    if (!transport) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec de la connexion à %s:%d", address, port);
         return -1;
     }
     
-    // Mise à jour du statut de connexion
-    UpdatePeerStatus(existingIndex, true);
-    connectedPeers[existingIndex].lastPacketTime = time(NULL);
-    
-    // Envoi d'un paquet de handshake
-    char handshakeData[128] = {0};
-    sprintf(handshakeData, "C_Screenshare Handshake");
+    ResetPeerLink(existingIndex, transport);
     
-    if (!SendPacket(connectedPeers[existingIndex].id, PACKET_TYPE_HANDSHAKE, 
-                  handshakeData, strlen(handshakeData) + 1, RNET_RELIABLE)) {
-        printf("[ERROR] Échec de l'envoi du handshake à %s:%d\n", address, port);
-        rnetClose(connectionPeer);
-        UpdatePeerStatus(existingIndex, false);
-        return -1;
-    }
+    // Le handshake sera envoyé à la réception de l'événement de connexion
+    peerLinks[existingIndex].handshakePending = true;
     
-    // Fermeture de la connexion temporaire (la connexion est maintenue par hostPeer)
-    rnetClose(connectionPeer);
+    // Mise à jour du statut de connexion
+    UpdatePeerStatus(existingIndex, true);
     
-    printf("[INFO] Connexion établie avec %s:%d (ID %d)\n", 
-           address, port, connectedPeers[existingIndex].id);
+    LOG_INFO(LOG_MODULE_NETWORK, "Connexion en cours avec %s:%d (ID %d)", 
+                                 address, port, connectedPeers[existingIndex].id);
     
     return connectedPeers[existingIndex].id;
 }
 
 void DisconnectFromPeer(int peerId) {
     if (!networkInitialized || !hostPeer) {
-        printf("[ERROR] Système réseau non initialisé\n");
+        LOG_ERROR(LOG_MODULE_NETWORK, "Système réseau non initialisé");
         return;
     }
     
     int index = FindPeerById(peerId);
     if (index < 0) {
-        printf("[ERROR] Pair avec ID %d non trouvé\n", peerId);
+        LOG_ERROR(LOG_MODULE_NETWORK, "Pair avec ID %d non trouvé", peerId);
         return;
     }
     
     // Mise à jour du statut de connexion
     UpdatePeerStatus(index, false);
     
-    printf("[INFO] Déconnexion du pair %s:%d (ID %d)\n", 
-           connectedPeers[index].address, connectedPeers[index].port, peerId);
+    LOG_INFO(LOG_MODULE_NETWORK, "Déconnexion du pair %s:%d (ID %d)", 
+                                 connectedPeers[index].address, connectedPeers[index].port, peerId);
 }
 
 bool SendCaptureData(int peerId, const CaptureData* captureData) {
     if (!networkInitialized || !hostPeer || !captureData) {
-        printf("[ERROR] Système réseau non initialisé ou données de capture invalides\n");
+        LOG_ERROR(LOG_MODULE_NETWORK, "Système réseau non initialisé ou données de capture invalides");
         return false;
     }
     
     // Vérifier si on a des données compressées
     if (!captureData->isCompressed || !captureData->compressedData || captureData->compressedSize <= 0) {
-        printf("[ERROR] Les données de capture doivent être compressées avant envoi\n");
+        LOG_ERROR(LOG_MODULE_NETWORK, "Les données de capture doivent être compressées avant envoi");
         return false;
     }
     
-    // Créer une structure pour les métadonnées
-    struct {
-        int width;
-        int height;
-        int dataSize;
-        bool hasChanged;
-        uint64_t timestamp;
-        int monitorIndex;
-    } metadata = {
-        captureData->width,
-        captureData->height,
-        captureData->compressedSize,
-        captureData->hasChanged,
-        captureData->timestamp,
-        captureData->monitorIndex
-    };
-    
-    // Allouer un buffer pour les métadonnées + données compressées
-    size_t totalSize = sizeof(metadata) + captureData->compressedSize;
-    uint8_t* buffer = (uint8_t*)malloc(totalSize);
-    if (!buffer) {
-        printf("[ERROR] Échec d'allocation mémoire pour l'envoi de données\n");
+    // Un seul buffer : en-tête + métadonnées + données compressées, écrits en place
+    uint32_t payloadSize = WIRE_CAPTURE_METADATA_SIZE + (uint32_t)captureData->compressedSize;
+    uint8_t* packet = AllocPacket(payloadSize);
+    if (!packet) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec d'allocation mémoire pour l'envoi de données");
         return false;
     }
     
-    // Copier les métadonnées et les données dans le buffer
-    memcpy(buffer, &metadata, sizeof(metadata));
-    memcpy(buffer + sizeof(metadata), captureData->compressedData, captureData->compressedSize);
-    
-    // Chiffrer les données si nécessaire
-    if (encSession.isEncryptionEnabled) {
-        // TODO: Implémenter le chiffrement, non implémenté dans cette version
-    }
+    uint8_t* metadata = PACKET_PAYLOAD(packet);
+    WireWriteCaptureMetadata(metadata,
+                             captureData->frameId,
+                             (uint16_t)captureData->width,
+                             (uint16_t)captureData->height,
+                             (uint16_t)(captureData->sourceWidth > 0 ? captureData->sourceWidth : captureData->width),
+                             (uint16_t)(captureData->sourceHeight > 0 ? captureData->sourceHeight : captureData->height),
+                             (uint16_t)captureData->sourceX,
+                             (uint16_t)captureData->sourceY,
+                             (uint32_t)captureData->compressedSize,
+                             captureData->hasChanged ? WIRE_CAPTURE_FLAG_CHANGED : 0,
+                             (int8_t)captureData->monitorIndex,
+                             (uint8_t)captureData->codec,
+                             (uint8_t)captureData->layer,
+                             captureData->timestamp / 1000,
+                             (uint32_t)((captureData->encodeStartNs - captureData->timestamp) / 1000),
+                             (uint32_t)((captureData->encodeEndNs - captureData->timestamp) / 1000));
+    memcpy(metadata + WIRE_CAPTURE_METADATA_SIZE, captureData->compressedData, captureData->compressedSize);
     
+    // Le chiffrement éventuel est fait par SendPreparedPacket
     // Envoyer le paquet
+    uint64_t sendStart = StatsBegin();
     bool success = false;
+    int sentCount = 0;
     
     if (peerId < 0) {
-        // Envoi à tous les pairs connectés
+        // Envoi à tous les pairs connectés (l'en-tête est réécrit pour chaque pair). Tant qu'un autre pair
+        // suit, le texte clair doit rester intact : il est chiffré vers un second buffer, le dernier pair
+        // est chiffré en place
+        int remaining = 0;
+        for (int i = 0; i < peerCount; i++) {
+            if (connectedPeers[i].isConnected) remaining++;
+        }
+        
         bool allSuccess = true;
+        uint8_t* sealed = NULL;
         for (int i = 0; i < peerCount; i++) {
             if (connectedPeers[i].isConnected) {
-                if (!SendPacket(connectedPeers[i].id, PACKET_TYPE_CAPTURE, 
-                              buffer, totalSize, RNET_UNRELIABLE)) {
-                    printf("[ERROR] Échec de l'envoi au pair ID %d\n", connectedPeers[i].id);
+                remaining--;
+                if (remaining > 0 && encSession.isEncryptionEnabled && !sealed) {
+                    sealed = AllocPacket(payloadSize);
+                    if (!sealed) {
+                        LOG_ERROR(LOG_MODULE_NETWORK, "Échec d'allocation mémoire pour le chiffrement des données");
+                        allSuccess = false;
+                        break;
+                    }
+                }
+                
+                if (!SendPreparedPacket(connectedPeers[i].id, PACKET_TYPE_CAPTURE, packet,
+                                        remaining > 0 ? sealed : NULL, payloadSize, RNET_UNRELIABLE)) {
+                    LOG_ERROR(LOG_MODULE_NETWORK, "Échec de l'envoi au pair ID %d", connectedPeers[i].id);
                     allSuccess = false;
+                } else {
+                    sentCount++;
                 }
             }
         }
+        free(sealed);
         success = allSuccess;
     } else {
         // Envoi à un pair spécifique
-        success = SendPacket(peerId, PACKET_TYPE_CAPTURE, buffer, totalSize, RNET_UNRELIABLE);
+        success = SendPreparedPacket(peerId, PACKET_TYPE_CAPTURE, packet, NULL, payloadSize, RNET_UNRELIABLE);
+        sentCount = success ? 1 : 0;
     }
     
-    free(buffer);
+    StatsEndFrame(STAT_STAGE_SEND, sendStart, captureData->frameId);
+    StatsAddCounter(STAT_COUNTER_FRAMES_SENT, sentCount);
+    StatsAddCounter(STAT_COUNTER_BYTES_SENT, (uint64_t)sentCount * (WIRE_HEADER_SIZE + payloadSize));
+    
+    free(packet);
     return success;
 }
 
@@ -252,52 +351,95 @@ int ProcessNetworkEvents(void) {
     rnetPacket packet;
     int processedPackets = 0;
     
+    // Mesures de décalage d'horloge périodiques
+    SendClockPings(ClockNowNs());
+    
     // Traiter tous les paquets en attente
     while (rnetReceive(hostPeer, &packet)) {
         processedPackets++;
+        uint64_t receiveNs = ClockNowNs();
         
         // Obtenir le pair qui a envoyé le paquet
         rnetTargetPeer* sender = rnetGetLastEventPeer(hostPeer);
         
-        // Vérifier que le paquet a une taille minimale pour l'en-tête
-        if (packet.size < sizeof(PacketHeader)) {
-            printf("[ERROR] Paquet reçu trop petit pour contenir un en-tête\n");
+        // Connexion et déconnexion arrivent sans données
+        if (packet.event == RNET_EVENT_CONNECT) {
+            HandleConnectEvent(sender);
+            continue;
+        }
+        if (packet.event == RNET_EVENT_DISCONNECT) {
+            HandleDisconnectEvent(sender);
+            continue;
+        }
+        
+        // Valider l'en-tête sans copier le paquet
+        WirePacketView view;
+        WireResult result = WireParsePacket((const uint8_t*)packet.data, packet.size, &view);
+        if (result != WIRE_OK) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Paquet invalide (code %d, %zu octets)", result, packet.size);
+            StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
             rnetFreePacket(&packet);
             continue;
         }
         
-        // Extraire l'en-tête et les données
-        PacketHeader* header = (PacketHeader*)packet.data;
-        void* data = (uint8_t*)packet.data + sizeof(PacketHeader);
-        size_t dataSize = packet.size - sizeof(PacketHeader);
+        // Trouver l'ID du pair expéditeur
+        int senderIndex = FindPeerByTransport(sender);
+        int senderId = senderIndex >= 0 ? connectedPeers[senderIndex].id : -1;
         
-        // Vérifier la taille des données
-        if (dataSize < header->dataSize) {
-            printf("[ERROR] Taille des données inconsistante\n");
+        // Déchiffrer en place avec la clé de ce pair avant toute interprétation (séquence comprise)
+        if (WireHeaderFlags(view.header) & WIRE_FLAG_ENCRYPTED) {
+            if (!OpenEncryptedPacket(senderIndex, (uint8_t*)packet.data, &view)) {
+                LOG_ERROR(LOG_MODULE_NETWORK, "Paquet chiffré rejeté (clé absente ou authentification invalide)");
+                StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
+                rnetFreePacket(&packet);
+                continue;
+            }
+        } else if (encSession.isEncryptionEnabled && WireHeaderType(view.header) != PACKET_TYPE_HANDSHAKE) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Paquet non chiffré refusé: le chiffrement est activé");
+            StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
             rnetFreePacket(&packet);
             continue;
         }
         
-        // Trouver l'ID du pair expéditeur
-        int senderId = -1;
-        // TODO: Implémenter la recherche du pair basée sur sender
+        // Écarter les paquets plus anciens que le dernier reçu sur le même flux. Les images sont
+        // écartées par couche dans HandleCapturePacket : les deux couches partagent le flux de capture,
+        // une image de détail ne doit pas être perdue derrière une vue d'ensemble plus récente
+        if (senderIndex >= 0) {
+            PeerLink* link = &peerLinks[senderIndex];
+            uint8_t stream = WireHeaderStream(view.header);
+            uint32_t sequence = WireHeaderSequence(view.header);
+            
+            if (stream != PACKET_STREAM_CAPTURE && link->rxStarted[stream] &&
+                !WireSequenceNewer(sequence, link->rxSequence[stream])) {
+                StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
+                rnetFreePacket(&packet);
+                continue;
+            }
+            link->rxSequence[stream] = sequence;
+            link->rxStarted[stream] = true;
+            connectedPeers[senderIndex].lastPacketTime = receiveNs;
+        }
         
         // Traiter le paquet selon son type
-        switch (header->type) {
+        switch (WireHeaderType(view.header)) {
             case PACKET_TYPE_CAPTURE:
-                HandleCapturePacket(header, data, dataSize, senderId);
+                HandleCapturePacket(&view, senderId, receiveNs);
                 break;
                 
             case PACKET_TYPE_CONTROL:
-                HandleControlPacket(header, data, dataSize, senderId);
+                HandleControlPacket(&view, senderId, receiveNs);
                 break;
                 
             case PACKET_TYPE_HANDSHAKE:
-                HandleHandshakePacket(header, data, dataSize, senderId);
+                HandleHandshakePacket(&view, senderId);
                 break;
                 
+            case PACKET_TYPE_CURSOR:
+                HandleCursorPacket(&view, senderId, receiveNs);
+                break;
+            
             default:
-                printf("[ERROR] Type de paquet inconnu: %d\n", header->type);
+                LOG_ERROR(LOG_MODULE_NETWORK, "Type de paquet inconnu: %d", WireHeaderType(view.header));
                 break;
         }
         
@@ -307,54 +449,285 @@ int ProcessNetworkEvents(void) {
     return processedPackets;
 }
 
-bool EnableEncryption(const char* password) {
-    if (!password) return false;
+bool ReceiveCaptureData(CaptureData* captureData) {
+    if (!captureData) return false;
     
-    // Génération simple de clé à partir du mot de passe (à améliorer dans une version future)
-    memset(&encSession.key, 0, sizeof(encSession.key));
-    memset(&encSession.iv, 0, sizeof(encSession.iv));
+    // Une couche à la fois, la zone entière d'abord : la région se dessine par-dessus.
+    // Transfert de propriété des données compressées à l'appelant
+    uint64_t now = ClockNowNs();
+    for (int layer = 0; layer < CAPTURE_LAYER_COUNT; layer++) {
+        if (JitterPop(&receivedFrames[layer], playoutPolicy, now, captureData)) return true;
+    }
+    return false;
+}
+
+void SetPlayoutPolicy(PlayoutPolicy policy) {
+    if ((unsigned)policy >= PLAYOUT_POLICY_COUNT || policy == playoutPolicy) return;
+    
+    playoutPolicy = policy;
+    LOG_INFO(LOG_MODULE_NETWORK, "Présentation des images reçues : %s",
+             policy == PLAYOUT_POLICY_SMOOTH ? "fluidité" : "latence minimale");
+}
+
+PlayoutPolicy GetPlayoutPolicy(void) {
+    return playoutPolicy;
+}
+
+uint64_t GetPlayoutDelayNs(uint64_t* jitterNs) {
+    const JitterBuffer* buffer = &receivedFrames[CAPTURE_LAYER_FULL];
+    if (jitterNs) *jitterNs = buffer->jitterNs;
+    return JitterPlayoutDelayNs(buffer);
+}
+
+uint32_t GetAcknowledgedFrame(int peerId, uint32_t canvasId) {
+    if (canvasId == 0) return 0;
+    
+    // Plusieurs destinataires : la référence doit être connue de tous, on prend la plus ancienne
+    uint32_t oldest = 0;
+    bool found = false;
+    for (int i = 0; i < peerCount; i++) {
+        if (!connectedPeers[i].isConnected || (peerId >= 0 && connectedPeers[i].id != peerId)) continue;
+        
+        const LayerAck* ack = FindLayerAck(&peerLinks[i], canvasId);
+        if (!ack) return 0;
+        if (!found || WireSequenceNewer(oldest, ack->ackedFrameId)) oldest = ack->ackedFrameId;
+        found = true;
+    }
+    return found ? oldest : 0;
+}
+
+uint64_t GetAppliedFrames(int peerId, uint32_t canvasId, uint32_t baseFrameId) {
+    if (canvasId == 0 || baseFrameId == 0) return 0;
     
-    size_t pwdLen = strlen(password);
-    for (size_t i = 0; i < pwdLen && i < sizeof(encSession.key); i++) {
-        encSession.key[i] = password[i];
+    // Intersection des masques de chaque destinataire, ramenés à l'image de référence
+    uint64_t applied = ~0ULL;
+    bool found = false;
+    for (int i = 0; i < peerCount; i++) {
+        if (!connectedPeers[i].isConnected || (peerId >= 0 && connectedPeers[i].id != peerId)) continue;
+        
+        const LayerAck* ack = FindLayerAck(&peerLinks[i], canvasId);
+        if (!ack) return 0;
+        if (WireSequenceNewer(baseFrameId, ack->ackedFrameId)) return 0;
+        
+        uint32_t lead = ack->ackedFrameId - baseFrameId;
+        applied &= lead < 64 ? ack->appliedFrames >> lead : 0;
+        found = true;
+    }
+    return found ? applied : 0;
+}
+
+uint32_t GetPeerCodecSupport(int peerId) {
+    // Plusieurs destinataires : seuls les codecs que tous décodent
+    uint32_t support = ~0u;
+    bool found = false;
+    for (int i = 0; i < peerCount; i++) {
+        if (!connectedPeers[i].isConnected || (peerId >= 0 && connectedPeers[i].id != peerId)) continue;
+        support &= peerLinks[i].codecSupport;
+        found = true;
     }
+    return found ? support : 0;
+}
+
+bool GetPeerViewport(int peerId, ViewerViewport* viewport) {
+    if (!viewport) return false;
     
-    // Initialiser le vecteur d'initialisation avec une valeur temporelle
-    uint64_t timestamp = time(NULL);
-    memcpy(encSession.iv, &timestamp, sizeof(timestamp));
+    // Plusieurs destinataires : un seul flux est codé pour tous, donc la plus grande fenêtre et
+    // l'union des régions ; la zone entière si l'un d'eux n'a pas zoomé
+    ViewerViewport merged = {0};
+    bool found = false;
+    bool wholeArea = false;
+    for (int i = 0; i < peerCount; i++) {
+        if (!connectedPeers[i].isConnected || (peerId >= 0 && connectedPeers[i].id != peerId)) continue;
+        
+        const ViewerViewport* peer = &peerLinks[i].viewport;
+        if (peer->width <= 0 || peer->height <= 0) return false;
+        if (peer->width > merged.width) merged.width = peer->width;
+        if (peer->height > merged.height) merged.height = peer->height;
+        
+        if (peer->regionWidth <= 0 || peer->regionHeight <= 0) {
+            wholeArea = true;
+        } else if (!found || merged.regionWidth == 0) {
+            merged.regionX = peer->regionX;
+            merged.regionY = peer->regionY;
+            merged.regionWidth = peer->regionWidth;
+            merged.regionHeight = peer->regionHeight;
+        } else {
+            int right = merged.regionX + merged.regionWidth;
+            int bottom = merged.regionY + merged.regionHeight;
+            if (peer->regionX + peer->regionWidth > right) right = peer->regionX + peer->regionWidth;
+            if (peer->regionY + peer->regionHeight > bottom) bottom = peer->regionY + peer->regionHeight;
+            if (peer->regionX < merged.regionX) merged.regionX = peer->regionX;
+            if (peer->regionY < merged.regionY) merged.regionY = peer->regionY;
+            merged.regionWidth = right - merged.regionX;
+            merged.regionHeight = bottom - merged.regionY;
+        }
+        found = true;
+    }
+    if (!found) return false;
     
-    encSession.isEncryptionEnabled = true;
-    printf("[INFO] Chiffrement activé\n");
+    if (wholeArea) {
+        merged.regionX = merged.regionY = merged.regionWidth = merged.regionHeight = 0;
+    }
+    *viewport = merged;
     return true;
 }
 
-void DisableEncryption(void) {
-    memset(&encSession.key, 0, sizeof(encSession.key));
-    memset(&encSession.iv, 0, sizeof(encSession.iv));
-    encSession.isEncryptionEnabled = false;
-    printf("[INFO] Chiffrement désactivé\n");
+bool SetViewerViewport(const ViewerViewport* viewport) {
+    if (!viewport) return false;
+    
+    ViewerViewport clamped = {
+        ClampU16(viewport->width), ClampU16(viewport->height),
+        ClampU16(viewport->regionX), ClampU16(viewport->regionY),
+        ClampU16(viewport->regionWidth), ClampU16(viewport->regionHeight)
+    };
+    if (memcmp(&clamped, &localViewport, sizeof(clamped)) == 0) return true;
+    localViewport = clamped;
+    
+    // Envoyé maintenant aux pairs prêts, à l'établissement de la liaison pour les autres
+    bool success = true;
+    for (int i = 0; i < peerCount; i++) {
+        peerLinks[i].viewportSent = false;
+        if (!connectedPeers[i].isConnected || !peerLinks[i].transport || peerLinks[i].handshakePending) continue;
+        if (encSession.isEncryptionEnabled && !peerLinks[i].handshake.keys.isEstablished) continue;
+        
+        SendViewport(i);
+        if (!peerLinks[i].viewportSent) success = false;
+    }
+    return success;
 }
 
-bool EncryptCaptureData(CaptureData* captureData) {
-    if (!captureData || !encSession.isEncryptionEnabled) return false;
+bool AcknowledgeCaptureFrame(int peerId, CaptureLayer layer, uint32_t canvasId, uint32_t frameId) {
+    int index = FindPeerById(peerId);
+    if (index < 0 || (unsigned)layer >= CAPTURE_LAYER_COUNT) return false;
     
-    // TODO: Implémenter le chiffrement des données
-    // Dans cette étape, nous nous concentrons sur la connexion P2P de base
-    // Le chiffrement sera implémenté dans une version future
+    // Seule la zone entière est annoncée à la reconnexion : la région dépend du zoom du moment
+    if (canvasId != 0 && layer == CAPTURE_LAYER_FULL) {
+        appliedCanvasId = canvasId;
+        appliedFrameId = frameId;
+    }
     
+    // Un acquittement perdu est remplacé par le suivant ; une demande d'image complète aussi
+    uint8_t ack[WIRE_FRAME_ACK_SIZE];
+    WireWriteFrameAck(ack, (uint8_t)layer, canvasId, frameId);
+    return SendPacket(peerId, PACKET_TYPE_CONTROL, ack, sizeof(ack), RNET_UNRELIABLE);
+}
+
+bool SendCursorState(int peerId, const CursorState* state) {
+    if (!networkInitialized || !hostPeer || !state) return false;
+    
+    // Position bornée au format réseau ; un curseur loin de la zone capturée n'est pas dessiné de toute façon
+    int x = state->x < INT16_MIN ? INT16_MIN : (state->x > INT16_MAX ? INT16_MAX : state->x);
+    int y = state->y < INT16_MIN ? INT16_MIN : (state->y > INT16_MAX ? INT16_MAX : state->y);
+    uint8_t position[WIRE_CURSOR_POSITION_SIZE];
+    WireWriteCursorPosition(position, state->visible ? WIRE_CURSOR_FLAG_VISIBLE : 0,
+                            (int16_t)x, (int16_t)y, state->shapeId);
+    
+    // Flux propre et sans garantie : seule la position la plus récente est utile
+    bool success = true;
+    int sentCount = 0;
+    for (int i = 0; i < peerCount; i++) {
+        if (!connectedPeers[i].isConnected || (peerId >= 0 && connectedPeers[i].id != peerId)) continue;
+        
+        if (SendPacket(connectedPeers[i].id, PACKET_TYPE_CURSOR, position, sizeof(position), RNET_UNRELIABLE)) {
+            sentCount++;
+        } else {
+            success = false;
+        }
+    }
+    
+    StatsAddCounter(STAT_COUNTER_CURSOR_BYTES_SENT, (uint64_t)sentCount * (WIRE_HEADER_SIZE + sizeof(position)));
+    return success && sentCount > 0;
+}
+
+bool SendCursorShape(int peerId, const CursorShape* shape) {
+    if (!networkInitialized || !hostPeer || !shape || !shape->pixels) return false;
+    
+    uint32_t pixelSize = (uint32_t)shape->width * shape->height * 4;
+    uint32_t size = WIRE_CURSOR_SHAPE_SIZE + pixelSize;
+    uint8_t* message = (uint8_t*)malloc(size);
+    if (!message) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec d'allocation mémoire pour la forme du curseur");
+        return false;
+    }
+    WireWriteCursorShape(message, shape->shapeId, (uint16_t)shape->width, (uint16_t)shape->height,
+                         (uint16_t)shape->hotspotX, (uint16_t)shape->hotspotY);
+    memcpy(message + WIRE_CURSOR_SHAPE_SIZE, shape->pixels, pixelSize);
+    
+    // Fiable : une forme n'est envoyée qu'à chaque changement
+    bool success = true;
+    int sentCount = 0;
+    for (int i = 0; i < peerCount; i++) {
+        if (!connectedPeers[i].isConnected || (peerId >= 0 && connectedPeers[i].id != peerId)) continue;
+        
+        if (SendPacket(connectedPeers[i].id, PACKET_TYPE_CONTROL, message, size, RNET_RELIABLE)) {
+            sentCount++;
+        } else {
+            success = false;
+        }
+    }
+    
+    free(message);
+    StatsAddCounter(STAT_COUNTER_CURSOR_BYTES_SENT, (uint64_t)sentCount * (WIRE_HEADER_SIZE + size));
+    return success && sentCount > 0;
+}
+
+bool ReceiveCursorState(CursorState* state) {
+    if (!state || !hasReceivedCursor) return false;
+    
+    *state = receivedCursor;
+    hasReceivedCursor = false;
     return true;
 }
 
-bool DecryptCaptureData(CaptureData* captureData) {
-    if (!captureData || !encSession.isEncryptionEnabled) return false;
+bool GetPeerClockOffset(int peerId, int64_t* offsetNs, uint64_t* rttNs) {
+    int index = FindPeerById(peerId);
+    if (index < 0 || !peerLinks[index].clock.isValid) return false;
+    
+    if (offsetNs) *offsetNs = peerLinks[index].clock.bestOffsetNs;
+    if (rttNs) *rttNs = peerLinks[index].clock.bestRttNs;
+    return true;
+}
+
+bool EnableEncryption(const char* password) {
+    if (!password) return false;
+    
+    // Clé pré-partagée : PBKDF2 n'est recalculé que si le mot de passe change
+    uint8_t psk[HANDSHAKE_PSK_SIZE];
+    HandshakeDerivePsk(password, psk);
+    bool pskChanged = !encSession.isEncryptionEnabled || memcmp(psk, encSession.psk, sizeof(psk)) != 0;
+    memcpy(encSession.psk, psk, sizeof(psk));
+    CryptoWipe(psk, sizeof(psk));
+    encSession.isEncryptionEnabled = true;
     
-    // TODO: Implémenter le déchiffrement des données
-    // Dans cette étape, nous nous concentrons sur la connexion P2P de base
-    // Le déchiffrement sera implémenté dans une version future
+    // Échange de clés avec les pairs déjà connectés ; les autres l'effectueront à la connexion
+    for (int i = 0; i < peerCount; i++) {
+        PeerLink* link = &peerLinks[i];
+        if (pskChanged) HandshakeReset(&link->handshake);
+        if (!connectedPeers[i].isConnected || !link->transport || link->handshakePending) continue;
+        if (link->handshake.mode == HANDSHAKE_MODE_NONE) SendHandshake(i);
+    }
     
+    LOG_INFO(LOG_MODULE_NETWORK, "Chiffrement activé");
     return true;
 }
 
+void DisableEncryption(void) {
+    CryptoWipe(&encSession, sizeof(encSession));
+    for (int i = 0; i < peerCount; i++) {
+        HandshakeReset(&peerLinks[i].handshake);
+    }
+    encSession.isEncryptionEnabled = false;
+    LOG_INFO(LOG_MODULE_NETWORK, "Chiffrement désactivé");
+}
+
+const char* GetPeerCipherName(int peerId) {
+    int index = FindPeerById(peerId);
+    if (!encSession.isEncryptionEnabled || index < 0 || !peerLinks[index].handshake.keys.isEstablished) {
+        return AeadAlgorithmName(AEAD_ALGORITHM_NONE);
+    }
+    return AeadAlgorithmName(peerLinks[index].handshake.keys.algorithm);
+}
+
 // Implémentation des fonctions utilitaires privées
 static int FindPeerById(int id) {
     for (int i = 0; i < peerCount; i++) {
@@ -374,6 +747,17 @@ static int FindPeerByAddress(const char* address, int port) {
     return -1;
 }
 
+static int FindPeerByTransport(rnetTargetPeer* transport) {
+    if (!transport) return -1;
+    
+    for (int i = 0; i < peerCount; i++) {
+        if (peerLinks[i].transport == transport) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 static int AddPeer(const char* address, int port) {
     if (peerCount >= MAX_PEERS) {
         return -1;
@@ -381,7 +765,7 @@ static int AddPeer(const char* address, int port) {
     
     int index = peerCount++;
     connectedPeers[index].id = index + 1; // IDs commencent à 1
-    strncpy(connectedPeers[index].address, address, sizeof(connectedPeers[index].address) - 1);
+    snprintf(connectedPeers[index].address, sizeof(connectedPeers[index].address), "%s", address);
     connectedPeers[index].port = port;
     connectedPeers[index].isConnected = false;
     connectedPeers[index].lastPacketTime = 0;
@@ -393,79 +777,851 @@ static void UpdatePeerStatus(int index, bool isConnected) {
     if (index >= 0 && index < peerCount) {
         connectedPeers[index].isConnected = isConnected;
         if (isConnected) {
-            connectedPeers[index].lastPacketTime = time(NULL);
+            connectedPeers[index].lastPacketTime = ClockNowNs();
         }
     }
 }
 
-static bool SendPacket(int peerId, uint8_t type, const void* data, uint32_t size, int flags) {
+static uint8_t* AllocPacket(uint32_t payloadSize) {
+    // Réserve la place de l'en-tête et du nonce devant les données, du tag derrière
+    return (uint8_t*)malloc(PACKET_HEADROOM + payloadSize + PACKET_TAILROOM);
+}
+
+static PacketStream StreamForType(uint8_t type) {
+    switch (type) {
+        case PACKET_TYPE_CAPTURE: return PACKET_STREAM_CAPTURE;
+        case PACKET_TYPE_HANDSHAKE: return PACKET_STREAM_HANDSHAKE;
+        case PACKET_TYPE_CURSOR: return PACKET_STREAM_CURSOR;
+        default: return PACKET_STREAM_CONTROL;
+    }
+}
+
+static bool SendPreparedPacket(int peerId, uint8_t type, uint8_t* packet, uint8_t* sealed, uint32_t payloadSize, int flags) {
     if (!networkInitialized || !hostPeer) return false;
     
     int index = FindPeerById(peerId);
     if (index < 0) {
-        printf("[ERROR] Pair avec ID %d non trouvé\n", peerId);
+        LOG_ERROR(LOG_MODULE_NETWORK, "Pair avec ID %d non trouvé", peerId);
         return false;
     }
     
-    // Créer l'en-tête
-    PacketHeader header = {
-        .type = type,
-        .flags = 0,
-        .sequence = nextSequence++,
-        .timestamp = (uint32_t)time(NULL),
-        .dataSize = size
-    };
+    PeerLink* link = &peerLinks[index];
+    if (!link->transport) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Aucun transport pour le pair ID %d", peerId);
+        return false;
+    }
+    
+    PacketStream stream = StreamForType(type);
+    uint8_t* payload = PACKET_PAYLOAD(packet);
+    
+    // Le handshake reste en clair : il annonce les algorithmes supportés
+    if (!encSession.isEncryptionEnabled || type == PACKET_TYPE_HANDSHAKE) {
+        uint8_t* header = payload - WIRE_HEADER_SIZE;
+        WireWriteHeader(header, type, 0, (uint8_t)stream,
+                        link->txSequence[stream]++,
+                        ClockNowUs(),
+                        payloadSize);
+        return rnetSendToPeer(hostPeer, link->transport, header, WIRE_HEADER_SIZE + payloadSize, flags);
+    }
     
-    // Allouer un buffer pour l'en-tête + données
-    size_t totalSize = sizeof(header) + size;
-    uint8_t* buffer = (uint8_t*)malloc(totalSize);
-    if (!buffer) {
-        printf("[ERROR] Échec d'allocation mémoire pour l'envoi de paquet\n");
+    // Pas de clé de session tant que l'échange de clés avec ce pair n'a pas abouti
+    SessionKeys* keys = &link->handshake.keys;
+    if (!keys->isEstablished) {
+        LOG_DEBUG(LOG_MODULE_NETWORK, "Échange de clés en cours avec le pair %d, paquet non envoyé", peerId);
         return false;
     }
     
-    // Copier l'en-tête et les données
-    memcpy(buffer, &header, sizeof(header));
-    memcpy(buffer + sizeof(header), data, size);
+    // Chiffrement avec la clé de ce sens, en place ou vers sealed (même disposition) si le texte clair doit
+    // rester intact ; l'en-tête complet sert de données associées authentifiées
+    uint8_t* out = sealed ? sealed : packet;
+    uint8_t* cipher = PACKET_PAYLOAD(out);
+    uint8_t* nonce = out + WIRE_HEADER_SIZE;
+    WireWriteHeader(out, type, WIRE_FLAG_ENCRYPTED | (uint8_t)(keys->algorithm << WIRE_FLAG_AEAD_SHIFT),
+                    (uint8_t)stream,
+                    link->txSequence[stream]++,
+                    ClockNowUs(),
+                    payloadSize + WIRE_AEAD_OVERHEAD);
     
-    // Envoyer le paquet
-    bool success = rnetSend(hostPeer, buffer, totalSize, flags);
+    // Nonce = préfixe propre au sens (4 octets) | compteur de paquets (8 octets)
+    memcpy(nonce, keys->txNoncePrefix, sizeof(keys->txNoncePrefix));
+    WireWriteU64(nonce + sizeof(keys->txNoncePrefix), keys->txNonceCounter++);
+    
+    AeadSealTo(&keys->txContext, nonce, out, WIRE_HEADER_SIZE,
+               payload, cipher, payloadSize, cipher + payloadSize);
+    
+    return rnetSendToPeer(hostPeer, link->transport, out,
+                          WIRE_HEADER_SIZE + WIRE_AEAD_OVERHEAD + payloadSize, flags);
+}
+
+static bool OpenEncryptedPacket(int senderIndex, uint8_t* data, WirePacketView* view) {
+    if (!encSession.isEncryptionEnabled || senderIndex < 0 || view->payloadSize < WIRE_AEAD_OVERHEAD) return false;
+    
+    const SessionKeys* keys = &peerLinks[senderIndex].handshake.keys;
+    uint8_t algorithm = (WireHeaderFlags(view->header) & WIRE_FLAG_AEAD_MASK) >> WIRE_FLAG_AEAD_SHIFT;
+    if (!keys->isEstablished || algorithm != keys->algorithm) return false;
+    
+    // Le paquet ENet reçu nous appartient jusqu'à rnetFreePacket : déchiffrement en place, sans copie
+    uint8_t* nonce = data + WIRE_HEADER_SIZE;
+    uint8_t* cipher = nonce + WIRE_AEAD_NONCE_SIZE;
+    uint32_t cipherSize = view->payloadSize - WIRE_AEAD_OVERHEAD;
+    if (!AeadOpen(&keys->rxContext, nonce, data, WIRE_HEADER_SIZE,
+                  cipher, cipherSize, cipher + cipherSize)) {
+        return false;
+    }
+    
+    view->payload = cipher;
+    view->payloadSize = cipherSize;
+    return true;
+}
+
+static bool SendPacket(int peerId, uint8_t type, const void* data, uint32_t size, int flags) {
+    uint8_t* packet = AllocPacket(size);
+    if (!packet) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec d'allocation mémoire pour l'envoi de paquet");
+        return false;
+    }
+    
+    memcpy(PACKET_PAYLOAD(packet), data, size);
+    bool success = SendPreparedPacket(peerId, type, packet, NULL, size, flags);
     
-    free(buffer);
+    free(packet);
     return success;
 }
 
-static void HandleCapturePacket(const PacketHeader* header, const void* data, size_t size, int senderId) {
-    printf("[INFO] Paquet de capture reçu du pair %d\n", senderId);
+// Nouveau transport : les séquences de chaque flux repartent de zéro, les clés sont renégociées
+static void ResetPeerLink(int index, rnetTargetPeer* transport) {
+    // Un transport ne sert qu'à un pair : une entrée qui le détient encore appartient à une connexion terminée
+    for (int i = 0; i < peerCount; i++) {
+        if (i != index && transport && peerLinks[i].transport == transport) {
+            peerLinks[i].transport = NULL;
+            UpdatePeerStatus(i, false);
+        }
+    }
     
-    // TODO: Implémenter le traitement des paquets de capture
-    // Cette fonction sera complétée dans la phase d'intégration avec main.c
+    HandshakeReset(&peerLinks[index].handshake);
+    memset(&peerLinks[index], 0, sizeof(PeerLink));
+    peerLinks[index].transport = transport;
+    peerLinks[index].aeadAlgorithm = AEAD_ALGORITHM_CHACHA20_POLY1305;
 }
 
-static void HandleControlPacket(const PacketHeader* header, const void* data, size_t size, int senderId) {
-    printf("[INFO] Paquet de contrôle reçu du pair %d\n", senderId);
+static void HandleConnectEvent(rnetTargetPeer* sender) {
+    int index = FindPeerByTransport(sender);
     
-    // TODO: Implémenter le traitement des paquets de contrôle
-    // Cette fonction sera complétée dans la phase d'intégration avec main.c
+    // Connexion sortante établie : envoyer le handshake en attente
+    if (index >= 0 && peerLinks[index].handshakePending) {
+        UpdatePeerStatus(index, true);
+        peerLinks[index].handshakePending = false;
+        SendHandshake(index);
+        return;
+    }
+    
+    // Connexion entrante : enregistrer le pair à partir de son adresse. ENet réutilise ses pairs après
+    // une déconnexion, un transport déjà connu ne dit donc rien de l'état de la nouvelle connexion
+    char address[64] = {0};
+    uint16_t port = 0;
+    if (!rnetGetPeerAddress(sender, address, sizeof(address), &port)) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Adresse du pair entrant illisible");
+        return;
+    }
+    
+    index = FindPeerByAddress(address, port);
+    if (index < 0) index = AddPeer(address, port);
+    if (index < 0) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Impossible d'ajouter le pair entrant %s:%d, limite atteinte", address, port);
+        return;
+    }
+    
+    ResetPeerLink(index, sender);
+    UpdatePeerStatus(index, true);
+    LOG_INFO(LOG_MODULE_NETWORK, "Connexion entrante de %s:%d (ID %d)", address, port, connectedPeers[index].id);
+}
+
+static void HandleDisconnectEvent(rnetTargetPeer* sender) {
+    int index = FindPeerByTransport(sender);
+    if (index < 0) return;
+    
+    // Le transport sera réattribué par ENet : plus rien n'y est envoyé. Les clés de session sont
+    // effacées, une reprise passe par le cache de sessions
+    HandshakeReset(&peerLinks[index].handshake);
+    peerLinks[index].transport = NULL;
+    peerLinks[index].handshakePending = false;
+    UpdatePeerStatus(index, false);
+    LOG_INFO(LOG_MODULE_NETWORK, "Pair %s:%d déconnecté (ID %d)",
+                                 connectedPeers[index].address, connectedPeers[index].port, connectedPeers[index].id);
+}
+
+static void SendHandshake(int index) {
+    uint8_t message[WIRE_HANDSHAKE_SIZE + WIRE_KEY_SHARE_SIZE];
+    uint32_t size = WIRE_HANDSHAKE_SIZE;
+    WireWriteHandshake(message, (uint8_t)localAeadSupport, (uint8_t)CodecSupportedCodecs());
+    
+    // Chiffrement activé : le handshake porte aussi notre part d'échange de clés
+    if (encSession.isEncryptionEnabled) {
+        HandshakeState* handshake = &peerLinks[index].handshake;
+        if (handshake->mode == HANDSHAKE_MODE_NONE &&
+            !HandshakeBegin(handshake, connectedPeers[index].address, connectedPeers[index].port)) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Source d'aléa du système indisponible");
+            return;
+        }
+        HandshakeWriteKeyShare(handshake, encSession.psk, message);
+        size += WIRE_KEY_SHARE_SIZE;
+    }
+    
+    if (!SendPacket(connectedPeers[index].id, PACKET_TYPE_HANDSHAKE, message, size, RNET_RELIABLE)) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec de l'envoi du handshake au pair %d", connectedPeers[index].id);
+        return;
+    }
+    peerLinks[index].handshakeSent = true;
+}
+
+static void SendClockPings(uint64_t now) {
+    for (int i = 0; i < peerCount; i++) {
+        PeerLink* link = &peerLinks[i];
+        if (!connectedPeers[i].isConnected || !link->transport || link->handshakePending) continue;
+        if (now - link->lastPingNs < CLOCK_SYNC_INTERVAL_NS) continue;
+        
+        uint8_t ping[WIRE_CLOCK_SYNC_SIZE];
+        WireWriteClockSync(ping, CONTROL_TYPE_PING, now / 1000, 0, 0);
+        SendPacket(connectedPeers[i].id, PACKET_TYPE_CONTROL, ping, sizeof(ping), RNET_UNRELIABLE);
+        link->lastPingNs = now;
+    }
+}
+
+// Retient frameId comme dernière image de la couche s'il est plus récent que la précédente
+static bool AcceptFrameId(PeerLink* link, CaptureLayer layer, uint32_t frameId) {
+    if (link->rxFrameStarted[layer] && !WireSequenceNewer(frameId, link->rxFrameId[layer])) return false;
+    link->rxFrameId[layer] = frameId;
+    link->rxFrameStarted[layer] = true;
+    return true;
+}
+
+// Nouvelle session du pair : ses identifiants d'images repartent de zéro
+static void ResetReceivedFrames(PeerLink* link) {
+    memset(link->rxFrameId, 0, sizeof(link->rxFrameId));
+    memset(link->rxFrameStarted, 0, sizeof(link->rxFrameStarted));
+}
+
+static void HandleCapturePacket(const WirePacketView* packet, int senderId, uint64_t receiveNs) {
+    const uint8_t* metadata = packet->payload;
+    if (!WireCaptureValidate(metadata, packet->payloadSize)) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Métadonnées de capture invalides du pair %d", senderId);
+        StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
+        return;
+    }
+    
+    // En-tête propre au codec (indices des tuiles, tailles des tranches) complet avant toute copie
+    uint32_t dataSize = WireCaptureDataSize(metadata);
+    const uint8_t* frame = metadata + WIRE_CAPTURE_METADATA_SIZE;
+    const Codec* codec = CodecGet(WireCaptureCodec(metadata));
+    CodecFrameInfo info;
+    if (WireCaptureLayer(metadata) >= CAPTURE_LAYER_COUNT || !codec || !codec->parseFrame(frame, dataSize, &info)) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Image invalide ou codec %u inconnu du pair %d", WireCaptureCodec(metadata), senderId);
+        StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
+        return;
+    }
+    
+    // Image plus ancienne que la dernière acceptée sur la couche (tous flux et codecs confondus : les
+    // identifiants d'images de l'émetteur ne font que croître) : écartée avant la copie et le décodage,
+    // elle remplacerait à l'écran une image plus récente
+    CaptureLayer layer = (CaptureLayer)WireCaptureLayer(metadata);
+    uint32_t frameId = WireCaptureFrameId(metadata);
+    int index = FindPeerById(senderId);
+    if (index >= 0) {
+        PeerLink* link = &peerLinks[index];
+        if (!AcceptFrameId(link, layer, frameId)) {
+            LOG_DEBUG(LOG_MODULE_NETWORK, "Image %u du pair %d écartée: image %u déjà reçue",
+                      frameId, senderId, link->rxFrameId[layer]);
+            StatsAddCounter(STAT_COUNTER_FRAMES_STALE, 1);
+            return;
+        }
+    }
+    
+    unsigned char* data = (unsigned char*)malloc(dataSize);
+    if (!data) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Échec d'allocation mémoire pour l'image reçue");
+        return;
+    }
+    memcpy(data, frame, dataSize);
+    
+    CaptureData received = {0};
+    received.compressedData = data;
+    received.compressedSize = (int)dataSize;
+    received.isCompressed = true;
+    received.width = WireCaptureWidth(metadata);
+    received.height = WireCaptureHeight(metadata);
+    received.sourceWidth = WireCaptureSourceWidth(metadata);
+    received.sourceHeight = WireCaptureSourceHeight(metadata);
+    received.sourceX = WireCaptureSourceX(metadata);
+    received.sourceY = WireCaptureSourceY(metadata);
+    received.layer = layer;
+    received.hasChanged = (WireCaptureFlags(metadata) & WIRE_CAPTURE_FLAG_CHANGED) != 0;
+    received.monitorIndex = WireCaptureMonitorIndex(metadata);
+    received.frameId = frameId;
+    received.sourcePeerId = senderId;
+    received.codec = codec->id;
+    received.canvasId = info.streamId;
+    received.baseFrameId = info.baseFrameId;
+    received.tileCount = info.tileCount;
+    received.receiveNs = receiveNs;
+    
+    // Horodatages de l'émetteur ramenés dans notre horloge si le décalage est connu
+    if (index >= 0 && peerLinks[index].clock.isValid) {
+        const ClockOffsetEstimator* clock = &peerLinks[index].clock;
+        received.timestamp = ClockRemoteToLocalNs(clock, WireCaptureTimestampUs(metadata) * 1000);
+        received.encodeStartNs = received.timestamp + (uint64_t)WireCaptureEncodeStartUs(metadata) * 1000;
+        received.encodeEndNs = received.timestamp + (uint64_t)WireCaptureEncodeEndUs(metadata) * 1000;
+        received.sendNs = ClockRemoteToLocalNs(clock, WireHeaderTimestampUs(packet->header) * 1000);
+    }
+    
+    // Affichage selon la politique de présentation (ReceiveCaptureData)
+    JitterPush(&receivedFrames[layer], &received, playoutPolicy);
+    
+    StatsEndFrame(STAT_STAGE_RECEIVE, receiveNs, received.frameId);
+    StatsAddCounter(STAT_COUNTER_FRAMES_RECEIVED, 1);
+    StatsAddCounter(STAT_COUNTER_BYTES_RECEIVED, WIRE_HEADER_SIZE + packet->payloadSize);
+}
+
+static void HandleControlPacket(const WirePacketView* packet, int senderId, uint64_t receiveNs) {
+    if (packet->payloadSize < 1) return;
+    
+    const uint8_t* control = packet->payload;
+    switch (WireControlType(control)) {
+        case CONTROL_TYPE_PING: {
+            if (packet->payloadSize < WIRE_CLOCK_SYNC_SIZE) break;
+            
+            // Renvoyer t0 avec nos horodatages de réception et d'envoi
+            uint8_t pong[WIRE_CLOCK_SYNC_SIZE];
+            WireWriteClockSync(pong, CONTROL_TYPE_PONG, WireClockSyncT0(control), receiveNs / 1000, ClockNowUs());
+            SendPacket(senderId, PACKET_TYPE_CONTROL, pong, sizeof(pong), RNET_UNRELIABLE);
+            break;
+        }
+            
+        case CONTROL_TYPE_PONG: {
+            int index = FindPeerById(senderId);
+            if (index < 0 || packet->payloadSize < WIRE_CLOCK_SYNC_SIZE) break;
+            
+            ClockOffsetAddSample(&peerLinks[index].clock,
+                                 WireClockSyncT0(control) * 1000,
+                                 WireClockSyncT1(control) * 1000,
+                                 WireClockSyncT2(control) * 1000,
+                                 receiveNs);
+            break;
+        }
+            
+        case CONTROL_TYPE_FRAME_ACK: {
+            int index = FindPeerById(senderId);
+            if (index < 0 || packet->payloadSize < WIRE_FRAME_ACK_SIZE) break;
+            
+            uint8_t layer = WireFrameAckLayer(control);
+            if (layer >= CAPTURE_LAYER_COUNT) break;
+            
+            LayerAck* ack = &peerLinks[index].acks[layer];
+            uint32_t canvasId = WireFrameAckCanvasId(control);
+            uint32_t frameId = WireFrameAckFrameId(control);
+            
+            // Un acquittement plus ancien que celui retenu (arrivé dans le désordre) complète seulement
+            // le masque des images appliquées
+            if (canvasId != 0 && ack->hasFrameAck && canvasId == ack->ackedCanvasId &&
+                !WireSequenceNewer(frameId, ack->ackedFrameId)) {
+                uint32_t age = ack->ackedFrameId - frameId;
+                if (age < 64) ack->appliedFrames |= 1ULL << age;
+                break;
+            }
+            SetFrameAck(index, (CaptureLayer)layer, canvasId, frameId);
+            break;
+        }
+            
+        case CONTROL_TYPE_CURSOR_SHAPE: {
+            if (!WireCursorShapeValidate(control, packet->payloadSize)) {
+                LOG_ERROR(LOG_MODULE_NETWORK, "Forme de curseur invalide du pair %d", senderId);
+                break;
+            }
+            
+            CursorShape shape = {0};
+            shape.shapeId = WireCursorShapeId(control);
+            shape.width = WireCursorShapeWidth(control);
+            shape.height = WireCursorShapeHeight(control);
+            shape.hotspotX = WireCursorShapeHotspotX(control);
+            shape.hotspotY = WireCursorShapeHotspotY(control);
+            shape.pixels = (uint8_t*)control + WIRE_CURSOR_SHAPE_SIZE;
+            
+            // L'empreinte est recalculée : une forme ne peut pas en remplacer une autre dans le cache
+            if (CursorShapeHash(&shape) != shape.shapeId || !CursorCacheStore(&shape)) {
+                LOG_ERROR(LOG_MODULE_NETWORK, "Forme de curseur %08x du pair %d refusée", shape.shapeId, senderId);
+            }
+            break;
+        }
+        
+        case CONTROL_TYPE_VIEWPORT: {
+            int index = FindPeerById(senderId);
+            if (index < 0 || packet->payloadSize < WIRE_VIEWPORT_SIZE) break;
+            
+            ViewerViewport* viewport = &peerLinks[index].viewport;
+            viewport->width = WireViewportWidth(control);
+            viewport->height = WireViewportHeight(control);
+            viewport->regionX = WireViewportRegionX(control);
+            viewport->regionY = WireViewportRegionY(control);
+            viewport->regionWidth = WireViewportRegionWidth(control);
+            viewport->regionHeight = WireViewportRegionHeight(control);
+            LOG_DEBUG(LOG_MODULE_NETWORK, "Affichage du pair %d: %dx%d, région %dx%d en (%d, %d)", senderId,
+                                          viewport->width, viewport->height, viewport->regionWidth,
+                                          viewport->regionHeight, viewport->regionX, viewport->regionY);
+            break;
+        }
+        
+        case CONTROL_TYPE_CURSOR_REQUEST: {
+            if (packet->payloadSize < WIRE_CURSOR_REQUEST_SIZE) break;
+            
+            // Seule la forme courante est conservée : une demande plus ancienne est sans objet
+            const CursorShape* shape = GetCaptureCursorShape();
+            if (shape && shape->shapeId == WireCursorRequestShapeId(control)) {
+                SendCursorShape(senderId, shape);
+            }
+            break;
+        }
+        
+        default:
+            LOG_INFO(LOG_MODULE_NETWORK, "Paquet de contrôle %d reçu du pair %d", WireControlType(control), senderId);
+            break;
+    }
+}
+
+static void HandleCursorPacket(const WirePacketView* packet, int senderId, uint64_t receiveNs) {
+    if (packet->payloadSize < WIRE_CURSOR_POSITION_SIZE) {
+        StatsAddCounter(STAT_COUNTER_PACKETS_DROPPED, 1);
+        return;
+    }
+    
+    const uint8_t* position = packet->payload;
+    receivedCursor.visible = (WireCursorPositionFlags(position) & WIRE_CURSOR_FLAG_VISIBLE) != 0;
+    receivedCursor.x = WireCursorPositionX(position);
+    receivedCursor.y = WireCursorPositionY(position);
+    receivedCursor.shapeId = WireCursorPositionShapeId(position);
+    hasReceivedCursor = true;
+    
+    // Forme inconnue (changement perdu ou connexion en cours de partage) : la demander à l'émetteur
+    int index = FindPeerById(senderId);
+    if (index < 0 || !receivedCursor.visible || CursorCacheFind(receivedCursor.shapeId)) return;
+    
+    PeerLink* link = &peerLinks[index];
+    if (link->requestedShapeId == receivedCursor.shapeId && receiveNs - link->shapeRequestNs < CURSOR_REQUEST_INTERVAL_NS) return;
+    
+    uint8_t request[WIRE_CURSOR_REQUEST_SIZE];
+    WireWriteCursorRequest(request, receivedCursor.shapeId);
+    if (SendPacket(senderId, PACKET_TYPE_CONTROL, request, sizeof(request), RNET_UNRELIABLE)) {
+        link->requestedShapeId = receivedCursor.shapeId;
+        link->shapeRequestNs = receiveNs;
+    }
 }
 
-static void HandleHandshakePacket(const PacketHeader* header, const void* data, size_t size, int senderId) {
-    printf("[INFO] Paquet de handshake reçu du pair %d\n", senderId);
+static void HandleHandshakePacket(const WirePacketView* packet, int senderId) {
+    LOG_INFO(LOG_MODULE_NETWORK, "Paquet de handshake reçu du pair %d", senderId);
     
-    // Vérifier les données de handshake
-    const char* handshakeData = (const char*)data;
-    if (strcmp(handshakeData, "C_Screenshare Handshake") == 0) {
-        printf("[INFO] Handshake valide du pair %d\n", senderId);
+    // Vérifier les données de handshake (longueur explicite, pas de lecture hors buffer)
+    if (!WireHandshakeValidate(packet->payload, packet->payloadSize)) {
+        LOG_ERROR(LOG_MODULE_NETWORK, "Handshake invalide du pair %d", senderId);
+        return;
+    }
+    LOG_INFO(LOG_MODULE_NETWORK, "Handshake valide du pair %d", senderId);
+    
+    int index = FindPeerById(senderId);
+    if (index < 0) return;
+    PeerLink* link = &peerLinks[index];
+    
+    // Algorithme le plus rapide commun (ChaCha20-Poly1305 si le pair n'annonce rien)
+    AeadAlgorithm algorithm = AeadSelectAlgorithm(localAeadSupport, WireHandshakeAeadSupport(packet->payload));
+    if (algorithm == AEAD_ALGORITHM_NONE) algorithm = AEAD_ALGORITHM_CHACHA20_POLY1305;
+    
+    // Chiffrement activé : le handshake ne compte qu'une fois son MAC vérifié et les clés établies,
+    // un handshake forgé ne change ni le statut du pair, ni son algorithme, ni ses codecs
+    bool authenticated = !encSession.isEncryptionEnabled;
+    
+    // Répondre au moins une fois pour annoncer nos propres capacités
+    bool replyNeeded = !link->handshakeSent;
+    bool hasKeyShare = packet->payloadSize >= WIRE_HANDSHAKE_SIZE + WIRE_KEY_SHARE_SIZE;
+    
+    // Sans chiffrement, chaque handshake annonce un émetteur peut-être relancé : ses images
+    // repartent de zéro et ne doivent pas être écartées comme anciennes
+    if (!encSession.isEncryptionEnabled) {
+        ResetReceivedFrames(link);
+    }
+    
+    if (hasKeyShare && encSession.isEncryptionEnabled) {
+        uint8_t previousShare[HANDSHAKE_SHARE_SIZE];
+        memcpy(previousShare, link->handshake.usedPeerShare, sizeof(previousShare));
         
-        // Mise à jour du statut de connexion
-        int index = FindPeerById(senderId);
-        if (index >= 0) {
-            UpdatePeerStatus(index, true);
+        bool shareReply = false;
+        HandshakeResult result = HandshakeProcessKeyShare(&link->handshake, encSession.psk, packet->payload,
+                                                          algorithm,
+                                                          connectedPeers[index].address, connectedPeers[index].port,
+                                                          &shareReply);
+        replyNeeded = replyNeeded || shareReply;
+        authenticated = result == HANDSHAKE_RESULT_ESTABLISHED;
+        
+        if (result == HANDSHAKE_RESULT_ERROR) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Échange de clés refusé avec le pair %d (mot de passe différent ?)", senderId);
+        } else if (result == HANDSHAKE_RESULT_ESTABLISHED &&
+                   memcmp(previousShare, link->handshake.usedPeerShare, sizeof(previousShare)) != 0) {
+            LOG_INFO(LOG_MODULE_NETWORK, "Session chiffrée avec le pair %d: %s (%s)", senderId,
+                                         AeadAlgorithmName(link->handshake.keys.algorithm),
+                                         link->handshake.keys.isResumed ? "reprise" : "X25519");
+            ResetReceivedFrames(link);
+            
+            // Session reprise : le ticket indique la dernière image que ce visualiseur possède
+            uint32_t canvasId;
+            uint32_t frameId;
+            if (link->handshake.keys.isResumed && HandshakeGetFrameState(&link->handshake, &canvasId, &frameId)) {
+                SetFrameAck(index, CAPTURE_LAYER_FULL, canvasId, frameId);
+                LOG_INFO(LOG_MODULE_NETWORK, "Reprise de l'image %u pour le pair %d", frameId, senderId);
+            }
         }
+    } else if (hasKeyShare) {
+        LOG_WARNING(LOG_MODULE_NETWORK, "Le pair %d demande le chiffrement, désactivé ici", senderId);
+    } else if (encSession.isEncryptionEnabled) {
+        LOG_WARNING(LOG_MODULE_NETWORK, "Le pair %d n'a pas activé le chiffrement: ses paquets seront refusés", senderId);
+    }
+    
+    if (authenticated) {
+        UpdatePeerStatus(index, true);
+        link->aeadAlgorithm = algorithm;
         
-        // Répondre au handshake si nécessaire
-        // TODO: Implémenter la réponse au handshake
+        // Codecs que le pair décode (couverts par le MAC) : l'émetteur choisit parmi eux (CodecSelect)
+        link->codecSupport = WireHandshakeCodecSupport(packet->payload);
+    }
+    
+    if (replyNeeded) {
+        SendHandshake(index);
+    }
+    
+    // Visualiseur : annoncer l'image déjà possédée dès que le pair peut la lire
+    if (!link->frameStateSent && (!encSession.isEncryptionEnabled || link->handshake.keys.isEstablished)) {
+        SendFrameState(index);
+    }
+    if (!link->viewportSent && (!encSession.isEncryptionEnabled || link->handshake.keys.isEstablished)) {
+        SendViewport(index);
+    }
+}
+
+static void SendFrameState(int index) {
+    if (appliedCanvasId == 0) return;
+    
+    uint8_t ack[WIRE_FRAME_ACK_SIZE];
+    WireWriteFrameAck(ack, CAPTURE_LAYER_FULL, appliedCanvasId, appliedFrameId);
+    if (SendPacket(connectedPeers[index].id, PACKET_TYPE_CONTROL, ack, sizeof(ack), RNET_RELIABLE)) {
+        peerLinks[index].frameStateSent = true;
+    }
+}
+
+static void SendViewport(int index) {
+    // Fiable : envoyée seulement quand la fenêtre change
+    uint8_t viewport[WIRE_VIEWPORT_SIZE];
+    WireWriteViewport(viewport, (uint16_t)localViewport.width, (uint16_t)localViewport.height,
+                      (uint16_t)localViewport.regionX, (uint16_t)localViewport.regionY,
+                      (uint16_t)localViewport.regionWidth, (uint16_t)localViewport.regionHeight);
+    if (SendPacket(connectedPeers[index].id, PACKET_TYPE_CONTROL, viewport, sizeof(viewport), RNET_RELIABLE)) {
+        peerLinks[index].viewportSent = true;
+    }
+}
+
+static void SetFrameAck(int index, CaptureLayer layer, uint32_t canvasId, uint32_t frameId) {
+    LayerAck* ack = &peerLinks[index].acks[layer];
+    
+    // Images appliquées : le masque suit le nouvel acquittement sur le même canevas
+    uint32_t advance = frameId - ack->ackedFrameId;
+    if (canvasId != 0 && ack->hasFrameAck && canvasId == ack->ackedCanvasId && advance < 64) {
+        ack->appliedFrames = (ack->appliedFrames << advance) | 1;
     } else {
-        printf("[ERROR] Handshake invalide du pair %d\n", senderId);
+        ack->appliedFrames = canvasId != 0 ? 1 : 0;
+    }
+    
+    ack->hasFrameAck = canvasId != 0;
+    ack->ackedCanvasId = canvasId;
+    ack->ackedFrameId = frameId;
+    
+    // Conservé dans le ticket de session pour une reprise après reconnexion (zone entière seulement)
+    if (layer == CAPTURE_LAYER_FULL) {
+        HandshakeSetFrameState(&peerLinks[index].handshake, canvasId, frameId);
+    }
+}
+
+// Couche dont le canevas acquitté est canvasId (les identifiants de canevas sont distincts d'une couche à l'autre)
+static const LayerAck* FindLayerAck(const PeerLink* link, uint32_t canvasId) {
+    for (int layer = 0; layer < CAPTURE_LAYER_COUNT; layer++) {
+        const LayerAck* ack = &link->acks[layer];
+        if (ack->hasFrameAck && ack->ackedCanvasId == canvasId) return ack;
+    }
+    return NULL;
+}
+
+// Valeur bornée au format réseau (uint16)
+static int ClampU16(int value) {
+    return value < 0 ? 0 : (value > UINT16_MAX ? UINT16_MAX : value);
+}
+
+// Auto-test du format réseau : des paquets valides, altérés puis tronqués passent par tous les
+// analyseurs. Chaque paquet est alloué à sa taille exacte : une lecture au-delà est visible sous
+// AddressSanitizer, et les tailles déduites des en-têtes validés sont recoupées avec le buffer.
+
+#define SELF_TEST_SEED_COUNT 9
+#define SELF_TEST_MAX_PACKET 512
+
+// Somme des champs lus : les lectures ne peuvent pas être éliminées par le compilateur
+static volatile uint64_t selfTestSink = 0;
+
+typedef struct {
+    uint8_t data[SELF_TEST_MAX_PACKET];
+    uint32_t size;
+} SelfTestPacket;
+
+// Générateur xorshift à graine fixe : un échec se reproduit à l'identique
+static uint32_t SelfTestRandom(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Paquet complet autour d'une charge utile écrite par l'appelant
+static uint8_t* SelfTestBeginPacket(SelfTestPacket* packet, uint8_t type, uint32_t payloadSize) {
+    WireWriteHeader(packet->data, type, 0, (uint8_t)StreamForType(type), 1, 0, payloadSize);
+    packet->size = WIRE_HEADER_SIZE + payloadSize;
+    return packet->data + WIRE_HEADER_SIZE;
+}
+
+// Un paquet valide de chaque sorte, listes non vides comprises
+static void SelfTestBuildSeeds(SelfTestPacket seeds[SELF_TEST_SEED_COUNT]) {
+    memset(seeds, 0, sizeof(SelfTestPacket) * SELF_TEST_SEED_COUNT);
+    
+    // Image en tuiles : deux copies, deux tuiles en cache, trois tuiles dont une codée sans perte
+    uint32_t tilesSize = WireTileFrameHeaderSize(2, 2, 3, 1) + 16;
+    uint8_t* metadata = SelfTestBeginPacket(&seeds[0], PACKET_TYPE_CAPTURE, WIRE_CAPTURE_METADATA_SIZE + tilesSize);
+    WireWriteCaptureMetadata(metadata, 42, 640, 480, 1280, 960, 0, 0, tilesSize, WIRE_CAPTURE_FLAG_CHANGED,
+                             0, CODEC_ID_TILES, CAPTURE_LAYER_FULL, 1000, 10, 20);
+    uint8_t* tiles = metadata + WIRE_CAPTURE_METADATA_SIZE;
+    WireWriteTileFrame(tiles, 7, 41, 64, 3, 2, 2, 2, 1);
+    WireWriteU32(tiles + WIRE_TILE_FRAME_SIZE, 40);
+    for (uint32_t i = 0; i < 2; i++) {
+        WireWriteCopyRect(tiles + WIRE_TILE_FRAME_SIZE + 4 + i * WIRE_COPY_RECT_SIZE, 0, (uint16_t)(i * 64), 0, 64, 64, 64);
+        WireWriteCachedTile(tiles + WireTileFrameCachedOffset(2) + i * WIRE_CACHED_TILE_SIZE, (uint16_t)i, (uint16_t)(i + 1));
+    }
+    uint8_t* indices = tiles + WireTileFrameIndicesOffset(2, 2);
+    for (uint32_t i = 0; i < 3; i++) {
+        WireWriteU16(indices + 2 * i, (uint16_t)(i + 2));
+        WireWriteU16(indices + 6 + 2 * i, (uint16_t)i);
+    }
+    uint8_t* codecs = tiles + WireTileFrameCodecsOffset(2, 2, 3);
+    codecs[0] = 1;
+    WireWriteU16(codecs + 1, 16);
+    
+    // Image vidéo en deux tranches
+    uint32_t videoSize = WireVideoFrameHeaderSize(2) + 24;
+    metadata = SelfTestBeginPacket(&seeds[1], PACKET_TYPE_CAPTURE, WIRE_CAPTURE_METADATA_SIZE + videoSize);
+    WireWriteCaptureMetadata(metadata, 43, 320, 240, 320, 240, 0, 0, videoSize, 0,
+                             0, CODEC_ID_VIDEO, CAPTURE_LAYER_DETAIL, 2000, 10, 20);
+    uint8_t* video = metadata + WIRE_CAPTURE_METADATA_SIZE;
+    WireWriteVideoFrame(video, 9, 42, 28, 2);
+    WireWriteU32(video + WIRE_VIDEO_FRAME_SIZE, 10);
+    WireWriteU32(video + WIRE_VIDEO_FRAME_SIZE + 4, 14);
+    
+    // Messages de contrôle
+    WireWriteClockSync(SelfTestBeginPacket(&seeds[2], PACKET_TYPE_CONTROL, WIRE_CLOCK_SYNC_SIZE), CONTROL_TYPE_PING, 1, 2, 3);
+    WireWriteFrameAck(SelfTestBeginPacket(&seeds[3], PACKET_TYPE_CONTROL, WIRE_FRAME_ACK_SIZE), CAPTURE_LAYER_FULL, 7, 42);
+    uint8_t* shape = SelfTestBeginPacket(&seeds[4], PACKET_TYPE_CONTROL, WIRE_CURSOR_SHAPE_SIZE + 2 * 3 * 4);
+    WireWriteCursorShape(shape, 0x1234, 2, 3, 1, 2);
+    WireWriteCursorRequest(SelfTestBeginPacket(&seeds[5], PACKET_TYPE_CONTROL, WIRE_CURSOR_REQUEST_SIZE), 0x1234);
+    WireWriteViewport(SelfTestBeginPacket(&seeds[6], PACKET_TYPE_CONTROL, WIRE_VIEWPORT_SIZE), 1920, 1080, 10, 20, 300, 200);
+    
+    // Handshake avec part d'échange de clés, position du curseur
+    uint8_t share[32] = {1};
+    uint8_t* handshake = SelfTestBeginPacket(&seeds[7], PACKET_TYPE_HANDSHAKE, WIRE_HANDSHAKE_SIZE + WIRE_KEY_SHARE_SIZE);
+    WireWriteHandshake(handshake, (uint8_t)AEAD_SUPPORT_BIT(AEAD_ALGORITHM_CHACHA20_POLY1305), (uint8_t)CODEC_SUPPORT_BIT(CODEC_ID_TILES));
+    WireWriteKeyShare(handshake + WIRE_HANDSHAKE_SIZE, 1, share, share, NULL);
+    WireWriteCursorPosition(SelfTestBeginPacket(&seeds[8], PACKET_TYPE_CURSOR, WIRE_CURSOR_POSITION_SIZE),
+                            WIRE_CURSOR_FLAG_VISIBLE, -5, 12, 0x1234);
+}
+
+// Parcourt une image en tuiles validée : toutes ses listes doivent tenir dans size octets
+static bool SelfTestTileFrame(const uint8_t* t, uint32_t size, uint64_t* sink) {
+    uint32_t copyCount = WireTileFrameCopyCount(t);
+    uint32_t cachedCount = WireTileFrameCachedCount(t);
+    uint32_t tileCount = WireTileFrameTileCount(t);
+    uint32_t codedCount = WireTileFrameCodedCount(t);
+    if (WireTileFrameHeaderSize(copyCount, cachedCount, tileCount, codedCount) > size) return false;
+    
+    *sink += WireTileFrameBaseFrameId(t) + WireTileFrameTileSize(t) + WireTileFrameAtlasColumns(t);
+    if (copyCount > 0) *sink += WireTileFrameCopySourceFrameId(t);
+    for (uint32_t i = 0; i < copyCount; i++) {
+        const uint8_t* copy = WireTileFrameCopyRect(t, i);
+        *sink += WireCopyRectSrcX(copy) + WireCopyRectSrcY(copy) + WireCopyRectDstX(copy) +
+                 WireCopyRectDstY(copy) + WireCopyRectWidth(copy) + WireCopyRectHeight(copy);
+    }
+    for (uint32_t i = 0; i < cachedCount; i++) {
+        const uint8_t* cached = WireTileFrameCachedTile(t, i);
+        *sink += WireCachedTileIndex(cached) + WireCachedTileSlot(cached);
+    }
+    for (uint32_t i = 0; i < tileCount; i++) {
+        *sink += WireTileFrameIndex(t, i) + WireTileFrameSlot(t, i);
+    }
+    for (uint32_t i = 0; i < codedCount; i++) {
+        *sink += WireTileFrameCodec(t, i) + WireTileFrameCodedSize(t, i);
+    }
+    return true;
+}
+
+// Parcourt une image vidéo validée : en-tête et tranches doivent tenir dans size octets
+static bool SelfTestVideoFrame(const uint8_t* v, uint32_t size, uint64_t* sink) {
+    uint32_t sliceCount = WireVideoFrameSliceCount(v);
+    uint64_t total = WireVideoFrameHeaderSize(sliceCount);
+    for (uint32_t i = 0; i < sliceCount && total <= size; i++) {
+        total += WireVideoFrameSliceSize(v, i);
+    }
+    *sink += WireVideoFrameReferenceFrameId(v) + WireVideoFrameQp(v);
+    return total <= size;
+}
+
+// Soumet des données à tous les analyseurs qui pourraient les recevoir, quel que soit le type annoncé
+static bool SelfTestPayload(const uint8_t* payload, uint32_t size, uint64_t* sink) {
+    bool valid = true;
+    
+    if (WireCaptureValidate(payload, size)) {
+        uint32_t dataSize = WireCaptureDataSize(payload);
+        if (WIRE_CAPTURE_METADATA_SIZE + (uint64_t)dataSize > size) valid = false;
+        *sink += WireCaptureFrameId(payload) + WireCaptureSourceX(payload) + WireCaptureSourceY(payload) +
+                 WireCaptureFlags(payload) + (uint8_t)WireCaptureMonitorIndex(payload) + WireCaptureCodec(payload) +
+                 WireCaptureLayer(payload) + WireCaptureTimestampUs(payload) + WireCaptureEncodeStartUs(payload) +
+                 WireCaptureEncodeEndUs(payload);
+        
+        // Chaque codec lit l'image comme s'il l'avait produite
+        const uint8_t* frame = payload + WIRE_CAPTURE_METADATA_SIZE;
+        for (uint32_t id = 0; id < CODEC_ID_COUNT; id++) {
+            CodecFrameInfo info;
+            if (CodecGet(id)->parseFrame(frame, dataSize, &info)) *sink += info.streamId + info.baseFrameId;
+        }
+    }
+    if (WireTileFrameValidate(payload, size) && !SelfTestTileFrame(payload, size, sink)) valid = false;
+    if (WireVideoFrameValidate(payload, size) && !SelfTestVideoFrame(payload, size, sink)) valid = false;
+    
+    if (WireCursorShapeValidate(payload, size)) {
+        uint32_t pixelSize = (uint32_t)WireCursorShapeWidth(payload) * WireCursorShapeHeight(payload) * 4;
+        if (WIRE_CURSOR_SHAPE_SIZE + (uint64_t)pixelSize > size) valid = false;
+        else *sink += payload[WIRE_CURSOR_SHAPE_SIZE + pixelSize - 1];
+    }
+    if (WireHandshakeValidate(payload, size)) {
+        *sink += WireHandshakeAeadSupport(payload) + WireHandshakeCodecSupport(payload);
+        if (size >= WIRE_HANDSHAKE_SIZE + WIRE_KEY_SHARE_SIZE) {
+            const uint8_t* share = payload + WIRE_HANDSHAKE_SIZE;
+            *sink += WireKeyShareMode(share) + WireKeyShareShare(share)[31] + WireKeyShareEcho(share)[31] +
+                     WireKeyShareSessionId(share)[15] + WireKeyShareMac(share)[15];
+        }
+    }
+    
+    // Messages de contrôle et position du curseur : lus après la même vérification de taille que les gestionnaires
+    if (size >= 1) *sink += WireControlType(payload);
+    if (size >= WIRE_CLOCK_SYNC_SIZE) *sink += WireClockSyncT0(payload) + WireClockSyncT1(payload) + WireClockSyncT2(payload);
+    if (size >= WIRE_FRAME_ACK_SIZE) *sink += WireFrameAckLayer(payload) + WireFrameAckCanvasId(payload) + WireFrameAckFrameId(payload);
+    if (size >= WIRE_CURSOR_REQUEST_SIZE) *sink += WireCursorRequestShapeId(payload);
+    if (size >= WIRE_VIEWPORT_SIZE) {
+        *sink += WireViewportWidth(payload) + WireViewportHeight(payload) + WireViewportRegionX(payload) +
+                 WireViewportRegionY(payload) + WireViewportRegionWidth(payload) + WireViewportRegionHeight(payload);
     }
-}
\ No newline at end of file
+    if (size >= WIRE_CURSOR_POSITION_SIZE) {
+        *sink += WireCursorPositionFlags(payload) + (uint16_t)WireCursorPositionX(payload) +
+                 (uint16_t)WireCursorPositionY(payload) + WireCursorPositionShapeId(payload);
+    }
+    return valid;
+}
+
+// Paquet reçu tel quel : en-tête, puis données si l'en-tête est accepté
+static bool SelfTestPacketParse(const uint8_t* data, size_t size, bool* accepted, uint64_t* sink) {
+    WirePacketView view;
+    *accepted = WireParsePacket(data, size, &view) == WIRE_OK;
+    if (!*accepted) return true;
+    
+    if (view.header != data || view.payload != data + WIRE_HEADER_SIZE ||
+        WIRE_HEADER_SIZE + (uint64_t)view.payloadSize > size) return false;
+    *sink += WireHeaderType(view.header) + WireHeaderFlags(view.header) + WireHeaderSequence(view.header) +
+             WireHeaderTimestampUs(view.header);
+    return SelfTestPayload(view.payload, view.payloadSize, sink);
+}
+
+bool RunNetworkSelfTest(int iterations) {
+    if (iterations <= 0) iterations = 1;
+    
+    SelfTestPacket seeds[SELF_TEST_SEED_COUNT];
+    SelfTestBuildSeeds(seeds);
+    
+    // Les paquets intacts doivent être acceptés
+    uint64_t sink = 0;
+    bool success = true;
+    for (int s = 0; s < SELF_TEST_SEED_COUNT; s++) {
+        bool accepted = false;
+        if (!SelfTestPacketParse(seeds[s].data, seeds[s].size, &accepted, &sink) || !accepted) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Auto-test : paquet valide %d refusé ou incohérent", s);
+            success = false;
+        }
+    }
+    
+    // Altérations : octets et champs aux valeurs limites, troncature, en-tête recalé sur la taille reçue
+    uint32_t state = 0x9E3779B9u;
+    int accepted = 0;
+    for (int i = 0; i < iterations && success; i++) {
+        const SelfTestPacket* seed = &seeds[SelfTestRandom(&state) % SELF_TEST_SEED_COUNT];
+        uint8_t buffer[SELF_TEST_MAX_PACKET];
+        uint32_t size = seed->size;
+        memcpy(buffer, seed->data, size);
+        
+        uint32_t mutations = 1 + SelfTestRandom(&state) % 4;
+        for (uint32_t m = 0; m < mutations; m++) {
+            uint32_t r = SelfTestRandom(&state);
+            uint32_t offset = size > 0 ? (r >> 8) % size : 0;
+            switch (r % 6) {
+                case 0:
+                    if (size > 0) buffer[offset] ^= (uint8_t)(1u << ((r >> 4) % 8));
+                    break;
+                case 1:
+                    if (size > 0) buffer[offset] = (uint8_t)SelfTestRandom(&state);
+                    break;
+                case 2: {
+                    static const uint32_t limits[] = { 0, 1, 0x7F, 0xFF, 0x7FFF, 0xFFFF, 0x7FFFFFFF, 0xFFFFFFFF };
+                    uint32_t value = limits[SelfTestRandom(&state) % 8];
+                    if (offset + 4 <= size) WireWriteU32(buffer + offset, value);
+                    else if (offset + 2 <= size) WireWriteU16(buffer + offset, (uint16_t)value);
+                    break;
+                }
+                case 3:
+                    size = size > 0 ? SelfTestRandom(&state) % size : 0;
+                    break;
+                case 4:
+                    for (uint32_t b = 0; b < size; b++) buffer[b] = (uint8_t)SelfTestRandom(&state);
+                    break;
+                default:
+                    if (size >= WIRE_HEADER_SIZE) {
+                        WireWriteU32(buffer + WIRE_FIELD(WirePacketHeader, dataSize), size - WIRE_HEADER_SIZE);
+                    }
+                    break;
+            }
+        }
+        
+        // Taille exacte : aucune marge derrière le dernier octet reçu
+        uint8_t* packet = (uint8_t*)malloc(size > 0 ? size : 1);
+        if (!packet) {
+            success = false;
+            break;
+        }
+        memcpy(packet, buffer, size);
+        bool packetAccepted = false;
+        if (!SelfTestPacketParse(packet, size, &packetAccepted, &sink)) {
+            LOG_ERROR(LOG_MODULE_NETWORK, "Auto-test : itération %d, paquet de %u octets validé mais incohérent", i, size);
+            success = false;
+        }
+        if (packetAccepted) accepted++;
+        free(packet);
+    }
+    
+    selfTestSink = sink;
+    LOG_INFO(LOG_MODULE_NETWORK, "Auto-test du format réseau : %d paquets altérés, %d acceptés, %s",
+             iterations, accepted, success ? "aucune incohérence" : "échec");
+    return success;
+}
@@ -0,0 +1,127 @@
+#include "../include/roi.h"
+#include "../include/tilecache.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Fonctions utilitaires privées
+static int Min(int a, int b) {
+    return a < b ? a : b;
+}
+
+static int Max(int a, int b) {
+    return a > b ? a : b;
+}
+
+// Nouvelles dimensions : grille recalculée, aucune activité connue
+static bool ResetMap(RoiMap* map, int width, int height) {
+    RoiMapFree(map);
+    map->columns = (width + ROI_CELL_SIZE - 1) / ROI_CELL_SIZE;
+    map->rows = (height + ROI_CELL_SIZE - 1) / ROI_CELL_SIZE;
+    size_t cells = (size_t)map->columns * map->rows;
+    map->hashes = (uint64_t*)calloc(cells, sizeof(uint64_t));
+    map->activity = (uint8_t*)calloc(cells, 1);
+    map->weights = (uint8_t*)calloc(cells, 1);
+    if (!map->hashes || !map->activity || !map->weights) {
+        RoiMapFree(map);
+        return false;
+    }
+    map->width = width;
+    map->height = height;
+    return true;
+}
+
+// Intérêt du curseur pour un rectangle : maximal tout près, décroissant linéairement jusqu'à ROI_CURSOR_FALLOFF
+static int CursorWeight(const RoiFocus* focus, int x, int y, int width, int height) {
+    int dx = Max(Max(x - focus->cursorX, focus->cursorX - (x + width - 1)), 0);
+    int dy = Max(Max(y - focus->cursorY, focus->cursorY - (y + height - 1)), 0);
+    if (dx >= ROI_CURSOR_FALLOFF || dy >= ROI_CURSOR_FALLOFF) return 0;
+    
+    // Distance de Tchebychev : des cellules carrées autour d'un pointeur, sans racine carrée
+    int distance = Max(dx, dy);
+    if (distance <= ROI_CURSOR_RADIUS) return 255;
+    return 255 * (ROI_CURSOR_FALLOFF - distance) / (ROI_CURSOR_FALLOFF - ROI_CURSOR_RADIUS);
+}
+
+static bool InsideWindow(const RoiFocus* focus, int x, int y, int width, int height) {
+    return x < focus->windowX + focus->windowWidth && focus->windowX < x + width &&
+           y < focus->windowY + focus->windowHeight && focus->windowY < y + height;
+}
+
+// Implémentation des fonctions publiques
+bool RoiMapUpdate(RoiMap* map, const Image* image, const RoiFocus* focus) {
+    if (!map || !image || !image->data || image->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return false;
+    
+    bool reset = map->width != image->width || map->height != image->height || !map->weights;
+    if (reset && !ResetMap(map, image->width, image->height)) return false;
+    
+    size_t stride = (size_t)image->width * 4;
+    const uint8_t* pixels = (const uint8_t*)image->data;
+    bool hasCursor = focus && focus->hasCursor;
+    bool hasWindow = focus && focus->hasWindow && focus->windowWidth > 0 && focus->windowHeight > 0;
+    int total = 0;
+    int activeTotal = 0;
+    int activeCount = 0;
+    
+    for (int row = 0; row < map->rows; row++) {
+        for (int column = 0; column < map->columns; column++) {
+            int index = row * map->columns + column;
+            int x = column * ROI_CELL_SIZE;
+            int y = row * ROI_CELL_SIZE;
+            int width = Min(ROI_CELL_SIZE, image->width - x);
+            int height = Min(ROI_CELL_SIZE, image->height - y);
+            
+            // Activité : une cellule modifiée repart au maximum, puis s'éteint en quelques images.
+            // La première image de la carte n'est comparée à rien
+            uint64_t hash = TileHash(pixels + (size_t)y * stride + (size_t)x * 4, stride, width, height);
+            if (!reset && hash != map->hashes[index]) {
+                map->activity[index] = 255;
+            } else {
+                map->activity[index] = (uint8_t)(map->activity[index] * 27 / 32);
+            }
+            map->hashes[index] = hash;
+            
+            // Signaux cumulés : une zone qui change dans la fenêtre active, sous le curseur, passe devant
+            int weight = map->activity[index] * ROI_ACTIVITY_WEIGHT / 255;
+            if (hasWindow && InsideWindow(focus, x, y, width, height)) weight += ROI_WINDOW_WEIGHT;
+            if (hasCursor) weight += CursorWeight(focus, x, y, width, height);
+            weight = Min(weight, 255);
+            map->weights[index] = (uint8_t)weight;
+            total += weight;
+            if (map->activity[index] > 0) {
+                activeTotal += weight;
+                activeCount++;
+            }
+        }
+    }
+    
+    // Seules les cellules qui changent coûtent des octets : la moyenne qui centre les écarts de
+    // quantificateur est la leur. Une image figée n'en a aucune, la moyenne porte alors sur toutes
+    map->meanWeight = activeCount > 0 ? activeTotal / activeCount : total / (map->columns * map->rows);
+    return true;
+}
+
+uint8_t RoiMapWeight(const RoiMap* map, int x, int y) {
+    if (!map || !map->weights || x < 0 || y < 0 || x >= map->width || y >= map->height) return 0;
+    return map->weights[(y / ROI_CELL_SIZE) * map->columns + x / ROI_CELL_SIZE];
+}
+
+int RoiMapQpOffset(const RoiMap* map, int x, int y) {
+    if (!map || !map->weights) return 0;
+    
+    // Bords ajoutés jusqu'au macrobloc : même cellule que le dernier pixel
+    x = Min(Max(x, 0), map->width - 1);
+    y = Min(Max(y, 0), map->height - 1);
+    
+    // Pente de deux plages pour tout l'intervalle d'intérêt : une petite zone d'attention sur une
+    // périphérie calme atteint la borne basse, la périphérie ne remonte que d'un ou deux crans
+    int offset = 2 * ROI_QP_RANGE * (map->meanWeight - (int)RoiMapWeight(map, x, y)) / 255;
+    return Min(Max(offset, -ROI_QP_RANGE), ROI_QP_RANGE);
+}
+
+void RoiMapFree(RoiMap* map) {
+    if (!map) return;
+    free(map->hashes);
+    free(map->activity);
+    free(map->weights);
+    memset(map, 0, sizeof(*map));
+}
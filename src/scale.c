@@ -0,0 +1,240 @@
+#include "../include/scale.h"
+#include <stdlib.h>
+#include <string.h>
+
+// SSE2 fait partie de l'ABI x86-64 : pas de détection à l'exécution
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SCALE_SSE2 1
+#endif
+
+// Poids de l'interpolation bilinéaire, sur 8 bits de fraction
+#define BILINEAR_BITS 8
+#define BILINEAR_ONE (1 << BILINEAR_BITS)
+
+void ScaleHalf(const uint8_t* src, size_t srcStride, int width, int height, uint8_t* dst, size_t dstStride) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row0 = src + (size_t)(2 * y) * srcStride;
+        const uint8_t* row1 = row0 + srcStride;
+        uint8_t* out = dst + (size_t)y * dstStride;
+        int x = 0;
+        
+#ifdef SCALE_SSE2
+        // 4 pixels produits par tour : sommes sur 16 bits des deux lignes, puis des pixels voisins
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        for (; x + 4 <= width; x += 4) {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + 8 * x));
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + 8 * x + 16));
+            __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + 8 * x));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + 8 * x + 16));
+            __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+            __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+            __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+            __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+            
+            // Chaque registre tient deux pixels voisins : leur somme dans la moitié basse
+            __m128i p0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+            __m128i p1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+            __m128i p2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+            __m128i p3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+            __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(p0, p1), two), 2);
+            __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(p2, p3), two), 2);
+            _mm_storeu_si128((__m128i*)(out + 4 * x), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        
+        for (; x < width; x++) {
+            const uint8_t* a = row0 + 8 * x;
+            const uint8_t* b = row1 + 8 * x;
+            for (int c = 0; c < 4; c++) {
+                out[4 * x + c] = (uint8_t)((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+            }
+        }
+    }
+}
+
+void ScaleQuarter(const uint8_t* src, size_t srcStride, int width, int height, uint8_t* dst, size_t dstStride) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* rows = src + (size_t)(4 * y) * srcStride;
+        uint8_t* out = dst + (size_t)y * dstStride;
+        int x = 0;
+        
+#ifdef SCALE_SSE2
+        // 2 pixels produits par tour : 16 sommes de 4 lignes, repliées deux fois sur 16 bits (4080 au plus)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i eight = _mm_set1_epi16(8);
+        for (; x + 2 <= width; x += 2) {
+            __m128i sumA = zero;
+            __m128i sumB = zero;
+            for (int r = 0; r < 4; r++) {
+                const uint8_t* row = rows + (size_t)r * srcStride + 16 * x;
+                __m128i a = _mm_loadu_si128((const __m128i*)row);
+                __m128i b = _mm_loadu_si128((const __m128i*)(row + 16));
+                sumA = _mm_add_epi16(sumA, _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpackhi_epi8(a, zero)));
+                sumB = _mm_add_epi16(sumB, _mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpackhi_epi8(b, zero)));
+            }
+            sumA = _mm_add_epi16(sumA, _mm_srli_si128(sumA, 8));
+            sumB = _mm_add_epi16(sumB, _mm_srli_si128(sumB, 8));
+            __m128i pixels = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sumA, sumB), eight), 4);
+            _mm_storel_epi64((__m128i*)(out + 4 * x), _mm_packus_epi16(pixels, zero));
+        }
+#endif
+        
+        for (; x < width; x++) {
+            for (int c = 0; c < 4; c++) {
+                int sum = 8;
+                for (int r = 0; r < 4; r++) {
+                    const uint8_t* p = rows + (size_t)r * srcStride + 16 * x + c;
+                    sum += p[0] + p[4] + p[8] + p[12];
+                }
+                out[4 * x + c] = (uint8_t)(sum >> 4);
+            }
+        }
+    }
+}
+
+// Position source (16 bits de fraction) du premier pixel de destination et pas entre deux pixels,
+// centres des pixels alignés
+static void BilinearStep(int srcSize, int dstSize, int32_t* start, int32_t* step) {
+    *step = (int32_t)(((int64_t)srcSize << 16) / dstSize);
+    *start = *step / 2 - (1 << 15);
+}
+
+// Ligne mélangée de deux lignes source : (a * (256 - w) + b * w + 128) / 256, octet par octet
+static void BlendRows(const uint8_t* a, const uint8_t* b, int weight, uint8_t* out, int bytes) {
+    int i = 0;
+    
+#ifdef SCALE_SSE2
+    // a * (256 - w) + b * w tient sur 16 bits non signés (65280 au plus)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wa = _mm_set1_epi16((short)(BILINEAR_ONE - weight));
+    const __m128i wb = _mm_set1_epi16((short)weight);
+    const __m128i half = _mm_set1_epi16(BILINEAR_ONE / 2);
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), wa),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), wb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), wa),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), wb));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, half), BILINEAR_BITS);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, half), BILINEAR_BITS);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    
+    for (; i < bytes; i++) {
+        out[i] = (uint8_t)((a[i] * (BILINEAR_ONE - weight) + b[i] * weight + BILINEAR_ONE / 2) >> BILINEAR_BITS);
+    }
+}
+
+bool ScaleBilinear(const uint8_t* src, size_t srcStride, int srcWidth, int srcHeight,
+                   uint8_t* dst, size_t dstStride, int dstWidth, int dstHeight) {
+    // Colonnes source et poids de chaque colonne de destination, calculés une fois
+    int* columns = (int*)malloc((size_t)dstWidth * sizeof(int));
+    uint8_t* weights = (uint8_t*)malloc((size_t)dstWidth);
+    uint8_t* blended = (uint8_t*)malloc((size_t)srcWidth * 4);
+    if (!columns || !weights || !blended) {
+        free(columns);
+        free(weights);
+        free(blended);
+        return false;
+    }
+    
+    int32_t startX, stepX, startY, stepY;
+    BilinearStep(srcWidth, dstWidth, &startX, &stepX);
+    BilinearStep(srcHeight, dstHeight, &startY, &stepY);
+    for (int x = 0; x < dstWidth; x++) {
+        int32_t position = startX + x * stepX;
+        if (position < 0) position = 0;
+        int column = position >> 16;
+        if (column >= srcWidth - 1) {
+            columns[x] = srcWidth - 1;
+            weights[x] = 0;
+        } else {
+            columns[x] = column;
+            weights[x] = (uint8_t)((position >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1));
+        }
+    }
+    
+    for (int y = 0; y < dstHeight; y++) {
+        int32_t position = startY + y * stepY;
+        if (position < 0) position = 0;
+        int row = position >> 16;
+        int weight = (position >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1);
+        if (row >= srcHeight - 1) {
+            row = srcHeight - 1;
+            weight = 0;
+        }
+        const uint8_t* row0 = src + (size_t)row * srcStride;
+        const uint8_t* row1 = weight > 0 ? row0 + srcStride : row0;
+        BlendRows(row0, row1, weight, blended, srcWidth * 4);
+        
+        uint8_t* out = dst + (size_t)y * dstStride;
+        for (int x = 0; x < dstWidth; x++) {
+            const uint8_t* p = blended + (size_t)columns[x] * 4;
+            int w = weights[x];
+            const uint8_t* q = w > 0 ? p + 4 : p;
+            for (int c = 0; c < 4; c++) {
+                out[4 * x + c] = (uint8_t)((p[c] * (BILINEAR_ONE - w) + q[c] * w + BILINEAR_ONE / 2) >> BILINEAR_BITS);
+            }
+        }
+    }
+    
+    free(columns);
+    free(weights);
+    free(blended);
+    return true;
+}
+
+bool ScaleImage(const uint8_t* src, size_t srcStride, int srcWidth, int srcHeight,
+                uint8_t* dst, size_t dstStride, int dstWidth, int dstHeight) {
+    if (!src || !dst || dstWidth <= 0 || dstHeight <= 0 || dstWidth > srcWidth || dstHeight > srcHeight) return false;
+    
+    // Rapports exacts : moyennes de blocs, en une lecture
+    if (dstWidth == srcWidth / 4 && dstHeight == srcHeight / 4) {
+        ScaleQuarter(src, srcStride, dstWidth, dstHeight, dst, dstStride);
+        return true;
+    }
+    if (dstWidth == srcWidth / 2 && dstHeight == srcHeight / 2) {
+        ScaleHalf(src, srcStride, dstWidth, dstHeight, dst, dstStride);
+        return true;
+    }
+    
+    // Réductions de moitié tant que possible : l'interpolation qui suit ne saute plus aucun pixel
+    const uint8_t* level = src;
+    size_t levelStride = srcStride;
+    int levelWidth = srcWidth;
+    int levelHeight = srcHeight;
+    uint8_t* buffers[2] = { NULL, NULL };
+    int current = 0;
+    bool success = true;
+    while (dstWidth * 2 <= levelWidth && dstHeight * 2 <= levelHeight) {
+        int halfWidth = levelWidth / 2;
+        int halfHeight = levelHeight / 2;
+        if (!buffers[current]) buffers[current] = (uint8_t*)malloc((size_t)halfWidth * halfHeight * 4);
+        if (!buffers[current]) {
+            free(buffers[0]);
+            free(buffers[1]);
+            return false;
+        }
+        ScaleHalf(level, levelStride, halfWidth, halfHeight, buffers[current], (size_t)halfWidth * 4);
+        level = buffers[current];
+        levelStride = (size_t)halfWidth * 4;
+        levelWidth = halfWidth;
+        levelHeight = halfHeight;
+        current ^= 1;
+    }
+    
+    if (levelWidth == dstWidth && levelHeight == dstHeight) {
+        for (int y = 0; y < dstHeight; y++) {
+            memcpy(dst + (size_t)y * dstStride, level + (size_t)y * levelStride, (size_t)dstWidth * 4);
+        }
+    } else if (!ScaleBilinear(level, levelStride, levelWidth, levelHeight, dst, dstStride, dstWidth, dstHeight)) {
+        success = false;
+    }
+    free(buffers[0]);
+    free(buffers[1]);
+    return success;
+}
@@ -0,0 +1,56 @@
+#include "../include/scheduler.h"
+
+// Implémentation des fonctions publiques
+void SchedulerReset(CaptureScheduler* scheduler, uint32_t minIntervalMs, uint32_t idleIntervalMs) {
+    if (!scheduler) return;
+    
+    if (minIntervalMs == 0) minIntervalMs = 1;
+    if (idleIntervalMs < minIntervalMs) idleIntervalMs = minIntervalMs;
+    scheduler->minIntervalNs = (uint64_t)minIntervalMs * 1000000ULL;
+    scheduler->idleIntervalNs = (uint64_t)idleIntervalMs * 1000000ULL;
+    scheduler->intervalNs = scheduler->minIntervalNs;
+    scheduler->nextCaptureNs = 0;
+    scheduler->lastCaptureNs = 0;
+    scheduler->staticFrames = 0;
+}
+
+bool SchedulerCaptureDue(const CaptureScheduler* scheduler, uint64_t now) {
+    return scheduler && now >= scheduler->nextCaptureNs;
+}
+
+void SchedulerInputActivity(CaptureScheduler* scheduler, uint64_t inputNs) {
+    if (!scheduler || inputNs <= scheduler->lastCaptureNs) return;
+    
+    // La saisie va probablement modifier l'écran : pleine cadence sans attendre l'échéance lente
+    scheduler->staticFrames = 0;
+    scheduler->intervalNs = scheduler->minIntervalNs;
+    uint64_t earliest = scheduler->lastCaptureNs + scheduler->minIntervalNs;
+    if (earliest < scheduler->nextCaptureNs) {
+        scheduler->nextCaptureNs = earliest;
+    }
+}
+
+void SchedulerFrameCaptured(CaptureScheduler* scheduler, uint64_t now, bool changed) {
+    if (!scheduler) return;
+    
+    // Activité : pleine cadence ; écran figé : l'intervalle double par paliers jusqu'au repos
+    if (changed) {
+        scheduler->staticFrames = 0;
+        scheduler->intervalNs = scheduler->minIntervalNs;
+    } else if (++scheduler->staticFrames % SCHEDULER_RAMP_FRAMES == 0) {
+        scheduler->intervalNs *= 2;
+        if (scheduler->intervalNs > scheduler->idleIntervalNs) {
+            scheduler->intervalNs = scheduler->idleIntervalNs;
+        }
+    }
+    
+    // Échéance suivante sur la grille de la précédente ; après un retard de plus d'un intervalle
+    // (fenêtre déplacée, machine chargée), la grille repart de maintenant plutôt que d'enchaîner
+    // des captures de rattrapage
+    uint64_t base = scheduler->nextCaptureNs > 0 ? scheduler->nextCaptureNs : now;
+    scheduler->nextCaptureNs = base + scheduler->intervalNs;
+    if (scheduler->nextCaptureNs <= now) {
+        scheduler->nextCaptureNs = now + scheduler->intervalNs;
+    }
+    scheduler->lastCaptureNs = now;
+}
@@ -0,0 +1,312 @@
+#include "../include/stats.h"
+#include "../include/trace.h"
+#include "../include/log.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nombre maximal de threads instrumentés et capacité de l'anneau de chacun
+#define STATS_MAX_THREADS 16
+#define STATS_RING_CAPACITY 1024 // Puissance de deux
+#define STATS_HISTORY_SIZE 8192  // Mesures brutes conservées pour l'export
+
+/**
+ * @brief Mesure brute écrite par un thread
+ */
+typedef struct {
+    uint64_t endNs;         // Fin de l'étape
+    uint32_t durationNs;    // Durée (saturée à ~4 s)
+    uint32_t frameId;       // Image concernée (0 si aucune)
+    uint8_t stage;          // StatStage
+    uint8_t thread;         // Index de l'anneau du thread producteur
+} StatSample;
+
+/**
+ * @brief Anneau mono-producteur / mono-consommateur propre à un thread
+ */
+typedef struct {
+    _Atomic uint32_t head;  // Écrit par le thread propriétaire
+    _Atomic uint32_t tail;  // Écrit par le collecteur
+    uint8_t index;          // Position dans rings[]
+    char name[32];          // Nom du thread pour les traces
+    StatSample samples[STATS_RING_CAPACITY];
+} StatsRing;
+
+/**
+ * @brief Fenêtre glissante d'une étape (côté collecteur)
+ */
+typedef struct {
+    uint32_t durationsNs[STATS_WINDOW_SIZE];
+    uint32_t count;
+    uint32_t next;
+    uint64_t totalCount;
+    uint64_t histogram[STATS_HISTOGRAM_BUCKETS];
+} StageWindow;
+
+static const char* stageNames[STAT_STAGE_COUNT] = {
+    "capture", "swizzle", "scale", "detect", "motion", "encode", "send",
+    "receive", "playout", "decode", "upload", "present"
+};
+
+static const char* counterNames[STAT_COUNTER_COUNT] = {
+    "frames_captured", "frames_changed", "tiles_encoded", "tiles_palette", "tiles_lossless", "tiles_delta", "tiles_refined", "copy_rects", "video_keyframes", "cache_hits", "cache_bytes_saved", "frames_sent", "bytes_sent", "cursor_bytes_sent",
+    "frames_received", "bytes_received", "packets_dropped", "frames_skipped", "frames_stale", "samples_lost"
+};
+
+// Anneaux enregistrés (un par thread ayant publié au moins une mesure)
+static _Atomic(StatsRing*) rings[STATS_MAX_THREADS];
+static _Atomic int ringCount = 0;
+static _Thread_local StatsRing* threadRing = NULL;
+static _Thread_local bool threadRingUnavailable = false;
+
+static _Atomic uint64_t counters[STAT_COUNTER_COUNT];
+
+// État du collecteur
+static StageWindow windows[STAT_STAGE_COUNT];
+static StatSample history[STATS_HISTORY_SIZE];
+static uint32_t historyCount = 0;
+static uint32_t historyNext = 0;
+
+static StatsRing* GetThreadRing(void) {
+    if (threadRing || threadRingUnavailable) return threadRing;
+    
+    // Réservation d'un emplacement sans verrou
+    int slot = atomic_fetch_add(&ringCount, 1);
+    if (slot >= STATS_MAX_THREADS) {
+        threadRingUnavailable = true;
+        return NULL;
+    }
+    
+    StatsRing* ring = (StatsRing*)calloc(1, sizeof(StatsRing));
+    if (!ring) {
+        threadRingUnavailable = true;
+        return NULL;
+    }
+    ring->index = (uint8_t)slot;
+    
+    // Publication : le collecteur ignore les emplacements encore NULL
+    atomic_store_explicit(&rings[slot], ring, memory_order_release);
+    threadRing = ring;
+    return ring;
+}
+
+void StatsInit(void) {
+    memset(windows, 0, sizeof(windows));
+    historyCount = 0;
+    historyNext = 0;
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+        atomic_store(&counters[i], 0);
+    }
+}
+
+void StatsShutdown(void) {
+    int count = atomic_load(&ringCount);
+    if (count > STATS_MAX_THREADS) count = STATS_MAX_THREADS;
+    
+    for (int i = 0; i < count; i++) {
+        free(atomic_exchange(&rings[i], NULL));
+    }
+    atomic_store(&ringCount, 0);
+    threadRing = NULL;
+    threadRingUnavailable = false;
+}
+
+void StatsRecordFrame(StatStage stage, uint64_t durationNs, uint32_t frameId) {
+    if ((unsigned)stage >= STAT_STAGE_COUNT) return;
+    
+    StatsRing* ring = GetThreadRing();
+    if (!ring) {
+        atomic_fetch_add_explicit(&counters[STAT_COUNTER_SAMPLES_LOST], 1, memory_order_relaxed);
+        return;
+    }
+    
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= STATS_RING_CAPACITY) {
+        // Anneau plein : on perd la mesure plutôt que de bloquer le pipeline
+        atomic_fetch_add_explicit(&counters[STAT_COUNTER_SAMPLES_LOST], 1, memory_order_relaxed);
+        return;
+    }
+    
+    StatSample* sample = &ring->samples[head & (STATS_RING_CAPACITY - 1)];
+    sample->endNs = ClockNowNs();
+    sample->durationNs = durationNs > UINT32_MAX ? UINT32_MAX : (uint32_t)durationNs;
+    sample->frameId = frameId;
+    sample->stage = (uint8_t)stage;
+    sample->thread = ring->index;
+    
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void StatsRecord(StatStage stage, uint64_t durationNs) {
+    StatsRecordFrame(stage, durationNs, 0);
+}
+
+void StatsEnd(StatStage stage, uint64_t startNs) {
+    StatsRecordFrame(stage, ClockNowNs() - startNs, 0);
+}
+
+void StatsEndFrame(StatStage stage, uint64_t startNs, uint32_t frameId) {
+    StatsRecordFrame(stage, ClockNowNs() - startNs, frameId);
+}
+
+void StatsSetThreadName(const char* name) {
+    StatsRing* ring = GetThreadRing();
+    if (!ring || !name) return;
+    
+    strncpy(ring->name, name, sizeof(ring->name) - 1);
+    ring->name[sizeof(ring->name) - 1] = '\0';
+}
+
+const char* StatsGetThreadName(int threadIndex) {
+    int count = atomic_load(&ringCount);
+    if (threadIndex < 0 || threadIndex >= count || threadIndex >= STATS_MAX_THREADS) return NULL;
+    
+    StatsRing* ring = atomic_load_explicit(&rings[threadIndex], memory_order_acquire);
+    if (!ring || ring->name[0] == '\0') return NULL;
+    return ring->name;
+}
+
+void StatsAddCounter(StatCounter counter, uint64_t value) {
+    if ((unsigned)counter >= STAT_COUNTER_COUNT) return;
+    atomic_fetch_add_explicit(&counters[counter], value, memory_order_relaxed);
+}
+
+static int HistogramBucket(uint32_t durationNs) {
+    uint32_t us = durationNs / 1000;
+    int bucket = 0;
+    while (us > 0 && bucket < STATS_HISTOGRAM_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void StatsCollect(void) {
+    int count = atomic_load(&ringCount);
+    if (count > STATS_MAX_THREADS) count = STATS_MAX_THREADS;
+    
+    for (int r = 0; r < count; r++) {
+        StatsRing* ring = atomic_load_explicit(&rings[r], memory_order_acquire);
+        if (!ring) continue;
+        
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        
+        for (; tail != head; tail++) {
+            const StatSample* sample = &ring->samples[tail & (STATS_RING_CAPACITY - 1)];
+            StageWindow* window = &windows[sample->stage];
+            
+            window->durationsNs[window->next] = sample->durationNs;
+            window->next = (window->next + 1) % STATS_WINDOW_SIZE;
+            if (window->count < STATS_WINDOW_SIZE) window->count++;
+            window->totalCount++;
+            window->histogram[HistogramBucket(sample->durationNs)]++;
+            
+            history[historyNext] = *sample;
+            historyNext = (historyNext + 1) % STATS_HISTORY_SIZE;
+            if (historyCount < STATS_HISTORY_SIZE) historyCount++;
+            
+            TraceAppend(sample->endNs - sample->durationNs, sample->durationNs,
+                        sample->frameId, sample->stage, sample->thread);
+        }
+        
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+}
+
+static int CompareU32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void StatsGetSnapshot(StatsSnapshot* snapshot) {
+    if (!snapshot) return;
+    memset(snapshot, 0, sizeof(*snapshot));
+    
+    uint32_t sorted[STATS_WINDOW_SIZE];
+    for (int s = 0; s < STAT_STAGE_COUNT; s++) {
+        const StageWindow* window = &windows[s];
+        StatStageSummary* summary = &snapshot->stages[s];
+        
+        summary->windowCount = window->count;
+        summary->totalCount = window->totalCount;
+        memcpy(summary->histogram, window->histogram, sizeof(summary->histogram));
+        if (window->count == 0) continue;
+        
+        memcpy(sorted, window->durationsNs, window->count * sizeof(uint32_t));
+        qsort(sorted, window->count, sizeof(uint32_t), CompareU32);
+        
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < window->count; i++) sum += sorted[i];
+        
+        summary->meanMs = ClockNsToMs((int64_t)(sum / window->count));
+        summary->p50Ms = ClockNsToMs(sorted[(window->count - 1) / 2]);
+        summary->p99Ms = ClockNsToMs(sorted[(window->count - 1) * 99 / 100]);
+        summary->maxMs = ClockNsToMs(sorted[window->count - 1]);
+    }
+    
+    for (int c = 0; c < STAT_COUNTER_COUNT; c++) {
+        snapshot->counters[c] = atomic_load_explicit(&counters[c], memory_order_relaxed);
+    }
+}
+
+const char* StatsStageName(StatStage stage) {
+    return (unsigned)stage < STAT_STAGE_COUNT ? stageNames[stage] : "unknown";
+}
+
+const char* StatsCounterName(StatCounter counter) {
+    return (unsigned)counter < STAT_COUNTER_COUNT ? counterNames[counter] : "unknown";
+}
+
+bool StatsExportCsv(const char* path) {
+    if (!path) return false;
+    
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        LOG_ERROR(LOG_MODULE_STATS, "Impossible d'ouvrir %s pour l'export des statistiques", path);
+        return false;
+    }
+    
+    StatsSnapshot snapshot;
+    StatsGetSnapshot(&snapshot);
+    
+    // Résumés par étape
+    fprintf(file, "# stages\nstage,count,mean_ms,p50_ms,p99_ms,max_ms\n");
+    for (int s = 0; s < STAT_STAGE_COUNT; s++) {
+        const StatStageSummary* summary = &snapshot.stages[s];
+        fprintf(file, "%s,%llu,%.4f,%.4f,%.4f,%.4f\n", stageNames[s],
+                (unsigned long long)summary->totalCount,
+                summary->meanMs, summary->p50Ms, summary->p99Ms, summary->maxMs);
+    }
+    
+    // Histogrammes (bornes supérieures en microsecondes)
+    fprintf(file, "\n# histograms\nstage,bucket_max_us,count\n");
+    for (int s = 0; s < STAT_STAGE_COUNT; s++) {
+        for (int b = 0; b < STATS_HISTOGRAM_BUCKETS; b++) {
+            if (snapshot.stages[s].histogram[b] == 0) continue;
+            fprintf(file, "%s,%llu,%llu\n", stageNames[s], 1ULL << b,
+                    (unsigned long long)snapshot.stages[s].histogram[b]);
+        }
+    }
+    
+    fprintf(file, "\n# counters\ncounter,value\n");
+    for (int c = 0; c < STAT_COUNTER_COUNT; c++) {
+        fprintf(file, "%s,%llu\n", counterNames[c], (unsigned long long)snapshot.counters[c]);
+    }
+    
+    // Mesures brutes, de la plus ancienne à la plus récente
+    fprintf(file, "\n# samples\nend_ns,stage,duration_ns,frame_id,thread\n");
+    uint32_t first = (historyNext + STATS_HISTORY_SIZE - historyCount) % STATS_HISTORY_SIZE;
+    for (uint32_t i = 0; i < historyCount; i++) {
+        const StatSample* sample = &history[(first + i) % STATS_HISTORY_SIZE];
+        fprintf(file, "%llu,%s,%u,%u,%u\n", (unsigned long long)sample->endNs,
+                stageNames[sample->stage], sample->durationNs, sample->frameId, sample->thread);
+    }
+    
+    fclose(file);
+    LOG_INFO(LOG_MODULE_STATS, "Statistiques exportées dans %s", path);
+    return true;
+}
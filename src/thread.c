@@ -0,0 +1,149 @@
+#include "../include/thread.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Fonction et argument transmis au point d'entrée natif
+typedef struct {
+    ThreadFunc func;
+    void* arg;
+} ThreadStart;
+
+#ifdef _WIN32
+static DWORD WINAPI ThreadEntry(LPVOID param) {
+    ThreadStart start = *(ThreadStart*)param;
+    free(param);
+    return (DWORD)start.func(start.arg);
+}
+#else
+static void* ThreadEntry(void* param) {
+    ThreadStart start = *(ThreadStart*)param;
+    free(param);
+    return (void*)(intptr_t)start.func(start.arg);
+}
+#endif
+
+bool ThreadCreate(Thread* thread, ThreadFunc func, void* arg) {
+    if (!thread || !func) return false;
+    
+    ThreadStart* start = (ThreadStart*)malloc(sizeof(ThreadStart));
+    if (!start) return false;
+    start->func = func;
+    start->arg = arg;
+    
+#ifdef _WIN32
+    HANDLE handle = CreateThread(NULL, 0, ThreadEntry, start, 0, NULL);
+    if (!handle) {
+        free(start);
+        return false;
+    }
+    thread->handle = (uintptr_t)handle;
+#else
+    pthread_t handle;
+    if (pthread_create(&handle, NULL, ThreadEntry, start) != 0) {
+        free(start);
+        return false;
+    }
+    thread->handle = (uintptr_t)handle;
+#endif
+    return true;
+}
+
+void ThreadJoin(Thread* thread) {
+    if (!thread || !thread->handle) return;
+    
+#ifdef _WIN32
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+#else
+    pthread_join((pthread_t)thread->handle, NULL);
+#endif
+    thread->handle = 0;
+}
+
+void ThreadSleepMs(uint32_t ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+bool SemaphoreCreate(Semaphore* semaphore, uint32_t initial) {
+    if (!semaphore) return false;
+    
+#ifdef _WIN32
+    HANDLE handle = CreateSemaphoreA(NULL, (LONG)initial, 0x7FFFFFFF, NULL);
+    if (!handle) return false;
+    semaphore->handle = (uintptr_t)handle;
+#else
+    sem_t* handle = (sem_t*)malloc(sizeof(sem_t));
+    if (!handle) return false;
+    if (sem_init(handle, 0, initial) != 0) {
+        free(handle);
+        return false;
+    }
+    semaphore->handle = (uintptr_t)handle;
+#endif
+    return true;
+}
+
+void SemaphorePost(Semaphore* semaphore, uint32_t count) {
+    if (!semaphore || !semaphore->handle || count == 0) return;
+    
+#ifdef _WIN32
+    ReleaseSemaphore((HANDLE)semaphore->handle, (LONG)count, NULL);
+#else
+    for (uint32_t i = 0; i < count; i++) {
+        sem_post((sem_t*)semaphore->handle);
+    }
+#endif
+}
+
+void SemaphoreWait(Semaphore* semaphore) {
+    if (!semaphore || !semaphore->handle) return;
+    
+#ifdef _WIN32
+    WaitForSingleObject((HANDLE)semaphore->handle, INFINITE);
+#else
+    // Signal reçu pendant l'attente : on attend de nouveau
+    while (sem_wait((sem_t*)semaphore->handle) != 0) {
+    }
+#endif
+}
+
+void SemaphoreDestroy(Semaphore* semaphore) {
+    if (!semaphore || !semaphore->handle) return;
+    
+#ifdef _WIN32
+    CloseHandle((HANDLE)semaphore->handle);
+#else
+    sem_destroy((sem_t*)semaphore->handle);
+    free((sem_t*)semaphore->handle);
+#endif
+    semaphore->handle = 0;
+}
+
+int ThreadCpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
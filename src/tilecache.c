@@ -0,0 +1,261 @@
+#include "../include/tilecache.h"
+#include "../include/protocol.h"
+#include "../include/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+// SSE2 fait partie de l'ABI x86-64 : pas de détection à l'exécution
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TILE_HASH_SSE2 1
+#endif
+
+#define HASH_PRIME32 0x9E3779B1u
+#define HASH_PRIME64 0x9E3779B97F4A7C15ULL
+
+// Octets accumulés par bloc : 8 voies de 64 bits
+#define HASH_STRIPE 64
+
+// Clé mélangée aux données de chaque voie (constantes arbitraires)
+static const uint64_t hashKey[8] = {
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL,
+    0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL, 0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL
+};
+
+// Fonctions utilitaires privées
+static uint64_t Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+#ifdef TILE_HASH_SSE2
+// Bloc de 64 octets : voie i += produit des moitiés de (données ^ clé), voie i ^ 1 += données
+static void HashStripe(__m128i* acc, const uint8_t* p) {
+    for (int i = 0; i < 4; i++) {
+        __m128i data = _mm_loadu_si128((const __m128i*)(p + i * 16));
+        __m128i key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)(hashKey + 2 * i)));
+        __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, swapped));
+    }
+}
+
+// Brassage entre deux lignes, pour que les bits hauts des produits se propagent
+static void HashScramble(__m128i* acc) {
+    const __m128i prime = _mm_set1_epi32((int)HASH_PRIME32);
+    for (int i = 0; i < 4; i++) {
+        __m128i value = _mm_xor_si128(acc[i], _mm_srli_epi64(acc[i], 47));
+        value = _mm_xor_si128(value, _mm_loadu_si128((const __m128i*)(hashKey + 2 * i)));
+        __m128i low = _mm_mul_epu32(value, prime);
+        __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)), prime);
+        acc[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+    }
+}
+#else
+static void HashStripe(uint64_t* acc, const uint8_t* p) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t data;
+        memcpy(&data, p + i * 8, sizeof(data));
+        uint64_t key = data ^ hashKey[i];
+        acc[i ^ 1] += data;
+        acc[i] += (key & 0xFFFFFFFFu) * (key >> 32);
+    }
+}
+
+static void HashScramble(uint64_t* acc) {
+    for (int i = 0; i < 8; i++) {
+        acc[i] = ((acc[i] ^ (acc[i] >> 47)) ^ hashKey[i]) * HASH_PRIME32;
+    }
+}
+#endif
+
+static void LruUnlink(TileCache* cache, int slot) {
+    TileCacheEntry* entry = &cache->entries[slot];
+    if (entry->newer >= 0) cache->entries[entry->newer].older = entry->older;
+    else cache->newest = entry->older;
+    if (entry->older >= 0) cache->entries[entry->older].newer = entry->newer;
+    else cache->oldest = entry->newer;
+    entry->newer = -1;
+    entry->older = -1;
+}
+
+static void LruPushNewest(TileCache* cache, int slot) {
+    TileCacheEntry* entry = &cache->entries[slot];
+    entry->newer = -1;
+    entry->older = cache->newest;
+    if (cache->newest >= 0) cache->entries[cache->newest].newer = (int16_t)slot;
+    else cache->oldest = (int16_t)slot;
+    cache->newest = (int16_t)slot;
+}
+
+static int BucketOf(uint64_t hash) {
+    return (int)((hash ^ (hash >> 32)) & (TILE_CACHE_BUCKETS - 1));
+}
+
+static void BucketRemove(TileCache* cache, int slot) {
+    int16_t* link = &cache->buckets[BucketOf(cache->entries[slot].hash)];
+    while (*link >= 0 && *link != slot) link = &cache->entries[*link].chain;
+    if (*link == slot) *link = cache->entries[slot].chain;
+    cache->entries[slot].chain = -1;
+}
+
+// Implémentation des fonctions publiques
+uint64_t TileHash(const uint8_t* pixels, size_t stride, int width, int height) {
+    size_t rowSize = (size_t)width * 4;
+    size_t stripes = rowSize / HASH_STRIPE;
+    uint64_t tail = HASH_PRIME64;
+    
+#ifdef TILE_HASH_SSE2
+    __m128i acc[4];
+    for (int i = 0; i < 4; i++) acc[i] = _mm_set_epi64x((long long)hashKey[2 * i + 1], (long long)hashKey[2 * i]);
+#else
+    uint64_t acc[8];
+    memcpy(acc, hashKey, sizeof(acc));
+#endif
+    
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        for (size_t s = 0; s < stripes; s++) {
+            HashStripe(acc, row + s * HASH_STRIPE);
+        }
+        HashScramble(acc);
+        
+        // Fin de ligne des tuiles du bord : pixel par pixel
+        for (size_t x = stripes * HASH_STRIPE; x < rowSize; x += 4) {
+            uint32_t pixel;
+            memcpy(&pixel, row + x, sizeof(pixel));
+            tail = RotateLeft(tail ^ (pixel * (uint64_t)HASH_PRIME32), 31) * HASH_PRIME64;
+        }
+    }
+    
+    uint64_t lanes[8];
+#ifdef TILE_HASH_SSE2
+    for (int i = 0; i < 4; i++) _mm_storeu_si128((__m128i*)(lanes + 2 * i), acc[i]);
+#else
+    memcpy(lanes, acc, sizeof(lanes));
+#endif
+    
+    uint64_t hash = Avalanche(((uint64_t)width << 32 | (uint32_t)height) ^ tail);
+    for (int i = 0; i < 8; i++) {
+        hash = RotateLeft(hash ^ Avalanche(lanes[i] + hashKey[i]), 27) * HASH_PRIME64;
+    }
+    return Avalanche(hash);
+}
+
+void TileCacheReset(TileCache* cache) {
+    if (!cache) return;
+    
+    memset(cache->entries, 0, sizeof(cache->entries));
+    for (int i = 0; i < TILE_CACHE_SLOTS; i++) {
+        cache->entries[i].newer = -1;
+        cache->entries[i].older = -1;
+        cache->entries[i].chain = -1;
+    }
+    for (int i = 0; i < TILE_CACHE_BUCKETS; i++) {
+        cache->buckets[i] = -1;
+    }
+    cache->newest = -1;
+    cache->oldest = -1;
+    cache->used = 0;
+}
+
+void TileCacheConfirm(TileCache* cache, uint32_t baseFrameId, uint64_t appliedFrames) {
+    if (!cache || baseFrameId == 0 || appliedFrames == 0) return;
+    
+    for (int slot = 0; slot < TILE_CACHE_SLOTS; slot++) {
+        TileCacheEntry* entry = &cache->entries[slot];
+        if (!entry->used || entry->confirmed || WireSequenceNewer(entry->storeFrameId, baseFrameId)) continue;
+        
+        // Au-delà de la fenêtre, l'application n'est plus connue : la tuile sera transmise à nouveau
+        uint32_t age = baseFrameId - entry->storeFrameId;
+        if (age < TILE_CACHE_CONFIRM_WINDOW && (appliedFrames >> age) & 1) {
+            entry->confirmed = true;
+        }
+    }
+}
+
+int TileCacheFind(TileCache* cache, uint64_t hash) {
+    if (!cache || cache->used == 0) return -1;
+    
+    for (int slot = cache->buckets[BucketOf(hash)]; slot >= 0; slot = cache->entries[slot].chain) {
+        if (cache->entries[slot].hash == hash) {
+            LruUnlink(cache, slot);
+            LruPushNewest(cache, slot);
+            return slot;
+        }
+    }
+    return -1;
+}
+
+int TileCacheStore(TileCache* cache, uint64_t hash, uint32_t frameId) {
+    int slot = TileCacheFind(cache, hash);
+    
+    if (slot < 0) {
+        // Emplacement libre tant que le cache se remplit, sinon le moins récemment utilisé
+        if (cache->used < TILE_CACHE_SLOTS) {
+            slot = cache->used++;
+        } else {
+            slot = cache->oldest;
+            BucketRemove(cache, slot);
+            LruUnlink(cache, slot);
+        }
+        
+        TileCacheEntry* entry = &cache->entries[slot];
+        int bucket = BucketOf(hash);
+        entry->hash = hash;
+        entry->used = true;
+        entry->chain = cache->buckets[bucket];
+        cache->buckets[bucket] = (int16_t)slot;
+        LruPushNewest(cache, slot);
+    }
+    
+    cache->entries[slot].storeFrameId = frameId;
+    cache->entries[slot].confirmed = false;
+    return slot;
+}
+
+bool TileCacheMirrorStore(TileCacheMirror* mirror, int slot, const uint8_t* pixels, size_t stride, int tileSize) {
+    if (!mirror || !pixels || slot < 0 || slot >= TILE_CACHE_SLOTS || tileSize <= 0) return false;
+    
+    // Nouvelle taille de tuile : les emplacements existants ne sont plus réutilisables
+    if (mirror->tileSize != tileSize) {
+        TileCacheMirrorFree(mirror);
+        mirror->tileSize = tileSize;
+    }
+    
+    size_t rowSize = (size_t)tileSize * 4;
+    if (!mirror->slots[slot]) {
+        mirror->slots[slot] = (uint8_t*)malloc(rowSize * tileSize);
+        if (!mirror->slots[slot]) {
+            LOG_ERROR(LOG_MODULE_APP, "Impossible d'allouer l'emplacement %d du cache de tuiles", slot);
+            return false;
+        }
+    }
+    
+    for (int y = 0; y < tileSize; y++) {
+        memcpy(mirror->slots[slot] + (size_t)y * rowSize, pixels + (size_t)y * stride, rowSize);
+    }
+    return true;
+}
+
+const uint8_t* TileCacheMirrorGet(const TileCacheMirror* mirror, int slot, int tileSize) {
+    if (!mirror || slot < 0 || slot >= TILE_CACHE_SLOTS || mirror->tileSize != tileSize) return NULL;
+    return mirror->slots[slot];
+}
+
+void TileCacheMirrorFree(TileCacheMirror* mirror) {
+    if (!mirror) return;
+    
+    for (int i = 0; i < TILE_CACHE_SLOTS; i++) {
+        free(mirror->slots[i]);
+    }
+    memset(mirror, 0, sizeof(*mirror));
+}
@@ -0,0 +1,614 @@
+#include "../include/tilecodec.h"
+#include <string.h>
+
+// SSE2 fait partie de l'ABI x86-64 : pas de détection à l'exécution
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TILE_CODEC_SSE2 1
+#endif
+
+// Canaux RGB d'un pixel RGBA lu en little-endian : l'alpha n'est ni mesuré ni transmis
+#define RGB_MASK 0x00FFFFFFu
+#define ALPHA_OPAQUE 0xFF000000u
+
+// Table des couleurs de l'analyse (puissance de 2, plus du double de TILE_LOSSLESS_MAX_COLORS)
+#define COLOR_TABLE_BITS 9
+#define COLOR_TABLE_SIZE (1 << COLOR_TABLE_BITS)
+
+// Préfixe unaire à partir duquel un résidu est écrit tel quel sur 8 bits
+#define RICE_ESCAPE 16
+
+// Plages de la palette : 1 à 15 pixels dans l'octet, 16 à 271 avec un octet de plus
+#define PALETTE_SHORT_RUN 15
+#define PALETTE_LONG_RUN (16 + 255)
+
+// Plage la plus longue du codage sans perte (bits du préfixe gamma)
+#define RUN_MAX_BITS 13
+
+// Opérations de QOI (qoiformat.org) sans alpha, état remis à zéro à chaque tuile
+#define QOI_OP_INDEX 0x00       // 00iiiiii : couleur récente de la table
+#define QOI_OP_DIFF 0x40        // 01rrggbb : écarts de -2 à 1
+#define QOI_OP_LUMA 0x80        // 10gggggg puis rrrrbbbb : écart du vert, rouge et bleu relatifs au vert
+#define QOI_OP_RUN 0xC0         // 11llllll : répétition du pixel précédent (1 à 62)
+#define QOI_OP_RGB 0xFE         // Puis rouge, vert, bleu
+#define QOI_OP_MASK 0xC0
+#define QOI_RUN_MAX 62
+
+typedef struct {
+    uint8_t* data;
+    int capacity;
+    int size;
+    uint64_t bits;              // Bits en attente, le premier écrit en poids faible
+    int count;
+    bool overflow;
+} BitWriter;
+
+typedef struct {
+    const uint8_t* data;
+    int size;
+    int position;
+    uint64_t bits;
+    int count;
+    bool overrun;               // Lecture au-delà des données
+} BitReader;
+
+// Paramètre de Rice d'un canal, adapté à la moyenne glissante des résidus (comme LOCO-I)
+typedef struct {
+    uint32_t sum;
+    uint32_t count;
+} RiceState;
+
+static const uint8_t bitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// Fonctions utilitaires privées
+static uint32_t ReadPixel(const uint8_t* p) {
+    uint32_t pixel;
+    memcpy(&pixel, p, sizeof(pixel));
+    return pixel & RGB_MASK;
+}
+
+static void WritePixel(uint8_t* p, uint32_t rgb) {
+    uint32_t pixel = rgb | ALPHA_OPAQUE;
+    memcpy(p, &pixel, sizeof(pixel));
+}
+
+// Différence et somme canal par canal (modulo 256) de deux pixels RGB, sans retenue entre canaux
+static uint32_t SubtractPixel(uint32_t a, uint32_t b) {
+    return (((a | 0x80808080u) - (b & 0x7F7F7F7Fu)) ^ ((a ^ ~b) & 0x80808080u)) & RGB_MASK;
+}
+
+static uint32_t AddPixel(uint32_t a, uint32_t b) {
+    return (((a & 0x7F7F7F7Fu) + (b & 0x7F7F7F7Fu)) ^ ((a ^ b) & 0x80808080u)) & RGB_MASK;
+}
+
+static void AddColor(uint32_t* table, int* colors, uint32_t pixel) {
+    if (*colors > TILE_LOSSLESS_MAX_COLORS) return;
+    
+    // Clé jamais nulle : l'alpha forcé distingue une entrée du noir
+    uint32_t key = pixel | ALPHA_OPAQUE;
+    uint32_t slot = (key * 0x9E3779B1u) >> (32 - COLOR_TABLE_BITS);
+    while (table[slot] != 0) {
+        if (table[slot] == key) return;
+        slot = (slot + 1) & (COLOR_TABLE_SIZE - 1);
+    }
+    table[slot] = key;
+    (*colors)++;
+}
+
+static void PutBits(BitWriter* w, uint32_t value, int n) {
+    w->bits |= (uint64_t)value << w->count;
+    w->count += n;
+    while (w->count >= 8) {
+        if (w->size < w->capacity) w->data[w->size++] = (uint8_t)w->bits;
+        else w->overflow = true;
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+static void FlushBits(BitWriter* w) {
+    if (w->count > 0) PutBits(w, 0, 8 - w->count);
+}
+
+static uint32_t GetBits(BitReader* r, int n) {
+    while (r->count < n) {
+        uint64_t byte = 0;
+        if (r->position < r->size) byte = r->data[r->position++];
+        else r->overrun = true;
+        r->bits |= byte << r->count;
+        r->count += 8;
+    }
+    uint32_t value = (uint32_t)(r->bits & ((1ULL << n) - 1));
+    r->bits >>= n;
+    r->count -= n;
+    return value;
+}
+
+// q bits à 1 puis un 0 (q < 32)
+static void PutUnary(BitWriter* w, int q) {
+    PutBits(w, (1u << q) - 1, q);
+    PutBits(w, 0, 1);
+}
+
+// Le 0 final n'est pas lu quand la limite est atteinte
+static int GetUnary(BitReader* r, int limit) {
+    int q = 0;
+    while (q < limit && !r->overrun && GetBits(r, 1)) q++;
+    return q;
+}
+
+static int RiceParameter(const RiceState* state) {
+    int k = 0;
+    while (k < 7 && (state->count << k) < state->sum) k++;
+    return k;
+}
+
+static void RiceUpdate(RiceState* state, uint32_t value) {
+    state->sum += value;
+    if (++state->count == 64) {
+        state->sum >>= 1;
+        state->count >>= 1;
+    }
+}
+
+static void PutRice(BitWriter* w, RiceState* state, uint32_t value) {
+    int k = RiceParameter(state);
+    uint32_t q = value >> k;
+    if (q < RICE_ESCAPE) {
+        PutUnary(w, (int)q);
+        PutBits(w, value & ((1u << k) - 1), k);
+    } else {
+        PutBits(w, (1u << RICE_ESCAPE) - 1, RICE_ESCAPE);
+        PutBits(w, value, 8);
+    }
+    RiceUpdate(state, value);
+}
+
+static uint32_t GetRice(BitReader* r, RiceState* state) {
+    int k = RiceParameter(state);
+    int q = GetUnary(r, RICE_ESCAPE);
+    uint32_t value = q < RICE_ESCAPE ? ((uint32_t)q << k) | GetBits(r, k) : GetBits(r, 8);
+    RiceUpdate(state, value);
+    return value;
+}
+
+// Code gamma d'une plage (value >= 1)
+static void PutGamma(BitWriter* w, uint32_t value) {
+    int n = 0;
+    while ((value >> (n + 1)) != 0) n++;
+    PutUnary(w, n);
+    PutBits(w, value - (1u << n), n);
+}
+
+static uint32_t GetGamma(BitReader* r) {
+    int n = GetUnary(r, RUN_MAX_BITS);
+    if (n >= RUN_MAX_BITS) {
+        r->overrun = true;
+        return 0;
+    }
+    return (1u << n) + GetBits(r, n);
+}
+
+// Canaux décorrélés : vert, rouge - vert, bleu - vert (modulo 256)
+static void Decorrelate(uint32_t pixel, int* channels) {
+    int red = pixel & 0xFF;
+    int green = (pixel >> 8) & 0xFF;
+    int blue = (pixel >> 16) & 0xFF;
+    channels[0] = green;
+    channels[1] = (red - green) & 0xFF;
+    channels[2] = (blue - green) & 0xFF;
+}
+
+static uint32_t Correlate(const int* channels) {
+    uint32_t green = (uint32_t)channels[0];
+    uint32_t red = (uint32_t)(channels[1] + channels[0]) & 0xFF;
+    uint32_t blue = (uint32_t)(channels[2] + channels[0]) & 0xFF;
+    return red | (green << 8) | (blue << 16);
+}
+
+// Prédicteur MED de LOCO-I : gauche, haut ou plan selon le contour détecté
+static int PredictMed(int left, int up, int upLeft) {
+    int low = left < up ? left : up;
+    int high = left < up ? up : left;
+    if (upLeft >= high) return low;
+    if (upLeft <= low) return high;
+    return left + up - upLeft;
+}
+
+// Voisins (gauche, haut, haut gauche) d'un pixel, décorrélés ; repliés sur les bords de la tuile
+static void Neighbors(const uint8_t* pixels, size_t stride, int x, int y, int* left, int* up, int* upLeft) {
+    uint32_t a = x > 0 ? ReadPixel(pixels + (size_t)y * stride + (size_t)(x - 1) * 4)
+                       : (y > 0 ? ReadPixel(pixels + (size_t)(y - 1) * stride) : 0);
+    uint32_t b = y > 0 ? ReadPixel(pixels + (size_t)(y - 1) * stride + (size_t)x * 4) : a;
+    uint32_t c = x > 0 && y > 0 ? ReadPixel(pixels + (size_t)(y - 1) * stride + (size_t)(x - 1) * 4) : b;
+    Decorrelate(a, left);
+    Decorrelate(b, up);
+    Decorrelate(c, upLeft);
+}
+
+static int PaletteIndex(const uint32_t* palette, int colors, uint32_t pixel) {
+    int index = 0;
+    while (index < colors && palette[index] != pixel) index++;
+    return index;
+}
+
+static int EncodePalette(const uint8_t* pixels, size_t stride, int width, int height,
+                         uint8_t* output, int capacity) {
+    uint32_t palette[TILE_PALETTE_MAX_COLORS];
+    int colors = 0;
+    int total = width * height;
+    
+    // Palette dans l'ordre d'apparition
+    uint32_t last = 0;
+    for (int i = 0; i < total; i++) {
+        uint32_t pixel = ReadPixel(pixels + (size_t)(i / width) * stride + (size_t)(i % width) * 4);
+        if (colors > 0 && pixel == last) continue;
+        last = pixel;
+        if (PaletteIndex(palette, colors, pixel) == colors) {
+            if (colors == TILE_PALETTE_MAX_COLORS) return 0;
+            palette[colors++] = pixel;
+        }
+    }
+    
+    int size = 1 + colors * 3;
+    if (size > capacity) return 0;
+    output[0] = (uint8_t)(colors - 1);
+    for (int c = 0; c < colors; c++) {
+        output[1 + c * 3] = (uint8_t)palette[c];
+        output[2 + c * 3] = (uint8_t)(palette[c] >> 8);
+        output[3 + c * 3] = (uint8_t)(palette[c] >> 16);
+    }
+    
+    // Plages en ordre de balayage : indice dans les 4 bits hauts, longueur dans les 4 bits bas
+    // (0 : longueur de 16 à 271 dans l'octet suivant)
+    for (int i = 0; i < total; ) {
+        uint32_t pixel = ReadPixel(pixels + (size_t)(i / width) * stride + (size_t)(i % width) * 4);
+        int index = PaletteIndex(palette, colors, pixel);
+        int run = 1;
+        while (i + run < total && run < PALETTE_LONG_RUN &&
+               ReadPixel(pixels + (size_t)((i + run) / width) * stride + (size_t)((i + run) % width) * 4) == pixel) {
+            run++;
+        }
+        
+        if (run > PALETTE_SHORT_RUN) {
+            if (size + 2 > capacity) return 0;
+            output[size++] = (uint8_t)(index << 4);
+            output[size++] = (uint8_t)(run - 16);
+        } else {
+            if (size + 1 > capacity) return 0;
+            output[size++] = (uint8_t)((index << 4) | run);
+        }
+        i += run;
+    }
+    return size;
+}
+
+static bool DecodePalette(const uint8_t* data, int size, uint8_t* pixels, size_t stride, int width, int height) {
+    if (size < 1) return false;
+    int colors = data[0] + 1;
+    if (colors > TILE_PALETTE_MAX_COLORS || size < 1 + colors * 3) return false;
+    
+    uint32_t palette[TILE_PALETTE_MAX_COLORS];
+    for (int c = 0; c < colors; c++) {
+        palette[c] = data[1 + c * 3] | ((uint32_t)data[2 + c * 3] << 8) | ((uint32_t)data[3 + c * 3] << 16);
+    }
+    
+    int position = 1 + colors * 3;
+    int total = width * height;
+    for (int i = 0; i < total; ) {
+        if (position >= size) return false;
+        int index = data[position] >> 4;
+        int run = data[position++] & 0x0F;
+        if (run == 0) {
+            if (position >= size) return false;
+            run = 16 + data[position++];
+        }
+        if (index >= colors || run > total - i) return false;
+        
+        for (int end = i + run; i < end; i++) {
+            WritePixel(pixels + (size_t)(i / width) * stride + (size_t)(i % width) * 4, palette[index]);
+        }
+    }
+    return position == size;
+}
+
+static int QoiHash(uint32_t rgb) {
+    return (int)(((rgb & 0xFF) * 3 + ((rgb >> 8) & 0xFF) * 5 + ((rgb >> 16) & 0xFF) * 7 + 255 * 11) & 63);
+}
+
+// Le pire cas tient dans capacity : aucune vérification par opération.
+// Avec une référence, ce sont les différences avec elle qui sont codées
+static int EncodeQoi(const uint8_t* pixels, size_t stride, const uint8_t* reference, size_t referenceStride,
+                     int width, int height, uint8_t* output, int capacity) {
+    if (capacity < TILE_QOI_MAX_SIZE(width, height)) return 0;
+    
+    uint32_t index[64] = {0};
+    uint32_t previous = 0;
+    int run = 0;
+    uint8_t* out = output;
+    
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        const uint8_t* referenceRow = reference ? reference + (size_t)y * referenceStride : NULL;
+        for (int x = 0; x < width; x++) {
+            uint32_t pixel = ReadPixel(row + (size_t)x * 4);
+            if (referenceRow) pixel = SubtractPixel(pixel, ReadPixel(referenceRow + (size_t)x * 4));
+            if (pixel == previous) {
+                if (++run == QOI_RUN_MAX) {
+                    *out++ = (uint8_t)(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *out++ = (uint8_t)(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+            
+            int slot = QoiHash(pixel);
+            if (index[slot] == pixel) {
+                *out++ = (uint8_t)(QOI_OP_INDEX | slot);
+            } else {
+                index[slot] = pixel;
+                int dr = (int8_t)(uint8_t)((pixel & 0xFF) - (previous & 0xFF));
+                int dg = (int8_t)(uint8_t)(((pixel >> 8) & 0xFF) - ((previous >> 8) & 0xFF));
+                int db = (int8_t)(uint8_t)(((pixel >> 16) & 0xFF) - ((previous >> 16) & 0xFF));
+                int drg = dr - dg;
+                int dbg = db - dg;
+                
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    *out++ = (uint8_t)(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                    *out++ = (uint8_t)(QOI_OP_LUMA | (dg + 32));
+                    *out++ = (uint8_t)((drg + 8) << 4 | (dbg + 8));
+                } else {
+                    *out++ = QOI_OP_RGB;
+                    *out++ = (uint8_t)pixel;
+                    *out++ = (uint8_t)(pixel >> 8);
+                    *out++ = (uint8_t)(pixel >> 16);
+                }
+            }
+            previous = pixel;
+        }
+    }
+    if (run > 0) *out++ = (uint8_t)(QOI_OP_RUN | (run - 1));
+    return (int)(out - output);
+}
+
+static bool DecodeQoi(const uint8_t* data, int size, const uint8_t* reference, size_t referenceStride,
+                      uint8_t* pixels, size_t stride, int width, int height) {
+    uint32_t index[64] = {0};
+    uint32_t previous = 0;
+    int position = 0;
+    int run = 0;
+    
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = pixels + (size_t)y * stride;
+        const uint8_t* referenceRow = reference ? reference + (size_t)y * referenceStride : NULL;
+        for (int x = 0; x < width; x++) {
+            if (run > 0) {
+                run--;
+                WritePixel(row + (size_t)x * 4, referenceRow ? AddPixel(previous, ReadPixel(referenceRow + (size_t)x * 4)) : previous);
+                continue;
+            }
+            if (position >= size) return false;
+            
+            int op = data[position++];
+            if (op == QOI_OP_RGB) {
+                if (size - position < 3) return false;
+                previous = data[position] | ((uint32_t)data[position + 1] << 8) | ((uint32_t)data[position + 2] << 16);
+                position += 3;
+            } else if ((op & QOI_OP_MASK) == QOI_OP_INDEX) {
+                previous = index[op];
+            } else if ((op & QOI_OP_MASK) == QOI_OP_DIFF) {
+                uint32_t red = (previous + ((op >> 4) & 3) - 2) & 0xFF;
+                uint32_t green = ((previous >> 8) + ((op >> 2) & 3) - 2) & 0xFF;
+                uint32_t blue = ((previous >> 16) + (op & 3) - 2) & 0xFF;
+                previous = red | (green << 8) | (blue << 16);
+            } else if ((op & QOI_OP_MASK) == QOI_OP_LUMA) {
+                if (position >= size) return false;
+                int dg = (op & 0x3F) - 32;
+                int next = data[position++];
+                uint32_t red = (previous + dg + (next >> 4) - 8) & 0xFF;
+                uint32_t green = ((previous >> 8) + dg) & 0xFF;
+                uint32_t blue = ((previous >> 16) + dg + (next & 0x0F) - 8) & 0xFF;
+                previous = red | (green << 8) | (blue << 16);
+            } else {
+                // Plage : ce pixel puis run autres ; 0xFF (RGBA de QOI) n'est jamais produit
+                if (op == 0xFF) return false;
+                run = op & 0x3F;
+            }
+            index[QoiHash(previous)] = previous;
+            WritePixel(row + (size_t)x * 4, referenceRow ? AddPixel(previous, ReadPixel(referenceRow + (size_t)x * 4)) : previous);
+        }
+    }
+    return run == 0 && position == size;
+}
+
+static int EncodeLossless(const uint8_t* pixels, size_t stride, int width, int height,
+                          uint8_t* output, int capacity) {
+    BitWriter w = { output, capacity, 0, 0, 0, false };
+    RiceState rice[3] = { { 2, 1 }, { 2, 1 }, { 2, 1 } };
+    int total = width * height;
+    uint32_t previous = 0;
+    bool afterRun = false;
+    
+    for (int i = 0; i < total && !w.overflow; ) {
+        int x = i % width;
+        int y = i / width;
+        uint32_t pixel = ReadPixel(pixels + (size_t)y * stride + (size_t)x * 4);
+        
+        // Plage : pixels identiques au précédent en ordre de balayage (aplats de l'interface)
+        if (i > 0 && pixel == previous) {
+            int run = 1;
+            while (i + run < total &&
+                   ReadPixel(pixels + (size_t)((i + run) / width) * stride + (size_t)((i + run) % width) * 4) == previous) {
+                run++;
+            }
+            PutBits(&w, 1, 1);
+            PutGamma(&w, (uint32_t)run);
+            i += run;
+            afterRun = true;
+            continue;
+        }
+        
+        // Après une plage, le pixel suivant diffère forcément : l'indicateur est omis
+        if (i > 0 && !afterRun) PutBits(&w, 0, 1);
+        afterRun = false;
+        
+        int channels[3], left[3], up[3], upLeft[3];
+        Decorrelate(pixel, channels);
+        Neighbors(pixels, stride, x, y, left, up, upLeft);
+        for (int c = 0; c < 3; c++) {
+            int8_t residual = (int8_t)(uint8_t)(channels[c] - PredictMed(left[c], up[c], upLeft[c]));
+            uint32_t folded = residual >= 0 ? (uint32_t)residual * 2 : (uint32_t)(-residual) * 2 - 1;
+            PutRice(&w, &rice[c], folded);
+        }
+        previous = pixel;
+        i++;
+    }
+    
+    FlushBits(&w);
+    return w.overflow ? 0 : w.size;
+}
+
+static bool DecodeLossless(const uint8_t* data, int size, uint8_t* pixels, size_t stride, int width, int height) {
+    BitReader r = { data, size, 0, 0, 0, false };
+    RiceState rice[3] = { { 2, 1 }, { 2, 1 }, { 2, 1 } };
+    int total = width * height;
+    uint32_t previous = 0;
+    bool afterRun = false;
+    
+    for (int i = 0; i < total; ) {
+        if (i > 0 && !afterRun && GetBits(&r, 1)) {
+            uint32_t run = GetGamma(&r);
+            if (r.overrun || run > (uint32_t)(total - i)) return false;
+            for (uint32_t end = (uint32_t)i + run; (uint32_t)i < end; i++) {
+                WritePixel(pixels + (size_t)(i / width) * stride + (size_t)(i % width) * 4, previous);
+            }
+            afterRun = true;
+            continue;
+        }
+        afterRun = false;
+        
+        int x = i % width;
+        int y = i / width;
+        int channels[3], left[3], up[3], upLeft[3];
+        Neighbors(pixels, stride, x, y, left, up, upLeft);
+        for (int c = 0; c < 3; c++) {
+            uint32_t folded = GetRice(&r, &rice[c]);
+            int residual = (folded & 1) ? -(int)((folded + 1) / 2) : (int)(folded / 2);
+            channels[c] = (PredictMed(left[c], up[c], upLeft[c]) + residual) & 0xFF;
+        }
+        if (r.overrun) return false;
+        
+        previous = Correlate(channels);
+        WritePixel(pixels + (size_t)y * stride + (size_t)x * 4, previous);
+        i++;
+    }
+    return !r.overrun;
+}
+
+// Implémentation des fonctions publiques
+void TileAnalyze(const uint8_t* pixels, size_t stride, int width, int height, TileFeatures* features) {
+    uint32_t table[COLOR_TABLE_SIZE];
+    memset(table, 0, sizeof(table));
+    memset(features, 0, sizeof(*features));
+    
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        AddColor(table, &features->colors, ReadPixel(row));
+        int x = 1;
+        
+#ifdef TILE_CODEC_SSE2
+        // 4 pixels comparés à leur voisin de gauche : égalité (aplats) et somme des écarts (gradient)
+        const __m128i mask = _mm_set1_epi32((int)RGB_MASK);
+        __m128i energy = _mm_setzero_si128();
+        for (; x + 4 <= width; x += 4) {
+            __m128i current = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + (size_t)x * 4)), mask);
+            __m128i left = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + (size_t)(x - 1) * 4)), mask);
+            int equal = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(current, left)));
+            features->flatPixels += bitCount[equal];
+            energy = _mm_add_epi64(energy, _mm_sad_epu8(current, left));
+            
+            // Seuls les pixels qui changent peuvent apporter une nouvelle couleur
+            for (int lane = 0; lane < 4 && equal != 0x0F; lane++) {
+                if (!(equal & (1 << lane))) AddColor(table, &features->colors, ReadPixel(row + (size_t)(x + lane) * 4));
+            }
+        }
+        uint64_t sums[2];
+        _mm_storeu_si128((__m128i*)sums, energy);
+        features->gradientEnergy += sums[0] + sums[1];
+#endif
+        
+        for (; x < width; x++) {
+            uint32_t current = ReadPixel(row + (size_t)x * 4);
+            uint32_t left = ReadPixel(row + (size_t)(x - 1) * 4);
+            if (current == left) {
+                features->flatPixels++;
+                continue;
+            }
+            for (int shift = 0; shift < 24; shift += 8) {
+                int difference = (int)((current >> shift) & 0xFF) - (int)((left >> shift) & 0xFF);
+                features->gradientEnergy += (uint64_t)(difference < 0 ? -difference : difference);
+            }
+            AddColor(table, &features->colors, current);
+        }
+    }
+}
+
+TileCodec TileChooseCodec(const TileFeatures* features, int width, int height) {
+    uint64_t pixels = (uint64_t)width * height;
+    
+    if (features->colors <= TILE_PALETTE_MAX_COLORS) return TILE_CODEC_PALETTE;
+    if (features->colors <= TILE_LOSSLESS_MAX_COLORS) return TILE_CODEC_LOSSLESS;
+    
+    // Nombreuses couleurs : interface (aplats majoritaires) ou dégradé lisse, sinon photo
+    if ((uint64_t)features->flatPixels * 2 >= pixels) return TILE_CODEC_LOSSLESS;
+    if (features->gradientEnergy < pixels * 3 * TILE_SMOOTH_GRADIENT) return TILE_CODEC_LOSSLESS;
+    return TILE_CODEC_JPEG;
+}
+
+int TileEncode(TileCodec codec, const uint8_t* pixels, size_t stride, int width, int height,
+               uint8_t* output, int capacity) {
+    if (!pixels || !output || width <= 0 || height <= 0 || capacity <= 0) return 0;
+    
+    switch (codec) {
+        case TILE_CODEC_PALETTE:
+            return EncodePalette(pixels, stride, width, height, output, capacity);
+        case TILE_CODEC_LOSSLESS:
+            return EncodeLossless(pixels, stride, width, height, output, capacity);
+        case TILE_CODEC_QOI:
+            return EncodeQoi(pixels, stride, NULL, 0, width, height, output, capacity);
+        default:
+            return 0;
+    }
+}
+
+bool TileDecode(TileCodec codec, const uint8_t* data, int size, uint8_t* pixels, size_t stride,
+                int width, int height) {
+    if (!data || !pixels || width <= 0 || height <= 0) return false;
+    
+    switch (codec) {
+        case TILE_CODEC_PALETTE:
+            return DecodePalette(data, size, pixels, stride, width, height);
+        case TILE_CODEC_LOSSLESS:
+            return DecodeLossless(data, size, pixels, stride, width, height);
+        case TILE_CODEC_QOI:
+            return DecodeQoi(data, size, NULL, 0, pixels, stride, width, height);
+        default:
+            return false;
+    }
+}
+
+int TileEncodeDelta(const uint8_t* pixels, size_t stride, const uint8_t* reference, size_t referenceStride,
+                    int width, int height, uint8_t* output, int capacity) {
+    if (!pixels || !reference || !output || width <= 0 || height <= 0) return 0;
+    return EncodeQoi(pixels, stride, reference, referenceStride, width, height, output, capacity);
+}
+
+bool TileDecodeDelta(const uint8_t* data, int size, const uint8_t* reference, size_t referenceStride,
+                     uint8_t* pixels, size_t stride, int width, int height) {
+    if (!data || !reference || !pixels || width <= 0 || height <= 0) return false;
+    return DecodeQoi(data, size, reference, referenceStride, pixels, stride, width, height);
+}
@@ -0,0 +1,837 @@
+#include "../include/tiles.h"
+#include "../include/roi.h"
+#include "../include/protocol.h"
+#include "../include/clock.h"
+#include "../include/log.h"
+#include "../include/stats.h"
+#include "../include/workers.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Fonctions utilitaires privées
+static uint32_t NewCanvasId(uint32_t previous) {
+    // Dérivé de l'horloge : distinct du canevas précédent, et en pratique de ceux d'un autre émetteur
+    uint64_t seed = (ClockNowNs() ^ ((uint64_t)previous << 32)) * 0x9E3779B97F4A7C15ULL;
+    uint32_t id = (uint32_t)(seed >> 32);
+    if (id == 0 || id == previous) id = previous + 1;
+    return id != 0 ? id : 1;
+}
+
+static int GridSize(int pixels, int tileSize) {
+    return (pixels + tileSize - 1) / tileSize;
+}
+
+static int Min(int a, int b) {
+    return a < b ? a : b;
+}
+
+static int Max(int a, int b) {
+    return a > b ? a : b;
+}
+
+// Tuiles entièrement couvertes par la destination d'une copie
+static void MarkCopiedTiles(TileHistory* history) {
+    for (int c = 0; c < history->copyCount; c++) {
+        const MotionRect* copy = &history->copies[c];
+        
+        for (int ty = 0; ty < history->rows; ty++) {
+            int y0 = ty * TILE_SIZE;
+            int y1 = Min(y0 + TILE_SIZE, history->height);
+            if (y0 < copy->dstY || y1 > copy->dstY + copy->height) continue;
+            
+            for (int tx = 0; tx < history->columns; tx++) {
+                int x0 = tx * TILE_SIZE;
+                int x1 = Min(x0 + TILE_SIZE, history->width);
+                if (x0 < copy->dstX || x1 > copy->dstX + copy->width) continue;
+                history->flags[ty * history->columns + tx] |= TILE_FLAG_COPIED;
+            }
+        }
+    }
+}
+
+// Copies de rectangles d'une image reçue : toutes les sources sont lues avant la première écriture
+static bool ApplyCopies(Image* image, const uint8_t* data, uint32_t copyCount) {
+    size_t total = 0;
+    for (uint32_t c = 0; c < copyCount; c++) {
+        const uint8_t* copy = WireTileFrameCopyRect(data, c);
+        total += (size_t)WireCopyRectWidth(copy) * WireCopyRectHeight(copy) * 4;
+    }
+    
+    uint8_t* saved = (uint8_t*)malloc(total > 0 ? total : 1);
+    if (!saved) return false;
+    
+    size_t stride = (size_t)image->width * 4;
+    uint8_t* pixels = (uint8_t*)image->data;
+    uint8_t* next = saved;
+    for (uint32_t c = 0; c < copyCount; c++) {
+        const uint8_t* copy = WireTileFrameCopyRect(data, c);
+        size_t rowSize = (size_t)WireCopyRectWidth(copy) * 4;
+        for (int y = 0; y < WireCopyRectHeight(copy); y++, next += rowSize) {
+            memcpy(next, pixels + (WireCopyRectSrcY(copy) + y) * stride + (size_t)WireCopyRectSrcX(copy) * 4, rowSize);
+        }
+    }
+    
+    next = saved;
+    for (uint32_t c = 0; c < copyCount; c++) {
+        const uint8_t* copy = WireTileFrameCopyRect(data, c);
+        size_t rowSize = (size_t)WireCopyRectWidth(copy) * 4;
+        for (int y = 0; y < WireCopyRectHeight(copy); y++, next += rowSize) {
+            memcpy(pixels + (WireCopyRectDstY(copy) + y) * stride + (size_t)WireCopyRectDstX(copy) * 4, next, rowSize);
+        }
+    }
+    
+    free(saved);
+    return true;
+}
+
+// Tuiles codées et atlas JPEG d'une image reçue, décodés en parallèle dans des zones disjointes
+typedef struct {
+    const uint8_t* data;
+    uint32_t size;
+    const uint32_t* offsets;    // Par tuile codée : début de ses données (la suivante marque la fin)
+    const uint8_t* canvas;      // Pixels du canevas, références des différences (lus seulement)
+    uint8_t* decoded;           // Une case de tileBytes par tuile codée
+    size_t tileBytes;
+    int tileSize;
+    int columns;
+    int width;
+    int height;
+    uint32_t atlasOffset;       // Début de l'atlas JPEG (size si aucun)
+    Image atlas;
+    _Atomic bool failed;
+} TileDecodeBatch;
+
+static void DecodeTileJob(void* context, int index) {
+    TileDecodeBatch* batch = (TileDecodeBatch*)context;
+    if (atomic_load_explicit(&batch->failed, memory_order_relaxed)) return;
+    
+    // L'atlas en premier : la tâche la plus longue démarre avant les tuiles
+    if (batch->atlasOffset < batch->size) {
+        if (index == 0) {
+            batch->atlas = LoadImageFromMemory(".jpg", batch->data + batch->atlasOffset,
+                                               (int)(batch->size - batch->atlasOffset));
+            if (batch->atlas.data && batch->atlas.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+                ImageFormat(&batch->atlas, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            }
+            if (!batch->atlas.data) atomic_store_explicit(&batch->failed, true, memory_order_relaxed);
+            return;
+        }
+        index--;
+    }
+    
+    int tile = WireTileFrameIndex(batch->data, (uint32_t)index);
+    int x0 = (tile % batch->columns) * batch->tileSize;
+    int y0 = (tile / batch->columns) * batch->tileSize;
+    int tileWidth = Min(batch->tileSize, batch->width - x0);
+    int tileHeight = Min(batch->tileSize, batch->height - y0);
+    TileCodec codec = (TileCodec)WireTileFrameCodec(batch->data, (uint32_t)index);
+    const uint8_t* coded = batch->data + batch->offsets[index];
+    int codedSize = (int)(batch->offsets[index + 1] - batch->offsets[index]);
+    uint8_t* output = batch->decoded + (size_t)index * batch->tileBytes;
+    size_t outputStride = (size_t)batch->tileSize * 4;
+    
+    bool valid;
+    if (codec == TILE_CODEC_DELTA) {
+        size_t stride = (size_t)batch->width * 4;
+        valid = batch->canvas &&
+                TileDecodeDelta(coded, codedSize, batch->canvas + (size_t)y0 * stride + (size_t)x0 * 4, stride,
+                                output, outputStride, tileWidth, tileHeight);
+    } else {
+        valid = TileDecode(codec, coded, codedSize, output, outputStride, tileWidth, tileHeight);
+    }
+    if (!valid) atomic_store_explicit(&batch->failed, true, memory_order_relaxed);
+}
+
+// Marque les tuiles touchées par un rectangle du canevas
+static void MarkDirtyTiles(TileCanvas* canvas, int tileSize, int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0) return;
+    
+    for (int row = y / tileSize; row <= (y + height - 1) / tileSize; row++) {
+        for (int column = x / tileSize; column <= (x + width - 1) / tileSize; column++) {
+            canvas->dirtyTiles[row * canvas->dirtyColumns + column] = 1;
+        }
+    }
+}
+
+// Plages de tuiles marquées par rangée ; une plage identique à celle de la rangée précédente
+// prolonge son rectangle, si bien qu'une image complète donne un seul rectangle
+static void BuildDirtyRects(TileCanvas* canvas, int tileSize) {
+    int width = canvas->image.width;
+    int height = canvas->image.height;
+    int count = 0;
+    
+    for (int column = 0; column < canvas->dirtyColumns; column++) {
+        canvas->dirtyRuns[column] = -1;
+    }
+    
+    for (int row = 0; row < canvas->dirtyRows; row++) {
+        const uint8_t* marks = canvas->dirtyTiles + (size_t)row * canvas->dirtyColumns;
+        int y = row * tileSize;
+        int rowHeight = Min(tileSize, height - y);
+        int column = 0;
+        while (column < canvas->dirtyColumns) {
+            if (!marks[column]) {
+                canvas->dirtyRuns[column++] = -1;
+                continue;
+            }
+            
+            int first = column;
+            while (column < canvas->dirtyColumns && marks[column]) {
+                if (column > first) canvas->dirtyRuns[column] = -1;
+                column++;
+            }
+            int x = first * tileSize;
+            int runWidth = Min(column * tileSize, width) - x;
+            
+            int open = canvas->dirtyRuns[first];
+            if (open >= 0 && canvas->dirtyRects[open].width == runWidth) {
+                canvas->dirtyRects[open].height += rowHeight;
+            } else {
+                open = count++;
+                canvas->dirtyRects[open] = (DirtyRect){ x, y, runWidth, rowHeight };
+            }
+            canvas->dirtyRuns[first] = open;
+        }
+    }
+    canvas->dirtyCount = count;
+}
+
+// Implémentation des fonctions publiques
+int TileHistoryUpdate(TileHistory* history, const Image* image, uint32_t frameId, bool detectMotion, bool* canvasReset) {
+    if (canvasReset) *canvasReset = false;
+    if (!history || !image || !image->data || image->width <= 0 || image->height <= 0) return -1;
+    if (image->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return -1;
+    
+    int width = image->width;
+    int height = image->height;
+    size_t stride = (size_t)width * 4;
+    history->copyCount = 0;
+    
+    // Nouvelles dimensions : nouveau canevas, toutes les tuiles sont à envoyer
+    if (!history->reference || history->width != width || history->height != height) {
+        int columns = GridSize(width, TILE_SIZE);
+        int rows = GridSize(height, TILE_SIZE);
+        if ((int64_t)columns * rows > TILE_MAX_COUNT) {
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Capture trop grande pour le découpage en tuiles (%dx%d)", width, height);
+            return -1;
+        }
+        
+        uint32_t previousId = history->canvasId;
+        TileHistoryFree(history);
+        history->changedFrame = (uint32_t*)malloc((size_t)columns * rows * sizeof(uint32_t));
+        history->previousChange = (uint32_t*)malloc((size_t)columns * rows * sizeof(uint32_t));
+        history->flags = (uint8_t*)malloc((size_t)columns * rows);
+        history->lossyFrame = (uint32_t*)calloc((size_t)columns * rows, sizeof(uint32_t));
+        history->refineFrame = (uint32_t*)calloc((size_t)columns * rows, sizeof(uint32_t));
+        history->reference = (uint8_t*)malloc(stride * height);
+        history->previous = (uint8_t*)malloc(stride * height);
+        if (!history->changedFrame || !history->previousChange || !history->flags || !history->lossyFrame ||
+            !history->refineFrame || !history->reference || !history->previous) {
+            LOG_ERROR(LOG_MODULE_CAPTURE, "Impossible d'allouer l'historique des tuiles");
+            TileHistoryFree(history);
+            return -1;
+        }
+        
+        history->canvasId = NewCanvasId(previousId);
+        history->width = width;
+        history->height = height;
+        history->columns = columns;
+        history->rows = rows;
+        history->referenceFrameId = frameId;
+        history->copySourceFrameId = 0;
+        memcpy(history->reference, image->data, stride * height);
+        memcpy(history->previous, image->data, stride * height);
+        memset(history->flags, TILE_FLAG_CHANGED, (size_t)columns * rows);
+        for (int i = 0; i < columns * rows; i++) {
+            history->changedFrame[i] = frameId;
+            history->previousChange[i] = frameId;
+        }
+        
+        if (canvasReset) *canvasReset = true;
+        return columns * rows;
+    }
+    
+    const uint8_t* pixels = (const uint8_t*)image->data;
+    int changed = 0;
+    int minColumn = history->columns;
+    int maxColumn = -1;
+    int minRow = history->rows;
+    int maxRow = -1;
+    
+    for (int ty = 0; ty < history->rows; ty++) {
+        int y0 = ty * TILE_SIZE;
+        int tileHeight = Min(TILE_SIZE, height - y0);
+        
+        for (int tx = 0; tx < history->columns; tx++) {
+            int x0 = tx * TILE_SIZE;
+            size_t rowSize = (size_t)Min(TILE_SIZE, width - x0) * 4;
+            size_t offset = (size_t)y0 * stride + (size_t)x0 * 4;
+            int tile = ty * history->columns + tx;
+            history->flags[tile] = 0;
+            
+            int y = 0;
+            while (y < tileHeight && memcmp(pixels + offset + y * stride, history->reference + offset + y * stride, rowSize) == 0) {
+                y++;
+            }
+            if (y == tileHeight) continue;
+            
+            history->flags[tile] = TILE_FLAG_CHANGED;
+            history->previousChange[tile] = history->changedFrame[tile];
+            history->changedFrame[tile] = frameId;
+            changed++;
+            minColumn = Min(minColumn, tx);
+            maxColumn = Max(maxColumn, tx);
+            minRow = Min(minRow, ty);
+            maxRow = Max(maxRow, ty);
+        }
+    }
+    
+    // Défilement cherché dans la zone des tuiles modifiées, tant que la référence contient l'image précédente
+    if (detectMotion && changed >= TILE_MOTION_MIN_TILES) {
+        uint64_t motionStart = StatsBegin();
+        MotionRect area = {0};
+        area.srcX = minColumn * TILE_SIZE;
+        area.srcY = minRow * TILE_SIZE;
+        area.width = Min((maxColumn + 1) * TILE_SIZE, width) - area.srcX;
+        area.height = Min((maxRow + 1) * TILE_SIZE, height) - area.srcY;
+        history->copyCount = MotionDetect(history->reference, pixels, width, height, area,
+                                          history->copies, MOTION_MAX_RECTS);
+        MarkCopiedTiles(history);
+        StatsEndFrame(STAT_STAGE_MOTION, motionStart, frameId);
+    }
+    history->copySourceFrameId = history->referenceFrameId;
+    
+    // Référence mise à jour avec les seules tuiles modifiées, leur ancien contenu gardé pour le codage en différence
+    for (int tile = 0; changed > 0 && tile < history->columns * history->rows; tile++) {
+        if (!(history->flags[tile] & TILE_FLAG_CHANGED)) continue;
+        
+        int x0 = (tile % history->columns) * TILE_SIZE;
+        int y0 = (tile / history->columns) * TILE_SIZE;
+        size_t rowSize = (size_t)Min(TILE_SIZE, width - x0) * 4;
+        int tileHeight = Min(TILE_SIZE, height - y0);
+        for (int y = y0; y < y0 + tileHeight; y++) {
+            size_t offset = y * stride + (size_t)x0 * 4;
+            memcpy(history->previous + offset, history->reference + offset, rowSize);
+            memcpy(history->reference + offset, pixels + offset, rowSize);
+        }
+    }
+    history->referenceFrameId = frameId;
+    
+    return changed;
+}
+
+int TileHistoryCollect(const TileHistory* history, uint32_t baseFrameId, bool useCopies, uint16_t* tiles) {
+    if (!history || !history->changedFrame || !tiles) return 0;
+    
+    int count = 0;
+    int total = history->columns * history->rows;
+    for (int i = 0; i < total; i++) {
+        if (useCopies && (history->flags[i] & TILE_FLAG_COPIED)) continue;
+        if (baseFrameId == 0 || WireSequenceNewer(history->changedFrame[i], baseFrameId)) {
+            tiles[count++] = (uint16_t)i;
+        }
+    }
+    return count;
+}
+
+int TileRefineCollect(TileHistory* history, uint32_t frameId, uint32_t baseFrameId, uint64_t appliedFrames,
+                      int maxTiles, uint16_t* tiles) {
+    if (!history || !history->lossyFrame || !tiles || baseFrameId == 0) return 0;
+    
+    int count = 0;
+    int total = history->columns * history->rows;
+    for (int i = 0; i < total; i++) {
+        // Envoi sans perte acquitté : exact s'il a été appliqué, sinon à refaire. Au-delà de la
+        // fenêtre des images appliquées, l'application n'est plus connue
+        uint32_t refineFrame = history->refineFrame[i];
+        if (refineFrame != 0 && !WireSequenceNewer(refineFrame, baseFrameId)) {
+            uint32_t age = baseFrameId - refineFrame;
+            if (age < TILE_CACHE_CONFIRM_WINDOW && (appliedFrames >> age) & 1) history->lossyFrame[i] = 0;
+            history->refineFrame[i] = 0;
+        }
+        
+        if (count >= maxTiles || history->lossyFrame[i] == 0 || history->refineFrame[i] != 0) continue;
+        
+        // Tuile encore en transit ou qui vient de changer : elle sera de toute façon renvoyée, ou
+        // risque de changer de nouveau
+        uint32_t changedFrame = history->changedFrame[i];
+        if (WireSequenceNewer(changedFrame, baseFrameId)) continue;
+        if (frameId - changedFrame < TILE_REFINE_STATIC_FRAMES) continue;
+        tiles[count++] = (uint16_t)i;
+    }
+    return count;
+}
+
+void TileRefineRecord(TileHistory* history, uint32_t frameId, const uint16_t* tiles, int codedCount, int tileCount,
+                      const TileCacheRef* cached, int cachedCount, bool useCopies) {
+    if (!history || !history->lossyFrame) return;
+    
+    for (int i = 0; i < tileCount; i++) {
+        if (i < codedCount) {
+            history->refineFrame[tiles[i]] = frameId;
+        } else {
+            history->lossyFrame[tiles[i]] = frameId;
+            history->refineFrame[tiles[i]] = 0;
+        }
+    }
+    for (int i = 0; i < cachedCount; i++) {
+        history->lossyFrame[cached[i].tile] = frameId;
+        history->refineFrame[cached[i].tile] = 0;
+    }
+    
+    int total = history->columns * history->rows;
+    for (int i = 0; useCopies && i < total; i++) {
+        if (!(history->flags[i] & TILE_FLAG_COPIED)) continue;
+        history->lossyFrame[i] = frameId;
+        history->refineFrame[i] = 0;
+    }
+}
+
+int TileCacheResolve(TileCache* cache, const TileHistory* history, const Image* image, uint32_t frameId,
+                     uint16_t* tiles, int count, TileCacheRef* cached, int* cachedCount, uint16_t* slots) {
+    *cachedCount = 0;
+    if (!cache || !history || !image || !image->data || !tiles || !cached || !slots) return count;
+    if (image->width != history->width || image->height != history->height) return count;
+    
+    size_t stride = (size_t)image->width * 4;
+    const uint8_t* pixels = (const uint8_t*)image->data;
+    int remaining = 0;
+    for (int i = 0; i < count; i++) {
+        int x0 = (tiles[i] % history->columns) * TILE_SIZE;
+        int y0 = (tiles[i] / history->columns) * TILE_SIZE;
+        uint64_t hash = TileHash(pixels + (size_t)y0 * stride + (size_t)x0 * 4, stride,
+                                 Min(TILE_SIZE, image->width - x0), Min(TILE_SIZE, image->height - y0));
+        
+        int slot = TileCacheFind(cache, hash);
+        if (slot >= 0 && cache->entries[slot].confirmed) {
+            cached[*cachedCount].tile = tiles[i];
+            cached[*cachedCount].slot = (uint16_t)slot;
+            (*cachedCount)++;
+            continue;
+        }
+        
+        // Tuile inconnue, ou transmise par une image dont l'application n'est pas confirmée
+        tiles[remaining] = tiles[i];
+        slots[remaining] = (uint16_t)TileCacheStore(cache, hash, frameId);
+        remaining++;
+    }
+    return remaining;
+}
+
+int TileEncodeCoded(const TileHistory* history, const Image* image, uint16_t* tiles, uint16_t* slots, int count,
+                    const TileCodingOptions* options, uint8_t* codecs, uint16_t* sizes, uint8_t** data, uint32_t* dataSize) {
+    *data = NULL;
+    *dataSize = 0;
+    if (!history || !image || !image->data || !options || !tiles || !slots || !codecs || !sizes || count <= 0) return 0;
+    if (image->width != history->width || image->height != history->height) return 0;
+    bool lossless = options->lossless;
+    
+    // Tuiles laissées au JPEG, replacées après les tuiles codées
+    uint16_t* deferred = (uint16_t*)malloc((size_t)count * 2 * sizeof(uint16_t));
+    if (!deferred) return -1;
+    
+    size_t stride = (size_t)image->width * 4;
+    const uint8_t* pixels = (const uint8_t*)image->data;
+    uint8_t* output = NULL;
+    uint32_t used = 0;
+    uint32_t capacity = 0;
+    int coded = 0;
+    int deferredCount = 0;
+    
+    for (int i = 0; i < count; i++) {
+        int x0 = (tiles[i] % history->columns) * TILE_SIZE;
+        int y0 = (tiles[i] / history->columns) * TILE_SIZE;
+        int tileWidth = Min(TILE_SIZE, image->width - x0);
+        int tileHeight = Min(TILE_SIZE, image->height - y0);
+        const uint8_t* src = pixels + (size_t)y0 * stride + (size_t)x0 * 4;
+        
+        // Sans perte : QOI pour tout, assez rapide pour ne pas analyser le contenu. Le contenu
+        // remplacé est alors exact chez tous les visualiseurs s'il date d'une image sans perte
+        // qu'ils ont tous appliquée : seule la différence est transmise
+        TileCodec codec = TILE_CODEC_QOI;
+        uint32_t previousChange = history->previousChange[tiles[i]];
+        bool refine = i >= count - options->refineCount;
+        if (lossless && !refine && options->deltaBaseFrameId != 0 &&
+            !WireSequenceNewer(previousChange, options->deltaBaseFrameId) &&
+            !WireSequenceNewer(options->deltaSinceFrameId, previousChange)) {
+            codec = TILE_CODEC_DELTA;
+        } else if (!lossless) {
+            TileFeatures features;
+            TileAnalyze(src, stride, tileWidth, tileHeight, &features);
+            codec = TileChooseCodec(&features, tileWidth, tileHeight);
+        }
+        
+        // Tuile figée renvoyée pour être affinée : sans perte, la marge de débit a été vérifiée avant.
+        // Tuile photographique sous l'attention de l'utilisateur : sans perte si le débit le permet,
+        // dans la même limite de taille que les tuiles d'interface
+        bool focused = false;
+        if (codec == TILE_CODEC_JPEG && refine) {
+            codec = TILE_CODEC_QOI;
+        } else if (codec == TILE_CODEC_JPEG && options->roi && options->roi->boostLossless &&
+            RoiMapWeight(options->roi, x0, y0) >= ROI_FOCUS_WEIGHT) {
+            codec = TILE_CODEC_QOI;
+            focused = true;
+        }
+        
+        int size = 0;
+        if (codec != TILE_CODEC_JPEG) {
+            uint32_t budget = (codec == TILE_CODEC_QOI && !focused) || codec == TILE_CODEC_DELTA
+                                  ? (uint32_t)TILE_QOI_MAX_SIZE(tileWidth, tileHeight)
+                                                      : (uint32_t)(tileWidth * tileHeight * TILE_CODED_MAX_BYTES_PER_PIXEL);
+            if (capacity - used < budget) {
+                uint32_t grown = capacity * 2 > used + budget ? capacity * 2 : used + budget;
+                uint8_t* buffer = (uint8_t*)realloc(output, grown);
+                if (!buffer) {
+                    free(output);
+                    free(deferred);
+                    return -1;
+                }
+                output = buffer;
+                capacity = grown;
+            }
+            
+            // Trop volumineuse une fois codée (contenu plus riche que prévu) : elle ira dans le JPEG
+            if (codec == TILE_CODEC_DELTA) {
+                size = TileEncodeDelta(src, stride, history->previous + (size_t)y0 * stride + (size_t)x0 * 4, stride,
+                                       tileWidth, tileHeight, output + used, (int)budget);
+            } else {
+                size = TileEncode(codec, src, stride, tileWidth, tileHeight, output + used, (int)budget);
+            }
+        }
+        
+        if (size > 0) {
+            tiles[coded] = tiles[i];
+            slots[coded] = slots[i];
+            codecs[coded] = (uint8_t)codec;
+            sizes[coded] = (uint16_t)size;
+            used += (uint32_t)size;
+            coded++;
+        } else {
+            deferred[2 * deferredCount] = tiles[i];
+            deferred[2 * deferredCount + 1] = slots[i];
+            deferredCount++;
+        }
+    }
+    
+    for (int i = 0; i < deferredCount; i++) {
+        tiles[coded + i] = deferred[2 * i];
+        slots[coded + i] = deferred[2 * i + 1];
+    }
+    free(deferred);
+    
+    if (coded == 0) {
+        free(output);
+        return 0;
+    }
+    *data = output;
+    *dataSize = used;
+    return coded;
+}
+
+void TileHistoryFree(TileHistory* history) {
+    if (!history) return;
+    
+    free(history->changedFrame);
+    free(history->previousChange);
+    free(history->flags);
+    free(history->lossyFrame);
+    free(history->refineFrame);
+    free(history->reference);
+    free(history->previous);
+    history->changedFrame = NULL;
+    history->previousChange = NULL;
+    history->flags = NULL;
+    history->lossyFrame = NULL;
+    history->refineFrame = NULL;
+    history->reference = NULL;
+    history->previous = NULL;
+    history->copyCount = 0;
+    history->width = 0;
+    history->height = 0;
+    history->columns = 0;
+    history->rows = 0;
+}
+
+int TileBuildAtlas(const TileHistory* history, const Image* image, const uint16_t* tiles, int count, Image* atlas) {
+    if (!history || !image || !image->data || !tiles || !atlas || count <= 0) return 0;
+    if (image->width != history->width || image->height != history->height) return 0;
+    
+    int atlasColumns = Min(count, history->columns);
+    int atlasRows = GridSize(count, atlasColumns);
+    int atlasWidth = atlasColumns * TILE_SIZE;
+    int atlasHeight = atlasRows * TILE_SIZE;
+    size_t atlasStride = (size_t)atlasWidth * 4;
+    size_t stride = (size_t)image->width * 4;
+    
+    uint8_t* data = (uint8_t*)malloc(atlasStride * atlasHeight);
+    if (!data) return 0;
+    
+    const uint8_t* pixels = (const uint8_t*)image->data;
+    for (int i = 0; i < count; i++) {
+        int x0 = (tiles[i] % history->columns) * TILE_SIZE;
+        int y0 = (tiles[i] / history->columns) * TILE_SIZE;
+        int tileWidth = Min(TILE_SIZE, image->width - x0);
+        int tileHeight = Min(TILE_SIZE, image->height - y0);
+        uint8_t* slot = data + (size_t)(i / atlasColumns) * TILE_SIZE * atlasStride + (size_t)(i % atlasColumns) * TILE_SIZE * 4;
+        
+        for (int y = 0; y < TILE_SIZE; y++) {
+            const uint8_t* src = pixels + (size_t)(y0 + Min(y, tileHeight - 1)) * stride + (size_t)x0 * 4;
+            uint8_t* dst = slot + (size_t)y * atlasStride;
+            memcpy(dst, src, (size_t)tileWidth * 4);
+            
+            // Tuile du bord : répéter le dernier pixel plutôt qu'un aplat qui coûterait des artefacts
+            for (int x = tileWidth; x < TILE_SIZE; x++) {
+                memcpy(dst + x * 4, src + (tileWidth - 1) * 4, 4);
+            }
+        }
+    }
+    
+    atlas->data = data;
+    atlas->width = atlasWidth;
+    atlas->height = atlasHeight;
+    atlas->mipmaps = 1;
+    atlas->format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return atlasColumns;
+}
+
+TileApplyResult TileCanvasApply(TileCanvas* canvas, const uint8_t* data, uint32_t size,
+                                uint32_t frameId, int width, int height) {
+    if (!canvas || !WireTileFrameValidate(data, size) || width <= 0 || height <= 0) return TILE_APPLY_ERROR;
+    
+    uint32_t canvasId = WireTileFrameCanvasId(data);
+    uint32_t baseFrameId = WireTileFrameBaseFrameId(data);
+    bool sameCanvas = canvas->canvasId == canvasId && canvas->image.data &&
+                      canvas->image.width == width && canvas->image.height == height;
+    
+    if (sameCanvas && !WireSequenceNewer(frameId, canvas->frameId)) return TILE_APPLY_STALE;
+    
+    // Image partielle : le canevas doit contenir la référence ou une image plus récente du même canevas
+    if (baseFrameId != 0 && (!sameCanvas || WireSequenceNewer(baseFrameId, canvas->frameId))) {
+        return TILE_APPLY_MISSING_BASE;
+    }
+    
+    // Copies relatives à l'image précédente : le canevas doit être exactement à cette image
+    uint32_t copyCount = WireTileFrameCopyCount(data);
+    if (copyCount > 0) {
+        if (baseFrameId == 0) return TILE_APPLY_ERROR;
+        if (!sameCanvas || canvas->frameId != WireTileFrameCopySourceFrameId(data)) return TILE_APPLY_MISSING_COPY;
+        
+        for (uint32_t c = 0; c < copyCount; c++) {
+            const uint8_t* copy = WireTileFrameCopyRect(data, c);
+            if (WireCopyRectSrcX(copy) + WireCopyRectWidth(copy) > width ||
+                WireCopyRectDstX(copy) + WireCopyRectWidth(copy) > width ||
+                WireCopyRectSrcY(copy) + WireCopyRectHeight(copy) > height ||
+                WireCopyRectDstY(copy) + WireCopyRectHeight(copy) > height) {
+                return TILE_APPLY_ERROR;
+            }
+        }
+    }
+    
+    int tileSize = WireTileFrameTileSize(data);
+    int columns = GridSize(width, tileSize);
+    int total = columns * GridSize(height, tileSize);
+    uint32_t tileCount = WireTileFrameTileCount(data);
+    uint32_t cachedCount = WireTileFrameCachedCount(data);
+    uint32_t codedCount = WireTileFrameCodedCount(data);
+    if (baseFrameId == 0 && (tileCount != (uint32_t)total || cachedCount > 0)) return TILE_APPLY_ERROR;
+    for (uint32_t i = 0; i < tileCount; i++) {
+        uint16_t slot = WireTileFrameSlot(data, i);
+        if (WireTileFrameIndex(data, i) >= total) return TILE_APPLY_ERROR;
+        if (slot != TILE_CACHE_NO_SLOT && slot >= TILE_CACHE_SLOTS) return TILE_APPLY_ERROR;
+    }
+    
+    // Tuiles en cache : un emplacement vide signifie que le cache n'est plus synchronisé avec l'émetteur
+    for (uint32_t i = 0; i < cachedCount; i++) {
+        const uint8_t* entry = WireTileFrameCachedTile(data, i);
+        if (WireCachedTileIndex(entry) >= total) return TILE_APPLY_ERROR;
+        if (!TileCacheMirrorGet(&canvas->cache, WireCachedTileSlot(entry), tileSize)) return TILE_APPLY_MISSING_CACHE;
+    }
+    
+    // Tuiles codées : données de chacune délimitées avant de lancer le décodage
+    uint32_t offset = WireTileFrameHeaderSize(copyCount, cachedCount, tileCount, codedCount);
+    uint32_t* offsets = (uint32_t*)malloc(((size_t)codedCount + 1) * sizeof(uint32_t));
+    if (!offsets) return TILE_APPLY_ERROR;
+    for (uint32_t i = 0; i < codedCount; i++) {
+        uint32_t codedSize = WireTileFrameCodedSize(data, i);
+        if (codedSize > size - offset) {
+            free(offsets);
+            return TILE_APPLY_ERROR;
+        }
+        offsets[i] = offset;
+        offset += codedSize;
+    }
+    offsets[codedCount] = offset;
+    
+    uint32_t atlasCount = tileCount - codedCount;
+    int atlasColumns = WireTileFrameAtlasColumns(data);
+    if (atlasCount > 0 && offset >= size) {
+        free(offsets);
+        return TILE_APPLY_ERROR;
+    }
+    
+    // Tableaux des zones modifiées, à la grille de cette image
+    int rows = total / columns;
+    if (canvas->dirtyColumns != columns || canvas->dirtyRows != rows) {
+        free(canvas->dirtyRects);
+        free(canvas->dirtyTiles);
+        free(canvas->dirtyRuns);
+        canvas->dirtyRects = (DirtyRect*)malloc((size_t)total * sizeof(DirtyRect));
+        canvas->dirtyTiles = (uint8_t*)malloc((size_t)total);
+        canvas->dirtyRuns = (int*)malloc((size_t)columns * sizeof(int));
+        canvas->dirtyColumns = columns;
+        canvas->dirtyRows = rows;
+        if (!canvas->dirtyRects || !canvas->dirtyTiles || !canvas->dirtyRuns) {
+            canvas->dirtyColumns = 0;
+            canvas->dirtyRows = 0;
+            free(offsets);
+            return TILE_APPLY_ERROR;
+        }
+    }
+    canvas->dirtyCount = 0;
+    
+    // Tuiles codées et atlas décodés à part, en parallèle : le canevas n'est modifié que si tous sont
+    // valides. Les différences s'appliquent au canevas tel qu'il était avant cette image (copies comprises)
+    size_t tileBytes = (size_t)tileSize * tileSize * 4;
+    TileDecodeBatch batch = {
+        .data = data,
+        .size = size,
+        .offsets = offsets,
+        .canvas = baseFrameId != 0 ? (const uint8_t*)canvas->image.data : NULL,
+        .tileBytes = tileBytes,
+        .tileSize = tileSize,
+        .columns = columns,
+        .width = width,
+        .height = height,
+        .atlasOffset = atlasCount > 0 ? offset : size,
+    };
+    atomic_init(&batch.failed, false);
+    if (codedCount > 0) {
+        batch.decoded = (uint8_t*)calloc(codedCount, tileBytes);
+        if (!batch.decoded) {
+            free(offsets);
+            return TILE_APPLY_ERROR;
+        }
+    }
+    WorkerPoolRun(DecodeTileJob, &batch, (int)codedCount + (atlasCount > 0 ? 1 : 0));
+    free(offsets);
+        
+    uint8_t* decoded = batch.decoded;
+    Image atlas = batch.atlas;
+    if (atomic_load(&batch.failed) ||
+        (atlasCount > 0 && (atlas.width < atlasColumns * tileSize ||
+                            atlas.height < GridSize((int)atlasCount, atlasColumns) * tileSize))) {
+        if (atlas.data) UnloadImage(atlas);
+        free(decoded);
+        return TILE_APPLY_ERROR;
+    }
+    
+    // Image complète aux nouvelles dimensions : nouveau buffer, l'ancien reste intact en cas d'échec
+    if (!canvas->image.data || canvas->image.width != width || canvas->image.height != height) {
+        void* pixels = malloc((size_t)width * height * 4);
+        if (!pixels) {
+            if (atlas.data) UnloadImage(atlas);
+            free(decoded);
+            return TILE_APPLY_ERROR;
+        }
+        if (canvas->image.data) UnloadImage(canvas->image);
+        canvas->image.data = pixels;
+        canvas->image.width = width;
+        canvas->image.height = height;
+        canvas->image.mipmaps = 1;
+        canvas->image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    }
+    
+    // Défilement : contenu déplacé avant que les tuiles ne corrigent le reste
+    if (copyCount > 0 && !ApplyCopies(&canvas->image, data, copyCount)) {
+        if (atlas.data) UnloadImage(atlas);
+        free(decoded);
+        return TILE_APPLY_ERROR;
+    }
+    
+    size_t stride = (size_t)width * 4;
+    uint8_t* pixels = (uint8_t*)canvas->image.data;
+    
+    // Tuiles reprises du cache avant que les tuiles transmises ne réattribuent leurs emplacements
+    for (uint32_t i = 0; i < cachedCount; i++) {
+        const uint8_t* entry = WireTileFrameCachedTile(data, i);
+        int tile = WireCachedTileIndex(entry);
+        int x0 = (tile % columns) * tileSize;
+        int y0 = (tile / columns) * tileSize;
+        size_t rowSize = (size_t)Min(tileSize, width - x0) * 4;
+        int tileHeight = Min(tileSize, height - y0);
+        const uint8_t* src = TileCacheMirrorGet(&canvas->cache, WireCachedTileSlot(entry), tileSize);
+        
+        for (int y = 0; y < tileHeight; y++) {
+            memcpy(pixels + (size_t)(y0 + y) * stride + (size_t)x0 * 4, src + (size_t)y * tileSize * 4, rowSize);
+        }
+    }
+    
+    size_t atlasStride = (size_t)atlas.width * 4;
+    for (uint32_t i = 0; i < tileCount; i++) {
+        int tile = WireTileFrameIndex(data, i);
+        int x0 = (tile % columns) * tileSize;
+        int y0 = (tile / columns) * tileSize;
+        size_t rowSize = (size_t)Min(tileSize, width - x0) * 4;
+        int tileHeight = Min(tileSize, height - y0);
+        
+        // Tuiles codées en tête, puis celles de l'atlas dans leur ordre
+        const uint8_t* src;
+        size_t srcStride;
+        if (i < codedCount) {
+            src = decoded + i * tileBytes;
+            srcStride = (size_t)tileSize * 4;
+        } else {
+            uint32_t a = i - codedCount;
+            src = (const uint8_t*)atlas.data + (size_t)(a / atlasColumns) * tileSize * atlasStride +
+                  (size_t)(a % atlasColumns) * tileSize * 4;
+            srcStride = atlasStride;
+        }
+        
+        for (int y = 0; y < tileHeight; y++) {
+            memcpy(pixels + (size_t)(y0 + y) * stride + (size_t)x0 * 4, src + (size_t)y * srcStride, rowSize);
+        }
+        
+        // Un échec laisse l'emplacement vide : une référence ultérieure demandera une image complète
+        uint16_t slot = WireTileFrameSlot(data, i);
+        if (slot != TILE_CACHE_NO_SLOT) {
+            TileCacheMirrorStore(&canvas->cache, slot, src, srcStride, tileSize);
+        }
+    }
+    
+    if (atlas.data) UnloadImage(atlas);
+    free(decoded);
+    
+    // Zones à envoyer à la texture : tout le canevas pour une image complète, sinon les tuiles
+    // transmises, reprises du cache et couvertes par les copies
+    memset(canvas->dirtyTiles, baseFrameId == 0 ? 1 : 0, (size_t)total);
+    if (baseFrameId != 0) {
+        for (uint32_t c = 0; c < copyCount; c++) {
+            const uint8_t* copy = WireTileFrameCopyRect(data, c);
+            MarkDirtyTiles(canvas, tileSize, WireCopyRectDstX(copy), WireCopyRectDstY(copy),
+                           WireCopyRectWidth(copy), WireCopyRectHeight(copy));
+        }
+        for (uint32_t i = 0; i < cachedCount; i++) {
+            canvas->dirtyTiles[WireCachedTileIndex(WireTileFrameCachedTile(data, i))] = 1;
+        }
+        for (uint32_t i = 0; i < tileCount; i++) {
+            canvas->dirtyTiles[WireTileFrameIndex(data, i)] = 1;
+        }
+    }
+    BuildDirtyRects(canvas, tileSize);
+    
+    canvas->canvasId = canvasId;
+    canvas->frameId = frameId;
+    return TILE_APPLY_OK;
+}
+
+void TileCanvasFree(TileCanvas* canvas) {
+    if (!canvas) return;
+    
+    if (canvas->image.data) UnloadImage(canvas->image);
+    TileCacheMirrorFree(&canvas->cache);
+    free(canvas->dirtyRects);
+    free(canvas->dirtyTiles);
+    free(canvas->dirtyRuns);
+    memset(canvas, 0, sizeof(*canvas));
+}
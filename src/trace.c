@@ -0,0 +1,121 @@
+#include "../include/trace.h"
+#include "../include/stats.h"
+#include "../include/log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Intervalle enregistré (format binaire compact, 24 octets)
+ */
+typedef struct {
+    uint64_t startNs;
+    uint32_t durationNs;
+    uint32_t frameId;
+    uint8_t stage;
+    uint8_t thread;
+} TraceEvent;
+
+static TraceEvent* events = NULL;
+static uint32_t capacity = 0;
+static uint32_t eventCount = 0;
+static uint32_t nextEvent = 0;
+
+bool TraceInit(uint32_t requestedCapacity) {
+    TraceShutdown();
+    
+    if (requestedCapacity == 0) requestedCapacity = TRACE_DEFAULT_CAPACITY;
+    events = (TraceEvent*)malloc(requestedCapacity * sizeof(TraceEvent));
+    if (!events) {
+        LOG_ERROR(LOG_MODULE_STATS, "Échec d'allocation du tampon de traces (%u intervalles)", requestedCapacity);
+        return false;
+    }
+    
+    capacity = requestedCapacity;
+    return true;
+}
+
+void TraceShutdown(void) {
+    free(events);
+    events = NULL;
+    capacity = 0;
+    eventCount = 0;
+    nextEvent = 0;
+}
+
+void TraceAppend(uint64_t startNs, uint32_t durationNs, uint32_t frameId, uint8_t stage, uint8_t thread) {
+    if (!events) return;
+    
+    TraceEvent* event = &events[nextEvent];
+    event->startNs = startNs;
+    event->durationNs = durationNs;
+    event->frameId = frameId;
+    event->stage = stage;
+    event->thread = thread;
+    
+    nextEvent = (nextEvent + 1) % capacity;
+    if (eventCount < capacity) eventCount++;
+}
+
+void TraceClear(void) {
+    eventCount = 0;
+    nextEvent = 0;
+}
+
+bool TraceExportChromeJson(const char* path) {
+    if (!path) return false;
+    if (!events || eventCount == 0) {
+        LOG_WARNING(LOG_MODULE_STATS, "Aucune trace à exporter");
+        return false;
+    }
+    
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        LOG_ERROR(LOG_MODULE_STATS, "Impossible d'ouvrir %s pour l'export de la trace", path);
+        return false;
+    }
+    
+    uint32_t first = (nextEvent + capacity - eventCount) % capacity;
+    
+    // Origine des temps : début le plus ancien (les intervalles ne sont triés que par fin)
+    uint64_t originNs = UINT64_MAX;
+    bool threadSeen[256] = {0};
+    for (uint32_t i = 0; i < eventCount; i++) {
+        const TraceEvent* event = &events[(first + i) % capacity];
+        if (event->startNs < originNs) originNs = event->startNs;
+        threadSeen[event->thread] = true;
+    }
+    
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                  "\"args\":{\"name\":\"C_Screenshare\"}}");
+    
+    // Noms des threads instrumentés
+    for (int t = 0; t < 256; t++) {
+        if (!threadSeen[t]) continue;
+        const char* name = StatsGetThreadName(t);
+        if (name) {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                          "\"args\":{\"name\":\"%s\"}}", t, name);
+        } else {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                          "\"args\":{\"name\":\"thread %d\"}}", t, t);
+        }
+    }
+    
+    // Un événement complet ("X") par intervalle, en microsecondes
+    for (uint32_t i = 0; i < eventCount; i++) {
+        const TraceEvent* event = &events[(first + i) % capacity];
+        fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                StatsStageName((StatStage)event->stage), event->thread,
+                (event->startNs - originNs) / 1000.0, event->durationNs / 1000.0,
+                event->frameId);
+    }
+    
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    
+    LOG_INFO(LOG_MODULE_STATS, "Trace exportée dans %s (%u intervalles)", path, eventCount);
+    return true;
+}
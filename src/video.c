@@ -0,0 +1,1002 @@
+#include "../include/video.h"
+#include "../include/roi.h"
+#include "../include/clock.h"
+#include "../include/protocol.h"
+#include "../include/workers.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// SSE2 fait partie de l'ABI x86-64 : pas de détection à l'exécution
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define VIDEO_SSE2 1
+#endif
+
+// Type d'un macrobloc codé d'une image P (ue) ; tous ceux d'une image I sont intra
+#define MB_INTER 0
+#define MB_INTRA 1
+
+// Prédictions intra de la luminance, à partir des pixels reconstruits au-dessus et à gauche
+#define INTRA_DC 0
+#define INTRA_VERTICAL 1
+#define INTRA_HORIZONTAL 2
+#define INTRA_MODES 3
+
+// Blocs 4x4 d'un macrobloc : 16 de luminance (4 par quadrant de 8x8), 4 de U puis 4 de V.
+// Motif des blocs codés : un bit par quadrant de luminance, puis U et V
+#define MB_BLOCKS 24
+#define CBP_MAX 63
+
+// Préfixe d'un code de Golomb exponentiel au-delà duquel le flux est invalide
+#define GOLOMB_MAX_ZEROS 24
+
+// Coût d'un pixel d'écart avec le déplacement prédit, ajouté à la SAD pendant la recherche
+#define MOTION_VECTOR_COST 4
+
+// Avance de SAD qu'un macrobloc intra doit avoir sur le meilleur déplacement pour être choisi
+#define INTRA_BIAS 256
+
+// Quantificateur le plus grossier (le pas double tous les 6)
+#define VIDEO_QP_MAX 51
+
+// Niveau quantifié maximal pour QP < 6, divisé par deux tous les 6 (au-delà le flux est invalide)
+#define LEVEL_MAX 4096
+
+// Ordre de parcours des coefficients, des basses vers les hautes fréquences
+static const uint8_t zigzag[16] = { 0, 1, 4, 8, 5, 2, 3, 6, 9, 12, 13, 10, 7, 11, 14, 15 };
+
+// Quantification et reconstruction de H.264 par QP % 6 : positions (paire, paire), (impaire, impaire), autres
+static const int quantScale[6][3] = {
+    { 13107, 5243, 8066 }, { 11916, 4660, 7490 }, { 10082, 4194, 6554 },
+    { 9362, 3647, 5825 }, { 8192, 3355, 5243 }, { 7282, 2893, 4559 }
+};
+static const int dequantScale[6][3] = {
+    { 10, 16, 13 }, { 11, 18, 14 }, { 13, 20, 16 }, { 14, 23, 18 }, { 16, 25, 20 }, { 18, 29, 23 }
+};
+
+// Prédiction d'un macrobloc, plans séparés
+typedef struct {
+    uint8_t y[VIDEO_MB_SIZE * VIDEO_MB_SIZE];
+    uint8_t u[VIDEO_MB_SIZE * VIDEO_MB_SIZE / 4];
+    uint8_t v[VIDEO_MB_SIZE * VIDEO_MB_SIZE / 4];
+} MacroblockPixels;
+
+// Résidu quantifié d'un macrobloc, coefficients dans l'ordre des lignes
+typedef struct {
+    int16_t levels[MB_BLOCKS][16];
+    uint8_t counts[MB_BLOCKS];  // Coefficients non nuls par bloc
+    int cbp;                    // Groupes de blocs transmis
+    int qp;                     // Quantificateur du macrobloc
+} MacroblockResidual;
+
+// Image en cours de codage ou de décodage
+typedef struct {
+    YuvImage* current;          // Reconstruction en cours
+    const YuvImage* reference;  // Référence d'une image P (NULL pour une image I)
+    int mbColumns;
+    int mbRows;
+    int16_t* motion;            // Déplacement (x, y) par macrobloc de l'image en cours
+    int qp;                     // Quantificateur de l'image, point de départ de chaque tranche
+    const RoiMap* roi;          // Intérêt de chaque zone (codeur seulement, NULL : quantificateur uniforme)
+    int firstRow;               // Première ligne de macroblocs de la tranche : rien n'est prédit au-dessus
+} SliceContext;
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint64_t bits;              // Bits en attente (les count derniers)
+    int count;
+    bool failed;                // Échec d'allocation
+} BitWriter;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t position;            // En bits
+    bool failed;                // Lecture au-delà des données ou code invalide
+} BitReader;
+
+// Fonctions utilitaires privées
+static uint32_t NewStreamId(uint32_t previous) {
+    // Dérivé de l'horloge, comme les identifiants de canevas des tuiles
+    uint64_t seed = (ClockNowNs() ^ ((uint64_t)previous << 32)) * 0xD6E8FEB86659FD93ULL;
+    uint32_t id = (uint32_t)(seed >> 32);
+    if (id == 0 || id == previous) id = previous + 1;
+    return id != 0 ? id : 1;
+}
+
+static inline uint8_t ClampPixel(int value) {
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static inline int Abs(int value) {
+    return value < 0 ? -value : value;
+}
+
+static void PutByte(BitWriter* writer, uint8_t byte) {
+    if (writer->failed) return;
+    if (writer->size == writer->capacity) {
+        size_t capacity = writer->capacity ? writer->capacity * 2 : 4096;
+        uint8_t* data = (uint8_t*)realloc(writer->data, capacity);
+        if (!data) {
+            writer->failed = true;
+            return;
+        }
+        writer->data = data;
+        writer->capacity = capacity;
+    }
+    writer->data[writer->size++] = byte;
+}
+
+static void PutBits(BitWriter* writer, uint32_t value, int count) {
+    writer->bits = (writer->bits << count) | value;
+    writer->count += count;
+    while (writer->count >= 8) {
+        writer->count -= 8;
+        PutByte(writer, (uint8_t)(writer->bits >> writer->count));
+    }
+}
+
+// Golomb exponentiel : n zéros puis la valeur + 1 sur n + 1 bits
+static void PutUe(BitWriter* writer, uint32_t value) {
+    uint32_t code = value + 1;
+    int length = 0;
+    while ((code >> length) > 1) length++;
+    PutBits(writer, 0, length);
+    PutBits(writer, code, length + 1);
+}
+
+static void PutSe(BitWriter* writer, int value) {
+    PutUe(writer, value > 0 ? 2 * (uint32_t)value - 1 : 2 * (uint32_t)(-value));
+}
+
+static void FlushBits(BitWriter* writer) {
+    if (writer->count > 0) PutBits(writer, 0, 8 - writer->count);
+}
+
+// Lit 1 à 25 bits
+static uint32_t GetBits(BitReader* reader, int count) {
+    if (reader->failed || reader->position + (size_t)count > reader->size * 8) {
+        reader->failed = true;
+        return 0;
+    }
+    size_t byte = reader->position >> 3;
+    uint32_t window = 0;
+    for (size_t i = 0; i < 4; i++) {
+        window = (window << 8) | (byte + i < reader->size ? reader->data[byte + i] : 0);
+    }
+    uint32_t value = (window << (reader->position & 7)) >> (32 - count);
+    reader->position += (size_t)count;
+    return value;
+}
+
+static uint32_t GetUe(BitReader* reader) {
+    int zeros = 0;
+    while (!reader->failed && GetBits(reader, 1) == 0) {
+        if (++zeros > GOLOMB_MAX_ZEROS) {
+            reader->failed = true;
+            return 0;
+        }
+    }
+    if (zeros == 0 || reader->failed) return 0;
+    return ((1u << zeros) | GetBits(reader, zeros)) - 1;
+}
+
+static int GetSe(BitReader* reader) {
+    uint32_t code = GetUe(reader);
+    return code & 1 ? (int)((code + 1) / 2) : -(int)(code / 2);
+}
+
+// Classe de quantification d'une position du bloc 4x4
+static inline int ScaleClass(int position) {
+    int row = position >> 2;
+    int column = position & 3;
+    if (!(row & 1) && !(column & 1)) return 0;
+    if ((row & 1) && (column & 1)) return 1;
+    return 2;
+}
+
+// Transformée entière 4x4 de H.264 : lignes puis colonnes
+static void ForwardTransform(const int* residual, int* coeffs) {
+    int rows[16];
+    for (int i = 0; i < 4; i++) {
+        const int* r = residual + 4 * i;
+        int s03 = r[0] + r[3], d03 = r[0] - r[3];
+        int s12 = r[1] + r[2], d12 = r[1] - r[2];
+        rows[4 * i + 0] = s03 + s12;
+        rows[4 * i + 1] = 2 * d03 + d12;
+        rows[4 * i + 2] = s03 - s12;
+        rows[4 * i + 3] = d03 - 2 * d12;
+    }
+    for (int i = 0; i < 4; i++) {
+        int s03 = rows[i] + rows[12 + i], d03 = rows[i] - rows[12 + i];
+        int s12 = rows[4 + i] + rows[8 + i], d12 = rows[4 + i] - rows[8 + i];
+        coeffs[i] = s03 + s12;
+        coeffs[4 + i] = 2 * d03 + d12;
+        coeffs[8 + i] = s03 - s12;
+        coeffs[12 + i] = d03 - 2 * d12;
+    }
+}
+
+// Transformée inverse en place, résultat arrondi (division par 64)
+static void InverseTransform(int* block) {
+    for (int i = 0; i < 4; i++) {
+        int* r = block + 4 * i;
+        int e0 = r[0] + r[2], e1 = r[0] - r[2];
+        int e2 = (r[1] >> 1) - r[3], e3 = r[1] + (r[3] >> 1);
+        r[0] = e0 + e3;
+        r[1] = e1 + e2;
+        r[2] = e1 - e2;
+        r[3] = e0 - e3;
+    }
+    for (int i = 0; i < 4; i++) {
+        int e0 = block[i] + block[8 + i], e1 = block[i] - block[8 + i];
+        int e2 = (block[4 + i] >> 1) - block[12 + i], e3 = block[4 + i] + (block[12 + i] >> 1);
+        block[i] = (e0 + e3 + 32) >> 6;
+        block[4 + i] = (e1 + e2 + 32) >> 6;
+        block[8 + i] = (e1 - e2 + 32) >> 6;
+        block[12 + i] = (e0 - e3 + 32) >> 6;
+    }
+}
+
+// Arrondi d'un tiers pour l'intra, d'un sixième pour l'inter (plus de zéros sur un résidu de prédiction)
+static int Quantize(const int* coeffs, int qp, bool intra, int16_t* levels) {
+    int shift = 15 + qp / 6;
+    int rounding = (1 << shift) / (intra ? 3 : 6);
+    int nonZero = 0;
+    for (int i = 0; i < 16; i++) {
+        int magnitude = (Abs(coeffs[i]) * quantScale[qp % 6][ScaleClass(i)] + rounding) >> shift;
+        levels[i] = (int16_t)(coeffs[i] < 0 ? -magnitude : magnitude);
+        if (magnitude != 0) nonZero++;
+    }
+    return nonZero;
+}
+
+static void ReconstructBlock(const int16_t* levels, int qp, const uint8_t* pred, int predStride,
+                             uint8_t* dst, int dstStride, int dstStep) {
+    int block[16];
+    for (int i = 0; i < 16; i++) block[i] = levels[i] * dequantScale[qp % 6][ScaleClass(i)] * (1 << (qp / 6));
+    InverseTransform(block);
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            dst[y * dstStride + x * dstStep] = ClampPixel(pred[y * predStride + x] + block[4 * y + x]);
+        }
+    }
+}
+
+// Position d'un bloc 4x4 dans son plan (0 = Y, 1 = U, 2 = V), relative au macrobloc
+static void BlockPosition(int block, int* plane, int* x, int* y) {
+    if (block < 16) {
+        *plane = 0;
+        *x = ((block >> 2) & 1) * 8 + (block & 1) * 4;
+        *y = (block >> 3) * 8 + ((block >> 1) & 1) * 4;
+    } else {
+        int k = (block - 16) & 3;
+        *plane = block < 20 ? 1 : 2;
+        *x = (k & 1) * 4;
+        *y = (k >> 1) * 4;
+    }
+}
+
+static inline int CbpBit(int block) {
+    return block < 16 ? block >> 2 : (block < 20 ? 4 : 5);
+}
+
+// Coin d'un macrobloc dans un plan de l'image : la chrominance NV12 est entrelacée (pas de 2)
+static uint8_t* PlaneAt(const YuvImage* picture, int plane, int mx, int my, int* stride, int* step) {
+    if (plane == 0) {
+        *stride = picture->yStride;
+        *step = 1;
+        return picture->y + (size_t)my * VIDEO_MB_SIZE * picture->yStride + (size_t)mx * VIDEO_MB_SIZE;
+    }
+    *stride = picture->uvStride;
+    *step = 2;
+    return picture->uv + (size_t)my * (VIDEO_MB_SIZE / 2) * picture->uvStride + (size_t)mx * VIDEO_MB_SIZE + (plane - 1);
+}
+
+static const uint8_t* PredictionPlane(const MacroblockPixels* pred, int plane, int* stride) {
+    *stride = plane == 0 ? VIDEO_MB_SIZE : VIDEO_MB_SIZE / 2;
+    return plane == 0 ? pred->y : (plane == 1 ? pred->u : pred->v);
+}
+
+static bool IntraModeAvailable(int mode, bool top, bool left) {
+    if (mode == INTRA_VERTICAL) return top;
+    if (mode == INTRA_HORIZONTAL) return left;
+    return mode == INTRA_DC;
+}
+
+// Moyenne des pixels reconstruits au-dessus et à gauche d'un bloc carré, 128 sans voisin
+static uint8_t PredictDc(const uint8_t* origin, int stride, int step, int size, bool top, bool left) {
+    int sum = 0;
+    int count = 0;
+    for (int i = 0; top && i < size; i++, count++) sum += origin[-stride + i * step];
+    for (int i = 0; left && i < size; i++, count++) sum += origin[i * stride - step];
+    return count > 0 ? (uint8_t)((sum + count / 2) / count) : 128;
+}
+
+static void PredictIntra(const SliceContext* slice, int mx, int my, int mode, MacroblockPixels* pred) {
+    bool top = my > slice->firstRow;
+    bool left = mx > 0;
+    int stride, step;
+    const uint8_t* origin = PlaneAt(slice->current, 0, mx, my, &stride, &step);
+    
+    if (mode == INTRA_VERTICAL) {
+        for (int y = 0; y < VIDEO_MB_SIZE; y++) memcpy(pred->y + y * VIDEO_MB_SIZE, origin - stride, VIDEO_MB_SIZE);
+    } else if (mode == INTRA_HORIZONTAL) {
+        for (int y = 0; y < VIDEO_MB_SIZE; y++) memset(pred->y + y * VIDEO_MB_SIZE, origin[y * stride - 1], VIDEO_MB_SIZE);
+    } else {
+        memset(pred->y, PredictDc(origin, stride, 1, VIDEO_MB_SIZE, top, left), sizeof(pred->y));
+    }
+    
+    // Chrominance toujours en DC
+    for (int plane = 1; plane <= 2; plane++) {
+        const uint8_t* chroma = PlaneAt(slice->current, plane, mx, my, &stride, &step);
+        memset(plane == 1 ? pred->u : pred->v, PredictDc(chroma, stride, step, VIDEO_MB_SIZE / 2, top, left),
+               sizeof(pred->u));
+    }
+}
+
+// Déplacement valide : le bloc de référence est entièrement dans l'image (bords déjà répétés)
+static bool MotionInBounds(const SliceContext* slice, int mx, int my, int mvx, int mvy) {
+    int x = mx * VIDEO_MB_SIZE + mvx;
+    int y = my * VIDEO_MB_SIZE + mvy;
+    return x >= 0 && y >= 0 && x <= (slice->mbColumns - 1) * VIDEO_MB_SIZE && y <= (slice->mbRows - 1) * VIDEO_MB_SIZE;
+}
+
+// Bloc déplacé de la référence ; la chrominance suit au pixel pair inférieur
+static void PredictInter(const SliceContext* slice, int mx, int my, int mvx, int mvy, MacroblockPixels* pred) {
+    const YuvImage* reference = slice->reference;
+    const uint8_t* luma = reference->y + (size_t)(my * VIDEO_MB_SIZE + mvy) * reference->yStride +
+                          (size_t)(mx * VIDEO_MB_SIZE + mvx);
+    for (int y = 0; y < VIDEO_MB_SIZE; y++) {
+        memcpy(pred->y + y * VIDEO_MB_SIZE, luma + (size_t)y * reference->yStride, VIDEO_MB_SIZE);
+    }
+    
+    int cx = mx * (VIDEO_MB_SIZE / 2) + (mvx >> 1);
+    int cy = my * (VIDEO_MB_SIZE / 2) + (mvy >> 1);
+    const uint8_t* chroma = reference->uv + (size_t)cy * reference->uvStride + (size_t)cx * 2;
+    for (int y = 0; y < VIDEO_MB_SIZE / 2; y++) {
+        const uint8_t* row = chroma + (size_t)y * reference->uvStride;
+        for (int x = 0; x < VIDEO_MB_SIZE / 2; x++) {
+            pred->u[y * 8 + x] = row[2 * x];
+            pred->v[y * 8 + x] = row[2 * x + 1];
+        }
+    }
+}
+
+// Prédiction plus résidu dans l'image en cours ; les blocs sans coefficient recopient la prédiction
+static void ReconstructMacroblock(const SliceContext* slice, int mx, int my, const MacroblockPixels* pred,
+                                  const MacroblockResidual* residual) {
+    for (int block = 0; block < MB_BLOCKS; block++) {
+        int plane, x, y, stride, step, predStride;
+        BlockPosition(block, &plane, &x, &y);
+        uint8_t* dst = PlaneAt(slice->current, plane, mx, my, &stride, &step) + (size_t)y * stride + (size_t)x * step;
+        const uint8_t* source = PredictionPlane(pred, plane, &predStride) + y * predStride + x;
+        
+        if (residual && (residual->cbp >> CbpBit(block) & 1) && residual->counts[block] > 0) {
+            ReconstructBlock(residual->levels[block], residual->qp, source, predStride, dst, stride, step);
+        } else {
+            for (int row = 0; row < 4; row++) {
+                for (int column = 0; column < 4; column++) {
+                    dst[row * stride + column * step] = source[row * predStride + column];
+                }
+            }
+        }
+    }
+}
+
+static uint32_t Sad16x16(const uint8_t* a, int aStride, const uint8_t* b, int bStride) {
+#ifdef VIDEO_SSE2
+    __m128i sum = _mm_setzero_si128();
+    for (int y = 0; y < VIDEO_MB_SIZE; y++) {
+        __m128i rowA = _mm_loadu_si128((const __m128i*)(a + (size_t)y * aStride));
+        __m128i rowB = _mm_loadu_si128((const __m128i*)(b + (size_t)y * bStride));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(rowA, rowB));
+    }
+    return (uint32_t)(_mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+#else
+    uint32_t sum = 0;
+    for (int y = 0; y < VIDEO_MB_SIZE; y++) {
+        for (int x = 0; x < VIDEO_MB_SIZE; x++) sum += (uint32_t)Abs(a[(size_t)y * aStride + x] - b[(size_t)y * bStride + x]);
+    }
+    return sum;
+#endif
+}
+
+// Macrobloc identique dans la référence (luminance et chrominance) : sauté sans autre calcul
+static bool MacroblockUnchanged(const SliceContext* slice, const YuvImage* input, int mx, int my) {
+    int stride, step, refStride;
+    const uint8_t* luma = PlaneAt(input, 0, mx, my, &stride, &step);
+    const uint8_t* refLuma = PlaneAt(slice->reference, 0, mx, my, &refStride, &step);
+    if (Sad16x16(luma, stride, refLuma, refStride) != 0) return false;
+    
+    const uint8_t* chroma = PlaneAt(input, 1, mx, my, &stride, &step);
+    const uint8_t* refChroma = PlaneAt(slice->reference, 1, mx, my, &refStride, &step);
+    for (int y = 0; y < VIDEO_MB_SIZE / 2; y++) {
+        if (memcmp(chroma + (size_t)y * stride, refChroma + (size_t)y * refStride, VIDEO_MB_SIZE) != 0) return false;
+    }
+    return true;
+}
+
+static uint32_t MotionCost(const SliceContext* slice, const uint8_t* source, int stride, int mx, int my,
+                           int mvx, int mvy, int predX, int predY) {
+    if (Abs(mvx) > VIDEO_MAX_MOTION || Abs(mvy) > VIDEO_MAX_MOTION || !MotionInBounds(slice, mx, my, mvx, mvy)) {
+        return UINT32_MAX;
+    }
+    const YuvImage* reference = slice->reference;
+    const uint8_t* candidate = reference->y + (size_t)(my * VIDEO_MB_SIZE + mvy) * reference->yStride +
+                               (size_t)(mx * VIDEO_MB_SIZE + mvx);
+    return Sad16x16(source, stride, candidate, reference->yStride) +
+           (uint32_t)(MOTION_VECTOR_COST * (Abs(mvx - predX) + Abs(mvy - predY)));
+}
+
+// Déplacements des voisins, puis losange de pas décroissant autour du meilleur
+static uint32_t SearchMotion(const SliceContext* slice, const YuvImage* input, int mx, int my,
+                             int predX, int predY, int* bestX, int* bestY) {
+    int stride, step;
+    const uint8_t* source = PlaneAt(input, 0, mx, my, &stride, &step);
+    int index = my * slice->mbColumns + mx;
+    int candidates[3][2] = { { 0, 0 }, { predX, predY }, { 0, 0 } };
+    int candidateCount = 2;
+    if (my > slice->firstRow) {
+        candidates[2][0] = slice->motion[2 * (index - slice->mbColumns)];
+        candidates[2][1] = slice->motion[2 * (index - slice->mbColumns) + 1];
+        candidateCount = 3;
+    }
+    
+    *bestX = 0;
+    *bestY = 0;
+    uint32_t best = UINT32_MAX;
+    for (int c = 0; c < candidateCount; c++) {
+        uint32_t cost = MotionCost(slice, source, stride, mx, my, candidates[c][0], candidates[c][1], predX, predY);
+        if (cost < best) {
+            best = cost;
+            *bestX = candidates[c][0];
+            *bestY = candidates[c][1];
+        }
+    }
+    
+    static const int directions[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    for (int size = 8; size >= 1; size /= 2) {
+        for (int iteration = 0; iteration < 8; iteration++) {
+            int centerX = *bestX;
+            int centerY = *bestY;
+            for (int d = 0; d < 4; d++) {
+                int mvx = centerX + directions[d][0] * size;
+                int mvy = centerY + directions[d][1] * size;
+                uint32_t cost = MotionCost(slice, source, stride, mx, my, mvx, mvy, predX, predY);
+                if (cost < best) {
+                    best = cost;
+                    *bestX = mvx;
+                    *bestY = mvy;
+                }
+            }
+            if (*bestX == centerX && *bestY == centerY) break;
+        }
+    }
+    return best;
+}
+
+// Prédiction intra disponible de plus faible SAD de luminance
+static uint32_t SearchIntraMode(const SliceContext* slice, const YuvImage* input, int mx, int my, int* bestMode) {
+    int stride, step;
+    const uint8_t* source = PlaneAt(input, 0, mx, my, &stride, &step);
+    bool top = my > slice->firstRow;
+    bool left = mx > 0;
+    uint32_t best = UINT32_MAX;
+    *bestMode = INTRA_DC;
+    for (int mode = 0; mode < INTRA_MODES; mode++) {
+        if (!IntraModeAvailable(mode, top, left)) continue;
+        MacroblockPixels pred;
+        PredictIntra(slice, mx, my, mode, &pred);
+        uint32_t sad = Sad16x16(source, stride, pred.y, VIDEO_MB_SIZE);
+        if (sad < best) {
+            best = sad;
+            *bestMode = mode;
+        }
+    }
+    return best;
+}
+
+static void QuantizeMacroblock(const SliceContext* slice, const YuvImage* input, int mx, int my,
+                               const MacroblockPixels* pred, bool intra, MacroblockResidual* residual) {
+    residual->cbp = 0;
+    residual->qp = slice->qp;
+    if (slice->roi) {
+        int qp = slice->qp + RoiMapQpOffset(slice->roi, mx * VIDEO_MB_SIZE, my * VIDEO_MB_SIZE);
+        residual->qp = qp < 0 ? 0 : (qp > VIDEO_QP_MAX ? VIDEO_QP_MAX : qp);
+    }
+    for (int block = 0; block < MB_BLOCKS; block++) {
+        int plane, x, y, stride, step, predStride;
+        BlockPosition(block, &plane, &x, &y);
+        const uint8_t* source = PlaneAt(input, plane, mx, my, &stride, &step) + (size_t)y * stride + (size_t)x * step;
+        const uint8_t* prediction = PredictionPlane(pred, plane, &predStride) + y * predStride + x;
+        
+        int difference[16];
+        int coeffs[16];
+        for (int row = 0; row < 4; row++) {
+            for (int column = 0; column < 4; column++) {
+                difference[4 * row + column] = source[row * stride + column * step] - prediction[row * predStride + column];
+            }
+        }
+        ForwardTransform(difference, coeffs);
+        residual->counts[block] = (uint8_t)Quantize(coeffs, residual->qp, intra, residual->levels[block]);
+        if (residual->counts[block] > 0) residual->cbp |= 1 << CbpBit(block);
+    }
+}
+
+// Motif des blocs, écart au quantificateur du dernier macrobloc avec résidu, puis par bloc transmis :
+// coefficients non nuls, et pour chacun les zéros qui le précèdent
+static void WriteResidual(BitWriter* writer, const MacroblockResidual* residual, int* lastQp) {
+    PutUe(writer, (uint32_t)residual->cbp);
+    if (residual->cbp == 0) return;
+    PutSe(writer, residual->qp - *lastQp);
+    *lastQp = residual->qp;
+    for (int block = 0; block < MB_BLOCKS; block++) {
+        if (!(residual->cbp >> CbpBit(block) & 1)) continue;
+        PutUe(writer, residual->counts[block]);
+        uint32_t run = 0;
+        for (int k = 0, written = 0; k < 16 && written < residual->counts[block]; k++) {
+            int level = residual->levels[block][zigzag[k]];
+            if (level == 0) {
+                run++;
+                continue;
+            }
+            PutUe(writer, run);
+            PutSe(writer, level);
+            run = 0;
+            written++;
+        }
+    }
+}
+
+static bool ReadResidual(BitReader* reader, int* lastQp, MacroblockResidual* residual) {
+    memset(residual, 0, sizeof(*residual));
+    uint32_t cbp = GetUe(reader);
+    if (reader->failed || cbp > CBP_MAX) return false;
+    residual->cbp = (int)cbp;
+    residual->qp = *lastQp;
+    if (cbp == 0) return true;
+    
+    int qp = *lastQp + GetSe(reader);
+    if (reader->failed || qp < 0 || qp > VIDEO_QP_MAX) return false;
+    residual->qp = qp;
+    *lastQp = qp;
+    
+    int maxLevel = LEVEL_MAX >> (qp / 6);
+    for (int block = 0; block < MB_BLOCKS; block++) {
+        if (!(residual->cbp >> CbpBit(block) & 1)) continue;
+        uint32_t count = GetUe(reader);
+        if (reader->failed || count > 16) return false;
+        residual->counts[block] = (uint8_t)count;
+        uint32_t position = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            position += GetUe(reader);
+            int level = GetSe(reader);
+            if (reader->failed || position >= 16 || level == 0 || Abs(level) > maxLevel) return false;
+            residual->levels[block][zigzag[position]] = (int16_t)level;
+            position++;
+        }
+    }
+    return true;
+}
+
+// Macrobloc sauté : copie de la référence au même endroit
+static void SkipMacroblock(const SliceContext* slice, int mx, int my) {
+    MacroblockPixels pred;
+    PredictInter(slice, mx, my, 0, 0, &pred);
+    ReconstructMacroblock(slice, mx, my, &pred, NULL);
+    int index = my * slice->mbColumns + mx;
+    slice->motion[2 * index] = 0;
+    slice->motion[2 * index + 1] = 0;
+}
+
+// Image P : nombre de macroblocs sautés avant chaque macrobloc codé, et après le dernier
+static void EncodeSlice(const SliceContext* slice, const YuvImage* input, int lastRow, BitWriter* writer) {
+    bool intraFrame = slice->reference == NULL;
+    uint32_t skipRun = 0;
+    int lastQp = slice->qp;
+    for (int my = slice->firstRow; my < lastRow; my++) {
+        for (int mx = 0; mx < slice->mbColumns; mx++) {
+            int index = my * slice->mbColumns + mx;
+            int predX = mx > 0 ? slice->motion[2 * (index - 1)] : 0;
+            int predY = mx > 0 ? slice->motion[2 * (index - 1) + 1] : 0;
+            
+            if (!intraFrame && MacroblockUnchanged(slice, input, mx, my)) {
+                SkipMacroblock(slice, mx, my);
+                skipRun++;
+                continue;
+            }
+            
+            int type = MB_INTRA;
+            int mode = INTRA_DC;
+            int mvx = 0;
+            int mvy = 0;
+            uint32_t intraSad = SearchIntraMode(slice, input, mx, my, &mode);
+            if (!intraFrame) {
+                uint32_t interSad = SearchMotion(slice, input, mx, my, predX, predY, &mvx, &mvy);
+                if (intraSad + INTRA_BIAS >= interSad) type = MB_INTER;
+            }
+            
+            MacroblockPixels pred;
+            if (type == MB_INTER) {
+                PredictInter(slice, mx, my, mvx, mvy, &pred);
+            } else {
+                mvx = 0;
+                mvy = 0;
+                PredictIntra(slice, mx, my, mode, &pred);
+            }
+            MacroblockResidual residual;
+            QuantizeMacroblock(slice, input, mx, my, &pred, type == MB_INTRA, &residual);
+            ReconstructMacroblock(slice, mx, my, &pred, &residual);
+            slice->motion[2 * index] = (int16_t)mvx;
+            slice->motion[2 * index + 1] = (int16_t)mvy;
+            
+            // Sans résidu ni déplacement, le macrobloc est identique à un macrobloc sauté
+            if (type == MB_INTER && mvx == 0 && mvy == 0 && residual.cbp == 0) {
+                skipRun++;
+                continue;
+            }
+            
+            if (!intraFrame) {
+                PutUe(writer, skipRun);
+                PutUe(writer, (uint32_t)type);
+                skipRun = 0;
+            }
+            if (type == MB_INTER) {
+                PutSe(writer, mvx - predX);
+                PutSe(writer, mvy - predY);
+            } else {
+                PutUe(writer, (uint32_t)mode);
+            }
+            WriteResidual(writer, &residual, &lastQp);
+        }
+    }
+    if (skipRun > 0) PutUe(writer, skipRun);
+    FlushBits(writer);
+}
+
+static bool DecodeMacroblock(const SliceContext* slice, BitReader* reader, int mx, int my, int* lastQp) {
+    int index = my * slice->mbColumns + mx;
+    int type = slice->reference ? (int)GetUe(reader) : MB_INTRA;
+    int mvx = 0;
+    int mvy = 0;
+    MacroblockPixels pred;
+    
+    if (type == MB_INTER) {
+        mvx = (mx > 0 ? slice->motion[2 * (index - 1)] : 0) + GetSe(reader);
+        mvy = (mx > 0 ? slice->motion[2 * (index - 1) + 1] : 0) + GetSe(reader);
+        if (reader->failed || !MotionInBounds(slice, mx, my, mvx, mvy)) return false;
+        PredictInter(slice, mx, my, mvx, mvy, &pred);
+    } else if (type == MB_INTRA) {
+        int mode = (int)GetUe(reader);
+        if (reader->failed || !IntraModeAvailable(mode, my > slice->firstRow, mx > 0)) return false;
+        PredictIntra(slice, mx, my, mode, &pred);
+    } else {
+        return false;
+    }
+    
+    MacroblockResidual residual;
+    if (!ReadResidual(reader, lastQp, &residual)) return false;
+    ReconstructMacroblock(slice, mx, my, &pred, &residual);
+    slice->motion[2 * index] = (int16_t)mvx;
+    slice->motion[2 * index + 1] = (int16_t)mvy;
+    return true;
+}
+
+static bool DecodeSlice(const SliceContext* slice, const uint8_t* data, uint32_t size, int lastRow) {
+    BitReader reader = { data, size, 0, false };
+    int first = slice->firstRow * slice->mbColumns;
+    int total = lastRow * slice->mbColumns;
+    int position = first;
+    int lastQp = slice->qp;
+    while (position < total) {
+        if (slice->reference) {
+            uint32_t skipRun = GetUe(&reader);
+            if (reader.failed || skipRun > (uint32_t)(total - position)) return false;
+            for (uint32_t i = 0; i < skipRun; i++, position++) {
+                SkipMacroblock(slice, position % slice->mbColumns, position / slice->mbColumns);
+            }
+            if (position == total) break;
+        }
+        if (!DecodeMacroblock(slice, &reader, position % slice->mbColumns, position / slice->mbColumns, &lastQp)) {
+            return false;
+        }
+        position++;
+    }
+    return true;
+}
+
+// Tranches de lignes de macroblocs de tailles égales à une ligne près
+static int SliceFirstRow(int slice, int sliceCount, int mbRows) {
+    return (int)((int64_t)slice * mbRows / sliceCount);
+}
+
+// Tranches d'une image reçue, décodées en parallèle : chacune n'écrit que ses propres lignes de
+// l'image en cours et ne lit en dehors que la référence, qui n'est pas modifiée
+typedef struct {
+    const SliceContext* frame;
+    const uint8_t* payloads[VIDEO_MAX_SLICES];
+    uint32_t sizes[VIDEO_MAX_SLICES];
+    int sliceCount;
+    _Atomic bool failed;
+} SliceDecodeBatch;
+
+static void DecodeSliceJob(void* context, int index) {
+    SliceDecodeBatch* batch = (SliceDecodeBatch*)context;
+    if (atomic_load_explicit(&batch->failed, memory_order_relaxed)) return;
+    
+    SliceContext slice = *batch->frame;
+    slice.firstRow = SliceFirstRow(index, batch->sliceCount, slice.mbRows);
+    if (!DecodeSlice(&slice, batch->payloads[index], batch->sizes[index],
+                     SliceFirstRow(index + 1, batch->sliceCount, slice.mbRows))) {
+        atomic_store_explicit(&batch->failed, true, memory_order_relaxed);
+    }
+}
+
+// Conversion en RGBA par bandes de lignes de macroblocs (hauteur paire : la chrominance suit)
+typedef struct {
+    const YuvImage* visible;
+    uint8_t* rgba;
+    size_t stride;
+    int mbRows;
+    int bandCount;
+} ConvertBatch;
+
+static void ConvertBandJob(void* context, int index) {
+    const ConvertBatch* batch = (const ConvertBatch*)context;
+    int first = SliceFirstRow(index, batch->bandCount, batch->mbRows) * VIDEO_MB_SIZE;
+    int last = SliceFirstRow(index + 1, batch->bandCount, batch->mbRows) * VIDEO_MB_SIZE;
+    if (last > batch->visible->height) last = batch->visible->height;
+    if (first >= last) return;
+    
+    YuvImage band = *batch->visible;
+    band.y += (size_t)first * band.yStride;
+    band.uv += (size_t)(first / 2) * band.uvStride;
+    band.height = last - first;
+    ColorConvertNv12ToRgba(&band, batch->rgba + (size_t)first * batch->stride, batch->stride);
+}
+
+static int FindReference(const VideoReference* references, uint32_t frameId) {
+    if (frameId == 0) return -1;
+    for (int i = 0; i < VIDEO_MAX_REFERENCES; i++) {
+        if (references[i].frameId == frameId) return i;
+    }
+    return -1;
+}
+
+// Emplacement de la nouvelle reconstruction : libre, sinon la plus ancienne, jamais la référence utilisée
+static int ChooseReferenceSlot(const VideoReference* references, int keep, uint32_t frameId) {
+    int slot = -1;
+    uint32_t oldest = 0;
+    for (int i = 0; i < VIDEO_MAX_REFERENCES; i++) {
+        if (i == keep) continue;
+        if (references[i].frameId == 0) return i;
+        uint32_t age = frameId - references[i].frameId;
+        if (slot < 0 || age > oldest) {
+            slot = i;
+            oldest = age;
+        }
+    }
+    return slot;
+}
+
+static void FreeReferences(VideoReference* references) {
+    for (int i = 0; i < VIDEO_MAX_REFERENCES; i++) {
+        YuvImageFree(&references[i].picture);
+        references[i].frameId = 0;
+    }
+}
+
+// Nouvelles dimensions : plus aucune référence, grille de macroblocs recalculée
+static bool ResetGrid(VideoReference* references, int16_t** motion, int* mbColumns, int* mbRows, int width, int height) {
+    FreeReferences(references);
+    free(*motion);
+    *mbColumns = (width + VIDEO_MB_SIZE - 1) / VIDEO_MB_SIZE;
+    *mbRows = (height + VIDEO_MB_SIZE - 1) / VIDEO_MB_SIZE;
+    *motion = (int16_t*)calloc((size_t)*mbColumns * *mbRows * 2, sizeof(int16_t));
+    return *motion != NULL;
+}
+
+// Copie de l'image à coder, dernière colonne et dernière ligne répétées jusqu'au macrobloc
+static void PadInput(YuvImage* padded, const YuvImage* input) {
+    int chromaWidth = (input->width + 1) / 2;
+    int chromaHeight = (input->height + 1) / 2;
+    for (int y = 0; y < padded->height; y++) {
+        const uint8_t* source = input->y + (size_t)(y < input->height ? y : input->height - 1) * input->yStride;
+        uint8_t* row = padded->y + (size_t)y * padded->yStride;
+        memcpy(row, source, (size_t)input->width);
+        memset(row + input->width, source[input->width - 1], (size_t)(padded->width - input->width));
+    }
+    for (int y = 0; y < padded->height / 2; y++) {
+        const uint8_t* source = input->uv + (size_t)(y < chromaHeight ? y : chromaHeight - 1) * input->uvStride;
+        uint8_t* row = padded->uv + (size_t)y * padded->uvStride;
+        memcpy(row, source, (size_t)chromaWidth * 2);
+        for (int x = chromaWidth; x < padded->width / 2; x++) {
+            row[2 * x] = source[2 * chromaWidth - 2];
+            row[2 * x + 1] = source[2 * chromaWidth - 1];
+        }
+    }
+}
+
+int VideoQualityToQp(int quality) {
+    if (quality < 0) quality = 0;
+    if (quality > 100) quality = 100;
+    return 51 - quality * 41 / 100;
+}
+
+bool VideoEncode(VideoEncoder* encoder, const YuvImage* input, uint32_t frameId, uint32_t referenceFrameId,
+                 const VideoEncodeOptions* options, uint8_t** data, uint32_t* size) {
+    if (!data || !size) return false;
+    *data = NULL;
+    *size = 0;
+    if (!encoder || !input || !input->y || !options || input->width <= 0 || input->height <= 0) return false;
+    
+    if (encoder->width != input->width || encoder->height != input->height || !encoder->input.y) {
+        if (!ResetGrid(encoder->references, &encoder->motion, &encoder->mbColumns, &encoder->mbRows,
+                       input->width, input->height) ||
+            !YuvImageAlloc(&encoder->input, encoder->mbColumns * VIDEO_MB_SIZE, encoder->mbRows * VIDEO_MB_SIZE)) {
+            VideoEncoderFree(encoder);
+            return false;
+        }
+        encoder->streamId = NewStreamId(encoder->streamId);
+        encoder->width = input->width;
+        encoder->height = input->height;
+    }
+    PadInput(&encoder->input, input);
+    
+    // Image P depuis la référence acquittée si elle est conservée et que le GOP le permet
+    int referenceIndex = -1;
+    bool gopOpen = options->gop <= 0 || encoder->framesSinceIntra + 1 < options->gop;
+    if (gopOpen && referenceFrameId != 0 && WireSequenceNewer(frameId, referenceFrameId)) {
+        referenceIndex = FindReference(encoder->references, referenceFrameId);
+    }
+    int slot = ChooseReferenceSlot(encoder->references, referenceIndex, frameId);
+    VideoReference* output = &encoder->references[slot];
+    output->frameId = 0;
+    if (!YuvImageAlloc(&output->picture, encoder->input.width, encoder->input.height)) return false;
+    
+    int sliceCount = options->slices < 1 ? 1 : options->slices;
+    if (sliceCount > VIDEO_MAX_SLICES) sliceCount = VIDEO_MAX_SLICES;
+    if (sliceCount > encoder->mbRows) sliceCount = encoder->mbRows;
+    
+    SliceContext slice = {0};
+    slice.current = &output->picture;
+    slice.reference = referenceIndex >= 0 ? &encoder->references[referenceIndex].picture : NULL;
+    slice.mbColumns = encoder->mbColumns;
+    slice.mbRows = encoder->mbRows;
+    slice.motion = encoder->motion;
+    slice.qp = VideoQualityToQp(options->quality);
+    slice.roi = options->roi;
+    
+    BitWriter writers[VIDEO_MAX_SLICES];
+    memset(writers, 0, sizeof(writers));
+    bool failed = false;
+    uint32_t total = WireVideoFrameHeaderSize((uint32_t)sliceCount);
+    for (int s = 0; s < sliceCount; s++) {
+        slice.firstRow = SliceFirstRow(s, sliceCount, encoder->mbRows);
+        EncodeSlice(&slice, &encoder->input, SliceFirstRow(s + 1, sliceCount, encoder->mbRows), &writers[s]);
+        failed |= writers[s].failed;
+        total += (uint32_t)writers[s].size;
+    }
+    
+    uint8_t* frame = failed ? NULL : (uint8_t*)malloc(total);
+    if (frame) {
+        uint32_t referenceUsed = slice.reference ? referenceFrameId : 0;
+        WireWriteVideoFrame(frame, encoder->streamId, referenceUsed, (uint8_t)slice.qp, (uint8_t)sliceCount);
+        uint8_t* payload = frame + WireVideoFrameHeaderSize((uint32_t)sliceCount);
+        for (int s = 0; s < sliceCount; s++) {
+            WireWriteU32(frame + WIRE_VIDEO_FRAME_SIZE + 4 * s, (uint32_t)writers[s].size);
+            if (writers[s].size > 0) memcpy(payload, writers[s].data, writers[s].size);
+            payload += writers[s].size;
+        }
+    }
+    for (int s = 0; s < sliceCount; s++) free(writers[s].data);
+    if (!frame) return false;
+    
+    output->frameId = frameId;
+    encoder->framesSinceIntra = slice.reference ? encoder->framesSinceIntra + 1 : 0;
+    *data = frame;
+    *size = total;
+    return true;
+}
+
+void VideoEncoderFree(VideoEncoder* encoder) {
+    if (!encoder) return;
+    FreeReferences(encoder->references);
+    YuvImageFree(&encoder->input);
+    free(encoder->motion);
+    memset(encoder, 0, sizeof(*encoder));
+}
+
+TileApplyResult VideoDecoderApply(VideoDecoder* decoder, const uint8_t* data, uint32_t size,
+                                  uint32_t frameId, int width, int height) {
+    if (!decoder || !WireVideoFrameValidate(data, size) || width <= 0 || height <= 0) return TILE_APPLY_ERROR;
+    
+    uint32_t streamId = WireVideoFrameStreamId(data);
+    uint32_t referenceFrameId = WireVideoFrameReferenceFrameId(data);
+    bool sameStream = decoder->streamId == streamId && decoder->width == width && decoder->height == height;
+    if (sameStream && !WireSequenceNewer(frameId, decoder->frameId)) return TILE_APPLY_STALE;
+    
+    // Image P : la reconstruction de la référence doit être conservée
+    int referenceIndex = -1;
+    if (referenceFrameId != 0) {
+        if (!sameStream || !WireSequenceNewer(frameId, referenceFrameId)) return TILE_APPLY_MISSING_BASE;
+        referenceIndex = FindReference(decoder->references, referenceFrameId);
+        if (referenceIndex < 0) return TILE_APPLY_MISSING_BASE;
+    } else if (!sameStream) {
+        if (!ResetGrid(decoder->references, &decoder->motion, &decoder->mbColumns, &decoder->mbRows, width, height)) {
+            VideoDecoderFree(decoder);
+            return TILE_APPLY_ERROR;
+        }
+        decoder->streamId = streamId;
+        decoder->width = width;
+        decoder->height = height;
+        decoder->frameId = 0;
+    }
+    
+    uint32_t sliceCount = WireVideoFrameSliceCount(data);
+    if (sliceCount > (uint32_t)decoder->mbRows || sliceCount > VIDEO_MAX_SLICES) return TILE_APPLY_ERROR;
+    
+    int slot = ChooseReferenceSlot(decoder->references, referenceIndex, frameId);
+    VideoReference* output = &decoder->references[slot];
+    output->frameId = 0;
+    if (!YuvImageAlloc(&output->picture, decoder->mbColumns * VIDEO_MB_SIZE, decoder->mbRows * VIDEO_MB_SIZE)) {
+        return TILE_APPLY_ERROR;
+    }
+    
+    SliceContext slice = {0};
+    slice.current = &output->picture;
+    slice.reference = referenceIndex >= 0 ? &decoder->references[referenceIndex].picture : NULL;
+    slice.mbColumns = decoder->mbColumns;
+    slice.mbRows = decoder->mbRows;
+    slice.motion = decoder->motion;
+    slice.qp = WireVideoFrameQp(data);
+    
+    SliceDecodeBatch batch = { .frame = &slice, .sliceCount = (int)sliceCount };
+    atomic_init(&batch.failed, false);
+    const uint8_t* payload = data + WireVideoFrameHeaderSize(sliceCount);
+    for (uint32_t s = 0; s < sliceCount; s++) {
+        batch.payloads[s] = payload;
+        batch.sizes[s] = WireVideoFrameSliceSize(data, s);
+        payload += batch.sizes[s];
+    }
+    WorkerPoolRun(DecodeSliceJob, &batch, (int)sliceCount);
+    if (atomic_load(&batch.failed)) return TILE_APPLY_ERROR;
+    output->frameId = frameId;
+    decoder->frameId = frameId;
+    
+    // Image affichée : reconstruction sans les bords ajoutés, en RGBA
+    if (!decoder->image.data || decoder->image.width != width || decoder->image.height != height) {
+        free(decoder->image.data);
+        decoder->image.data = malloc((size_t)width * height * 4);
+        if (!decoder->image.data) {
+            memset(&decoder->image, 0, sizeof(decoder->image));
+            return TILE_APPLY_ERROR;
+        }
+        decoder->image.width = width;
+        decoder->image.height = height;
+        decoder->image.mipmaps = 1;
+        decoder->image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    }
+    YuvImage visible = output->picture;
+    visible.width = width;
+    visible.height = height;
+    ConvertBatch convert = { &visible, (uint8_t*)decoder->image.data, (size_t)width * 4, decoder->mbRows, 0 };
+    convert.bandCount = WorkerPoolSize() < decoder->mbRows ? WorkerPoolSize() : decoder->mbRows;
+    WorkerPoolRun(ConvertBandJob, &convert, convert.bandCount);
+    
+    // Les macroblocs sautés reprennent la référence, pas forcément l'image affichée : tout est à jour
+    decoder->dirty = (DirtyRect){ 0, 0, width, height };
+    return TILE_APPLY_OK;
+}
+
+void VideoDecoderFree(VideoDecoder* decoder) {
+    if (!decoder) return;
+    FreeReferences(decoder->references);
+    free(decoder->motion);
+    free(decoder->image.data);
+    memset(decoder, 0, sizeof(*decoder));
+}
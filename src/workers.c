@@ -0,0 +1,103 @@
+#include "../include/workers.h"
+#include "../include/thread.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+static Thread threads[WORKER_MAX_THREADS];
+static int threadCount = 0;
+static Semaphore startSignal;               // Un jeton par thread à réveiller
+static Semaphore doneSignal;                // Un jeton par thread qui a fini le lot
+static _Atomic bool poolRunning = false;
+
+// Lot en cours (écrit par l'appelant avant de réveiller les threads)
+static WorkerJob batchJob = NULL;
+static void* batchContext = NULL;
+static int batchCount = 0;
+static _Atomic int batchNext = 0;
+
+// Prend des tâches du lot jusqu'à épuisement
+static void RunBatch(void) {
+    int index;
+    while ((index = atomic_fetch_add_explicit(&batchNext, 1, memory_order_relaxed)) < batchCount) {
+        batchJob(batchContext, index);
+    }
+}
+
+static int WorkerMain(void* arg) {
+    (void)arg;
+    
+    for (;;) {
+        SemaphoreWait(&startSignal);
+        if (!atomic_load(&poolRunning)) break;
+        RunBatch();
+        SemaphorePost(&doneSignal, 1);
+    }
+    return 0;
+}
+
+// Implémentation des fonctions publiques
+int WorkerPoolInit(int threadsWanted) {
+    WorkerPoolShutdown();
+    
+    if (threadsWanted < 0) threadsWanted = ThreadCpuCount() - 1;
+    if (threadsWanted > WORKER_MAX_THREADS) threadsWanted = WORKER_MAX_THREADS;
+    if (threadsWanted <= 0) return 0;
+    
+    if (!SemaphoreCreate(&startSignal, 0)) return 0;
+    if (!SemaphoreCreate(&doneSignal, 0)) {
+        SemaphoreDestroy(&startSignal);
+        return 0;
+    }
+    
+    atomic_store(&poolRunning, true);
+    while (threadCount < threadsWanted && ThreadCreate(&threads[threadCount], WorkerMain, NULL)) {
+        threadCount++;
+    }
+    if (threadCount == 0) {
+        atomic_store(&poolRunning, false);
+        SemaphoreDestroy(&startSignal);
+        SemaphoreDestroy(&doneSignal);
+    }
+    return threadCount;
+}
+
+void WorkerPoolShutdown(void) {
+    if (!atomic_exchange(&poolRunning, false)) return;
+    
+    SemaphorePost(&startSignal, (uint32_t)threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        ThreadJoin(&threads[i]);
+    }
+    threadCount = 0;
+    SemaphoreDestroy(&startSignal);
+    SemaphoreDestroy(&doneSignal);
+}
+
+int WorkerPoolSize(void) {
+    return threadCount + 1;
+}
+
+void WorkerPoolRun(WorkerJob job, void* context, int count) {
+    if (!job || count <= 0) return;
+    
+    // Pas de pool ou une seule tâche : inutile de réveiller des threads
+    if (threadCount == 0 || count == 1) {
+        for (int i = 0; i < count; i++) {
+            job(context, i);
+        }
+        return;
+    }
+    
+    batchJob = job;
+    batchContext = context;
+    batchCount = count;
+    atomic_store(&batchNext, 0);
+    
+    // L'appelant prend sa part : une tâche de moins à confier aux threads
+    int woken = count - 1 < threadCount ? count - 1 : threadCount;
+    SemaphorePost(&startSignal, (uint32_t)woken);
+    RunBatch();
+    for (int i = 0; i < woken; i++) {
+        SemaphoreWait(&doneSignal);
+    }
+}